@@ -65,6 +65,13 @@ public:
 
    virtual void UnzipEvent(TObject *tree, Long64_t pos, Double_t start, Int_t complen, Int_t objlen) = 0;
 
+   // Per-branch events, only sent to the perf stats attached to a TTree.
+   virtual void BasketReadEvent(TObject * /*branch*/, Int_t /*len*/, Double_t /*start*/, Bool_t /*cacheMiss*/) {}
+
+   virtual void BasketUnzipEvent(TObject * /*branch*/, Double_t /*start*/, Int_t /*complen*/, Int_t /*objlen*/) {}
+
+   virtual void BranchStreamerEvent(TObject * /*branch*/, Double_t /*start*/, Int_t /*len*/) {}
+
    virtual void RateEvent(Double_t proctime, Double_t deltatime,
                           Long64_t eventsprocessed, Long64_t bytesRead) = 0;
 
@@ -18,6 +18,7 @@
 
 
 
+#pragma link C++ class TArrayCounts-;
 #pragma link C++ class TAxis-;
 #pragma link C++ class TBinomialEfficiencyFitter+;
 #pragma link C++ class TFormula-;
@@ -55,6 +56,7 @@
 #pragma link C++ class TH1F+;
 #pragma link C++ class TH1S+;
 #pragma link C++ class TH1I+;
+#pragma link C++ class TH1U+;
 #pragma link C++ class TH1K+;
 #pragma link C++ class TH2-;
 #pragma link C++ class TH2C-;
@@ -64,12 +66,14 @@
 #pragma link C++ class TH2PolyBin+;
 #pragma link C++ class TH2S-;
 #pragma link C++ class TH2I+;
+#pragma link C++ class TH2U+;
 #pragma link C++ class TH3-;
 #pragma link C++ class TH3C-;
 #pragma link C++ class TH3D-;
 #pragma link C++ class TH3F-;
 #pragma link C++ class TH3S-;
 #pragma link C++ class TH3I+;
+#pragma link C++ class TH3U+;
 #pragma link C++ class THLimitsFinder+;
 #pragma link C++ class THnBase+;
 #pragma link C++ class THnIter+;
@@ -222,6 +226,13 @@
 #pragma link C++ function operator*(TH1I&, TH1I&);
 #pragma link C++ function operator/(TH1I&, TH1I&);
 
+#pragma link C++ function operator*(Float_t,TH1U&);
+#pragma link C++ function operator*(TH1U&, Float_t);
+#pragma link C++ function operator+(TH1U&, TH1U&);
+#pragma link C++ function operator-(TH1U&, TH1U&);
+#pragma link C++ function operator*(TH1U&, TH1U&);
+#pragma link C++ function operator/(TH1U&, TH1U&);
+
 #pragma link C++ function operator*(Float_t,TH1F&);
 #pragma link C++ function operator*(TH1F&, Float_t);
 #pragma link C++ function operator+(TH1F&, TH1F&);
@@ -257,6 +268,13 @@
 #pragma link C++ function operator*(TH2I&, TH2I&);
 #pragma link C++ function operator/(TH2I&, TH2I&);
 
+#pragma link C++ function operator*(Float_t,TH2U&);
+#pragma link C++ function operator*(TH2U&, Float_t);
+#pragma link C++ function operator+(TH2U&, TH2U&);
+#pragma link C++ function operator-(TH2U&, TH2U&);
+#pragma link C++ function operator*(TH2U&, TH2U&);
+#pragma link C++ function operator/(TH2U&, TH2U&);
+
 #pragma link C++ function operator*(Float_t,TH2F&);
 #pragma link C++ function operator*(TH2F&, Float_t);
 #pragma link C++ function operator+(TH2F&, TH2F&);
@@ -292,6 +310,13 @@
 #pragma link C++ function operator*(TH3I&, TH3I&);
 #pragma link C++ function operator/(TH3I&, TH3I&);
 
+#pragma link C++ function operator*(Float_t,TH3U&);
+#pragma link C++ function operator*(TH3U&, Float_t);
+#pragma link C++ function operator+(TH3U&, TH3U&);
+#pragma link C++ function operator-(TH3U&, TH3U&);
+#pragma link C++ function operator*(TH3U&, TH3U&);
+#pragma link C++ function operator/(TH3U&, TH3U&);
+
 #pragma link C++ function operator*(Float_t,TH3F&);
 #pragma link C++ function operator*(TH3F&, Float_t);
 #pragma link C++ function operator+(TH3F&, TH3F&);
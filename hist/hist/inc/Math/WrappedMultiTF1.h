@@ -117,6 +117,15 @@ public:
    /// evaluate the derivative of the function with respect to the parameters
    void  ParameterGradient(const double * x, const double * par, double * grad ) const;
 
+   /**
+      Return true for the functions defined by a formula: their evaluation and their
+      parameter gradient with given parameter values do not modify the TF1, so they can be
+      computed concurrently (and the fits of ROOT::Fit::FitUtil are then evaluated in parallel
+      when implicit multi-threading is enabled). The functions defined by a C++ function,
+      a functor or an interpreted method are not assumed to be thread safe
+   */
+   bool IsThreadSafe() const;
+
    /// precision value used for calculating the derivative step-size
    /// h = eps * |x|. The default is 0.001, give a smaller in case function changes rapidly
    static void SetDerivPrecision(double eps);
@@ -141,6 +150,11 @@ private:
       return fFunc->EvalPar(x,p);
    }
 
+   /// evaluate function on a set of points passing the vector of parameters
+   void DoEvalParVec (unsigned int n, const double * x, double * result, const double * p, unsigned int stride) const {
+      fFunc->EvalParVec(n, x, result, p, stride);
+   }
+
    /// evaluate function using the cached parameter values (of TF1)
    /// re-implement for better efficiency
    double DoEval (const double* x) const { 
@@ -150,10 +164,19 @@ private:
       return fFunc->EvalPar(x, 0 ); 
    }
 
+   /// evaluate function on a set of points using the cached parameter values (of TF1)
+   void DoEvalVec (unsigned int n, const double * x, double * result) const {
+      fFunc->EvalParVec(n, x, result, 0, fDim);
+   }
+
 
    /// evaluate the partial derivative with respect to the parameter
    double DoParameterDerivative(const double * x, const double * p, unsigned int ipar) const;
 
+   /// evaluate the derivative with respect to the parameter ipar as TF1::GradientPar,
+   /// but varying the parameter values in p instead of those of the TF1
+   double GradientParCopy(unsigned int ipar, const double * x, double * p) const;
+
 
    bool fLinear;                 // flag for linear functions
    bool fPolynomial;             // flag for polynomial functions
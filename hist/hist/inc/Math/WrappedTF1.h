@@ -142,6 +142,11 @@ private:
       return fFunc->EvalPar(fX, 0 ); 
    }
 
+   /// evaluate function on a set of points using the cached parameter values (of TF1)
+   void DoEvalVec (unsigned int n, const double * x, double * result) const {
+      fFunc->EvalParVec(n, x, result, 0, 1);
+   }
+
    /// return the function derivatives w.r.t. x
    double DoDerivative( double  x  ) const;
 
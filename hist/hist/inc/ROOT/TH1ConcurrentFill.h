@@ -0,0 +1,400 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TH1ConcurrentFill
+#define ROOT_TH1ConcurrentFill
+
+#ifndef ROOT_TH1
+#include "TH1.h"
+#endif
+
+#ifndef ROOT_TList
+#include "TList.h"
+#endif
+
+#ifndef ROOT_TError
+#include "TError.h"
+#endif
+
+#ifndef ROOT_THashList
+#include "THashList.h"
+#endif
+
+#ifndef ROOT_TDirectory
+#include "TDirectory.h"
+#endif
+
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
+namespace ROOT {
+
+   /// Strategies to fill one histogram from several threads.
+   enum class EConcurrentFillMode {
+      kSharded, ///< Each filler fills a private copy of the histogram, added to the target when flushed
+      kAtomic   ///< Each filler adds directly to the bins of the target with atomic operations
+   };
+
+   template<class HIST> class TH1ConcurrentFillManager;
+
+   namespace Internal {
+
+      namespace TH1ConcurrentFillUtils {
+
+         template<class T>
+         inline T AddToBin(T content, Double_t w, std::false_type /*isIntegral*/)
+         {
+            return T(content + w);
+         }
+
+         /// Integer bins saturate at +-max as in TH1C, TH1S and TH1I::AddBinContent.
+         template<class T>
+         inline T AddToBin(T content, Double_t w, std::true_type /*isIntegral*/)
+         {
+            const Long64_t maxContent = std::numeric_limits<T>::max();
+            Long64_t newval = Long64_t(content) + Int_t(w);
+            if (newval > maxContent) return T(maxContent);
+            if (newval < -maxContent) return T(-maxContent);
+            return T(newval);
+         }
+
+         /// Return the content of a bin of type T incremented by w, with the
+         /// same conversion as the AddBinContent of the histogram classes.
+         template<class T>
+         inline T AddToBin(T content, Double_t w)
+         {
+            return AddToBin(content, w, std::is_integral<T>());
+         }
+
+         /// Add w to *addr. Concurrent calls on the same address are safe.
+         template<class T>
+         inline void AtomicAdd(T *addr, Double_t w)
+         {
+#if defined(__GNUC__) || defined(__clang__)
+            T expected;
+            __atomic_load(addr, &expected, __ATOMIC_RELAXED);
+            T desired = AddToBin(expected, w);
+            while (!__atomic_compare_exchange(addr, &expected, &desired, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+               desired = AddToBin(expected, w);
+            }
+#else
+            static std::mutex addMutex;
+            std::lock_guard<std::mutex> lg(addMutex);
+            *addr = AddToBin(*addr, w);
+#endif
+         }
+
+      } // End of namespace TH1ConcurrentFillUtils
+   } // End of namespace Internal
+
+   /**
+    * \class ROOT::TH1ConcurrentFiller
+    * \brief Fills a histogram managed by a TH1ConcurrentFillManager from one thread.
+    * \tparam HIST Concrete histogram class (e.g. TH1F, TH2D, TProfile)
+    * \ingroup Multicore
+    *
+    * A filler must be used by one thread only. Its Fill methods have the same
+    * signature as the ones of HIST taking numerical arguments or bin labels.
+    * - In sharded mode the entries go to a private copy of the histogram,
+    *   the "slab", which is added to the target by Flush.
+    * - In atomic mode the bin contents (and sums of squares of weights) of
+    *   the target are incremented atomically, while the statistics (sum of
+    *   weights, of x*w, ...) and the number of entries are accumulated
+    *   locally and added to the target by Flush. The bin labels must
+    *   already be defined on the axes: unknown labels are only counted
+    *   as entries, while TH1::Fill would add them to the axis.
+    * Flush is called by the destructor.
+    */
+   template<class HIST>
+   class TH1ConcurrentFiller {
+   public:
+      TH1ConcurrentFiller(TH1ConcurrentFillManager<HIST> &manager, HIST *slab) :
+      fManager(&manager), fSlab(slab)
+      {
+         ResetStats();
+      }
+
+      TH1ConcurrentFiller(TH1ConcurrentFiller &&other) :
+      fManager(other.fManager), fSlab(std::move(other.fSlab)), fEntries(other.fEntries)
+      {
+         for (Int_t i = 0; i < TH1::kNstat; ++i) fStats[i] = other.fStats[i];
+         other.fManager = nullptr;
+      }
+
+      TH1ConcurrentFiller(const TH1ConcurrentFiller &) = delete;
+      TH1ConcurrentFiller &operator=(const TH1ConcurrentFiller &) = delete;
+
+      ~TH1ConcurrentFiller()
+      {
+         Flush();
+      }
+
+      /// Thread-specific HIST::Fill().
+      template<class ...ARGS>
+      void Fill(ARGS... args)
+      {
+         if (fSlab) fSlab->Fill(args...);
+         else FillAtomicArgs(args...);
+      }
+
+      /// Add the entries collected so far to the target histogram.
+      void Flush()
+      {
+         if (fManager) fManager->Flush(*this);
+      }
+
+      /// The histogram private to this filler, null in atomic mode.
+      HIST *GetSlab() const { return fSlab.get(); }
+
+   private:
+      friend class TH1ConcurrentFillManager<HIST>;
+
+      TH1ConcurrentFillManager<HIST> *fManager; ///< The manager of the target histogram
+      std::unique_ptr<HIST> fSlab;              ///< Private histogram (sharded mode only)
+      Double_t fStats[TH1::kNstat];             ///< Statistics not yet added to the target (atomic mode only)
+      Double_t fEntries;                        ///< Entries not yet added to the target (atomic mode only)
+
+      void ResetStats()
+      {
+         for (Int_t i = 0; i < TH1::kNstat; ++i) fStats[i] = 0;
+         fEntries = 0;
+      }
+
+      /// Add w to the global bin of the target and update the statistics
+      /// the way TH1::Fill, TH2::Fill and TH3::Fill do.
+      void AddToTarget(Int_t binx, Int_t biny, Int_t binz, Double_t x, Double_t y, Double_t z, Double_t w)
+      {
+         ++fEntries;
+         if (binx < 0 || biny < 0 || binz < 0) return;
+         HIST &hist = fManager->GetHist();
+         Int_t bin = hist.GetBin(binx, biny, binz);
+         Internal::TH1ConcurrentFillUtils::AtomicAdd(hist.GetArray() + bin, w);
+         if (hist.GetSumw2N()) Internal::TH1ConcurrentFillUtils::AtomicAdd(hist.GetSumw2()->GetArray() + bin, w*w);
+         const Int_t dim = hist.GetDimension();
+         if (!TH1::GetStatOverflows()) {
+            if (binx == 0 || binx > hist.GetXaxis()->GetNbins()) return;
+            if (dim > 1 && (biny == 0 || biny > hist.GetYaxis()->GetNbins())) return;
+            if (dim > 2 && (binz == 0 || binz > hist.GetZaxis()->GetNbins())) return;
+         }
+         fStats[0] += w;
+         fStats[1] += w*w;
+         fStats[2] += w*x;
+         fStats[3] += w*x*x;
+         if (dim > 1) {
+            fStats[4] += w*y;
+            fStats[5] += w*y*y;
+            fStats[6] += w*x*y;
+         }
+         if (dim > 2) {
+            fStats[7] += w*z;
+            fStats[8] += w*z*z;
+            fStats[9] += w*x*z;
+            fStats[10] += w*y*z;
+         }
+      }
+
+      /// Set the coordinate corresponding to a numerical argument of Fill.
+      static Bool_t ToCoordinate(TAxis *, Double_t arg, Double_t &coord)
+      {
+         coord = arg;
+         return kTRUE;
+      }
+
+      /// Set the coordinate corresponding to a bin label argument of Fill: the center of the
+      /// labelled bin, as in TH1::Fill. Return false if the label is not defined.
+      static Bool_t ToCoordinate(TAxis *axis, const char *label, Double_t &coord)
+      {
+         THashList *labels = axis ? axis->GetLabels() : nullptr;
+         TObject *obj = labels ? labels->FindObject(label) : nullptr;
+         if (!obj) return kFALSE;
+         coord = axis->GetBinCenter(obj->GetUniqueID());
+         return kTRUE;
+      }
+
+      /// Convert the arguments of Fill to coordinates and weight and fill the target.
+      template<class ...ARGS>
+      void FillAtomicArgs(ARGS... args)
+      {
+         static_assert(sizeof...(ARGS) >= 1 && sizeof...(ARGS) <= 4, "Fill takes one to four arguments");
+         HIST &hist = fManager->GetHist();
+         TAxis *axes[4] = { hist.GetXaxis(), hist.GetYaxis(), hist.GetZaxis(), nullptr };
+         Double_t c[4] = { 0, 0, 0, 0 };
+         Bool_t known = kTRUE;
+         Int_t iarg = 0;
+         Int_t expand[] = { (known &= ToCoordinate(axes[iarg], args, c[iarg]), ++iarg)... };
+         (void)expand;
+         if (!known) {
+            ++fEntries;
+            return;
+         }
+         switch (sizeof...(ARGS)) {
+            case 1: FillAtomic(c[0]); break;
+            case 2: FillAtomic(c[0], c[1]); break;
+            case 3: FillAtomic(c[0], c[1], c[2]); break;
+            default: FillAtomic(c[0], c[1], c[2], c[3]);
+         }
+      }
+
+      void FillAtomic(Double_t x)
+      {
+         HIST &hist = fManager->GetHist();
+         AddToTarget(hist.GetXaxis()->FindFixBin(x), 0, 0, x, 0, 0, 1);
+      }
+
+      /// Fill(x, w) of a 1D histogram or Fill(x, y) of a 2D histogram.
+      void FillAtomic(Double_t a, Double_t b)
+      {
+         HIST &hist = fManager->GetHist();
+         if (hist.GetDimension() == 1) {
+            AddToTarget(hist.GetXaxis()->FindFixBin(a), 0, 0, a, 0, 0, b);
+         } else {
+            AddToTarget(hist.GetXaxis()->FindFixBin(a), hist.GetYaxis()->FindFixBin(b), 0, a, b, 0, 1);
+         }
+      }
+
+      /// Fill(x, y, w) of a 2D histogram or Fill(x, y, z) of a 3D histogram.
+      void FillAtomic(Double_t a, Double_t b, Double_t c)
+      {
+         HIST &hist = fManager->GetHist();
+         Int_t binx = hist.GetXaxis()->FindFixBin(a);
+         Int_t biny = hist.GetYaxis()->FindFixBin(b);
+         if (hist.GetDimension() == 2) {
+            AddToTarget(binx, biny, 0, a, b, 0, c);
+         } else {
+            AddToTarget(binx, biny, hist.GetZaxis()->FindFixBin(c), a, b, c, 1);
+         }
+      }
+
+      /// Fill(x, y, z, w) of a 3D histogram.
+      void FillAtomic(Double_t x, Double_t y, Double_t z, Double_t w)
+      {
+         HIST &hist = fManager->GetHist();
+         AddToTarget(hist.GetXaxis()->FindFixBin(x), hist.GetYaxis()->FindFixBin(y),
+                     hist.GetZaxis()->FindFixBin(z), x, y, z, w);
+      }
+   };
+
+   /**
+    * \class ROOT::TH1ConcurrentFillManager
+    * \brief Allows several threads to fill the same histogram.
+    * \tparam HIST Concrete histogram class (e.g. TH1F, TH2D, TProfile)
+    * \ingroup Multicore
+    *
+    * TH1::Fill is not thread safe. The manager hands out one
+    * TH1ConcurrentFiller per thread; the fillers collect the entries without
+    * synchronisation and add them to the target histogram when they are
+    * flushed, under the lock of the manager:
+    * ~~~{.cpp}
+    * TH1F h("h", "h", 100, -4, 4);
+    * ROOT::TH1ConcurrentFillManager<TH1F> manager(h);
+    * auto work = [&](int seed) {
+    *    auto filler = manager.MakeFiller();
+    *    TRandom3 rndm(seed);
+    *    for (int i = 0; i < 1000000; ++i) filler.Fill(rndm.Gaus());
+    * }; // the filler is flushed when it goes out of scope
+    * ~~~
+    * Two strategies are available, see EConcurrentFillMode:
+    * - kSharded (the default) gives each filler a private copy of the
+    *   histogram: filling does not touch any shared memory, flushing costs
+    *   one TH1::Add. It supports all the histogram classes, including the
+    *   profiles and the histograms with extendable axes (merged with TH1::Merge).
+    * - kAtomic increments the bins of the target directly. It needs no extra
+    *   memory and the target is always up to date (except for the statistics),
+    *   which suits large histograms filled with little contention. It is
+    *   supported for TH1, TH2 and TH3 without extendable axes or buffer; the
+    *   profiles and the other cases use the sharded strategy. The storage of
+    *   the sum of squares of weights is switched on in advance, see TH1::Sumw2.
+    * The target must not be used by other means while fillers are active,
+    * except through Flush.
+    */
+   template<class HIST>
+   class TH1ConcurrentFillManager {
+   public:
+      TH1ConcurrentFillManager(HIST &hist, EConcurrentFillMode mode = EConcurrentFillMode::kSharded) :
+      fHist(hist), fMode(mode)
+      {
+         if (fMode == EConcurrentFillMode::kAtomic) {
+            if (fHist.InheritsFrom("TProfile") || fHist.InheritsFrom("TProfile2D") || fHist.InheritsFrom("TProfile3D")) {
+               Warning("TH1ConcurrentFillManager", "%s is a profile: using the sharded mode", fHist.GetName());
+               fMode = EConcurrentFillMode::kSharded;
+            } else if (CanExtend()) {
+               Warning("TH1ConcurrentFillManager", "%s has extendable axes: using the sharded mode", fHist.GetName());
+               fMode = EConcurrentFillMode::kSharded;
+            }
+         }
+         if (fMode == EConcurrentFillMode::kAtomic) {
+            fHist.BufferEmpty(1);
+            if (!fHist.GetSumw2N() && !fHist.TestBit(TH1::kIsNotW)) fHist.Sumw2();
+            fHist.GetStats(fStats);
+            fEntries = fHist.GetEntries();
+         }
+      }
+
+      /// Return a new filler, to be used by one thread.
+      TH1ConcurrentFiller<HIST> MakeFiller()
+      {
+         HIST *slab = nullptr;
+         if (fMode == EConcurrentFillMode::kSharded) {
+            std::lock_guard<std::mutex> lg(fFillMutex);
+            // do not register the slab in the current directory
+            TDirectory::TContext ctx(nullptr);
+            slab = static_cast<HIST*>(fHist.Clone());
+            slab->SetDirectory(nullptr);
+            slab->Reset();
+         }
+         return TH1ConcurrentFiller<HIST>(*this, slab);
+      }
+
+      /// Add the entries collected by filler to the target histogram.
+      void Flush(TH1ConcurrentFiller<HIST> &filler)
+      {
+         std::lock_guard<std::mutex> lg(fFillMutex);
+         if (filler.fSlab) {
+            HIST *slab = filler.fSlab.get();
+            if (slab->GetEntries() == 0) return;
+            if (CanExtend()) {
+               TList list;
+               list.Add(slab);
+               fHist.Merge(&list);
+            } else {
+               fHist.Add(slab);
+            }
+            slab->Reset();
+         } else {
+            if (filler.fEntries == 0) return;
+            for (Int_t i = 0; i < TH1::kNstat; ++i) fStats[i] += filler.fStats[i];
+            fEntries += filler.fEntries;
+            fHist.PutStats(fStats);
+            fHist.SetEntries(fEntries);
+            filler.ResetStats();
+         }
+      }
+
+      HIST &GetHist() { return fHist; }
+      EConcurrentFillMode GetMode() const { return fMode; }
+
+   private:
+      HIST &fHist;                   ///< The target histogram
+      EConcurrentFillMode fMode;     ///< The strategy used by the fillers
+      std::mutex fFillMutex;         ///< Serialises the flushes into fHist
+      Double_t fStats[TH1::kNstat];  ///< Statistics of fHist (atomic mode only)
+      Double_t fEntries = 0;         ///< Entries of fHist (atomic mode only)
+
+      Bool_t CanExtend()
+      {
+         return fHist.GetXaxis()->CanExtend() || fHist.GetYaxis()->CanExtend() || fHist.GetZaxis()->CanExtend();
+      }
+   };
+
+} // End ROOT namespace
+
+#endif
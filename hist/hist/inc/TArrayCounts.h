@@ -0,0 +1,98 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TArrayCounts
+#define ROOT_TArrayCounts
+
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TArrayCounts                                                         //
+//                                                                      //
+// Array of 16 bits counters promoted to double on overflow.            //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef ROOT_TArray
+#include "TArray.h"
+#endif
+
+#include <unordered_map>
+
+
+class TArrayCounts : public TArray {
+
+public:
+   enum {
+      kMaxCount = 0xFFFE,   // largest value stored in the compact array
+      kPromoted = 0xFFFF    // marks a bin whose value lives in fPromoted
+   };
+
+protected:
+   UShort_t   *fCounts;      //[fN] compact counters, 0 when the array is promoted
+   Double_t   *fValues;      //[fN] double values, 0 unless the whole array is promoted
+   std::unordered_map<Int_t, Double_t> fPromoted; //! values of individually promoted bins
+
+   void           PromoteAll();
+   void           PromoteBin(Int_t i, Double_t v);
+
+public:
+   TArrayCounts();
+   TArrayCounts(Int_t n);
+   TArrayCounts(const TArrayCounts &array);
+   TArrayCounts   &operator=(const TArrayCounts &rhs);
+   virtual        ~TArrayCounts();
+
+   Double_t       At(Int_t i) const;
+   Double_t       GetAt(Int_t i) const { return At(i); }
+   Int_t          GetNPromoted() const { return fValues ? fN : (Int_t)fPromoted.size(); }
+   Double_t       GetSum() const;
+   void           Increment(Int_t i);
+   void           Increment(Int_t i, Double_t w);
+   Bool_t         IsPromoted() const { return fValues != 0; }
+   void           Reset();
+   void           Set(Int_t n);
+   void           SetAt(Double_t v, Int_t i);
+
+   ClassDef(TArrayCounts,1)  //Array of 16 bits counters with overflow promotion
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the value of element i.
+
+inline Double_t TArrayCounts::At(Int_t i) const
+{
+   if (fValues) return fValues[i];
+   UShort_t c = fCounts[i];
+   if (c != kPromoted) return c;
+   return fPromoted.find(i)->second;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add 1 to element i.
+
+inline void TArrayCounts::Increment(Int_t i)
+{
+   if (fValues) { ++fValues[i]; return; }
+   if (fCounts[i] < kMaxCount) { ++fCounts[i]; return; }
+   SetAt(At(i) + 1, i);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add w to element i. Unit weights stay on the compact path.
+
+inline void TArrayCounts::Increment(Int_t i, Double_t w)
+{
+   if (fValues) { fValues[i] += w; return; }
+   if (w == 1 && fCounts[i] < kMaxCount) { ++fCounts[i]; return; }
+   SetAt(At(i) + w, i);
+}
+
+#endif
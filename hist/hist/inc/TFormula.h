@@ -28,6 +28,7 @@
 #include <vector>
 #include <list>
 #include <map>
+#include <atomic>
 
 class TFormulaFunction
 {
@@ -103,9 +104,14 @@ private:
 
    TInterpreter::CallFuncIFacePtr_t::Generic_t fFuncPtr;   //!  function pointer
    void *   fLambdaPtr;                                    //!  pointer to the lambda function
+   mutable std::atomic<TInterpreter::CallFuncIFacePtr_t::Generic_t> fVecFuncPtr[2]; //! functions evaluating arrays of points, with libm and with vdt
+   mutable std::atomic<Long64_t> fVecNPoints;                                          //! number of points evaluated by EvalParVec
+   mutable std::atomic<Bool_t> fVecFailed[2];                                          //! the array functions could not be built
 
    void     InputFormulaIntoCling();
    Bool_t   PrepareEvalMethod();
+   TInterpreter::CallFuncIFacePtr_t::Generic_t PrepareVecMethod(Bool_t fastMath) const;
+   void     ResetVecMethods() { fVecFuncPtr[0] = nullptr; fVecFuncPtr[1] = nullptr; fVecFailed[0] = kFALSE; fVecFailed[1] = kFALSE; fVecNPoints = 0; }
    void     FillDefaults();
    void     HandlePolN(TString &formula);
    void     HandleParametrizedFunctions(TString &formula);
@@ -169,6 +175,7 @@ public:
    Double_t       Eval(Double_t x, Double_t y , Double_t z) const;
    Double_t       Eval(Double_t x, Double_t y , Double_t z , Double_t t ) const;
    Double_t       EvalPar(const Double_t *x, const Double_t *params=0) const;
+   void           EvalParVec(Int_t n, const Double_t *x, Double_t *result, const Double_t *params=0, Int_t stride=0) const;
    TString        GetExpFormula(Option_t *option="") const;
    const TObject *GetLinearPart(Int_t i) const;
    Int_t          GetNdim() const {return fNdim;}
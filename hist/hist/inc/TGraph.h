@@ -47,9 +47,13 @@ class TH1F;
 class TCollection;
 class TF1;
 class TSpline;
+class TSpline3;
 
 #include "TFitResultPtr.h"
 
+#include <atomic>
+#include <vector>
+
 class TGraph : public TNamed, public TAttLine, public TAttFill, public TAttMarker {
 
 protected:
@@ -62,6 +66,9 @@ protected:
    TH1F              *fHistogram; //Pointer to histogram used for drawing axis
    Double_t           fMinimum;   //Minimum value for plotting along y
    Double_t           fMaximum;   //Maximum value for plotting along y
+   mutable std::vector<Int_t> fEvalIndex;  //!Indices of the points sorted in x, used by Eval
+   mutable std::atomic<Bool_t> fEvalIndexValid; //!True when fEvalIndex is up to date
+   mutable std::atomic<TSpline3*> fEvalSpline; //!Spline through the points, used by Eval with option "S"
 
    static void        SwapValues(Double_t* arr, Int_t pos1, Int_t pos2);
    virtual void       SwapPoints(Int_t pos1, Int_t pos2);
@@ -75,6 +82,8 @@ protected:
    virtual void       FillZero(Int_t begin, Int_t end, Bool_t from_ctor = kTRUE);
    Double_t         **ShrinkAndCopy(Int_t size, Int_t iend);
    virtual Bool_t     DoMerge(const TGraph * g);
+   const std::vector<Int_t> &GetEvalIndex() const;
+   TSpline3          *GetEvalSpline() const;
 
 public:
    // TGraph status bits
@@ -113,6 +122,7 @@ public:
    virtual void          DrawGraph(Int_t n, const Double_t *x=0, const Double_t *y=0, Option_t *option="");
    virtual void          DrawPanel(); // *MENU*
    virtual Double_t      Eval(Double_t x, TSpline *spline=0, Option_t *option="") const;
+   void                  Eval(Int_t n, const Double_t *x, Double_t *y, Option_t *option="") const;
    virtual void          ExecuteEvent(Int_t event, Int_t px, Int_t py);
    virtual void          Expand(Int_t newsize);
    virtual void          Expand(Int_t newsize, Int_t step);
@@ -171,6 +181,7 @@ public:
    virtual void          PaintStats(TF1 *fit);
    virtual void          Print(Option_t *chopt="") const;
    virtual void          RecursiveRemove(TObject *obj);
+   void                  ResetEvalCache();
    virtual Int_t         RemovePoint(); // *MENU*
    virtual Int_t         RemovePoint(Int_t ipoint);
    virtual void          SavePrimitive(std::ostream &out, Option_t *option = "");
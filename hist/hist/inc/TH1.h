@@ -52,6 +52,9 @@
 #ifndef ROOT_TArrayD
 #include "TArrayD.h"
 #endif
+#ifndef ROOT_TArrayCounts
+#include "TArrayCounts.h"
+#endif
 #include "Foption.h"
 
 #ifndef ROOT_TVectorFfwd
@@ -153,7 +156,9 @@ protected:
    virtual Double_t DoIntegral(Int_t ix1, Int_t ix2, Int_t iy1, Int_t iy2, Int_t iz1, Int_t iz2, Double_t & err,
                                Option_t * opt, Bool_t doerr = kFALSE) const;
 
+   virtual void     DoAddBinContents(Int_t n, const Int_t *bins, const Double_t *w, Int_t stride=1);
    virtual void     DoFillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride=1);
+   Bool_t           MergeSameBinning(TCollection *li, Double_t &nentries);
 
    static bool CheckAxisLimits(const TAxis* a1, const TAxis* a2);
    static bool CheckBinLimits(const TAxis* a1, const TAxis* a2);
@@ -307,6 +312,7 @@ public:
    virtual Int_t    GetQuantiles(Int_t nprobSum, Double_t *q, const Double_t *probSum=0);
    virtual Double_t GetRandom() const;
    virtual void     GetStats(Double_t *stats) const;
+   static  Bool_t   GetStatOverflows();
    virtual Double_t GetStdDev(Int_t axis=1) const;
    virtual Double_t GetStdDevError(Int_t axis=1) const;
    virtual Double_t GetSumOfWeights() const;
@@ -597,6 +603,7 @@ public:
    friend  TH1F     operator/(const TH1F &h1, const TH1F &h2);
 
 protected:
+   virtual void     DoAddBinContents(Int_t n, const Int_t *bins, const Double_t *w, Int_t stride=1);
    virtual Double_t RetrieveBinContent(Int_t bin) const { return Double_t (fArray[bin]); }
    virtual void     UpdateBinContent(Int_t bin, Double_t content) { fArray[bin] = Float_t (content); }
 };
@@ -640,6 +647,7 @@ public:
    friend  TH1D     operator/(const TH1D &h1, const TH1D &h2);
 
 protected:
+   virtual void     DoAddBinContents(Int_t n, const Int_t *bins, const Double_t *w, Int_t stride=1);
    virtual Double_t RetrieveBinContent(Int_t bin) const { return fArray[bin]; }
    virtual void     UpdateBinContent(Int_t bin, Double_t content) { fArray[bin] = content; }
 };
@@ -652,6 +660,48 @@ TH1D operator-(const TH1D &h1, const TH1D &h2);
 TH1D operator*(const TH1D &h1, const TH1D &h2);
 TH1D operator/(const TH1D &h1, const TH1D &h2);
 
+//________________________________________________________________________
+
+class TH1U : public TH1, public TArrayCounts {
+
+public:
+   TH1U();
+   TH1U(const char *name,const char *title,Int_t nbinsx,Double_t xlow,Double_t xup);
+   TH1U(const char *name,const char *title,Int_t nbinsx,const Float_t  *xbins);
+   TH1U(const char *name,const char *title,Int_t nbinsx,const Double_t *xbins);
+   TH1U(const TH1U &h1u);
+   TH1U& operator=(const TH1U &h1);
+   virtual ~TH1U();
+
+   virtual void     AddBinContent(Int_t bin) {Increment(bin);}
+   virtual void     AddBinContent(Int_t bin, Double_t w) {Increment(bin, w);}
+   virtual void     Copy(TObject &hnew) const;
+   virtual void     Reset(Option_t *option="");
+   virtual void     SetBinsLength(Int_t n=-1);
+
+   ClassDef(TH1U,1)  //1-Dim histograms (one 16 bits counter per channel, promoted on overflow)
+
+   friend  TH1U     operator*(Double_t c1, const TH1U &h1);
+   friend  TH1U     operator*(const TH1U &h1, Double_t c1);
+   friend  TH1U     operator+(const TH1U &h1, const TH1U &h2);
+   friend  TH1U     operator-(const TH1U &h1, const TH1U &h2);
+   friend  TH1U     operator*(const TH1U &h1, const TH1U &h2);
+   friend  TH1U     operator/(const TH1U &h1, const TH1U &h2);
+
+protected:
+   virtual void     DoAddBinContents(Int_t n, const Int_t *bins, const Double_t *w, Int_t stride=1);
+   virtual Double_t RetrieveBinContent(Int_t bin) const { return At(bin); }
+   virtual void     UpdateBinContent(Int_t bin, Double_t content) { SetAt(content, bin); }
+};
+
+TH1U operator*(Double_t c1, const TH1U &h1);
+inline
+TH1U operator*(const TH1U &h1, Double_t c1) {return operator*(c1,h1);}
+TH1U operator+(const TH1U &h1, const TH1U &h2);
+TH1U operator-(const TH1U &h1, const TH1U &h2);
+TH1U operator*(const TH1U &h1, const TH1U &h2);
+TH1U operator/(const TH1U &h1, const TH1U &h2);
+
    extern TH1 *R__H(Int_t hid);
    extern TH1 *R__H(const char *hname);
 
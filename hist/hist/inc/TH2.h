@@ -287,6 +287,7 @@ public:
 protected:
    virtual Double_t RetrieveBinContent(Int_t bin) const { return Double_t (fArray[bin]); }
    virtual void     UpdateBinContent(Int_t bin, Double_t content) { fArray[bin] = Float_t (content); }
+   virtual void     DoAddBinContents(Int_t n, const Int_t *bins, const Double_t *w, Int_t stride=1);
 
    ClassDef(TH2F,3)  //2-Dim histograms (one float per channel)
 };
@@ -328,9 +329,49 @@ public:
 protected:
    virtual Double_t RetrieveBinContent(Int_t bin) const { return fArray[bin]; }
    virtual void     UpdateBinContent(Int_t bin, Double_t content) { fArray[bin] = content; }
+   virtual void     DoAddBinContents(Int_t n, const Int_t *bins, const Double_t *w, Int_t stride=1);
 
    ClassDef(TH2D,3)  //2-Dim histograms (one double per channel)
 };
 
-#endif
 
+//________________________________________________________________________
+
+class TH2U : public TH2, public TArrayCounts {
+
+public:
+   TH2U();
+   TH2U(const char *name,const char *title,Int_t nbinsx,Double_t xlow,Double_t xup
+                                          ,Int_t nbinsy,Double_t ylow,Double_t yup);
+   TH2U(const char *name,const char *title,Int_t nbinsx,const Double_t *xbins
+                                          ,Int_t nbinsy,Double_t ylow,Double_t yup);
+   TH2U(const char *name,const char *title,Int_t nbinsx,Double_t xlow,Double_t xup
+                                          ,Int_t nbinsy,const Double_t *ybins);
+   TH2U(const char *name,const char *title,Int_t nbinsx,const Double_t *xbins
+                                          ,Int_t nbinsy,const Double_t *ybins);
+   TH2U(const char *name,const char *title,Int_t nbinsx,const Float_t  *xbins
+                                          ,Int_t nbinsy,const Float_t  *ybins);
+   TH2U(const TH2U &h2u);
+   virtual ~TH2U();
+   virtual void     AddBinContent(Int_t bin) {Increment(bin);}
+   virtual void     AddBinContent(Int_t bin, Double_t w) {Increment(bin, w);}
+   virtual void     Copy(TObject &hnew) const;
+   virtual void     Reset(Option_t *option="");
+   virtual void     SetBinsLength(Int_t n=-1);
+           TH2U&    operator=(const TH2U &h1);
+   friend  TH2U     operator*(Float_t c1, TH2U &h1);
+   friend  TH2U     operator*(TH2U &h1, Float_t c1) {return operator*(c1,h1);}
+   friend  TH2U     operator+(TH2U &h1, TH2U &h2);
+   friend  TH2U     operator-(TH2U &h1, TH2U &h2);
+   friend  TH2U     operator*(TH2U &h1, TH2U &h2);
+   friend  TH2U     operator/(TH2U &h1, TH2U &h2);
+
+protected:
+   virtual void     DoAddBinContents(Int_t n, const Int_t *bins, const Double_t *w, Int_t stride=1);
+   virtual Double_t RetrieveBinContent(Int_t bin) const { return At(bin); }
+   virtual void     UpdateBinContent(Int_t bin, Double_t content) { SetAt(content, bin); }
+
+   ClassDef(TH2U,1)  //2-Dim histograms (one 16 bits counter per channel, promoted on overflow)
+};
+
+#endif
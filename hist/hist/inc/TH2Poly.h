@@ -24,6 +24,8 @@
 #include "TH2.h"
 #endif
 
+#include <vector>
+
 class TH2PolyBin: public TObject{
 
 public:
@@ -92,6 +94,7 @@ public:
    Int_t        Fill(const char *, const char *, Double_t ){return -1;} //MayNotUse
    void         FillN(Int_t, const Double_t*, const Double_t*, Int_t){return;}  //MayNotUse
    Int_t        FindBin(Double_t x, Double_t y, Double_t z = 0);
+   void         FindBins(Int_t n, const Double_t *x, const Double_t *y, Int_t *bins, Int_t stride = 1);
    TList       *GetBins(){return fBins;}                                // Returns the TList of all bins in the histogram
    Double_t     GetBinContent(Int_t bin) const;
    Double_t     GetBinContent(Int_t, Int_t) const {return 0;}           //MayNotUse
@@ -138,8 +141,18 @@ protected:
    Bool_t   fFloat;             //When set to kTRUE, allows the histogram to expand if a bin outside the limits is added.
    Bool_t   fNewBinAdded;       //!For the 3D Painter
    Bool_t   fBinContentChanged; //!For the 3D Painter
+   Bool_t   fIndexValid;        //!True if the spatial index below describes the current bins
+   Double_t fIndexLimits[4];    //!Area covered by the spatial index: xmin, xmax, ymin, ymax
+   std::vector<TH2PolyBin*> fIndexBins;   //!Bins, indexed by bin number - 1
+   std::vector<Double_t>    fIndexBoxes;  //!Bounding box of each bin: xmin, xmax, ymin, ymax
+   std::vector<Int_t>       fIndexNodes;  //!Quadtree nodes: first child (-1 for leaves), begin and end of the leaf in fIndexLeaves
+   std::vector<Int_t>       fIndexLeaves; //!Bin numbers - 1 of the bins overlapping each leaf, in increasing order
 
    void   AddBinToPartition(TH2PolyBin *bin);  // Adds the input bin into the partition matrix
+   void   BuildIndex();                        // Builds the quadtree used by FindBin()
+   void   BuildIndexNode(Int_t node, const std::vector<Int_t> &bins, Double_t xmin, Double_t xmax, Double_t ymin, Double_t ymax, Int_t depth);
+   Int_t  FillBin(Int_t bin, Double_t x, Double_t y, Double_t w);
+   Int_t  FindBinInIndex(Double_t x, Double_t y);
    void   Initialize(Double_t xlow, Double_t xup, Double_t ylow, Double_t yup, Int_t n, Int_t m);
    Bool_t IsIntersecting(TH2PolyBin *bin, Double_t xclipl, Double_t xclipr, Double_t yclipb, Double_t yclipt);
    Bool_t IsIntersectingPolygon(Int_t bn, Double_t *x, Double_t *y, Double_t xclipl, Double_t xclipr, Double_t yclipb, Double_t yclipt);
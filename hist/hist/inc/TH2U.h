@@ -0,0 +1,28 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TH2U
+#define ROOT_TH2U
+
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TH2U                                                                 //
+//                                                                      //
+// 2-Dim histogram with a 16 bits counter per channel,                  //
+// promoted to double on overflow                                       //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef ROOT_TH2
+#include "TH2.h"
+#endif
+
+#endif
@@ -85,6 +85,9 @@ public:
    virtual Int_t    Fill(Double_t x, const char *namey, Double_t z, Double_t w);
    virtual Int_t    Fill(Double_t x, Double_t y, const char *namez, Double_t w);
 
+   virtual void     FillN(Int_t, const Double_t *, const Double_t *, Int_t) {;} //MayNotUse
+   virtual void     FillN(Int_t, const Double_t *, const Double_t *, const Double_t *, Int_t) {;} //MayNotUse
+   virtual void     FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *z, const Double_t *w, Int_t stride=1);
    virtual void     FillRandom(const char *fname, Int_t ntimes=5000);
    virtual void     FillRandom(TH1 *h, Int_t ntimes=5000);
    virtual Int_t    FindFirstBinAbove(Double_t threshold=0, Int_t axis=1) const;
@@ -300,6 +303,7 @@ public:
 protected:
    virtual Double_t RetrieveBinContent(Int_t bin) const { return Double_t (fArray[bin]); }
    virtual void     UpdateBinContent(Int_t bin, Double_t content) { fArray[bin] = Float_t (content); }
+   virtual void     DoAddBinContents(Int_t n, const Int_t *bins, const Double_t *w, Int_t stride=1);
 
    ClassDef(TH3F,3)  //3-Dim histograms (one float per channel)
 };
@@ -337,9 +341,47 @@ public:
 protected:
    virtual Double_t RetrieveBinContent(Int_t bin) const { return fArray[bin]; }
    virtual void     UpdateBinContent(Int_t bin, Double_t content) { fArray[bin] = content; }
+   virtual void     DoAddBinContents(Int_t n, const Int_t *bins, const Double_t *w, Int_t stride=1);
 
    ClassDef(TH3D,3)  //3-Dim histograms (one double per channel)
 };
 
-#endif
 
+//________________________________________________________________________
+
+class TH3U : public TH3, public TArrayCounts {
+public:
+   TH3U();
+   TH3U(const char *name,const char *title,Int_t nbinsx,Double_t xlow,Double_t xup
+                                  ,Int_t nbinsy,Double_t ylow,Double_t yup
+                                  ,Int_t nbinsz,Double_t zlow,Double_t zup);
+   TH3U(const char *name,const char *title,Int_t nbinsx,const Float_t *xbins
+                                          ,Int_t nbinsy,const Float_t *ybins
+                                          ,Int_t nbinsz,const Float_t *zbins);
+   TH3U(const char *name,const char *title,Int_t nbinsx,const Double_t *xbins
+                                          ,Int_t nbinsy,const Double_t *ybins
+                                          ,Int_t nbinsz,const Double_t *zbins);
+   TH3U(const TH3U &h3u);
+   virtual ~TH3U();
+   virtual void      AddBinContent(Int_t bin) {Increment(bin);}
+   virtual void      AddBinContent(Int_t bin, Double_t w) {Increment(bin, w);}
+   virtual void      Copy(TObject &hnew) const;
+   virtual void      Reset(Option_t *option="");
+   virtual void      SetBinsLength(Int_t n=-1);
+           TH3U&     operator=(const TH3U &h1);
+   friend  TH3U      operator*(Float_t c1, TH3U &h1);
+   friend  TH3U      operator*(TH3U &h1, Float_t c1) {return operator*(c1,h1);}
+   friend  TH3U      operator+(TH3U &h1, TH3U &h2);
+   friend  TH3U      operator-(TH3U &h1, TH3U &h2);
+   friend  TH3U      operator*(TH3U &h1, TH3U &h2);
+   friend  TH3U      operator/(TH3U &h1, TH3U &h2);
+
+protected:
+   virtual void     DoAddBinContents(Int_t n, const Int_t *bins, const Double_t *w, Int_t stride=1);
+   virtual Double_t RetrieveBinContent(Int_t bin) const { return At(bin); }
+   virtual void     UpdateBinContent(Int_t bin, Double_t content) { SetAt(content, bin); }
+
+   ClassDef(TH3U,1)  //3-Dim histograms (one 16 bits counter per channel, promoted on overflow)
+};
+
+#endif
@@ -0,0 +1,28 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TH3U
+#define ROOT_TH3U
+
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TH3U                                                                 //
+//                                                                      //
+// 3-Dim histogram with a 16 bits counter per channel,                  //
+// promoted to double on overflow                                       //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef ROOT_TH3
+#include "TH3.h"
+#endif
+
+#endif
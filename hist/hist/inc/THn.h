@@ -53,6 +53,7 @@ private:
 protected:
    void AllocCoordBuf() const;
    void InitStorage(Int_t* nbins, Int_t chunkSize);
+   Bool_t AddSameBinning(const THnBase* h, Double_t c);
 
    THn(): fCoordBuf() {}
    THn(const char* name, const char* title, Int_t dim, const Int_t* nbins,
@@ -116,6 +116,11 @@ private:
                           Bool_t wantNDim, Option_t* option = "") const;
    Bool_t PrintBin(Long64_t idx, Int_t* coord, Option_t* options) const;
    void AddInternal(const THnBase* h, Double_t c, Bool_t rebinned);
+   virtual Bool_t AddSameBinning(const THnBase* /*h*/, Double_t /*c*/) {
+      // Add c * h, binned identically to this, without going through the
+      // bin coordinates; return kFALSE if the storage has no such shortcut.
+      return kFALSE;
+   }
    THnBase* RebinBase(Int_t group) const;
    THnBase* RebinBase(const Int_t* group) const;
    void ResetBase(Option_t *option= "");
@@ -162,6 +167,8 @@ private:
       return bin;
    }
 
+   virtual void FillN(Long64_t n, const Double_t* x, const Double_t* w = 0);
+
    virtual void FillBin(Long64_t bin, Double_t w) = 0;
 
    void SetBinEdges(Int_t idim, const Double_t* bins);
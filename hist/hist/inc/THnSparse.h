@@ -23,9 +23,6 @@
 #ifndef ROOT_THnBase
 #include "THnBase.h"
 #endif
-#ifndef ROOT_TExMap
-#include "TExMap.h"
-#endif
 #ifndef ROOT_THnSparse_Internal
 #include "THnSparse_Internal.h"
 #endif
@@ -47,6 +44,8 @@
 #include "TArrayC.h"
 #endif
 
+#include <vector>
+
 class THnSparseCompactBinCoord;
 
 class THnSparse: public THnBase {
@@ -54,13 +53,22 @@ class THnSparse: public THnBase {
    Int_t      fChunkSize;    // number of entries for each chunk
    Long64_t   fFilledBins;   // number of filled bins
    TObjArray  fBinContent;   // array of THnSparseArrayChunk
-   TExMap     fBins;         //! filled bins
-   TExMap     fBinsContinued;//! filled bins for non-unique hashes, containing pairs of (bin index 0, bin index 1)
+   std::vector<Long64_t> fBinTable; //! open-addressing table of (hash, bin index + 1) pairs; 0 as bin index + 1 marks an empty slot
+   Int_t      fBinTableBits; //! log2 of the number of slots in fBinTable
    THnSparseCompactBinCoord *fCompactCoord; //! compact coordinate
 
    THnSparse(const THnSparse&); // Not implemented
    THnSparse& operator=(const THnSparse&); // Not implemented
 
+   ULong64_t GetBinTableSlot(ULong64_t hash) const {
+      // Slot where the search for "hash" starts: Fibonacci hashing, such
+      // that the perfect hashes of small compact coordinates are spread
+      // over the whole table.
+      return (hash * 0x9E3779B97F4A7C15ULL) >> (64 - fBinTableBits);
+   }
+   void AddToBinTable(ULong64_t hash, Long64_t idx);
+   void ReserveBinTable(Long64_t nbins);
+
  protected:
 
    THnSparse();
@@ -73,7 +81,8 @@ class THnSparse: public THnBase {
 
    THnSparseArrayChunk* AddChunk();
    void Reserve(Long64_t nbins);
-   void FillExMap();
+   void FillBinTable();
+   Bool_t AddSameBinning(const THnBase* h, Double_t c);
    virtual TArray* GenerateArray() const = 0;
    Long64_t GetBinIndexForCurrentBin(Bool_t allocate);
    void FillBin(Long64_t bin, Double_t w) {
@@ -114,6 +123,8 @@ class THnSparse: public THnBase {
    Long64_t GetBin(const Double_t* x, Bool_t allocate = kTRUE);
    Long64_t GetBin(const char* name[], Bool_t allocate = kTRUE);
 
+   void FillN(Long64_t n, const Double_t* x, const Double_t* w = 0);
+
    void SetBinContent(const Int_t* idx, Double_t v) {
       // Forwards to THnBase::SetBinContent().
       // Non-virtual, CINT-compatible replacement of a using declaration.
@@ -69,6 +69,12 @@ public:
       kForcedBinning
    };
 
+   enum EEvaluation { // Evaluation option of the density estimate
+      kExactEvaluation,     // Sum the kernel over all data points
+      kTruncatedEvaluation, // Sum the kernel over the sorted data points within the kernel support truncated at the tolerance
+      kBinnedEvaluation     // Sum the kernel once on a regular grid (FFT convolution for a fixed bandwidth) and interpolate linearly
+   };
+
    explicit TKDE(UInt_t events = 0, const Double_t* data = 0, Double_t xMin = 0.0, Double_t xMax = 0.0, const Option_t* option =
                  "KernelType:Gaussian;Iteration:Adaptive;Mirror:noMirror;Binning:RelaxedBinning", Double_t rho = 1.0) {
       Instantiate( nullptr,  events, data, nullptr, xMin, xMax, option, rho);
@@ -100,6 +106,7 @@ public:
    void SetUseBinsNEvents(UInt_t nEvents);
    void SetTuneFactor(Double_t rho);
    void SetRange(Double_t xMin, Double_t xMax); // By default computed from the data
+   void SetEvaluation(EEvaluation eval, Double_t tolerance = 1.E-6, UInt_t npoints = 0);
 
    virtual void Draw(const Option_t* option = "");
 
@@ -107,6 +114,7 @@ public:
    Double_t operator()(const Double_t* x, const Double_t* p=0) const;  // Needed for creating TF1
 
    Double_t GetValue(Double_t x) const { return (*this)(x); }
+   void GetValues(UInt_t n, const Double_t* x, Double_t* y) const;
    Double_t GetError(Double_t x) const;
 
    Double_t GetBias(Double_t x) const;
@@ -159,6 +167,7 @@ private:
    EIteration fIteration;
    EMirror fMirror;
    EBinning fBinning;
+   EEvaluation fEvaluation;
 
    Bool_t fUseMirroring, fMirrorLeft, fMirrorRight, fAsymLeft, fAsymRight;
    Bool_t fUseBins;
@@ -169,6 +178,9 @@ private:
    UInt_t fNEvents;        // Data's number of events
    Double_t fSumOfCounts; // Data sum of weights
    UInt_t fUseBinsNEvents; // If the algorithm is allowed to use binning this is the minimum number of events to do so
+   UInt_t fEvaluationNPoints; // Number of grid points for the binned evaluation, 0 to derive it from the bandwidths
+
+   Double_t fEvaluationTolerance; // Kernel value, relative to its maximum, below which the approximate evaluations neglect contributions
 
    Double_t fMean;  // Data mean
    Double_t fSigma; // Data std deviation
@@ -252,7 +264,7 @@ private:
    TF1* GetPDFUpperConfidenceInterval(Double_t confidenceLevel = 0.95, UInt_t npx = 100, Double_t xMin = 1.0, Double_t xMax = 0.0);
    TF1* GetPDFLowerConfidenceInterval(Double_t confidenceLevel = 0.95, UInt_t npx = 100, Double_t xMin = 1.0, Double_t xMax = 0.0);
 
-   ClassDef(TKDE, 2) // One dimensional semi-parametric Kernel Density Estimation
+   ClassDef(TKDE, 3) // One dimensional semi-parametric Kernel Density Estimation
 
 };
 
@@ -0,0 +1,254 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class TArrayCounts
+\ingroup Hist
+Array of 16 bits counters promoted to double on overflow.
+
+Elements holding an integer between 0 and kMaxCount (65534) are stored in
+two bytes. An element that overflows, becomes negative or receives a
+non-integer value is promoted individually: its compact slot is marked
+with kPromoted and its value is kept as a double on the side. When more
+than 1/16 of the elements are promoted the whole array switches to
+doubles. No precision is lost in either case; the compact form only
+changes the memory footprint, which is 4 times smaller than an array of
+doubles for typical occupancy maps filled with unit weights.
+
+Reset() brings the array back to its compact form.
+*/
+
+#include "TArrayCounts.h"
+#include "TBuffer.h"
+#include "TMath.h"
+
+
+ClassImp(TArrayCounts)
+
+////////////////////////////////////////////////////////////////////////////////
+/// Default TArrayCounts ctor.
+
+TArrayCounts::TArrayCounts() : fCounts(0), fValues(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create TArrayCounts object and set array size to n counters.
+
+TArrayCounts::TArrayCounts(Int_t n) : fCounts(0), fValues(0)
+{
+   if (n > 0) Set(n);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy constructor.
+
+TArrayCounts::TArrayCounts(const TArrayCounts &array) : TArray(), fCounts(0), fValues(0)
+{
+   *this = array;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// TArrayCounts assignment operator.
+
+TArrayCounts &TArrayCounts::operator=(const TArrayCounts &rhs)
+{
+   if (this == &rhs) return *this;
+   delete [] fCounts;
+   delete [] fValues;
+   fCounts = 0;
+   fValues = 0;
+   fN = rhs.fN;
+   fPromoted = rhs.fPromoted;
+   if (fN <= 0) return *this;
+   if (rhs.fValues) {
+      fValues = new Double_t[fN];
+      memcpy(fValues, rhs.fValues, fN*sizeof(Double_t));
+   } else {
+      fCounts = new UShort_t[fN];
+      memcpy(fCounts, rhs.fCounts, fN*sizeof(UShort_t));
+   }
+   return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Delete TArrayCounts object.
+
+TArrayCounts::~TArrayCounts()
+{
+   delete [] fCounts;
+   delete [] fValues;
+   fCounts = 0;
+   fValues = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the sum of all elements.
+
+Double_t TArrayCounts::GetSum() const
+{
+   Double_t sum = 0;
+   if (fValues) {
+      for (Int_t i = 0; i < fN; ++i) sum += fValues[i];
+      return sum;
+   }
+   for (Int_t i = 0; i < fN; ++i) {
+      if (fCounts[i] != kPromoted) sum += fCounts[i];
+   }
+   for (auto &p : fPromoted) sum += p.second;
+   return sum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Switch the whole array to doubles.
+
+void TArrayCounts::PromoteAll()
+{
+   if (fValues) return;
+   if (fN > 0) {
+      fValues = new Double_t[fN];
+      for (Int_t i = 0; i < fN; ++i) fValues[i] = At(i);
+   }
+   delete [] fCounts;
+   fCounts = 0;
+   fPromoted.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Store v as the double value of element i, promoting the whole array
+/// once too many elements do not fit in the compact form.
+
+void TArrayCounts::PromoteBin(Int_t i, Double_t v)
+{
+   fCounts[i] = kPromoted;
+   fPromoted[i] = v;
+   if (fPromoted.size() > (size_t)fN/16) PromoteAll();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set all elements to 0 and go back to the compact form.
+
+void TArrayCounts::Reset()
+{
+   fPromoted.clear();
+   if (fValues) {
+      delete [] fValues;
+      fValues = 0;
+      if (fN > 0) fCounts = new UShort_t[fN];
+   }
+   if (fCounts) memset(fCounts, 0, fN*sizeof(UShort_t));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set size of this array to n counters.
+/// A new array is created, the old contents copied to the new array,
+/// then the old array is deleted.
+
+void TArrayCounts::Set(Int_t n)
+{
+   if (n < 0) return;
+   if (n == fN && (fCounts || fValues)) return;
+   Int_t ncopy = TMath::Min(n, fN);
+   if (fValues) {
+      Double_t *temp = fValues;
+      fValues = 0;
+      if (n > 0) {
+         fValues = new Double_t[n];
+         memcpy(fValues, temp, ncopy*sizeof(Double_t));
+         memset(&fValues[ncopy], 0, (n-ncopy)*sizeof(Double_t));
+      }
+      delete [] temp;
+   } else {
+      UShort_t *temp = fCounts;
+      fCounts = 0;
+      if (n > 0) {
+         fCounts = new UShort_t[n];
+         if (ncopy > 0) memcpy(fCounts, temp, ncopy*sizeof(UShort_t));
+         memset(&fCounts[ncopy], 0, (n-ncopy)*sizeof(UShort_t));
+      }
+      delete [] temp;
+      for (auto it = fPromoted.begin(); it != fPromoted.end();) {
+         if (it->first >= n) it = fPromoted.erase(it);
+         else ++it;
+      }
+   }
+   fN = n;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set element i to v. Values that are not integers between 0 and kMaxCount
+/// promote the element to double.
+
+void TArrayCounts::SetAt(Double_t v, Int_t i)
+{
+   if (!BoundsOk("TArrayCounts::SetAt", i)) return;
+   if (fValues) {
+      fValues[i] = v;
+      return;
+   }
+   if (v >= 0 && v <= kMaxCount && v == (UShort_t)v) {
+      if (fCounts[i] == kPromoted) fPromoted.erase(i);
+      fCounts[i] = (UShort_t)v;
+   } else if (fCounts[i] == kPromoted) {
+      fPromoted[i] = v;
+   } else {
+      PromoteBin(i, v);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Stream a TArrayCounts object. The compact counters are written together
+/// with the promoted elements, or the doubles if the whole array was promoted.
+
+void TArrayCounts::Streamer(TBuffer &b)
+{
+   if (b.IsReading()) {
+      Int_t n;
+      Char_t promoted;
+      b >> n;
+      b >> promoted;
+      delete [] fCounts;
+      delete [] fValues;
+      fCounts = 0;
+      fValues = 0;
+      fPromoted.clear();
+      fN = n;
+      if (promoted) {
+         fValues = new Double_t[n > 0 ? n : 1];
+         b.ReadFastArray(fValues, n);
+      } else {
+         fCounts = new UShort_t[n > 0 ? n : 1];
+         b.ReadFastArray(fCounts, n);
+         Int_t npromoted;
+         b >> npromoted;
+         for (Int_t k = 0; k < npromoted; ++k) {
+            Int_t i;
+            Double_t v;
+            b >> i;
+            b >> v;
+            fPromoted[i] = v;
+         }
+      }
+   } else {
+      b << fN;
+      Char_t promoted = fValues ? 1 : 0;
+      b << promoted;
+      if (promoted) {
+         b.WriteFastArray(fValues, fN);
+      } else {
+         b.WriteFastArray(fCounts, fN);
+         Int_t npromoted = fPromoted.size();
+         b << npromoted;
+         for (auto &p : fPromoted) {
+            b << p.first;
+            b << p.second;
+         }
+      }
+   }
+}
@@ -405,6 +405,62 @@ Int_t TAxis::FindFixBin(Double_t x) const
    return bin;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Find the bin numbers corresponding to n abscissas x[0], x[stride], ...
+/// and store them in bins[0..n-1].
+///
+/// The result is the same as calling FindFixBin for each value, but the
+/// loops have no data dependent branches: for fix bins the bin number is
+/// computed arithmetically and the loop can be vectorized by the compiler,
+/// for variable bins a branchless binary search is run on a block of
+/// values at a time.
+
+void TAxis::FindFixBins(Int_t n, const Double_t *x, Int_t *bins, Int_t stride) const
+{
+   const Double_t xmin = fXmin;
+   const Double_t xmax = fXmax;
+   const Int_t overflow = fNbins+1;
+   if (!fXbins.fN) {        //*-* fix bins
+      const Double_t nbins = fNbins;
+      const Double_t width = fXmax-fXmin;
+      for (Int_t i = 0; i < n; ++i) {
+         const Double_t xi = x[i*stride];
+         // keep the value inside the axis (and not NaN) before converting to int
+         Double_t xc = (xi < xmin) ? xmin : xi;
+         xc = (xc < xmax) ? xc : xmin;
+         Int_t bin = 1 + int (nbins*(xc-xmin)/width);
+         bin = (xi < xmin) ? 0 : bin;
+         bins[i] = (xi < xmax) ? bin : overflow;  // note the way to catch NaN
+      }
+      return;
+   }
+   //*-* variable bin sizes: for each value find the last edge <= x, as TMath::BinarySearch
+   const Double_t *edges = fXbins.fArray;
+   const Int_t nedges = fXbins.fN;
+   const Int_t kBlock = 16;
+   Int_t pos[kBlock];
+   Double_t xb[kBlock];
+   for (Int_t first = 0; first < n; first += kBlock) {
+      const Int_t nb = TMath::Min(kBlock, n-first);
+      for (Int_t j = 0; j < nb; ++j) {
+         xb[j] = x[(first+j)*stride];
+         pos[j] = 0;
+      }
+      for (Int_t len = nedges; len > 1; ) {
+         const Int_t half = len/2;
+         for (Int_t j = 0; j < nb; ++j) {
+            pos[j] += (edges[pos[j]+half] <= xb[j]) ? half : 0;
+         }
+         len -= half;
+      }
+      for (Int_t j = 0; j < nb; ++j) {
+         Int_t bin = 1 + pos[j];
+         bin = (xb[j] < xmin) ? 0 : bin;
+         bins[first+j] = (xb[j] < xmax) ? bin : overflow;
+      }
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return label for bin
 
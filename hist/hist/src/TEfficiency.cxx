@@ -1641,6 +1641,8 @@ void TEfficiency::FillGraph(TGraphAsymmErrors * graph, Option_t * opt) const
 
    // tell the graph the effective number of points
    graph->Set(j);
+   // the points were written directly in the arrays of the graph
+   graph->ResetEvalCache();
    //refresh title before painting if changed
    TString oldTitle = graph->GetTitle();
    TString newTitle = GetTitle();
@@ -1257,6 +1257,38 @@ Double_t TF1::EvalPar(const Double_t *x, const Double_t *params)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate function at n points with given parameters.
+///
+/// The coordinates of point i start at x[i*stride] and its value is stored
+/// in result[i]. A stride of 0 means that the points are packed, i.e.
+/// stride = GetNdim(). If params is omitted or equal 0, the internal values
+/// of parameters (array fParams) are used instead.
+/// Functions defined by a formula are evaluated by a single call to a
+/// compiled loop (see TFormula::EvalParVec), the other functions are
+/// evaluated point by point with EvalPar.
+
+void TF1::EvalParVec(Int_t n, const Double_t *x, Double_t *result, const Double_t *params, Int_t stride)
+{
+   if (n <= 0) return;
+   if (stride <= 0) stride = TMath::Max(fNdim, 1);
+
+   if (fType == 0) {
+      assert(fFormula);
+      fFormula->EvalParVec(n, x, result, params, stride);
+      if (fNormalized && fNormIntegral != 0) {
+         for (Int_t i = 0; i < n; ++i) result[i] /= fNormIntegral;
+      }
+      return;
+   }
+   for (Int_t i = 0; i < n; ++i) {
+      const Double_t *xi = x + (Long64_t)i * stride;
+      if (fType == 2) InitArgs(xi, params);
+      result[i] = EvalPar(xi, params);
+   }
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Execute action corresponding to one event.
 ///
@@ -2762,7 +2794,6 @@ void TF1::Paint(Option_t *option)
 TH1 *  TF1::DoCreateHistogram(Double_t xmin, Double_t  xmax, Bool_t recreate)
 {
    Int_t i;
-   Double_t xv[1];
 
    TH1 * histogram = 0;
 
@@ -2823,11 +2854,10 @@ TH1 *  TF1::DoCreateHistogram(Double_t xmin, Double_t  xmax, Bool_t recreate)
    histogram->GetYaxis()->SetTitle(ytitle.Data());
    Double_t *parameters = GetParameters();
 
-   InitArgs(xv,parameters);
-   for (i=1;i<=fNpx;i++) {
-      xv[0] = histogram->GetBinCenter(i);
-      histogram->SetBinContent(i,EvalPar(xv,parameters));
-   }
+   std::vector<Double_t> xc(fNpx), values(fNpx);
+   for (i=1;i<=fNpx;i++) xc[i-1] = histogram->GetBinCenter(i);
+   EvalParVec(fNpx, xc.data(), values.data(), parameters, 1);
+   for (i=1;i<=fNpx;i++) histogram->SetBinContent(i,values[i-1]);
 
    // Copy Function attributes to histogram attributes.
    histogram->SetBit(TH1::kNoStats);
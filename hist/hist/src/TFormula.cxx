@@ -147,6 +147,11 @@ static const TString gNamePrefix = "TFormula__";
 // static map of function pointers and expressions
 //static std::unordered_map<std::string,  TInterpreter::CallFuncIFacePtr_t::Generic_t> gClingFunctions = std::unordered_map<TString,  TInterpreter::CallFuncIFacePtr_t::Generic_t>();
 static std::unordered_map<std::string,  void *> gClingFunctions = std::unordered_map<std::string,  void * >();
+// array forms of the formulas, indexed by the cling name of the formula
+static std::unordered_map<std::string,  void *> gClingVecFunctions = std::unordered_map<std::string,  void * >();
+// number of points a formula evaluates with EvalParVec before the array form is compiled:
+// the call to the interpreter costs as much as the evaluation of many points one by one
+static const Long64_t gVecCompileNPoints = 10000;
 
 Bool_t TFormula::IsOperator(const char c)
 {
@@ -258,6 +263,7 @@ TFormula::TFormula()
    fClingName = "";
    fFormula = "";
    fLambdaPtr = nullptr;
+   ResetVecMethods();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -303,6 +309,7 @@ TFormula::TFormula(const char *name, const char *formula, bool addToGlobList)
    fNumber = 0;
    fMethod = 0;
    fLambdaPtr = nullptr;
+   ResetVecMethods();
 
    FillDefaults();
 
@@ -341,6 +348,7 @@ TFormula::TFormula(const char *name, const char *formula, int ndim, int npar, bo
    fNpar = 0;
    fMethod = 0;
    fLambdaPtr = nullptr;
+   ResetVecMethods();
 
 
    fNdim = ndim;
@@ -387,6 +395,7 @@ TFormula::TFormula(const TFormula &formula) :
    fNumber = formula.GetNumber();
    fFormula = formula.GetExpFormula();   // returns fFormula in case of Lambda's
    fLambdaPtr = nullptr;
+   ResetVecMethods();
 
    // case of function based on a C++  expression (lambda's) which is ready to be compiled
    if (formula.fLambdaPtr && formula.TestBit(TFormula::kLambda)) {
@@ -565,6 +574,7 @@ void TFormula::Copy(TObject &obj) const
    fnew.fClingInitialized = fClingInitialized;
    fnew.fAllParametersSetted = fAllParametersSetted;
    fnew.fClingName = fClingName;
+   fnew.ResetVecMethods();
 
       // case of function based on a C++  expression (lambda's) which is ready to be compiled
    if (fLambdaPtr && TestBit(TFormula::kLambda)) {
@@ -598,6 +608,7 @@ void TFormula::Clear(Option_t * )
    fNumber = 0;
    fFormula = "";
    fClingName = "";
+   ResetVecMethods();
 
 
    if(fMethod) fMethod->Delete();
@@ -678,6 +689,81 @@ bool TFormula::PrepareEvalMethod()
    return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the function evaluating the formula on an array of points, with the
+/// TMath functions or, if fastMath is true, with the inline vdt ones. The
+/// function is declared to Cling the first time a formula expression is used
+/// in a mode, then cached in fVecFuncPtr: the cached pointer is read without
+/// taking the lock, which is held only to build it.
+/// The formula expression is inlined in the loop over the points so that the
+/// compiler can vectorize it. Return 0 if the formula cannot be evaluated
+/// in this way (e.g. lambda expressions). A failure is also cached, in
+/// fVecFailed and as a null function, so that the declaration is not retried.
+
+TInterpreter::CallFuncIFacePtr_t::Generic_t TFormula::PrepareVecMethod(Bool_t fastMath) const
+{
+   TInterpreter::CallFuncIFacePtr_t::Generic_t funcPtr = fVecFuncPtr[fastMath].load(std::memory_order_acquire);
+   if (funcPtr || fVecFailed[fastMath].load(std::memory_order_relaxed))
+      return funcPtr;
+   if (!fReadyToExecute || !fClingInitialized || TestBit(TFormula::kLambda) || fClingName.IsNull())
+      return nullptr;
+
+   TString vecName = fClingName + (fastMath ? "_vec_vdt" : "_vec");
+
+   R__LOCKGUARD2(gROOTMutex);
+   funcPtr = fVecFuncPtr[fastMath].load(std::memory_order_relaxed);
+   if (funcPtr || fVecFailed[fastMath].load(std::memory_order_relaxed))
+      return funcPtr;
+
+   auto funcit = gClingVecFunctions.find(std::string(vecName));
+   if (funcit != gClingVecFunctions.end()) {
+      funcPtr = (TInterpreter::CallFuncIFacePtr_t::Generic_t) funcit->second;
+      if (funcPtr)
+         fVecFuncPtr[fastMath].store(funcPtr, std::memory_order_release);
+      else
+         fVecFailed[fastMath] = kTRUE;
+      return funcPtr;
+   }
+
+   // record a failure to build the function of this expression and mode
+   auto fail = [&]() -> TInterpreter::CallFuncIFacePtr_t::Generic_t {
+      gClingVecFunctions.insert(std::make_pair(std::string(vecName), (void*) nullptr));
+      fVecFailed[fastMath] = kTRUE;
+      return nullptr;
+   };
+
+   TString expression = GetExpFormula("CLING");
+   if (fastMath) {
+      static Bool_t vdtDeclared = gCling->Declare("#include \"vdt/vdtMath.h\"");
+      if (!vdtDeclared)
+         return fail();
+      // the "(" avoids replacing e.g. TMath::Log10 or TMath::ATan2 by the wrong function
+      const char *vdtFunctions[][2] = { {"TMath::Exp(", "vdt::fast_exp("}, {"TMath::Log(", "vdt::fast_log("},
+                                        {"TMath::Sin(", "vdt::fast_sin("}, {"TMath::Cos(", "vdt::fast_cos("},
+                                        {"TMath::Tan(", "vdt::fast_tan("}, {"TMath::ASin(", "vdt::fast_asin("},
+                                        {"TMath::ACos(", "vdt::fast_acos("}, {"TMath::ATan(", "vdt::fast_atan("},
+                                        {"TMath::ATan2(", "vdt::fast_atan2("} };
+      for (auto &f : vdtFunctions)
+         expression.ReplaceAll(f[0], f[1]);
+   }
+   TString vecInput = TString::Format("void %s(Int_t n, Double_t *xs, Int_t stride, Double_t *p, Double_t *out){ "
+                                      "for (Int_t i = 0; i < n; ++i) { Double_t *x = xs + (Long64_t)i * stride; "
+                                      "out[i] = %s ; } }", vecName.Data(), expression.Data());
+   if (!gCling->Declare(vecInput))
+      return fail();
+   TMethodCall method;
+   method.InitWithPrototype(vecName, "Int_t,Double_t*,Int_t,Double_t*,Double_t*");
+   if (!method.IsValid()) {
+      Error("EvalParVec","Can't find %s function prototype",vecName.Data());
+      return fail();
+   }
+   TInterpreter::CallFuncIFacePtr_t faceptr = gCling->CallFunc_IFacePtr(method.GetCallFunc());
+   funcPtr = faceptr.fGeneric;
+   gClingVecFunctions.insert(std::make_pair(std::string(vecName), (void*) funcPtr));
+   fVecFuncPtr[fastMath].store(funcPtr, std::memory_order_release);
+   return funcPtr;
+}
+
 void TFormula::InputFormulaIntoCling()
 {
    //*-*
@@ -1830,6 +1916,7 @@ void TFormula::ProcessFormula(TString &formula)
          // set the cling name using hash of the static formulae map
          auto hasher = gClingFunctions.hash_function();
          fClingName = TString::Format("%s__id%zu",gNamePrefix.Data(), hasher(inputFormula) );
+         ResetVecMethods();
 
          fClingInput = TString::Format("Double_t %s(%s){ return %s ; }", fClingName.Data(),argumentsPrototype.Data(),inputFormula.c_str());
 
@@ -2513,6 +2600,48 @@ Double_t TFormula::EvalPar(const Double_t *x,const Double_t *params) const
 
    return DoEval(x, params);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the formula at n points and store the values in result.
+/// The coordinates of point i start at x[i*stride]; a stride of 0 means that
+/// the points are packed, i.e. stride = GetNdim().
+/// If params is 0 the stored parameter values are used.
+/// Once the formula has evaluated 10000 points in this way, all the points
+/// are evaluated by a single call to a compiled loop, built by Cling; before,
+/// e.g. for a few integrals of the function, the points are evaluated one by
+/// one to avoid the cost of the compilation. If fast math is enabled
+/// (TMath::EnableFastMath) the compiled loop uses the vdt functions, so the
+/// values can differ from EvalPar in the last digits.
+
+void TFormula::EvalParVec(Int_t n, const Double_t *x, Double_t *result, const Double_t *params, Int_t stride) const
+{
+   if (n <= 0) return;
+   if (stride <= 0) stride = TMath::Max(fNdim, 1);
+
+#ifdef R__HAS_VDT
+   const Bool_t fastMath = TMath::IsFastMathEnabled();
+#else
+   const Bool_t fastMath = kFALSE;
+#endif
+   TInterpreter::CallFuncIFacePtr_t::Generic_t funcPtr = fVecFuncPtr[fastMath].load(std::memory_order_acquire);
+   if (!funcPtr && !fVecFailed[fastMath].load(std::memory_order_relaxed)
+       && fVecNPoints.fetch_add(n, std::memory_order_relaxed) + n >= gVecCompileNPoints)
+      funcPtr = PrepareVecMethod(fastMath);
+   if (!funcPtr) {
+      for (Int_t i = 0; i < n; ++i) result[i] = DoEval(x + (Long64_t)i * stride, params);
+      return;
+   }
+
+   void* args[5];
+   double * xs = const_cast<double*>(x);
+   double * pars = (params) ? const_cast<double*>(params) : const_cast<double*>(fClingParameters.data());
+   args[0] = &n;
+   args[1] = &xs;
+   args[2] = &stride;
+   args[3] = &pars;
+   args[4] = &result;
+   (*funcPtr)(0, 5, args, 0);
+}
 Double_t TFormula::Eval(Double_t x, Double_t y, Double_t z, Double_t t) const
 {
    //*-*
@@ -36,6 +36,8 @@
 #include <stdlib.h>
 #include <string>
 #include <cassert>
+#include <algorithm>
+#include <mutex>
 
 #include "HFitInterface.h"
 #include "Fit/DataRange.h"
@@ -63,6 +65,13 @@ class. All details about the various painting options are given in this class.
     and name `SetTitle` and `SetName` should be called on the TGraph after its creation.
     TGraph was a light weight object to start with, like TPolyline or TPolyMarker.
     That’s why it did not have any title and name parameters in the constructors.
+  - TGraph::Eval caches the order of the points in x and the spline used with
+    option "S"; they are rebuilt when the points are changed through the TGraph
+    methods and when they are moved with the mouse. Call TGraph::ResetEvalCache
+    after modifying the arrays returned by GetX() or GetY() directly.
+    Although TGraph::Eval is const it fills these caches; they are built under
+    a lock, so several threads can call Eval on the same graph, provided none
+    of them modifies the points.
 
 The picture below gives an example:
 Begin_Macro(source)
@@ -168,6 +177,8 @@ TGraph::TGraph(const TGraph &gr)
    fHistogram = 0;
    fMinimum = gr.fMinimum;
    fMaximum = gr.fMaximum;
+   fEvalIndexValid = kFALSE;
+   fEvalSpline = 0;
    if (!fMaxSize) {
       fX = fY = 0;
       return;
@@ -220,6 +231,7 @@ TGraph& TGraph::operator=(const TGraph &gr)
 
       fMinimum = gr.fMinimum;
       fMaximum = gr.fMaximum;
+      ResetEvalCache();
       if (fX) delete [] fX;
       if (fY) delete [] fY;
       if (!fMaxSize) {
@@ -521,6 +533,7 @@ TGraph::~TGraph()
       fFunctions = 0; //to avoid accessing a deleted object in RecursiveRemove
    }
    delete fHistogram;
+   delete fEvalSpline.load();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -558,6 +571,7 @@ void TGraph::Apply(TF1 *f)
    for (Int_t i = 0; i < fNpoints; i++) {
       fY[i] = f->Eval(fX[i], fY[i]);
    }
+   ResetEvalCache();
    if (gPad) gPad->Modified();
 }
 
@@ -678,6 +692,7 @@ void TGraph::ComputeRange(Double_t &xmin, Double_t &ymin, Double_t &xmax, Double
 void TGraph::CopyAndRelease(Double_t **newarrays, Int_t ibegin, Int_t iend,
                             Int_t obegin)
 {
+   ResetEvalCache();
    CopyPoints(newarrays, ibegin, iend, obegin);
    if (newarrays) {
       delete[] fX;
@@ -723,6 +738,8 @@ Bool_t TGraph::CtorAllocate()
    fHistogram = 0;
    fMaximum = -1111;
    fMinimum = -1111;
+   fEvalIndexValid = kFALSE;
+   fEvalSpline = 0;
    SetBit(kClipFrame);
    fFunctions = new TList;
    if (fNpoints <= 0) {
@@ -851,11 +868,16 @@ void TGraph::DrawPanel()
 ///   extrapolation is computed.
 ///   If the points are sorted in X a binary search is used (significantly faster)
 ///   One needs to set the bit  TGraph::SetBit(TGraph::kIsSortedX) before calling
-///   TGraph::Eval to indicate that the graph is sorted in X.
+///   TGraph::Eval to indicate that the graph is sorted in X. Otherwise the
+///   order of the points in X is computed at the first call and cached.
 ///  -if spline==0 and option="S" a TSpline3 object is created using this graph
 ///   and the interpolated value from the spline is returned.
-///   the internally created spline is deleted on return.
+///   The spline is kept and reused by the next calls until the points change.
 ///  -if spline is specified, it is used to return the interpolated value.
+/// Although Eval is const, the first call needing the order of the points or
+/// the spline builds them and stores them in the graph. They are built under
+/// a lock, so that Eval can be called concurrently from several threads, as
+/// long as the points are not modified at the same time.
 
 Double_t TGraph::Eval(Double_t x, TSpline *spline, Option_t *option) const
 {
@@ -871,23 +893,9 @@ Double_t TGraph::Eval(Double_t x, TSpline *spline, Option_t *option) const
    if (option) {
       TString opt = option;
       opt.ToLower();
-      // create a TSpline every time when using option "s" and no spline pointer is given
+      // use the cached TSpline when using option "s" and no spline pointer is given
       if (opt.Contains("s")) {
-
-         // points must be sorted before using a TSpline
-         std::vector<Double_t> xsort(fNpoints);
-         std::vector<Double_t> ysort(fNpoints);
-         std::vector<Int_t> indxsort(fNpoints);
-         TMath::Sort(fNpoints, fX, &indxsort[0], false);
-         for (Int_t i = 0; i < fNpoints; ++i) {
-            xsort[i] = fX[ indxsort[i] ];
-            ysort[i] = fY[ indxsort[i] ];
-         }
-
-         // spline interpolation creating a new spline
-         TSpline3 s("", &xsort[0], &ysort[0], fNpoints);
-         Double_t result = s.Eval(x);
-         return result;
+         return GetEvalSpline()->Eval(x);
       }
    }
    //linear interpolation
@@ -908,38 +916,17 @@ Double_t TGraph::Eval(Double_t x, TSpline *spline, Option_t *option) const
       up = low+1;
    }
    else {
-      // case TGraph is not sorted
-
-   // find neighbours simply looping  all points
-   // and find also the 2 adjacent points: (low2 < low < x < up < up2 )
-   // needed in case x is outside the graph ascissa interval
-      Int_t low2 = -1;
-      Int_t up2 = -1;
-
-      for (Int_t i = 0; i < fNpoints; ++i) {
-         if (fX[i] < x) {
-            if (low == -1 || fX[i] > fX[low])  {
-               low2 = low;
-               low = i;
-            } else if (low2 == -1) low2 = i;
-         } else if (fX[i] > x) {
-            if (up  == -1 || fX[i] < fX[up])  {
-               up2 = up;
-               up = i;
-            } else if (up2 == -1) up2 = i;
-         } else // case x == fX[i]
-            return fY[i]; // no interpolation needed
-      }
-
-      // treat cases when x is outside graph min max abscissa
-      if (up == -1)  {
-         up  = low;
-         low = low2;
-      }
-      if (low == -1) {
-         low = up;
-         up  = up2;
-      }
+      // case TGraph is not sorted: binary search in the cached order of the points
+      const std::vector<Int_t> &index = GetEvalIndex();
+      const Double_t *px = fX;
+      Int_t k = std::lower_bound(index.begin(), index.end(), x,
+                                 [px](Int_t i, Double_t v) { return px[i] < v; }) - index.begin();
+      if (k < fNpoints && fX[index[k]] == x) return fY[index[k]]; // no interpolation needed
+      // use the first or last two points in case x is outside graph min max abscissa
+      if (k == 0) k = 1;
+      if (k == fNpoints) k = fNpoints - 1;
+      low = index[k - 1];
+      up  = index[k];
    }
    // do now the linear interpolation
    assert(low != -1 && up != -1);
@@ -949,6 +936,78 @@ Double_t TGraph::Eval(Double_t x, TSpline *spline, Option_t *option) const
    return yn;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Interpolate the graph at the n points x[i] and store the results in y[i],
+/// as TGraph::Eval(x[i], 0, option) does.
+///
+/// The option is parsed only once for all the points.
+
+void TGraph::Eval(Int_t n, const Double_t *x, Double_t *y, Option_t *option) const
+{
+   TString opt = option;
+   opt.ToLower();
+   if (opt.Contains("s") && fNpoints > 1) {
+      TSpline3 *spline = GetEvalSpline();
+      for (Int_t i = 0; i < n; ++i) y[i] = spline->Eval(x[i]);
+      return;
+   }
+   for (Int_t i = 0; i < n; ++i) y[i] = Eval(x[i]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Mutex serialising the construction of the Eval caches of all the graphs.
+
+static std::mutex &GetEvalCacheMutex()
+{
+   static std::mutex evalCacheMutex;
+   return evalCacheMutex;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the indices of the points sorted in increasing x, computing them
+/// if needed. Points with the same x keep their order.
+
+const std::vector<Int_t> &TGraph::GetEvalIndex() const
+{
+   if (!fEvalIndexValid.load(std::memory_order_acquire)) {
+      std::lock_guard<std::mutex> lock(GetEvalCacheMutex());
+      if (!fEvalIndexValid.load(std::memory_order_relaxed)) {
+         fEvalIndex.resize(fNpoints);
+         for (Int_t i = 0; i < fNpoints; ++i) fEvalIndex[i] = i;
+         const Double_t *px = fX;
+         std::stable_sort(fEvalIndex.begin(), fEvalIndex.end(),
+                          [px](Int_t i, Int_t j) { return px[i] < px[j]; });
+         fEvalIndexValid.store(kTRUE, std::memory_order_release);
+      }
+   }
+   return fEvalIndex;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the spline through the points sorted in x used by TGraph::Eval
+/// with option "S", creating it if needed.
+
+TSpline3 *TGraph::GetEvalSpline() const
+{
+   TSpline3 *spline = fEvalSpline.load(std::memory_order_acquire);
+   if (!spline) {
+      const std::vector<Int_t> &index = GetEvalIndex();
+      std::lock_guard<std::mutex> lock(GetEvalCacheMutex());
+      spline = fEvalSpline.load(std::memory_order_relaxed);
+      if (!spline) {
+         std::vector<Double_t> xsort(fNpoints);
+         std::vector<Double_t> ysort(fNpoints);
+         for (Int_t i = 0; i < fNpoints; ++i) {
+            xsort[i] = fX[ index[i] ];
+            ysort[i] = fY[ index[i] ];
+         }
+         spline = new TSpline3("", &xsort[0], &ysort[0], fNpoints);
+         fEvalSpline.store(spline, std::memory_order_release);
+      }
+   }
+   return spline;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Execute action corresponding to one event.
 ///
@@ -1981,6 +2040,19 @@ void TGraph::RecursiveRemove(TObject *obj)
    if (fHistogram == obj) fHistogram = 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Forget the order of the points and the spline cached by TGraph::Eval.
+/// This is done by all the TGraph methods changing the points and by the
+/// graph painter when points are moved with the mouse; it must be called after
+/// modifying the arrays returned by GetX() or GetY() directly.
+
+void TGraph::ResetEvalCache()
+{
+   fEvalIndexValid = kFALSE;
+   fEvalIndex.clear();
+   delete fEvalSpline.exchange(0);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Delete point close to the mouse position
 
@@ -2167,6 +2239,7 @@ void TGraph::SetPoint(Int_t i, Double_t x, Double_t y)
    }
    fX[i] = x;
    fY[i] = y;
+   ResetEvalCache();
    if (gPad) gPad->Modified();
 }
 
@@ -2270,6 +2343,7 @@ void TGraph::Streamer(TBuffer &b)
             }
          }
          fMaxSize = fNpoints;
+         ResetEvalCache();
          return;
       }
       //====process old versions before automatic schema evolution
@@ -2310,6 +2384,7 @@ void TGraph::Streamer(TBuffer &b)
          b >> fMaximum;
       }
       b.CheckByteCount(R__s, R__c, TGraph::IsA());
+      ResetEvalCache();
       //====end of old versions
 
    } else {
@@ -2324,6 +2399,7 @@ void TGraph::SwapPoints(Int_t pos1, Int_t pos2)
 {
    SwapValues(fX, pos1, pos2);
    SwapValues(fY, pos1, pos2);
+   ResetEvalCache();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -998,6 +998,7 @@ void TGraphAsymmErrors::ComputeRange(Double_t &xmin, Double_t &ymin, Double_t &x
 void TGraphAsymmErrors::CopyAndRelease(Double_t **newarrays,
                                        Int_t ibegin, Int_t iend, Int_t obegin)
 {
+   ResetEvalCache();
    CopyPoints(newarrays, ibegin, iend, obegin);
    if (newarrays) {
       delete[] fEXlow;
@@ -470,6 +470,7 @@ void TGraphErrors::ComputeRange(Double_t &xmin, Double_t &ymin, Double_t &xmax,
 void TGraphErrors::CopyAndRelease(Double_t **newarrays,
                                   Int_t ibegin, Int_t iend, Int_t obegin)
 {
+   ResetEvalCache();
    CopyPoints(newarrays, ibegin, iend, obegin);
    if (newarrays) {
       delete[] fX;
@@ -47,6 +47,13 @@
 #include "Math/MinimizerOptions.h"
 #include "Math/QuantFuncMathCore.h"
 
+#include <vector>
+
+#ifdef R__USE_IMT
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#endif
+
 /** \addtogroup Hist
 @{
 \class TH1C
@@ -59,6 +66,8 @@
 \brief tomato 1-D histogram with a float per channel (see TH1 documentation)}
 \class TH1D
 \brief tomato 1-D histogram with a double per channel (see TH1 documentation)}
+\class TH1U
+\brief tomato 1-D histogram with a compact counter per channel (see TH1 documentation)}
 @}
 */
 
@@ -74,18 +83,24 @@ ROOT supports the following histogram types:
       - TH1I : histograms with one int per channel.    Maximum bin content = 2147483647
       - TH1F : histograms with one float per channel.  Maximum precision 7 digits
       - TH1D : histograms with one double per channel. Maximum precision 14 digits
+      - TH1U : histograms with one 16 bits counter per channel, promoted to double
+               on overflow or for non-integer weights. No precision loss
   - 2-D histograms:
       - TH2C : histograms with one byte per channel.   Maximum bin content = 127
       - TH2S : histograms with one short per channel.  Maximum bin content = 32767
       - TH2I : histograms with one int per channel.    Maximum bin content = 2147483647
       - TH2F : histograms with one float per channel.  Maximum precision 7 digits
       - TH2D : histograms with one double per channel. Maximum precision 14 digits
+      - TH2U : histograms with one 16 bits counter per channel, promoted to double
+               on overflow or for non-integer weights. No precision loss
   - 3-D histograms:
       - TH3C : histograms with one byte per channel.   Maximum bin content = 127
       - TH3S : histograms with one short per channel.  Maximum bin content = 32767
       - TH3I : histograms with one int per channel.    Maximum bin content = 2147483647
       - TH3F : histograms with one float per channel.  Maximum precision 7 digits
       - TH3D : histograms with one double per channel. Maximum precision 14 digits
+      - TH3U : histograms with one 16 bits counter per channel, promoted to double
+               on overflow or for non-integer weights. No precision loss
   - Profile histograms: See classes  TProfile, TProfile2D and TProfile3D.
       Profile histograms are used to display the mean value of Y and its standard deviation
       for each bin in X. Profile histograms are in many cases an elegant
@@ -130,8 +145,15 @@ All histogram classes are derived from the base class TH1
       The TH*I classes also inherit from the array class TArrayI.
       The TH*F classes also inherit from the array class TArrayF.
       The TH*D classes also inherit from the array class TArrayD.
+      The TH*U classes also inherit from the array class TArrayCounts.
 ~~~
 
+The TH*U classes are meant for large occupancy maps filled with unit
+weights: they use 2 bytes per bin instead of 8 for TH*D, while any bin
+overflowing 65534 or receiving a non-integer or negative content is
+transparently promoted to double (see TArrayCounts). As for all other
+types the fSumw2 array is only created when needed.
+
 #### Creating histograms
 
 Histograms are created by invoking one of the constructors, e.g.
@@ -1201,6 +1223,22 @@ void TH1::AddBinContent(Int_t, Double_t)
    AbstractMethod("AddBinContent");
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Increment the content of the n bins bins[0..n-1] by the weights
+/// w[0], w[stride], ... (by 1 if w is null).
+/// Used by the FillN functions once the bin numbers have been computed.
+/// This implementation calls AddBinContent for each bin; the classes
+/// storing the contents in a plain array override it with a tight loop.
+
+void TH1::DoAddBinContents(Int_t n, const Int_t *bins, const Double_t *w, Int_t stride)
+{
+   for (Int_t i = 0; i < n; ++i) {
+      if (bins[i] < 0) continue;
+      if (w) AddBinContent(bins[i], w[i*stride]);
+      else   AddBinContent(bins[i]);
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Sets the flag controlling the automatic add of histograms in memory
 ///
@@ -3220,6 +3258,11 @@ Int_t TH1::Fill(const char *namex, Double_t w)
 /// weights is automatically triggered and the sum of the squares of weights is incremented
 /// by \f$ w^2 \f$ in the bin corresponding to x.
 /// if w is NULL each entry is assumed a weight=1
+///
+/// Unless the axis can be extended, the bin numbers are computed for a chunk
+/// of values at once (see TAxis::FindFixBins) and the contents and statistics
+/// are accumulated in tight loops: filling many values with one FillN call
+/// is much faster than calling Fill for each of them.
 
 void TH1::FillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride)
 {
@@ -3252,6 +3295,49 @@ void TH1::DoFillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stri
    fEntries += ntimes;
    Double_t ww = 1;
    Int_t nbins   = fXaxis.GetNbins();
+
+   // Bulk path: compute the bin numbers of a chunk of values at once,
+   // then accumulate contents and statistics in tight loops.
+   // With an extendable axis FindBin may change the binning: fill one by one.
+   if (!fXaxis.CanExtend()) {
+      if (w && !fSumw2.fN && !TestBit(TH1::kIsNotW)) {
+         for (i=0;i<ntimes;i++) {
+            if (w[i*stride] != 1.0) {Sumw2(); break;}
+         }
+      }
+      const Int_t kChunk = 512;
+      Int_t bins[kChunk];
+      Double_t sumw = 0, sumw2 = 0, sumwx = 0, sumwx2 = 0;
+      for (Int_t first = 0; first < ntimes; first += kChunk) {
+         const Int_t n = TMath::Min(kChunk, ntimes-first);
+         const Double_t *xc = x + first*stride;
+         const Double_t *wc = w ? w + first*stride : 0;
+         fXaxis.FindFixBins(n, xc, bins, stride);
+         DoAddBinContents(n, bins, wc, stride);
+         if (fSumw2.fN) {
+            for (i=0;i<n;i++) {
+               ww = wc ? wc[i*stride] : 1;
+               fSumw2.fArray[bins[i]] += ww*ww;
+            }
+         }
+         for (i=0;i<n;i++) {
+            // under/overflows enter the statistics only if requested
+            const Bool_t use = fgStatOverflows || (bins[i] > 0 && bins[i] <= nbins);
+            const Double_t z  = use ? (wc ? wc[i*stride] : 1) : 0;
+            const Double_t xi = use ? xc[i*stride] : 0;
+            sumw   += z;
+            sumw2  += z*z;
+            sumwx  += z*xi;
+            sumwx2 += z*xi*xi;
+         }
+      }
+      fTsumw   += sumw;
+      fTsumw2  += sumw2;
+      fTsumwx  += sumwx;
+      fTsumwx2 += sumwx2;
+      return;
+   }
+
    ntimes *= stride;
    for (i=0;i<ntimes;i+=stride) {
       bin =fXaxis.FindBin(x[i]);
@@ -5274,6 +5360,10 @@ Bool_t TH1::RecomputeAxisLimits(TAxis& destAxis, const TAxis& anAxis)
 /// The function returns the total number of entries in the result histogram
 /// if the merge is successful, -1 otherwise.
 ///
+/// When all the histograms have the same binning, the bins are added
+/// directly, in parallel if implicit multithreading is enabled
+/// (see TH1::MergeSameBinning).
+///
 /// IMPORTANT remark. The axis x may have different number
 /// of bins and different limits, BUT the largest bin width must be
 /// a multiple of the smallest bin width and the upper limit must also
@@ -5427,6 +5517,11 @@ Long64_t TH1::Merge(TCollection *li)
       return -1;
    }
 
+   // all histograms have the same binning: add the bins directly (in parallel if possible)
+   if (allSameLimits && allHaveLimits && !allHaveLabels) {
+      Double_t nentries = 0;
+      if (MergeSameBinning(&inlist, nentries)) return (Long64_t)nentries;
+   }
 
    next.Reset();
    // In the case of histogram with different limits
@@ -5606,6 +5701,102 @@ Long64_t TH1::Merge(TCollection *li)
    return (Long64_t)nentries;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Add the bin contents, errors and statistics of the histograms in the
+/// collection to this histogram, when the caller (the Merge functions) has
+/// checked that all the histograms have the same axes as this one.
+/// Returns kFALSE, leaving this histogram unchanged, if one of the objects
+/// is not a histogram with the same number of cells; otherwise sets
+/// nentries to the number of entries of the result and returns kTRUE.
+///
+/// When implicit multithreading is enabled (see ROOT::EnableImplicitMT)
+/// and the merge is large, it runs in parallel:
+///  - large histograms are split into ranges of cells, each range being
+///    merged from all the histograms by one thread;
+///  - many small histograms are split into groups summed by different
+///    threads, and the partial sums are added to this histogram at the end.
+
+Bool_t TH1::MergeSameBinning(TCollection *li, Double_t &nentries)
+{
+   std::vector<TH1*> hists;
+   TIter next(li);
+   while (TObject *obj = next()) {
+      TH1 *hist = dynamic_cast<TH1*>(obj);
+      if (!hist || hist->fNcells != fNcells) return kFALSE;
+      // skip empty histograms
+      if (hist->fTsumw == 0 && hist->GetEntries() == 0) continue;
+      hists.push_back(hist);
+   }
+
+   // merge the statistics
+   Double_t stats[kNstat], totstats[kNstat];
+   for (Int_t i = 0; i < kNstat; i++) {totstats[i] = stats[i] = 0;}
+   GetStats(totstats);
+   nentries = GetEntries();
+   for (UInt_t k = 0; k < hists.size(); ++k) {
+      hists[k]->GetStats(stats);
+      for (Int_t i = 0; i < kNstat; i++)
+         totstats[i] += stats[i];
+      nentries += hists[k]->GetEntries();
+   }
+
+   // merge the bin contents and errors of the cells [first, last)
+   const Bool_t haveSumw2 = (fSumw2.fN != 0);
+   auto mergeCells = [&](Int_t first, Int_t last) {
+      for (UInt_t k = 0; k < hists.size(); ++k) {
+         const TH1 *hist = hists[k];
+         for (Int_t bin = first; bin < last; ++bin) {
+            Double_t cu = hist->RetrieveBinContent(bin);
+            if (cu != 0) AddBinContent(bin, cu);
+            if (haveSumw2) fSumw2.fArray[bin] += hist->GetBinErrorSqUnchecked(bin);
+         }
+      }
+   };
+
+#ifdef R__USE_IMT
+   // below this number of cells times histograms a parallel merge does not pay off
+   const Double_t kMinParallelMerge = 1 << 20;
+   // number of cells merged by a thread at a time
+   const Int_t kMergeGrain = 1 << 15;
+   if (ROOT::IsImplicitMTEnabled() && Double_t(fNcells) * hists.size() >= kMinParallelMerge) {
+      // the compact storage of the TH*U classes promotes bins through a shared
+      // map, so their cells cannot be updated from several threads
+      if (fNcells >= 4 * kMergeGrain && !dynamic_cast<TArrayCounts*>(this)) {
+         tbb::parallel_for(tbb::blocked_range<Int_t>(0, fNcells, kMergeGrain),
+                           [&](const tbb::blocked_range<Int_t> &r) { mergeCells(r.begin(), r.end()); });
+      } else {
+         const Int_t ngroups = TMath::Min((Int_t)hists.size(), 64);
+         std::vector<std::vector<Double_t> > sums(ngroups);
+         std::vector<std::vector<Double_t> > sums2(haveSumw2 ? ngroups : 0);
+         tbb::parallel_for(0, ngroups, [&](Int_t g) {
+            sums[g].assign(fNcells, 0.);
+            if (haveSumw2) sums2[g].assign(fNcells, 0.);
+            for (UInt_t k = g * hists.size() / ngroups; k < (g + 1) * hists.size() / ngroups; ++k) {
+               for (Int_t bin = 0; bin < fNcells; ++bin) {
+                  sums[g][bin] += hists[k]->RetrieveBinContent(bin);
+                  if (haveSumw2) sums2[g][bin] += hists[k]->GetBinErrorSqUnchecked(bin);
+               }
+            }
+         });
+         for (Int_t g = 0; g < ngroups; ++g) {
+            for (Int_t bin = 0; bin < fNcells; ++bin) {
+               if (sums[g][bin] != 0) AddBinContent(bin, sums[g][bin]);
+               if (haveSumw2) fSumw2.fArray[bin] += sums2[g][bin];
+            }
+         }
+      }
+   } else
+#endif
+   {
+      mergeCells(0, fNcells);
+   }
+
+   //copy merged stats
+   PutStats(totstats);
+   SetEntries(nentries);
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Performs the operation: this = this*c1*f1
 /// if errors are defined (see TH1::Sumw2), errors are also recalculated.
@@ -6480,6 +6671,15 @@ void  TH1::StatOverflows(Bool_t flag)
    fgStatOverflows = flag;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return kTRUE if underflows and overflows are used by the Fill functions
+/// in the computation of statistics, see TH1::StatOverflows.
+
+Bool_t TH1::GetStatOverflows()
+{
+   return fgStatOverflows;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Stream a class object.
 
@@ -9434,6 +9634,18 @@ void TH1F::Copy(TObject &newth1) const
    TH1::Copy(newth1);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Increment the content of the bins bins[0..n-1] by w[0], w[stride], ...
+
+void TH1F::DoAddBinContents(Int_t n, const Int_t *bins, const Double_t *w, Int_t stride)
+{
+   if (w) {
+      for (Int_t i = 0; i < n; ++i) fArray[bins[i]] += Float_t (w[i*stride]);
+   } else {
+      for (Int_t i = 0; i < n; ++i) ++fArray[bins[i]];
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Reset.
 
@@ -9613,6 +9825,18 @@ void TH1D::Copy(TObject &newth1) const
    TH1::Copy(newth1);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Increment the content of the bins bins[0..n-1] by w[0], w[stride], ...
+
+void TH1D::DoAddBinContents(Int_t n, const Int_t *bins, const Double_t *w, Int_t stride)
+{
+   if (w) {
+      for (Int_t i = 0; i < n; ++i) fArray[bins[i]] += Double_t (w[i*stride]);
+   } else {
+      for (Int_t i = 0; i < n; ++i) ++fArray[bins[i]];
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Reset.
 
@@ -9697,6 +9921,181 @@ TH1D operator/(const TH1D &h1, const TH1D &h2)
    return hnew;
 }
 
+//______________________________________________________________________________
+//                     TH1U methods
+// TH1U : histograms with one 16 bits counter per channel, promoted to double on overflow
+//______________________________________________________________________________
+
+ClassImp(TH1U)
+
+////////////////////////////////////////////////////////////////////////////////
+/// Constructor.
+
+TH1U::TH1U(): TH1(), TArrayCounts()
+{
+   fDimension = 1;
+   SetBinsLength(3);
+   if (fgDefaultSumw2) Sumw2();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create a 1-Dim histogram with fix bins of compact counters
+/// (see TH1::TH1 for explanation of parameters)
+
+TH1U::TH1U(const char *name,const char *title,Int_t nbins,Double_t xlow,Double_t xup)
+: TH1(name,title,nbins,xlow,xup)
+{
+   fDimension = 1;
+   TArrayCounts::Set(fNcells);
+
+   if (xlow >= xup) SetBuffer(fgBufferSize);
+   if (fgDefaultSumw2) Sumw2();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create a 1-Dim histogram with variable bins of compact counters
+/// (see TH1::TH1 for explanation of parameters)
+
+TH1U::TH1U(const char *name,const char *title,Int_t nbins,const Float_t *xbins)
+: TH1(name,title,nbins,xbins)
+{
+   fDimension = 1;
+   TArrayCounts::Set(fNcells);
+   if (fgDefaultSumw2) Sumw2();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create a 1-Dim histogram with variable bins of compact counters
+/// (see TH1::TH1 for explanation of parameters)
+
+TH1U::TH1U(const char *name,const char *title,Int_t nbins,const Double_t *xbins)
+: TH1(name,title,nbins,xbins)
+{
+   fDimension = 1;
+   TArrayCounts::Set(fNcells);
+   if (fgDefaultSumw2) Sumw2();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor.
+
+TH1U::~TH1U()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy constructor.
+
+TH1U::TH1U(const TH1U &h1u) : TH1(), TArrayCounts()
+{
+   ((TH1U&)h1u).Copy(*this);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Increment the content of n bins at once, see TH1::DoAddBinContents.
+
+void TH1U::DoAddBinContents(Int_t n, const Int_t *bins, const Double_t *w, Int_t stride)
+{
+   if (w) {
+      for (Int_t i = 0; i < n; ++i) Increment(bins[i], w[i*stride]);
+   } else {
+      for (Int_t i = 0; i < n; ++i) Increment(bins[i]);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy this to newth1
+
+void TH1U::Copy(TObject &newth1) const
+{
+   TH1::Copy(newth1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Reset.
+
+void TH1U::Reset(Option_t *option)
+{
+   TH1::Reset(option);
+   TArrayCounts::Reset();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set total number of bins including under/overflow
+/// Reallocate bin contents array
+
+void TH1U::SetBinsLength(Int_t n)
+{
+   if (n < 0) n = fXaxis.GetNbins() + 2;
+   fNcells = n;
+   TArrayCounts::Set(n);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Operator =
+
+TH1U& TH1U::operator=(const TH1U &h1)
+{
+   if (this != &h1)  ((TH1U&)h1).Copy(*this);
+   return *this;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Operator *
+
+TH1U operator*(Double_t c1, const TH1U &h1)
+{
+   TH1U hnew = h1;
+   hnew.Scale(c1);
+   hnew.SetDirectory(0);
+   return hnew;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Operator +
+
+TH1U operator+(const TH1U &h1, const TH1U &h2)
+{
+   TH1U hnew = h1;
+   hnew.Add(&h2,1);
+   hnew.SetDirectory(0);
+   return hnew;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Operator -
+
+TH1U operator-(const TH1U &h1, const TH1U &h2)
+{
+   TH1U hnew = h1;
+   hnew.Add(&h2,-1);
+   hnew.SetDirectory(0);
+   return hnew;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Operator *
+
+TH1U operator*(const TH1U &h1, const TH1U &h2)
+{
+   TH1U hnew = h1;
+   hnew.Multiply(&h2);
+   hnew.SetDirectory(0);
+   return hnew;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Operator /
+
+TH1U operator/(const TH1U &h1, const TH1U &h2)
+{
+   TH1U hnew = h1;
+   hnew.Divide(&h2);
+   hnew.SetDirectory(0);
+   return hnew;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///return pointer to histogram with name
 ///hid if id >=0
@@ -528,6 +528,9 @@ Int_t TH2::Fill(Double_t x, const char *namey, Double_t w)
 ///     by w[i]^2 in the bin corresponding to x[i],y[i].
 ///   - If w is NULL each entry is assumed a weight=1
 ///
+/// Unless an axis can be extended, the values are filled in bulk as
+/// in TH1::FillN.
+///
 /// NB: function only valid for a TH2x object
 
 void TH2::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *w, Int_t stride)
@@ -552,6 +555,67 @@ void TH2::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double
    }
 
    Double_t ww = 1;
+
+   // Bulk path, see TH1::FillN: bin numbers of a chunk of values computed
+   // at once, contents and statistics accumulated in tight loops.
+   if (!fXaxis.CanExtend() && !fYaxis.CanExtend()) {
+      const Int_t n0 = (ntimes-ifirst+stride-1)/stride;
+      x += ifirst; y += ifirst;
+      if (w) w += ifirst;
+      fEntries += n0;
+      if (w && !fSumw2.fN && !TestBit(TH1::kIsNotW)) {
+         for (i=0;i<n0;i++) {
+            if (w[i*stride] != 1.0) {Sumw2(); break;}
+         }
+      }
+      const Int_t nbinsx = fXaxis.GetNbins();
+      const Int_t nbinsy = fYaxis.GetNbins();
+      const Int_t kChunk = 512;
+      Int_t bins[kChunk], binsy[kChunk];
+      Double_t s[7] = {0,0,0,0,0,0,0};
+      for (Int_t first = 0; first < n0; first += kChunk) {
+         const Int_t n = TMath::Min(kChunk, n0-first);
+         const Double_t *xc = x + first*stride;
+         const Double_t *yc = y + first*stride;
+         const Double_t *wc = w ? w + first*stride : 0;
+         fXaxis.FindFixBins(n, xc, bins, stride);
+         fYaxis.FindFixBins(n, yc, binsy, stride);
+         for (i=0;i<n;i++) {
+            // statistics use under/overflows only if requested; binsy is reused as flag
+            const Bool_t use = fgStatOverflows || (bins[i] > 0 && bins[i] <= nbinsx && binsy[i] > 0 && binsy[i] <= nbinsy);
+            bins[i] += binsy[i]*(nbinsx+2);
+            binsy[i] = use;
+         }
+         DoAddBinContents(n, bins, wc, stride);
+         if (fSumw2.fN) {
+            for (i=0;i<n;i++) {
+               ww = wc ? wc[i*stride] : 1;
+               fSumw2.fArray[bins[i]] += ww*ww;
+            }
+         }
+         for (i=0;i<n;i++) {
+            const Double_t z  = binsy[i] ? (wc ? wc[i*stride] : 1) : 0;
+            const Double_t xi = binsy[i] ? xc[i*stride] : 0;
+            const Double_t yi = binsy[i] ? yc[i*stride] : 0;
+            s[0] += z;
+            s[1] += z*z;
+            s[2] += z*xi;
+            s[3] += z*xi*xi;
+            s[4] += z*yi;
+            s[5] += z*yi*yi;
+            s[6] += z*xi*yi;
+         }
+      }
+      fTsumw   += s[0];
+      fTsumw2  += s[1];
+      fTsumwx  += s[2];
+      fTsumwx2 += s[3];
+      fTsumwy  += s[4];
+      fTsumwy2 += s[5];
+      fTsumwxy += s[6];
+      return;
+   }
+
    for (i=ifirst;i<ntimes;i+=stride) {
       fEntries++;
       binx = fXaxis.FindBin(x[i]);
@@ -1517,6 +1581,10 @@ Double_t TH2::KolmogorovTest(const TH1 *h2, Option_t *option) const
 /// The function returns the total number of entries in the result histogram
 /// if the merge is successfull, -1 otherwise.
 ///
+/// When all the histograms have the same binning, the bins are added
+/// directly, in parallel if implicit multithreading is enabled
+/// (see TH1::MergeSameBinning).
+///
 /// IMPORTANT remark. The 2 axis x and y may have different number
 /// of bins and different limits, BUT the largest bin width must be
 /// a multiple of the smallest bin width and the upper limit must also
@@ -1616,6 +1684,12 @@ Long64_t TH2::Merge(TCollection *list)
             (*next)->ClassName(),this->ClassName());
       return -1;
    }
+
+   // all histograms have the same binning: add the bins directly (in parallel if possible)
+   if (allSameLimits && allHaveLimits) {
+      Double_t nentries = 0;
+      if (MergeSameBinning(&inlist, nentries)) return (Long64_t)nentries;
+   }
    next.Reset();
 
    // In the case of histogram with different limits
@@ -3786,6 +3860,19 @@ void TH2F::Copy(TObject &newth2) const
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Increment the content of the bins bins[0..n-1] by w[0], w[stride], ...
+
+void TH2F::DoAddBinContents(Int_t n, const Int_t *bins, const Double_t *w, Int_t stride)
+{
+   if (w) {
+      for (Int_t i = 0; i < n; ++i) fArray[bins[i]] += Float_t (w[i*stride]);
+   } else {
+      for (Int_t i = 0; i < n; ++i) ++fArray[bins[i]];
+   }
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Reset this histogram: contents, errors, etc.
 
@@ -4051,6 +4138,19 @@ void TH2D::Copy(TObject &newth2) const
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Increment the content of the bins bins[0..n-1] by w[0], w[stride], ...
+
+void TH2D::DoAddBinContents(Int_t n, const Int_t *bins, const Double_t *w, Int_t stride)
+{
+   if (w) {
+      for (Int_t i = 0; i < n; ++i) fArray[bins[i]] += Double_t (w[i*stride]);
+   } else {
+      for (Int_t i = 0; i < n; ++i) ++fArray[bins[i]];
+   }
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Reset this histogram: contents, errors, etc.
 
@@ -4177,3 +4277,214 @@ TH2D operator/(TH2D &h1, TH2D &h2)
    hnew.SetDirectory(0);
    return hnew;
 }
+
+
+//______________________________________________________________________________
+//                     TH2U methods
+//  TH2U a 2-D histogram with two bytes per cell (16 bits counter), promoted to double on overflow
+//______________________________________________________________________________
+
+ClassImp(TH2U)
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Constructor.
+
+TH2U::TH2U(): TH2(), TArrayCounts()
+{
+   SetBinsLength(9);
+   if (fgDefaultSumw2) Sumw2();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor.
+
+TH2U::~TH2U()
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Constructor.
+
+TH2U::TH2U(const char *name,const char *title,Int_t nbinsx,Double_t xlow,Double_t xup
+           ,Int_t nbinsy,Double_t ylow,Double_t yup)
+           :TH2(name,title,nbinsx,xlow,xup,nbinsy,ylow,yup)
+{
+   TArrayCounts::Set(fNcells);
+   if (fgDefaultSumw2) Sumw2();
+
+   if (xlow >= xup || ylow >= yup) SetBuffer(fgBufferSize);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Constructor.
+
+TH2U::TH2U(const char *name,const char *title,Int_t nbinsx,const Double_t *xbins
+           ,Int_t nbinsy,Double_t ylow,Double_t yup)
+           :TH2(name,title,nbinsx,xbins,nbinsy,ylow,yup)
+{
+   TArrayCounts::Set(fNcells);
+   if (fgDefaultSumw2) Sumw2();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Constructor.
+
+TH2U::TH2U(const char *name,const char *title,Int_t nbinsx,Double_t xlow,Double_t xup
+           ,Int_t nbinsy,const Double_t *ybins)
+           :TH2(name,title,nbinsx,xlow,xup,nbinsy,ybins)
+{
+   TArrayCounts::Set(fNcells);
+   if (fgDefaultSumw2) Sumw2();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Constructor.
+
+TH2U::TH2U(const char *name,const char *title,Int_t nbinsx,const Double_t *xbins
+           ,Int_t nbinsy,const Double_t *ybins)
+           :TH2(name,title,nbinsx,xbins,nbinsy,ybins)
+{
+   TArrayCounts::Set(fNcells);
+   if (fgDefaultSumw2) Sumw2();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Constructor.
+
+TH2U::TH2U(const char *name,const char *title,Int_t nbinsx,const Float_t *xbins
+           ,Int_t nbinsy,const Float_t *ybins)
+           :TH2(name,title,nbinsx,xbins,nbinsy,ybins)
+{
+   TArrayCounts::Set(fNcells);
+   if (fgDefaultSumw2) Sumw2();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy constructor.
+
+TH2U::TH2U(const TH2U &h2u) : TH2(), TArrayCounts()
+{
+   ((TH2U&)h2u).Copy(*this);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Increment the content of n bins at once, see TH1::DoAddBinContents.
+
+void TH2U::DoAddBinContents(Int_t n, const Int_t *bins, const Double_t *w, Int_t stride)
+{
+   if (w) {
+      for (Int_t i = 0; i < n; ++i) Increment(bins[i], w[i*stride]);
+   } else {
+      for (Int_t i = 0; i < n; ++i) Increment(bins[i]);
+   }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy.
+
+void TH2U::Copy(TObject &newth2) const
+{
+   TH2::Copy((TH2U&)newth2);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Reset this histogram: contents, errors, etc.
+
+void TH2U::Reset(Option_t *option)
+{
+   TH2::Reset(option);
+   TArrayCounts::Reset();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set total number of bins including under/overflow
+/// Reallocate bin contents array
+
+void TH2U::SetBinsLength(Int_t n)
+{
+   if (n < 0) n = (fXaxis.GetNbins()+2)*(fYaxis.GetNbins()+2);
+   fNcells = n;
+   TArrayCounts::Set(n);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Operator =
+
+TH2U& TH2U::operator=(const TH2U &h1)
+{
+   if (this != &h1)  ((TH2U&)h1).Copy(*this);
+   return *this;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Operator *
+
+TH2U operator*(Float_t c1, TH2U &h1)
+{
+   TH2U hnew = h1;
+   hnew.Scale(c1);
+   hnew.SetDirectory(0);
+   return hnew;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Operator +
+
+TH2U operator+(TH2U &h1, TH2U &h2)
+{
+   TH2U hnew = h1;
+   hnew.Add(&h2,1);
+   hnew.SetDirectory(0);
+   return hnew;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Operator -
+
+TH2U operator-(TH2U &h1, TH2U &h2)
+{
+   TH2U hnew = h1;
+   hnew.Add(&h2,-1);
+   hnew.SetDirectory(0);
+   return hnew;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Operator *
+
+TH2U operator*(TH2U &h1, TH2U &h2)
+{
+   TH2U hnew = h1;
+   hnew.Multiply(&h2);
+   hnew.SetDirectory(0);
+   return hnew;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Operator /
+
+TH2U operator/(TH2U &h1, TH2U &h2)
+{
+   TH2U hnew = h1;
+   hnew.Divide(&h2);
+   hnew.SetDirectory(0);
+   return hnew;
+}
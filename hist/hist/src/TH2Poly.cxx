@@ -17,6 +17,8 @@
 #include "TList.h"
 #include "TMath.h"
 
+#include <algorithm>
+
 ClassImp(TH2Poly)
 
 /** \class TH2Poly
@@ -56,7 +58,8 @@ histogram limits is added. This is done when the default constructor (with no
 arguments) is used. It generates a histogram with no limits along the X and Y
 axis. Adding bins to it will extend it up to a proper size.
 
-`TH2Poly` implements a partitioning algorithm to speed up bins' filling.
+`TH2Poly` uses an adaptive spatial index to speed up bins' filling, see
+below. It also maintains a partitioning of the histogram area.
 The partitioning algorithm divides the histogram into regions called cells.
 The bins that each cell intersects are recorded in an array of `TList`s.
 When a coordinate in the histogram is to be filled; the method (quickly) finds
@@ -70,6 +73,9 @@ considerably faster than the brute force algorithm (i.e. checking if each bin
 contains the input coordinates), especially if the histogram is to be filled
 many times.
 
+Many points can be located or filled at once with `FindBins()` and
+`FillN()`.
+
 The following very simple macro shows how to build and fill a `TH2Poly`:
 ~~~ {.cpp}
 {
@@ -133,6 +139,21 @@ filling, it also adds a constant time delay into the code. When `Fill()`
 is to be called many times, it is more efficient to divide the histogram into
 a large number cells. However, if the histogram is to be filled only a few
 times, it is better to divide into a small number of cells.
+
+## Spatial Index
+A uniform grid of cells works badly for bins of very different sizes, e.g.
+for detector maps with small bins in some regions and large ones elsewhere:
+the cells covering the small bins each hold long lists of bins. `FindBin()`
+and `Fill()` therefore search an adaptive quadtree instead. Its root covers
+the axis ranges; a node is split into four quadrants as long as it overlaps
+more than a few bin bounding boxes and the split reduces that number. A
+point is located by descending to its leaf, and testing only the bins of that
+leaf whose bounding box contains the point.
+
+The quadtree is not stored with the histogram. It is built by the first
+`FindBin()` or `Fill()` after bins have been added, which usually means once,
+after all `AddBin()` calls. The bins of a leaf are kept in the order they were
+added, such that for overlapping bins the first one is still found.
 */
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -232,6 +253,7 @@ Int_t TH2Poly::AddBin(TObject *poly)
 
    // Adds the bin to the partition matrix
    AddBinToPartition(bin);
+   fIndexValid = kFALSE;
 
    return fNcells;
 }
@@ -425,6 +447,100 @@ void TH2Poly::AddBinToPartition(TH2PolyBin *bin)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Builds the quadtree used to locate points by FindBin() and Fill(): see
+/// the section "Spatial Index" of the class description.
+
+void TH2Poly::BuildIndex()
+{
+   fIndexBins.assign(fNcells, (TH2PolyBin*)0);
+   fIndexBoxes.assign(4*fNcells, 0.);
+   fIndexNodes.clear();
+   fIndexLeaves.clear();
+
+   fIndexLimits[0] = fXaxis.GetXmin();
+   fIndexLimits[1] = fXaxis.GetXmax();
+   fIndexLimits[2] = fYaxis.GetXmin();
+   fIndexLimits[3] = fYaxis.GetXmax();
+
+   TIter    next(fBins);
+   TObject  *obj;
+   while ((obj = next())) {
+      TH2PolyBin *bin = (TH2PolyBin*) obj;
+      Int_t bi = bin->GetBinNumber()-1;
+      if (bi < 0 || bi >= fNcells) continue;
+      fIndexBins[bi] = bin;
+      fIndexBoxes[4*bi]   = bin->GetXMin();
+      fIndexBoxes[4*bi+1] = bin->GetXMax();
+      fIndexBoxes[4*bi+2] = bin->GetYMin();
+      fIndexBoxes[4*bi+3] = bin->GetYMax();
+   }
+
+   // The root holds the bins overlapping the axis ranges, in increasing order
+   std::vector<Int_t> rootBins;
+   for (Int_t bi = 0; bi < fNcells; ++bi) {
+      const Double_t *box = &fIndexBoxes[4*bi];
+      if (fIndexBins[bi] && box[1] >= fIndexLimits[0] && box[0] <= fIndexLimits[1] &&
+          box[3] >= fIndexLimits[2] && box[2] <= fIndexLimits[3])
+         rootBins.push_back(bi);
+   }
+
+   fIndexNodes.resize(3);
+   BuildIndexNode(0, rootBins, fIndexLimits[0], fIndexLimits[1], fIndexLimits[2], fIndexLimits[3], 0);
+   fIndexValid = kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fills the quadtree node "node", covering [xmin,xmax]x[ymin,ymax] and
+/// overlapping the bins "bins": either as a leaf or by splitting it into
+/// four quadrants.
+
+void TH2Poly::BuildIndexNode(Int_t node, const std::vector<Int_t> &bins,
+                             Double_t xmin, Double_t xmax, Double_t ymin, Double_t ymax, Int_t depth)
+{
+   const Int_t kLeafSize = 8;  // Bins below which a node is not split
+   const Int_t kMaxDepth = 16; // Maximum depth of the tree
+
+   const Int_t nbins = bins.size();
+   if (nbins > kLeafSize && depth < kMaxDepth) {
+      const Double_t xmid = 0.5*(xmin + xmax);
+      const Double_t ymid = 0.5*(ymin + ymax);
+      std::vector<Int_t> quadrants[4];
+      Bool_t reduced = kFALSE;
+      for (Int_t q = 0; q < 4; ++q) {
+         const Double_t qxmin = (q & 1) ? xmid : xmin;
+         const Double_t qxmax = (q & 1) ? xmax : xmid;
+         const Double_t qymin = (q & 2) ? ymid : ymin;
+         const Double_t qymax = (q & 2) ? ymax : ymid;
+         for (Int_t i = 0; i < nbins; ++i) {
+            const Double_t *box = &fIndexBoxes[4*bins[i]];
+            if (box[1] >= qxmin && box[0] <= qxmax && box[3] >= qymin && box[2] <= qymax)
+               quadrants[q].push_back(bins[i]);
+         }
+         if ((Int_t) quadrants[q].size() < nbins) reduced = kTRUE;
+      }
+      if (reduced) {
+         const Int_t first = fIndexNodes.size()/3;
+         fIndexNodes[3*node]   = first;
+         fIndexNodes[3*node+1] = 0;
+         fIndexNodes[3*node+2] = 0;
+         fIndexNodes.resize(3*(first+4));
+         for (Int_t q = 0; q < 4; ++q) {
+            BuildIndexNode(first+q, quadrants[q],
+                           (q & 1) ? xmid : xmin, (q & 1) ? xmax : xmid,
+                           (q & 2) ? ymid : ymin, (q & 2) ? ymax : ymid, depth+1);
+         }
+         return;
+      }
+   }
+
+   // Leaf
+   fIndexNodes[3*node]   = -1;
+   fIndexNodes[3*node+1] = fIndexLeaves.size();
+   fIndexLeaves.insert(fIndexLeaves.end(), bins.begin(), bins.end());
+   fIndexNodes[3*node+2] = fIndexLeaves.size();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Changes the number of partition cells in the histogram.
 /// Deletes the old partition and constructs a new one.
@@ -546,33 +662,56 @@ Int_t TH2Poly::FindBin(Double_t x, Double_t y, Double_t)
    else if (x > fXaxis.GetXmin()) overflow += -1;
    if (overflow != -5) return overflow;
 
-   // Finds the cell (x,y) coordinates belong to
-   Int_t n = (Int_t)(floor((x-fXaxis.GetXmin())/fStepX));
-   Int_t m = (Int_t)(floor((y-fYaxis.GetXmin())/fStepY));
-
-   // Make sure the array indices are correct.
-   if (n>=fCellX) n = fCellX-1;
-   if (m>=fCellY) m = fCellY-1;
-   if (n<0)       n = 0;
-   if (m<0)       m = 0;
-
-   if (fIsEmpty[n+fCellX*m]) return -5;
+   return FindBinInIndex(x, y);
+}
 
-   TH2PolyBin *bin;
+////////////////////////////////////////////////////////////////////////////////
+/// Returns the number of the bin containing (x,y), which must be inside the
+/// axis ranges, or -5 if the point is on "the sea". Uses the spatial index,
+/// which is built first if needed.
 
-   TIter next(&fCells[n+fCellX*m]);
-   TObject *obj;
+Int_t TH2Poly::FindBinInIndex(Double_t x, Double_t y)
+{
+   if (!fIndexValid) BuildIndex();
+
+   // Descends to the leaf containing (x,y)
+   Double_t xmin = fIndexLimits[0], xmax = fIndexLimits[1];
+   Double_t ymin = fIndexLimits[2], ymax = fIndexLimits[3];
+   Int_t node = 0;
+   while (fIndexNodes[3*node] >= 0) {
+      const Double_t xmid = 0.5*(xmin + xmax);
+      const Double_t ymid = 0.5*(ymin + ymax);
+      Int_t q = 0;
+      if (x >= xmid) {q += 1; xmin = xmid;} else xmax = xmid;
+      if (y >= ymid) {q += 2; ymin = ymid;} else ymax = ymid;
+      node = fIndexNodes[3*node] + q;
+   }
 
-   // Search for the bin in the cell
-   while ((obj=next())) {
-      bin  = (TH2PolyBin*)obj;
-      if (bin->IsInside(x,y)) return bin->GetBinNumber();
+   // Search for the bin in the leaf
+   const Int_t end = fIndexNodes[3*node+2];
+   for (Int_t k = fIndexNodes[3*node+1]; k < end; ++k) {
+      const Int_t bi = fIndexLeaves[k];
+      const Double_t *box = &fIndexBoxes[4*bi];
+      if (x < box[0] || x > box[1] || y < box[2] || y > box[3]) continue;
+      if (fIndexBins[bi]->IsInside(x,y)) return bi+1;
    }
 
    // If the search has not returned a bin, the point must be on "the sea"
    return -5;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Stores in bins[i] the bin number of the point (x[i*stride], y[i*stride]),
+/// for i from 0 to n-1, as returned by FindBin().
+
+void TH2Poly::FindBins(Int_t n, const Double_t *x, const Double_t *y, Int_t *bins, Int_t stride)
+{
+   if (!fIndexValid) BuildIndex();
+   for (Int_t i = 0; i < n; ++i) {
+      bins[i] = FindBin(x[i*stride], y[i*stride]);
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Increment the bin containing (x,y) by 1.
 /// Uses the partitioning algorithm.
@@ -589,61 +728,7 @@ Int_t TH2Poly::Fill(Double_t x, Double_t y)
 Int_t TH2Poly::Fill(Double_t x, Double_t y, Double_t w)
 {
    if (fNcells==0) return 0;
-   Int_t overflow = 0;
-   if      (y > fYaxis.GetXmax()) overflow += -1;
-   else if (y > fYaxis.GetXmin()) overflow += -4;
-   else                           overflow += -7;
-   if      (x > fXaxis.GetXmax()) overflow += -2;
-   else if(x > fXaxis.GetXmin())  overflow += -1;
-   if (overflow != -5) {
-      fOverflow[-overflow - 1]++;
-      return overflow;
-   }
-
-   // Finds the cell (x,y) coordinates belong to
-   Int_t n = (Int_t)(floor((x-fXaxis.GetXmin())/fStepX));
-   Int_t m = (Int_t)(floor((y-fYaxis.GetXmin())/fStepY));
-
-   // Make sure the array indices are correct.
-   if (n>=fCellX) n = fCellX-1;
-   if (m>=fCellY) m = fCellY-1;
-   if (n<0)       n = 0;
-   if (m<0)       m = 0;
-
-   if (fIsEmpty[n+fCellX*m]) {
-      fOverflow[4]++;
-      return -5;
-   }
-
-   TH2PolyBin *bin;
-   Int_t bi;
-
-   TIter next(&fCells[n+fCellX*m]);
-   TObject *obj;
-
-   while ((obj=next())) {
-      bin  = (TH2PolyBin*)obj;
-      bi = bin->GetBinNumber()-1;
-      if (bin->IsInside(x,y)) {
-         bin->Fill(w);
-
-         // Statistics
-         fTsumw   = fTsumw + w;
-         fTsumwx  = fTsumwx + w*x;
-         fTsumwx2 = fTsumwx2 + w*x*x;
-         fTsumwy  = fTsumwy + w*y;
-         fTsumwy2 = fTsumwy2 + w*y*y;
-         if (fSumw2.fN) fSumw2.fArray[bi] += w*w;
-         fEntries++;
-
-         SetBinContentChanged(kTRUE);
-
-         return bin->GetBinNumber();
-      }
-   }
-
-   fOverflow[4]++;
-   return -5;
+   return FillBin(FindBin(x, y), x, y, w);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -677,17 +762,55 @@ Int_t TH2Poly::Fill(const char* name, Double_t w)
 ///                      (array size must be ntimes*stride)
 /// \param [in] x:       array of x values to be histogrammed
 /// \param [in] y:       array of y values to be histogrammed
-/// \param [in] w:       array of weights
+/// \param [in] w:       array of weights; if null, all weights are 1
 /// \param [in] stride:  step size through arrays x, y and w
 
 void TH2Poly::FillN(Int_t ntimes, const Double_t* x, const Double_t* y,
                                const Double_t* w, Int_t stride)
 {
-   for (int i = 0; i < ntimes; i += stride) {
-      Fill(x[i], y[i], w[i]);
+   if (fNcells==0) return;
+
+   // Locates a block of points at a time, then fills them
+   const Int_t kBlock = 512;
+   Int_t bins[kBlock];
+   for (Int_t first = 0; first < ntimes; first += kBlock) {
+      const Int_t nblock = TMath::Min(kBlock, ntimes - first);
+      const Int_t offset = first*stride;
+      FindBins(nblock, x + offset, y + offset, bins, stride);
+      for (Int_t i = 0; i < nblock; ++i) {
+         const Int_t k = offset + i*stride;
+         FillBin(bins[i], x[k], y[k], w ? w[k] : 1.);
+      }
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Increments bin number "bin", found by FindBin() for (x,y), by w and
+/// updates the statistics. Returns bin.
+
+Int_t TH2Poly::FillBin(Int_t bin, Double_t x, Double_t y, Double_t w)
+{
+   if (bin < 0) {
+      fOverflow[-bin - 1]++;
+      return bin;
+   }
+
+   fIndexBins[bin-1]->Fill(w);
+
+   // Statistics
+   fTsumw   = fTsumw + w;
+   fTsumwx  = fTsumwx + w*x;
+   fTsumwx2 = fTsumwx2 + w*x*x;
+   fTsumwy  = fTsumwy + w*y;
+   fTsumwy2 = fTsumwy2 + w*y*y;
+   if (fSumw2.fN) fSumw2.fArray[bin-1] += w*w;
+   fEntries++;
+
+   SetBinContentChanged(kTRUE);
+
+   return bin;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Returns the integral of bin contents.
 /// By default the integral is computed as the sum of bin contents.
@@ -967,6 +1090,8 @@ void TH2Poly::Initialize(Double_t xlow, Double_t xup,
    // 3D Painter flags
    SetNewBinAdded(kFALSE);
    SetBinContentChanged(kFALSE);
+
+   fIndexValid = kFALSE;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
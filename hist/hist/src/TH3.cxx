@@ -641,6 +641,115 @@ Int_t TH3::Fill(Double_t x, Double_t y, const char *namez, Double_t w)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill a 3-D histogram with an array of values and weights.
+///
+///  - ntimes:  number of entries in arrays x, y, z and w (array size must be ntimes*stride)
+///  - x, y, z: arrays of values to be histogrammed
+///  - w:       array of weights
+///  - stride:  step size through arrays x, y, z and w
+///
+///   - If the weight is not equal to 1, the storage of the sum of squares of
+///     weights is automatically triggered and the sum of the squares of weights is incremented
+///     by w[i]^2 in the bin corresponding to x[i],y[i],z[i].
+///   - If w is NULL each entry is assumed a weight=1
+///
+/// Unless an axis can be extended, the bin numbers of a chunk of values are
+/// computed at once (see TAxis::FindFixBins) and the contents and statistics
+/// are accumulated in tight loops, otherwise Fill is called for each entry.
+
+void TH3::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *z, const Double_t *w, Int_t stride)
+{
+   Int_t i;
+   Int_t ifirst = 0;
+
+   //If a buffer is activated, fill buffer
+   if (fBuffer) {
+      for (i=0;i<ntimes;i++) {
+         if (!fBuffer) break; // buffer can be deleted in BufferFill when is empty
+         BufferFill(x[i*stride], y[i*stride], z[i*stride], w ? w[i*stride] : 1.);
+      }
+      if (i == ntimes) return;
+      ifirst = i;
+   }
+
+   if (fXaxis.CanExtend() || fYaxis.CanExtend() || fZaxis.CanExtend()) {
+      for (i=ifirst;i<ntimes;i++) {
+         Fill(x[i*stride], y[i*stride], z[i*stride], w ? w[i*stride] : 1.);
+      }
+      return;
+   }
+
+   const Int_t n0 = ntimes-ifirst;
+   x += ifirst*stride; y += ifirst*stride; z += ifirst*stride;
+   if (w) w += ifirst*stride;
+   fEntries += n0;
+   if (w && !fSumw2.fN && !TestBit(TH1::kIsNotW)) {
+      for (i=0;i<n0;i++) {
+         if (w[i*stride] != 1.0) {Sumw2(); break;}
+      }
+   }
+   const Int_t nbinsx = fXaxis.GetNbins();
+   const Int_t nbinsy = fYaxis.GetNbins();
+   const Int_t nbinsz = fZaxis.GetNbins();
+   const Int_t kChunk = 512;
+   Int_t bins[kChunk], binsy[kChunk], binsz[kChunk];
+   Double_t s[11] = {0,0,0,0,0,0,0,0,0,0,0};
+   for (Int_t first = 0; first < n0; first += kChunk) {
+      const Int_t n = TMath::Min(kChunk, n0-first);
+      const Double_t *xc = x + first*stride;
+      const Double_t *yc = y + first*stride;
+      const Double_t *zc = z + first*stride;
+      const Double_t *wc = w ? w + first*stride : 0;
+      fXaxis.FindFixBins(n, xc, bins, stride);
+      fYaxis.FindFixBins(n, yc, binsy, stride);
+      fZaxis.FindFixBins(n, zc, binsz, stride);
+      for (i=0;i<n;i++) {
+         // statistics use under/overflows only if requested; binsy is reused as flag
+         const Bool_t use = fgStatOverflows || (bins[i] > 0 && bins[i] <= nbinsx &&
+                                                binsy[i] > 0 && binsy[i] <= nbinsy &&
+                                                binsz[i] > 0 && binsz[i] <= nbinsz);
+         bins[i] += (nbinsx+2)*(binsy[i] + (nbinsy+2)*binsz[i]);
+         binsy[i] = use;
+      }
+      DoAddBinContents(n, bins, wc, stride);
+      if (fSumw2.fN) {
+         for (i=0;i<n;i++) {
+            const Double_t ww = wc ? wc[i*stride] : 1;
+            fSumw2.fArray[bins[i]] += ww*ww;
+         }
+      }
+      for (i=0;i<n;i++) {
+         const Double_t ww = binsy[i] ? (wc ? wc[i*stride] : 1) : 0;
+         const Double_t xi = binsy[i] ? xc[i*stride] : 0;
+         const Double_t yi = binsy[i] ? yc[i*stride] : 0;
+         const Double_t zi = binsy[i] ? zc[i*stride] : 0;
+         s[0]  += ww;
+         s[1]  += ww*ww;
+         s[2]  += ww*xi;
+         s[3]  += ww*xi*xi;
+         s[4]  += ww*yi;
+         s[5]  += ww*yi*yi;
+         s[6]  += ww*xi*yi;
+         s[7]  += ww*zi;
+         s[8]  += ww*zi*zi;
+         s[9]  += ww*xi*zi;
+         s[10] += ww*yi*zi;
+      }
+   }
+   fTsumw   += s[0];
+   fTsumw2  += s[1];
+   fTsumwx  += s[2];
+   fTsumwx2 += s[3];
+   fTsumwy  += s[4];
+   fTsumwy2 += s[5];
+   fTsumwxy += s[6];
+   fTsumwz  += s[7];
+   fTsumwz2 += s[8];
+   fTsumwxz += s[9];
+   fTsumwyz += s[10];
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Fill histogram following distribution in function fname.
 ///
@@ -1557,6 +1666,10 @@ Double_t TH3::KolmogorovTest(const TH1 *h2, Option_t *option) const
 /// The function returns the total number of entries in the result histogram
 /// if the merge is successfull, -1 otherwise.
 ///
+/// When all the histograms have the same binning, the bins are added
+/// directly, in parallel if implicit multithreading is enabled
+/// (see TH1::MergeSameBinning).
+///
 /// IMPORTANT remark. The 2 axis x and y may have different number
 /// of bins and different limits, BUT the largest bin width must be
 /// a multiple of the smallest bin width and the upper limit must also
@@ -1665,6 +1778,12 @@ Long64_t TH3::Merge(TCollection *list)
             (*next)->ClassName(),this->ClassName());
       return -1;
    }
+
+   // all histograms have the same binning: add the bins directly (in parallel if possible)
+   if (allSameLimits && allHaveLimits) {
+      Double_t nentries = 0;
+      if (MergeSameBinning(&inlist, nentries)) return (Long64_t)nentries;
+   }
    next.Reset();
 
    // In the case of histogram with different limits
@@ -4308,6 +4427,18 @@ void TH3F::Copy(TObject &newth3) const
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Increment the content of the bins bins[0..n-1] by w[0], w[stride], ...
+
+void TH3F::DoAddBinContents(Int_t n, const Int_t *bins, const Double_t *w, Int_t stride)
+{
+   if (w) {
+      for (Int_t i = 0; i < n; ++i) fArray[bins[i]] += Float_t (w[i*stride]);
+   } else {
+      for (Int_t i = 0; i < n; ++i) ++fArray[bins[i]];
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Reset this histogram: contents, errors, etc.
 
@@ -4519,6 +4650,18 @@ void TH3D::Copy(TObject &newth3) const
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Increment the content of the bins bins[0..n-1] by w[0], w[stride], ...
+
+void TH3D::DoAddBinContents(Int_t n, const Int_t *bins, const Double_t *w, Int_t stride)
+{
+   if (w) {
+      for (Int_t i = 0; i < n; ++i) fArray[bins[i]] += Double_t (w[i*stride]);
+   } else {
+      for (Int_t i = 0; i < n; ++i) ++fArray[bins[i]];
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Reset this histogram: contents, errors, etc.
 
@@ -4643,3 +4786,194 @@ TH3D operator/(TH3D &h1, TH3D &h2)
    hnew.SetDirectory(0);
    return hnew;
 }
+
+
+//______________________________________________________________________________
+//                     TH3U methods
+//  TH3U a 3-D histogram with two bytes per cell (16 bits counter), promoted to double on overflow
+//______________________________________________________________________________
+
+ClassImp(TH3U)
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Constructor.
+
+TH3U::TH3U(): TH3(), TArrayCounts()
+{
+   SetBinsLength(27);
+   if (fgDefaultSumw2) Sumw2();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor.
+
+TH3U::~TH3U()
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Normal constructor for fix bin size 3-D histograms.
+
+TH3U::TH3U(const char *name,const char *title,Int_t nbinsx,Double_t xlow,Double_t xup
+           ,Int_t nbinsy,Double_t ylow,Double_t yup
+           ,Int_t nbinsz,Double_t zlow,Double_t zup)
+           :TH3(name,title,nbinsx,xlow,xup,nbinsy,ylow,yup,nbinsz,zlow,zup)
+{
+   TArrayCounts::Set(fNcells);
+   if (fgDefaultSumw2) Sumw2();
+
+   if (xlow >= xup || ylow >= yup || zlow >= zup) SetBuffer(fgBufferSize);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Normal constructor for variable bin size 3-D histograms.
+
+TH3U::TH3U(const char *name,const char *title,Int_t nbinsx,const Float_t *xbins
+           ,Int_t nbinsy,const Float_t *ybins
+           ,Int_t nbinsz,const Float_t *zbins)
+           :TH3(name,title,nbinsx,xbins,nbinsy,ybins,nbinsz,zbins)
+{
+   TArrayCounts::Set(fNcells);
+   if (fgDefaultSumw2) Sumw2();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Normal constructor for variable bin size 3-D histograms.
+
+TH3U::TH3U(const char *name,const char *title,Int_t nbinsx,const Double_t *xbins
+           ,Int_t nbinsy,const Double_t *ybins
+           ,Int_t nbinsz,const Double_t *zbins)
+           :TH3(name,title,nbinsx,xbins,nbinsy,ybins,nbinsz,zbins)
+{
+   TArrayCounts::Set(fNcells);
+   if (fgDefaultSumw2) Sumw2();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy constructor.
+
+TH3U::TH3U(const TH3U &h3u) : TH3(), TArrayCounts()
+{
+   ((TH3U&)h3u).Copy(*this);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Increment the content of n bins at once, see TH1::DoAddBinContents.
+
+void TH3U::DoAddBinContents(Int_t n, const Int_t *bins, const Double_t *w, Int_t stride)
+{
+   if (w) {
+      for (Int_t i = 0; i < n; ++i) Increment(bins[i], w[i*stride]);
+   } else {
+      for (Int_t i = 0; i < n; ++i) Increment(bins[i]);
+   }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy this 3-D histogram structure to newth3.
+
+void TH3U::Copy(TObject &newth3) const
+{
+   TH3::Copy((TH3U&)newth3);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Reset this histogram: contents, errors, etc.
+
+void TH3U::Reset(Option_t *option)
+{
+   TH3::Reset(option);
+   TArrayCounts::Reset();
+   // should also reset statistics once statistics are implemented for TH3
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set total number of bins including under/overflow
+/// Reallocate bin contents array
+
+void TH3U::SetBinsLength(Int_t n)
+{
+   if (n < 0) n = (fXaxis.GetNbins()+2)*(fYaxis.GetNbins()+2)*(fZaxis.GetNbins()+2);
+   fNcells = n;
+   TArrayCounts::Set(n);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Operator =
+
+TH3U& TH3U::operator=(const TH3U &h1)
+{
+   if (this != &h1)  ((TH3U&)h1).Copy(*this);
+   return *this;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Operator *
+
+TH3U operator*(Float_t c1, TH3U &h1)
+{
+   TH3U hnew = h1;
+   hnew.Scale(c1);
+   hnew.SetDirectory(0);
+   return hnew;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Operator +
+
+TH3U operator+(TH3U &h1, TH3U &h2)
+{
+   TH3U hnew = h1;
+   hnew.Add(&h2,1);
+   hnew.SetDirectory(0);
+   return hnew;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Operator _
+
+TH3U operator-(TH3U &h1, TH3U &h2)
+{
+   TH3U hnew = h1;
+   hnew.Add(&h2,-1);
+   hnew.SetDirectory(0);
+   return hnew;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Operator *
+
+TH3U operator*(TH3U &h1, TH3U &h2)
+{
+   TH3U hnew = h1;
+   hnew.Multiply(&h2);
+   hnew.SetDirectory(0);
+   return hnew;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Operator /
+
+TH3U operator/(TH3U &h1, TH3U &h2)
+{
+   TH3U hnew = h1;
+   hnew.Divide(&h2);
+   hnew.SetDirectory(0);
+   return hnew;
+}
@@ -13,6 +13,12 @@
 
 #include "TClass.h"
 
+#ifdef R__USE_IMT
+#include "TROOT.h"
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#endif
+
 namespace {
    //______________________________________________________________________________
    //
@@ -222,6 +228,52 @@ void THn::Sumw2() {
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Add c * h to this histogram, if h is a THn with the same binning: the
+/// bins with the same linear index are added, without computing their
+/// coordinates. Large histograms are split into ranges of bins added by
+/// different threads if implicit multithreading is enabled (see
+/// ROOT::EnableImplicitMT).
+
+Bool_t THn::AddSameBinning(const THnBase* h, Double_t c)
+{
+   const THn* hn = dynamic_cast<const THn*>(h);
+   if (!hn || hn == this || hn->GetNbins() != GetNbins())
+      return kFALSE;
+
+   const Bool_t haveErrors = GetCalculateErrors();
+   TNDArray& content = GetArray();
+   const TNDArray& hcontent = hn->GetArray();
+   const Long64_t nbins = GetNbins();
+   if (!nbins)
+      return kTRUE;
+   // allocate the (lazily allocated) arrays before the threads write to them
+   content.AddAt(0, 0.);
+   if (haveErrors) fSumw2.AddAt(0, 0.);
+
+   auto addBins = [&](Long64_t first, Long64_t last) {
+      for (Long64_t ibin = first; ibin < last; ++ibin) {
+         const Double_t v = hcontent.AtAsDouble(ibin);
+         if (haveErrors)
+            fSumw2.At(ibin) += c * c * hn->GetBinError2(ibin);
+         if (v != 0.)
+            content.AddAt(ibin, c * v);
+      }
+   };
+
+#ifdef R__USE_IMT
+   // number of bins added by a thread at a time
+   const Long64_t kAddGrain = 1 << 16;
+   if (ROOT::IsImplicitMTEnabled() && nbins >= 4 * kAddGrain) {
+      tbb::parallel_for(tbb::blocked_range<Long64_t>(0, nbins, kAddGrain),
+                        [&](const tbb::blocked_range<Long64_t>& r) { addBins(r.begin(), r.end()); });
+      return kTRUE;
+   }
+#endif
+   addBins(0, nbins);
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Create the coordinate buffer. Outlined to hide allocation
 /// from inlined functions.
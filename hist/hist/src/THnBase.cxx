@@ -385,6 +385,20 @@ TFitResultPtr THnBase::Fit(TF1 *f ,Option_t *option ,Option_t *goption)
    return ROOT::Fit::FitObject(this, f , fitOption , minOption, goption, range);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the histogram with the "n" n-dimensional points stored one after the
+/// other in "x", i.e. point i is x[i * GetNdimensions()], ...,
+/// x[i * GetNdimensions() + GetNdimensions() - 1]. The weight of point i is
+/// w[i], or 1 if w is null.
+/// The result is the same as calling Fill() for each point; derived classes
+/// can provide a faster implementation.
+
+void THnBase::FillN(Long64_t n, const Double_t* x, const Double_t* w /*= 0*/)
+{
+   for (Long64_t i = 0; i < n; ++i)
+      Fill(x + i * fNdimensions, w ? w[i] : 1.);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Generate an n-dimensional random tuple based on the histogrammed
 /// distribution. If subBinRandom, the returned tuple will be additionally
@@ -643,16 +657,22 @@ void THnBase::AddInternal(const THnBase* h, Double_t c, Bool_t rebinned)
       Sumw2();
    Bool_t haveErrors = GetCalculateErrors();
 
+   // Expand the bin index if needed, to reduce collisions
+   Long64_t numTargetBins = GetNbins() + h->GetNbins();
+   Reserve(numTargetBins);
+
+   // Let the storage add the bins of an identically binned histogram directly
+   if (!rebinned && AddSameBinning(h, c)) {
+      SetEntries(GetEntries() + c * h->GetEntries());
+      return;
+   }
+
    Double_t* x = 0;
    if (rebinned) {
       x = new Double_t[fNdimensions];
    }
    Int_t* coord = new Int_t[fNdimensions];
 
-   // Expand the exmap if needed, to reduce collisions
-   Long64_t numTargetBins = GetNbins() + h->GetNbins();
-   Reserve(numTargetBins);
-
    Long64_t i = 0;
    THnIter iter(h);
    // Add to this whatever is found inside the other histogram
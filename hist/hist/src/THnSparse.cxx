@@ -271,9 +271,9 @@ ULong64_t THnSparseCoordCompression::GetHashFromCoords(const Int_t* coord) const
 {
    // Bins are addressed in two different modes, depending
    // on whether the compact bin index fits into a Long64_t or not.
-   // If it does, we can use it as a "perfect hash" for the TExMap.
+   // If it does, we can use it as a "perfect hash" for the bin table.
    // If not we build a hash from the compact bin index, and use that
-   // as the TExMap's hash.
+   // as the bin table's hash.
 
    if (fCoordBufferSize <= 8) {
       // fits into a Long64_t
@@ -319,9 +319,9 @@ ULong64_t THnSparseCoordCompression::GetHashFromBuffer(const Char_t* buf) const
 {
    // Bins are addressed in two different modes, depending
    // on whether the compact bin index fits into a Long64_t or not.
-   // If it does, we can use it as a "perfect hash" for the TExMap.
+   // If it does, we can use it as a "perfect hash" for the bin table.
    // If not we build a hash from the compact bin index, and use that
-   // as the TExMap's hash.
+   // as the bin table's hash.
 
    if (fCoordBufferSize <= 8) {
       // fits into a Long64_t
@@ -571,14 +571,14 @@ Translation from an n-dimensional bin coordinate to the linear index within
 the chunks is done by GetBin(). It creates a hash from the compacted bin
 coordinates (the hash of a bin coordinate is the compacted coordinate itself
 if it takes less than 8 bytes, the size of a Long64_t.
-This hash is used to lookup the linear index in the TExMap member fBins;
-the coordinates of the entry fBins points to is compared to the coordinates
-passed to GetBin(). If they do not match, these two coordinates have the same
-hash - which is extremely unlikely but (for the case where the compact bin
-coordinates are larger than 4 bytes) possible. In this case, fBinsContinued
-contains a chain of linear indexes with the same hash. Iterating through this
-chain and comparing each bin coordinates with the one passed to GetBin() will
-retrieve the matching bin.
+This hash is used to lookup the linear index in the open-addressing table
+fBinTable, which stores pairs of hash and linear index next to each other.
+The search starts at a slot derived from the hash and visits the following
+slots until an empty one is found; for each slot with the same hash, the
+coordinates of the bin it points to are compared to the coordinates passed
+to GetBin(). Different coordinates can only have the same hash if the compact
+bin coordinates are larger than 8 bytes. The table is transient: it is
+rebuilt from the chunks when the histogram is read from a file.
 */
 
 
@@ -588,7 +588,7 @@ ClassImp(THnSparse);
 /// Construct an empty THnSparse.
 
 THnSparse::THnSparse():
-   fChunkSize(1024), fFilledBins(0), fCompactCoord(0)
+   fChunkSize(1024), fFilledBins(0), fBinTableBits(0), fCompactCoord(0)
 {
    fBinContent.SetOwner();
 }
@@ -605,7 +605,7 @@ THnSparse::THnSparse(const char* name, const char* title, Int_t dim,
                      const Int_t* nbins, const Double_t* xmin, const Double_t* xmax,
                      Int_t chunksize):
    THnBase(name, title, dim, nbins, xmin, xmax),
-   fChunkSize(chunksize), fFilledBins(0), fCompactCoord(0)
+   fChunkSize(chunksize), fFilledBins(0), fBinTableBits(0), fCompactCoord(0)
 {
    fCompactCoord = new THnSparseCompactBinCoord(dim, nbins);
    fBinContent.SetOwner();
@@ -629,6 +629,56 @@ void THnSparse::AddBinContent(Long64_t bin, Double_t v)
    return chunk->fContent->SetAt(v, bin);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Add c * h to this histogram, if h is a THnSparse with the same binning.
+/// The compact coordinates of h's bins are used as they are: no conversion
+/// to and from the bin coordinates is needed.
+
+Bool_t THnSparse::AddSameBinning(const THnBase* h, Double_t c)
+{
+   const THnSparse* hs = dynamic_cast<const THnSparse*>(h);
+   if (!hs || hs == this)
+      return kFALSE;
+   THnSparseCompactBinCoord* cc = GetCompactCoord();
+   if (cc->GetBufferSize() != hs->GetCompactCoord()->GetBufferSize())
+      return kFALSE;
+
+   const Bool_t haveErrors = GetCalculateErrors();
+   const Int_t nchunks = hs->GetNChunks();
+   for (Int_t ichunk = 0; ichunk < nchunks; ++ichunk) {
+      const THnSparseArrayChunk* chunk = hs->GetChunk(ichunk);
+      const Int_t nentries = chunk->GetEntries();
+      const Int_t singleCoordSize = chunk->fSingleCoordinateSize;
+      for (Int_t i = 0; i < nentries; ++i) {
+         cc->SetBuffer(chunk->fCoordinates + i * singleCoordSize);
+         const Long64_t bin = GetBinIndexForCurrentBin(kTRUE);
+         THnSparseArrayChunk* target = GetChunk(bin / fChunkSize);
+         const Int_t idx = bin % fChunkSize;
+         const Double_t v = chunk->fContent->GetAt(i);
+         if (haveErrors) {
+            const Double_t err2 = chunk->fSumw2 ? chunk->fSumw2->GetAt(i) : v;
+            (*target->fSumw2)[idx] += c * c * err2;
+         }
+         target->fContent->SetAt(target->fContent->GetAt(idx) + c * v, idx);
+      }
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Store the linear index "idx" for "hash" in the first empty slot of the
+/// bin table. The table must have room for it, see ReserveBinTable().
+
+void THnSparse::AddToBinTable(ULong64_t hash, Long64_t idx)
+{
+   const ULong64_t mask = (1ULL << fBinTableBits) - 1;
+   ULong64_t slot = GetBinTableSlot(hash);
+   while (fBinTable[2 * slot + 1])
+      slot = (slot + 1) & mask;
+   fBinTable[2 * slot] = (Long64_t) hash;
+   fBinTable[2 * slot + 1] = idx + 1; // 0 marks an empty slot
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Create a new chunk of bin content
 
@@ -651,35 +701,56 @@ void THnSparse::InitStorage(Int_t* nbins, Int_t chunkSize)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-///We have been streamed; set up fBins
+///We have been streamed; set up fBinTable
 
-void THnSparse::FillExMap()
+void THnSparse::FillBinTable()
 {
    TIter iChunk(&fBinContent);
    THnSparseArrayChunk* chunk = 0;
    THnSparseCoordCompression compactCoord(*GetCompactCoord());
    Long64_t idx = 0;
-   if (2 * GetNbins() > fBins.Capacity())
-      fBins.Expand(3 * GetNbins());
+   ReserveBinTable(GetNbins());
    while ((chunk = (THnSparseArrayChunk*) iChunk())) {
       const Int_t chunkSize = chunk->GetEntries();
       Char_t* buf = chunk->fCoordinates;
       const Int_t singleCoordSize = chunk->fSingleCoordinateSize;
       const Char_t* endbuf = buf + singleCoordSize * chunkSize;
-      for (; buf < endbuf; buf += singleCoordSize, ++idx) {
-         Long64_t hash = compactCoord.GetHashFromBuffer(buf);
-         Long64_t linidx = fBins.GetValue(hash);
-         if (linidx) {
-            Long64_t nextidx = linidx;
-            while (nextidx) {
-               // must be a collision, so go to fBinsContinued.
-               linidx = nextidx;
-               nextidx = fBinsContinued.GetValue(linidx);
-            }
-            fBinsContinued.Add(linidx, idx + 1);
-         } else {
-            fBins.Add(hash, idx + 1);
-         }
+      for (; buf < endbuf; buf += singleCoordSize, ++idx)
+         AddToBinTable(compactCoord.GetHashFromBuffer(buf), idx);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the histogram with the "n" n-dimensional points stored one after the
+/// other in "x", with weights "w" (or 1 if w is null); see THnBase::FillN().
+/// Unless an axis can be extended, the bins are found for a block of points
+/// at a time, one axis after the other, using TAxis::FindFixBins().
+
+void THnSparse::FillN(Long64_t n, const Double_t* x, const Double_t* w /*= 0*/)
+{
+   for (Int_t d = 0; d < fNdimensions; ++d) {
+      if (GetAxis(d)->CanExtend()) {
+         THnBase::FillN(n, x, w);
+         return;
+      }
+   }
+
+   const Int_t kBlock = 512;
+   std::vector<Int_t> bins(kBlock * fNdimensions);
+   THnSparseCompactBinCoord* cc = GetCompactCoord();
+   Int_t* coord = cc->GetCoord();
+   for (Long64_t first = 0; first < n; first += kBlock) {
+      const Int_t nblock = (Int_t) TMath::Min((Long64_t) kBlock, n - first);
+      const Double_t* xblock = x + first * fNdimensions;
+      for (Int_t d = 0; d < fNdimensions; ++d)
+         GetAxis(d)->FindFixBins(nblock, xblock + d, &bins[d * kBlock], fNdimensions);
+      for (Int_t i = 0; i < nblock; ++i) {
+         for (Int_t d = 0; d < fNdimensions; ++d)
+            coord[d] = bins[d * kBlock + i];
+         cc->UpdateCoord();
+         const Double_t wi = w ? w[first + i] : 1.;
+         UpdateXStat(xblock + i * fNdimensions, wi);
+         FillBin(GetBinIndexForCurrentBin(kTRUE), wi);
       }
    }
 }
@@ -688,11 +759,31 @@ void THnSparse::FillExMap()
 /// Initialize storage for nbins
 
 void THnSparse::Reserve(Long64_t nbins) {
-   if (!fBins.GetSize() && fBinContent.GetSize()) {
-      FillExMap();
+   if (fBinTable.empty() && fBinContent.GetEntriesFast()) {
+      FillBinTable();
    }
-   if (2 * nbins > fBins.Capacity()) {
-      fBins.Expand(3 * nbins);
+   ReserveBinTable(nbins);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Make room in the bin table for "nbins" bins, keeping the fraction of used
+/// slots below 70% such that searches stay short. Existing entries are moved
+/// to their slot in the enlarged table.
+
+void THnSparse::ReserveBinTable(Long64_t nbins) {
+   Int_t bits = 4;
+   while (10 * nbins > 7 * (1LL << bits))
+      ++bits;
+   if (!fBinTable.empty() && bits <= fBinTableBits)
+      return;
+
+   std::vector<Long64_t> oldTable;
+   oldTable.swap(fBinTable);
+   fBinTableBits = bits;
+   fBinTable.assign(2 * (1LL << bits), 0);
+   for (size_t i = 0; i < oldTable.size(); i += 2) {
+      if (oldTable[i + 1])
+         AddToBinTable(oldTable[i], oldTable[i + 1] - 1);
    }
 }
 
@@ -791,23 +882,25 @@ Long64_t THnSparse::GetBinIndexForCurrentBin(Bool_t allocate)
 {
    THnSparseCompactBinCoord* cc = GetCompactCoord();
    ULong64_t hash = cc->GetHash();
-   if (fBinContent.GetSize() && !fBins.GetSize())
-      FillExMap();
-   Long64_t linidx = (Long64_t) fBins.GetValue(hash);
-   while (linidx) {
-      // fBins stores index + 1!
-      THnSparseArrayChunk* chunk = GetChunk((linidx - 1)/ fChunkSize);
-      if (chunk->Matches((linidx - 1) % fChunkSize, cc->GetBuffer()))
-         return linidx - 1; // we store idx+1, 0 is "TExMap: not found"
-
-      Long64_t nextlinidx = fBinsContinued.GetValue(linidx);
-      if (!nextlinidx) break;
-
-      linidx = nextlinidx;
+   if (fBinContent.GetEntriesFast() && fBinTable.empty())
+      FillBinTable();
+   if (!fBinTable.empty()) {
+      const ULong64_t mask = (1ULL << fBinTableBits) - 1;
+      for (ULong64_t slot = GetBinTableSlot(hash); ; slot = (slot + 1) & mask) {
+         // fBinTable stores index + 1, 0 is "empty slot: not found"
+         const Long64_t linidx = fBinTable[2 * slot + 1];
+         if (!linidx) break;
+         if ((ULong64_t) fBinTable[2 * slot] != hash) continue;
+         THnSparseArrayChunk* chunk = GetChunk((linidx - 1)/ fChunkSize);
+         if (chunk->Matches((linidx - 1) % fChunkSize, cc->GetBuffer()))
+            return linidx - 1;
+      }
    }
    if (!allocate) return -1;
 
    ++fFilledBins;
+   if (fBinTable.empty() || 10 * fFilledBins > 7 * (1LL << fBinTableBits))
+      ReserveBinTable(fFilledBins);
 
    // allocate bin in chunk
    THnSparseArrayChunk *chunk = (THnSparseArrayChunk*) fBinContent.Last();
@@ -820,16 +913,7 @@ Long64_t THnSparse::GetBinIndexForCurrentBin(Bool_t allocate)
 
    // store translation between hash and bin
    newidx += (fBinContent.GetEntriesFast() - 1) * fChunkSize;
-   if (!linidx) {
-      // fBins didn't find it
-      if (2 * GetNbins() > fBins.Capacity())
-         fBins.Expand(3 * GetNbins());
-      fBins.Add(hash, newidx + 1);
-   } else {
-      // fBins contains one, but it's the wrong one;
-      // add entry to fBinsContinued.
-      fBinsContinued.Add(linidx, newidx + 1);
-   }
+   AddToBinTable(hash, newidx);
    return newidx;
 }
 
@@ -881,7 +965,7 @@ Double_t THnSparse::GetSparseFractionMem() const {
 
    Double_t size = 0.;
    size += fBinContent.GetEntries() * (GetChunkSize() * sizePerChunkElement + sizeof(THnSparseArrayChunk));
-   size += + 3 * sizeof(Long64_t) * fBins.GetSize() /* TExMap */;
+   size += sizeof(Long64_t) * fBinTable.size() /* bin table */;
 
    Double_t nbinsTotal = 1.;
    for (Int_t d = 0; d < fNdimensions; ++d)
@@ -963,8 +1047,8 @@ void THnSparse::Sumw2()
 void THnSparse::Reset(Option_t *option /*= ""*/)
 {
    fFilledBins = 0;
-   fBins.Delete();
-   fBinsContinued.Clear();
+   std::vector<Long64_t>().swap(fBinTable);
+   fBinTableBits = 0;
    fBinContent.Delete();
    ResetBase(option);
 }
@@ -22,6 +22,19 @@
  
  The algorithm is briefly described in (4). A binned version is also implemented to address the 
  performance issue due to its data size dependance.
+
+ By default each evaluation of the estimate sums the kernel over all data points (or bins).
+ For large data sets, SetEvaluation() selects a faster, approximate evaluation, for the
+ predefined kernels:
+  - TKDE::kTruncatedEvaluation: the data points are sorted once; an evaluation only sums over
+    the points within the kernel support. For the Gaussian kernel the support is truncated where
+    the kernel falls below the given tolerance times its maximum.
+  - TKDE::kBinnedEvaluation: the kernel sum is computed once on a regular grid and evaluations
+    interpolate linearly between grid points. For a fixed bandwidth, the data are binned linearly
+    on the grid and convolved with the kernel using TVirtualFFT (fftw), or directly if no FFT
+    plugin is available; for adaptive bandwidths, the grid is filled with the truncated sums.
+ In both cases the pilot estimate used to compute the adaptive bandwidths is evaluated the
+ same way. GetValues() evaluates the estimate at many points at once.
  */
 
 
@@ -41,6 +54,9 @@
 #include "TF1.h"
 #include "TH1.h"
 #include "TCanvas.h"
+#include "TVirtualFFT.h"
+#include "TROOT.h"
+#include "TPluginManager.h"
 #include "TKDE.h"
 
 
@@ -50,6 +66,24 @@ class TKDE::TKernel {
    TKDE* fKDE;
    UInt_t fNWeights; // Number of kernel weights (bandwidth as vectorized for binning)
    std::vector<Double_t> fWeights; // Kernel weights (bandwidth)
+   // Caches of the approximate evaluations, see TKDE::SetEvaluation()
+   mutable Bool_t fSorted;                       // Whether the sorted data below are set
+   mutable std::vector<Double_t> fSortedData;    // Data points with non-zero count, in increasing order
+   mutable std::vector<Double_t> fSortedCounts;  // Counts of the sorted data points
+   mutable std::vector<Double_t> fSortedWeights; // Bandwidths of the sorted data points
+   mutable Double_t fMaxWeight;                  // Largest bandwidth
+   mutable std::vector<Double_t> fGrid;          // Kernel sums on a regular grid
+   mutable Double_t fGridXMin;                   // Position of the first grid point
+   mutable Double_t fGridStep;                   // Distance between grid points
+   Double_t GetKernelRange() const;
+   void SortData() const;
+   void FillGrid() const;
+   void ConvolveOnGrid(Double_t weight) const;
+   Double_t GetSortedSum(Double_t x) const;
+   Double_t GetGridSum(Double_t x) const;
+   Double_t GetSum(Double_t x) const {
+      return (fKDE->fEvaluation == kBinnedEvaluation) ? GetGridSum(x) : GetSortedSum(x);
+   }
 public:
    TKernel(Double_t weight, TKDE* kde);
    void ComputeAdaptiveWeights();
@@ -130,6 +164,9 @@ void TKDE::Instantiate(KernelFunction_Ptr kernfunc, UInt_t events, const Double_
    fNBins = events < 10000 ? 100 : events / 10;
    fNEvents = events;
    fUseBinsNEvents = 10000;
+   fEvaluation = kExactEvaluation;
+   fEvaluationNPoints = 0;
+   fEvaluationTolerance = 1.E-6;
    fMean = 0.0;
    fSigma = 0.0;
    fXMin = xMin;
@@ -413,6 +450,26 @@ void TKDE::SetRange(Double_t xMin, Double_t xMax) {
    SetKernel();
 }
 
+void TKDE::SetEvaluation(EEvaluation eval, Double_t tolerance, UInt_t npoints) {
+   // Sets how the density estimate is evaluated, see the class description.
+   // tolerance: for the Gaussian kernel, contributions of data points where the kernel is below
+   //            tolerance times its maximum are neglected by the approximate evaluations
+   // npoints: number of grid points of the binned evaluation; by default (0) the grid step is
+   //          an eighth of the smallest bandwidth, with between 256 and 65536 points
+   if (tolerance <= 0. || tolerance >= 1.) {
+      Error("SetEvaluation", "The tolerance must be between 0 and 1. Present evaluation remains the same.");
+      return;
+   }
+   if (eval != kExactEvaluation && fKernelType == kUserDefined) {
+      Warning("SetEvaluation", "Approximate evaluations need a predefined kernel: using the exact evaluation.");
+      eval = kExactEvaluation;
+   }
+   fEvaluation = eval;
+   fEvaluationTolerance = tolerance;
+   fEvaluationNPoints = npoints;
+   SetKernel();
+}
+
 // private methods
 
 void TKDE::SetUseBins() {
@@ -672,6 +729,14 @@ Double_t TKDE::operator()(Double_t x) const {
    return (*fKernel)(x);
 }
 
+void TKDE::GetValues(UInt_t n, const Double_t* x, Double_t* y) const {
+   // Sets y[i] to the kernel density estimate at x[i], for i from 0 to n-1
+   if (fNewData) (const_cast<TKDE*>(this))->InitFromNewData();
+   for (UInt_t i = 0; i < n; ++i) {
+      y[i] = (*fKernel)(x[i]);
+   }
+}
+
 Double_t TKDE::GetMean() const {
    // return the mean of the data
    if (fNewData) (const_cast<TKDE*>(this))->InitFromNewData();
@@ -694,7 +759,11 @@ TKDE::TKernel::TKernel(Double_t weight, TKDE* kde) :
 // Internal class constructor
 fKDE(kde),
 fNWeights(kde->fData.size()),
-fWeights(fNWeights, weight)
+fWeights(fNWeights, weight),
+fSorted(kFALSE),
+fMaxWeight(0.),
+fGridXMin(0.),
+fGridStep(0.)
 {}
 
 void TKDE::TKernel::ComputeAdaptiveWeights() {
@@ -719,6 +788,9 @@ void TKDE::TKernel::ComputeAdaptiveWeights() {
    Double_t kAPPROX_GEO_MEAN = 0.241970724519143365; // 1 / TMath::Power(2 * TMath::Pi(), .5) * TMath::Exp(-.5). Approximated geometric mean over pointwise data (the KDE function is substituted by the "real Gaussian" pdf) and proportional to sigma. Used directly when the mirroring is enabled, otherwise computed from the data
    fKDE->fAdaptiveBandwidthFactor = fKDE->fUseMirroring ? kAPPROX_GEO_MEAN / fKDE->fSigmaRob : std::sqrt(std::exp(fKDE->fAdaptiveBandwidthFactor / fKDE->fData.size()));
    transform(weights.begin(), weights.end(), fWeights.begin(), std::bind2nd(std::multiplies<Double_t>(), fKDE->fAdaptiveBandwidthFactor));
+   // the caches of the approximate evaluations refer to the pilot bandwidths
+   fSorted = kFALSE;
+   fGrid.clear();
    //printf("adaptive bandwidth factor % f weight 0 %f , %f \n",fKDE->fAdaptiveBandwidthFactor, weights[0],fWeights[0] );
 }
 
@@ -909,6 +981,20 @@ Double_t TKDE::TKernel::operator()(Double_t x) const {
    // case of bins or weighted data 
    Bool_t useBins = (fKDE->fBinCount.size() == n);
    Double_t nSum = (useBins) ? fKDE->fSumOfCounts : fKDE->fNEvents;
+   if (fKDE->fEvaluation != kExactEvaluation && fKDE->fKernelType != kUserDefined) {
+      // the kernels are symmetric: the asymmetric mirror terms are sums at the mirrored position
+      result = GetSum(x);
+      if (fKDE->fAsymLeft) {
+         result -= GetSum(2. * fKDE->fXMin - x);
+      }
+      if (fKDE->fAsymRight) {
+         result -= GetSum(2. * fKDE->fXMax - x);
+      }
+      if ( TMath::IsNaN(result) ) {
+         fKDE->Warning("operator()","Result is NaN for  x %f \n",x);
+      }
+      return result / nSum;
+   }
    // double dmin = 1.E10;
    // double xmin,bmin,wmin; 
    for (UInt_t i = 0; i < n; ++i) {
@@ -941,6 +1027,153 @@ Double_t TKDE::TKernel::operator()(Double_t x) const {
    return result / nSum;
 }
 
+Double_t TKDE::TKernel::GetKernelRange() const {
+   // Returns the distance from the centre, in units of the bandwidth, beyond which the
+   // kernel is neglected by the approximate evaluations
+   if (fKDE->fKernelType == kGaussian) {
+      // GaussianKernel() itself is zero beyond 9
+      return std::min(9., std::sqrt(-2. * std::log(fKDE->fEvaluationTolerance)));
+   }
+   return 1.;
+}
+
+void TKDE::TKernel::SortData() const {
+   // Sorts the data points with their counts and bandwidths, for the approximate evaluations
+   UInt_t n = fKDE->fData.size();
+   Bool_t useBins = (fKDE->fBinCount.size() == n);
+   std::vector<UInt_t> order;
+   order.reserve(n);
+   for (UInt_t i = 0; i < n; ++i) {
+      if (!useBins || fKDE->fBinCount[i] != 0) order.push_back(i);
+   }
+   const std::vector<Double_t>& data = fKDE->fData;
+   std::sort(order.begin(), order.end(), [&data](UInt_t i, UInt_t j) { return data[i] < data[j]; });
+   fSortedData.resize(order.size());
+   fSortedCounts.resize(order.size());
+   fSortedWeights.resize(order.size());
+   fMaxWeight = 0.;
+   for (UInt_t k = 0; k < order.size(); ++k) {
+      fSortedData[k] = data[order[k]];
+      fSortedCounts[k] = useBins ? fKDE->fBinCount[order[k]] : 1.0;
+      fSortedWeights[k] = fWeights[order[k]];
+      fMaxWeight = std::max(fMaxWeight, fSortedWeights[k]);
+   }
+   fSorted = kTRUE;
+}
+
+Double_t TKDE::TKernel::GetSortedSum(Double_t x) const {
+   // Returns the sum of the kernels of the data points within reach of x
+   if (!fSorted) SortData();
+   const Double_t reach = GetKernelRange() * fMaxWeight;
+   const std::vector<Double_t>& data = fSortedData;
+   std::vector<Double_t>::const_iterator first = std::lower_bound(data.begin(), data.end(), x - reach);
+   std::vector<Double_t>::const_iterator last = std::upper_bound(first, data.end(), x + reach);
+   Double_t result = 0.;
+   for (UInt_t i = first - data.begin(); i < UInt_t(last - data.begin()); ++i) {
+      const Double_t weight = fSortedWeights[i];
+      result += fSortedCounts[i] / weight * (*fKDE->fKernelFunction)((x - fSortedData[i]) / weight);
+   }
+   return result;
+}
+
+Double_t TKDE::TKernel::GetGridSum(Double_t x) const {
+   // Returns the sum of the kernels at x, interpolated linearly on the grid
+   if (fGrid.empty()) FillGrid();
+   const Int_t npoints = fGrid.size();
+   const Double_t t = (x - fGridXMin) / fGridStep;
+   if (npoints < 2 || !(t >= 0.) || t > npoints - 1) {
+      // no data within reach of x
+      return GetSortedSum(x);
+   }
+   Int_t j = Int_t(t);
+   if (j >= npoints - 1) j = npoints - 2;
+   const Double_t f = t - j;
+   return (1. - f) * fGrid[j] + f * fGrid[j + 1];
+}
+
+void TKDE::TKernel::FillGrid() const {
+   // Computes the kernel sums on a regular grid covering the reach of all data points
+   if (!fSorted) SortData();
+   if (fSortedData.empty()) return;
+   const Double_t reach = GetKernelRange() * fMaxWeight;
+   const Double_t minWeight = *std::min_element(fSortedWeights.begin(), fSortedWeights.end());
+   fGridXMin = fSortedData.front() - reach;
+   const Double_t xmax = fSortedData.back() + reach;
+   Double_t npoints = fKDE->fEvaluationNPoints;
+   if (npoints < 2) {
+      npoints = std::min(65536., std::max(256., std::ceil(8. * (xmax - fGridXMin) / minWeight) + 1.));
+   }
+   fGrid.assign(UInt_t(npoints), 0.);
+   fGridStep = (xmax - fGridXMin) / (npoints - 1.);
+   if (minWeight == fMaxWeight) {
+      ConvolveOnGrid(minWeight);
+   } else {
+      for (UInt_t i = 0; i < fGrid.size(); ++i) {
+         fGrid[i] = GetSortedSum(fGridXMin + i * fGridStep);
+      }
+   }
+}
+
+void TKDE::TKernel::ConvolveOnGrid(Double_t weight) const {
+   // Computes the kernel sums on the grid for the fixed bandwidth "weight": the data counts are
+   // binned linearly on the grid, then convolved with the kernel sampled at the grid step
+   Int_t npoints = fGrid.size();
+   std::vector<Double_t> counts(npoints, 0.);
+   for (UInt_t k = 0; k < fSortedData.size(); ++k) {
+      const Double_t t = (fSortedData[k] - fGridXMin) / fGridStep;
+      Int_t j = std::min(Int_t(t), npoints - 2);
+      const Double_t f = t - j;
+      counts[j] += (1. - f) * fSortedCounts[k];
+      counts[j + 1] += f * fSortedCounts[k];
+   }
+   const Int_t range = std::min(npoints - 1, Int_t(GetKernelRange() * weight / fGridStep) + 1);
+   std::vector<Double_t> kernel(range + 1);
+   for (Int_t m = 0; m <= range; ++m) {
+      kernel[m] = (*fKDE->fKernelFunction)(m * fGridStep / weight) / weight;
+   }
+
+   // FFT of a zero padded length without wrap-around of the kernel over the grid
+   Int_t nfft = 1;
+   while (nfft < npoints + range) nfft *= 2;
+   // look for the plugin first, TVirtualFFT::FFT reports an error when it is missing
+   TPluginHandler* h = gROOT->GetPluginManager()->FindHandler("TVirtualFFT");
+   const Bool_t hasFFT = h && h->LoadPlugin() != -1;
+   TVirtualFFT* fftCounts = hasFFT ? TVirtualFFT::FFT(1, &nfft, "R2C K") : 0;
+   TVirtualFFT* fftKernel = fftCounts ? TVirtualFFT::FFT(1, &nfft, "R2C K") : 0;
+   TVirtualFFT* fftInverse = fftKernel ? TVirtualFFT::FFT(1, &nfft, "C2R K") : 0;
+   if (fftInverse) {
+      for (Int_t i = 0; i < nfft; ++i) {
+         fftCounts->SetPoint(i, i < npoints ? counts[i] : 0.);
+         Int_t m = (i <= nfft / 2) ? i : nfft - i;
+         fftKernel->SetPoint(i, m <= range ? kernel[m] : 0.);
+      }
+      fftCounts->Transform();
+      fftKernel->Transform();
+      Double_t re1, im1, re2, im2;
+      for (Int_t i = 0; i <= nfft / 2; ++i) {
+         fftCounts->GetPointComplex(i, re1, im1);
+         fftKernel->GetPointComplex(i, re2, im2);
+         fftInverse->SetPoint(i, re1 * re2 - im1 * im2, re1 * im2 + re2 * im1);
+      }
+      fftInverse->Transform();
+      for (Int_t i = 0; i < npoints; ++i) {
+         fGrid[i] = fftInverse->GetPointReal(i) / nfft;
+      }
+   } else {
+      // no FFT plugin: direct convolution over the kernel support
+      for (Int_t i = 0; i < npoints; ++i) {
+         Double_t sum = 0.;
+         for (Int_t j = std::max(0, i - range); j <= std::min(npoints - 1, i + range); ++j) {
+            sum += counts[j] * kernel[std::abs(i - j)];
+         }
+         fGrid[i] = sum;
+      }
+   }
+   delete fftCounts;
+   delete fftKernel;
+   delete fftInverse;
+}
+
 UInt_t TKDE::Index(Double_t x) const {
    // Returns the indices (bins) for the binned weights
    Int_t bin = Int_t((x - fXMin) * fWeightSize);
@@ -15,6 +15,7 @@
 #include "TClass.h"   // needed to copy the TF1 pointer
 
 #include <cmath>
+#include <vector>
 
 
 namespace ROOT {
@@ -200,7 +201,13 @@ void  WrappedMultiTF1::ParameterGradient(const double * x, const double * par, d
    //  BUT the TLinearFitter wants to have the derivatives also for fixed parameters.
    //  so in case of fLinear (or fPolynomial) a non-zero value will be returned for fixed parameters
 
-   if (!fLinear) {
+   if (!fLinear && IsThreadSafe()) {
+      // vary a copy of the parameters, leaving the TF1 unchanged
+      std::vector<double> p(par, par + NPar());
+      for (unsigned int i = 0; i < p.size(); ++i)
+         grad[i] = GradientParCopy(i, x, p.data());
+   }
+   else if (!fLinear) {
       // need to set parameter values
       fFunc->SetParameters( par );
       // no need to call InitArgs (it is called in TF1::GradientPar)
@@ -216,6 +223,10 @@ void  WrappedMultiTF1::ParameterGradient(const double * x, const double * par, d
 double WrappedMultiTF1::DoParameterDerivative(const double * x, const double * p, unsigned int ipar ) const {
    // evaluate the derivative of the function with respect to parameter ipar
    // see note above concerning the fixed parameters
+   if (! fLinear && IsThreadSafe()) {
+      std::vector<double> pcopy(p, p + NPar());
+      return GradientParCopy(ipar, x, pcopy.data());
+   }
    if (! fLinear ) {
       fFunc->SetParameters( p );
       return fFunc->GradientPar(ipar, x,fgEps);
@@ -235,6 +246,39 @@ double WrappedMultiTF1::DoParameterDerivative(const double * x, const double * p
    }
 }
 
+bool WrappedMultiTF1::IsThreadSafe() const {
+   // a formula evaluated with given parameters only reads the TF1 (see TF1::EvalPar)
+   return fFunc->GetFormula() != 0 && fFunc->GetMethodCall() == 0;
+}
+
+double WrappedMultiTF1::GradientParCopy(unsigned int ipar, const double * x, double * p) const {
+   // same central differences as TF1::GradientPar, with the parameter values of p
+   // which are restored on return
+   double eps = fgEps;
+   if (eps < 1e-10 || eps > 1) eps = 0.01;
+
+   double al, bl;
+   fFunc->GetParLimits(ipar, al, bl);
+   if (al*bl != 0 && al >= bl) {
+      //this parameter is fixed
+      return 0;
+   }
+   const double h = (fFunc->GetParError(ipar) != 0) ? eps*fFunc->GetParError(ipar) : eps;
+
+   const double par0 = p[ipar];
+   p[ipar] = par0 + h;     double f1 = fFunc->EvalPar(x,p);
+   p[ipar] = par0 - h;     double f2 = fFunc->EvalPar(x,p);
+   p[ipar] = par0 + h/2;   double g1 = fFunc->EvalPar(x,p);
+   p[ipar] = par0 - h/2;   double g2 = fFunc->EvalPar(x,p);
+   p[ipar] = par0;
+
+   //compute the central differences
+   double h2    = 1/(2.*h);
+   double d0    = f1 - f2;
+   double d2    = 2*(g1 - g2);
+   return h2*(4*d2 - d0)/3.;
+}
+
 void WrappedMultiTF1::SetDerivPrecision(double eps) { fgEps = eps; }
 
 double WrappedMultiTF1::GetDerivPrecision( ) { return fgEps; }
@@ -807,6 +807,7 @@ void TGraphPainter::ExecuteEventHelper(TGraph *theGraph, Int_t event, Int_t px,
             }
          }
          badcase = kFALSE;
+         theGraph->ResetEvalCache();
          gPad->Modified(kTRUE);
          //gPad->Update();
       }
@@ -864,6 +865,7 @@ void TGraphPainter::ExecuteEventHelper(TGraph *theGraph, Int_t event, Int_t px,
       badcase = kFALSE;
       delete [] x; x = 0;
       delete [] y; y = 0;
+      theGraph->ResetEvalCache();
       gPad->Modified(kTRUE);
       gVirtualX->SetLineColor(-1);
    }
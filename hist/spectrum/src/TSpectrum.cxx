@@ -7,6 +7,12 @@
 #include "TList.h"
 #include "TH1.h"
 #include "TMath.h"
+#include "TROOT.h"
+
+#ifdef R__USE_IMT
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#endif
 
 /** \class TSpectrum
     \ingroup Spectrum
@@ -44,6 +50,29 @@ Int_t TSpectrum::fgAverageWindow = 3;
 #define PEAK_WINDOW 1024
 ClassImp(TSpectrum)
 
+////////////////////////////////////////////////////////////////////////////////
+/// Call f(first, last) on subranges of the channels [first, last), from
+/// several threads when implicit multithreading is enabled and the channels
+/// hold enough work. f must only write to its own channels.
+
+template <class F>
+static void ForEachChannel(Int_t first, Int_t last, Double_t workPerChannel, F f)
+{
+   if (last <= first) return;
+#ifdef R__USE_IMT
+   // below this amount of work per call the threads do not pay off
+   const Double_t kMinParallelWork = 1 << 16;
+   if (ROOT::IsImplicitMTEnabled() && workPerChannel * (last - first) >= kMinParallelWork) {
+      tbb::parallel_for(tbb::blocked_range<Int_t>(first, last),
+                        [&](const tbb::blocked_range<Int_t> &r) { f(r.begin(), r.end()); });
+      return;
+   }
+#else
+   (void) workPerChannel;
+#endif
+   f(first, last);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Constructor.
 
@@ -1868,7 +1897,7 @@ const char *TSpectrum::Deconvolution(Double_t *source, const Double_t *response,
        //   working_space-pointer to the working vector
        //   (its size must be 4*ssize of source spectrum)
    Double_t *working_space = new Double_t[4 * ssize];
-   int i, j, k, lindex, posit, lh_gold, l, repet;
+   int i, j, lindex, posit, lh_gold, l, repet;
    Double_t lda, ldb, ldc, area, maximum;
    area = 0;
    lh_gold = -1;
@@ -1897,25 +1926,20 @@ const char *TSpectrum::Deconvolution(Double_t *source, const Double_t *response,
       working_space[2 * ssize + i] = source[i];
 
 // create matrix at*a and vector at*y
+// the response is 0 beyond lh_gold, so only its support is summed
    for (i = 0; i < ssize; i++){
       lda = 0;
-      for (j = 0; j < ssize; j++){
+      for (j = 0; j < lh_gold && i + j < ssize; j++){
          ldb = working_space[j];
-         k = i + j;
-         if (k < ssize){
-            ldc = working_space[k];
-            lda = lda + ldb * ldc;
-         }
+         ldc = working_space[i + j];
+         lda = lda + ldb * ldc;
       }
       working_space[ssize + i] = lda;
       lda = 0;
-      for (k = 0; k < ssize; k++){
-         l = k - i;
-         if (l >= 0){
-            ldb = working_space[l];
-            ldc = working_space[2 * ssize + k];
-            lda = lda + ldb * ldc;
-         }
+      for (l = 0; l < lh_gold && i + l < ssize; l++){
+         ldb = working_space[l];
+         ldc = working_space[2 * ssize + i + l];
+         lda = lda + ldb * ldc;
       }
       working_space[3 * ssize + i]=lda;
    }
@@ -1936,37 +1960,37 @@ const char *TSpectrum::Deconvolution(Double_t *source, const Double_t *response,
             working_space[i] = TMath::Power(working_space[i], boost);
       }
       for (lindex = 0; lindex < numberIterations; lindex++) {
-         for (i = 0; i < ssize; i++) {
-            if (working_space[2 * ssize + i] > 0.000001
-                 && working_space[i] > 0.000001) {
-               lda = 0;
-               for (j = 0; j < lh_gold; j++) {
-                  ldb = working_space[j + ssize];
-                  if (j != 0){
-                     k = i + j;
-                     ldc = 0;
-                     if (k < ssize)
-                        ldc = working_space[k];
-                     k = i - j;
-                     if (k >= 0)
-                        ldc += working_space[k];
+         // each channel only reads the current solution, the channels are
+         // updated in parallel
+         auto iterate = [&](Int_t ifirst, Int_t ilast) {
+            for (Int_t ic = ifirst; ic < ilast; ic++) {
+               if (working_space[2 * ssize + ic] > 0.000001
+                    && working_space[ic] > 0.000001) {
+                  Double_t sum = 0, h, x;
+                  for (Int_t jc = 0; jc < lh_gold; jc++) {
+                     h = working_space[jc + ssize];
+                     if (jc != 0){
+                        x = 0;
+                        if (ic + jc < ssize)
+                           x = working_space[ic + jc];
+                        if (ic - jc >= 0)
+                           x += working_space[ic - jc];
+                     }
+
+                     else
+                        x = working_space[ic];
+                     sum = sum + h * x;
                   }
+                  if (sum != 0)
+                     sum = working_space[2 * ssize + ic] / sum;
 
                   else
-                     ldc = working_space[i];
-                  lda = lda + ldb * ldc;
+                     sum = 0;
+                  working_space[3 * ssize + ic] = sum * working_space[ic];
                }
-               ldb = working_space[2 * ssize + i];
-               if (lda != 0)
-                  lda = ldb / lda;
-
-               else
-                  lda = 0;
-               ldb = working_space[i];
-               lda = lda * ldb;
-               working_space[3 * ssize + i] = lda;
             }
-         }
+         };
+         ForEachChannel(0, ssize, lh_gold, iterate);
          for (i = 0; i < ssize; i++)
             working_space[i] = working_space[3 * ssize + i];
       }
@@ -2148,8 +2172,8 @@ const char *TSpectrum::DeconvolutionRL(Double_t *source, const Double_t *respons
        //   working_space-pointer to the working vector
        //   (its size must be 4*ssize of source spectrum)
    Double_t *working_space = new Double_t[4 * ssize];
-   int i, j, k, lindex, posit, lh_gold, repet, kmin, kmax;
-   Double_t lda, ldb, ldc, maximum;
+   int i, j, lindex, posit, lh_gold, repet;
+   Double_t lda, maximum;
    lh_gold = -1;
    posit = 0;
    maximum = 0;
@@ -2183,6 +2207,9 @@ const char *TSpectrum::DeconvolutionRL(Double_t *source, const Double_t *respons
          working_space[i] = 0;
 
    }
+// the channels beyond ssize - lh_gold are not iterated and stay 0
+   for (i = ssize - lh_gold + 1; i < ssize; i++)
+      working_space[3 * ssize + i] = 0;
        //**START OF ITERATIONS**
    for (repet = 0; repet < numberRepetitions; repet++) {
       if (repet != 0) {
@@ -2190,37 +2217,42 @@ const char *TSpectrum::DeconvolutionRL(Double_t *source, const Double_t *respons
             working_space[i] = TMath::Power(working_space[i], boost);
       }
       for (lindex = 0; lindex < numberIterations; lindex++) {
-         for (i = 0; i <= ssize - lh_gold; i++){
-            lda = 0;
-            if (working_space[i] > 0){//x[i]
-               for (j = i; j < i + lh_gold; j++){
-                  ldb = working_space[2 * ssize + j];//y[j]
-                  if (j < ssize){
-                     if (ldb > 0){//y[j]
-                        kmax = j;
-                        if (kmax > lh_gold - 1)
-                           kmax = lh_gold - 1;
-                        kmin = j + lh_gold - ssize;
-                        if (kmin < 0)
-                           kmin = 0;
-                        ldc = 0;
-                        for (k = kmax; k >= kmin; k--){
-                           ldc += working_space[ssize + k] * working_space[j - k];//h[k]*x[j-k]
+         // each channel only reads the current solution, the channels are
+         // updated in parallel
+         auto iterate = [&](Int_t ifirst, Int_t ilast) {
+            for (Int_t ic = ifirst; ic < ilast; ic++){
+               Double_t sum = 0, y, conv;
+               if (working_space[ic] > 0){//x[i]
+                  for (Int_t jc = ic; jc < ic + lh_gold; jc++){
+                     y = working_space[2 * ssize + jc];//y[j]
+                     if (jc < ssize){
+                        if (y > 0){//y[j]
+                           Int_t kcmax = jc;
+                           if (kcmax > lh_gold - 1)
+                              kcmax = lh_gold - 1;
+                           Int_t kcmin = jc + lh_gold - ssize;
+                           if (kcmin < 0)
+                              kcmin = 0;
+                           conv = 0;
+                           for (Int_t kc = kcmax; kc >= kcmin; kc--){
+                              conv += working_space[ssize + kc] * working_space[jc - kc];//h[k]*x[j-k]
+                           }
+                           if (conv > 0)
+                              y = y / conv;
+
+                           else
+                              y = 0;
                         }
-                        if (ldc > 0)
-                           ldb = ldb / ldc;
-
-                        else
-                           ldb = 0;
+                        y = y * working_space[ssize + jc - ic];//y[j]*h[j-i]/suma(h[j][k]x[k])
                      }
-                     ldb = ldb * working_space[ssize + j - i];//y[j]*h[j-i]/suma(h[j][k]x[k])
+                     sum += y;
                   }
-                  lda += ldb;
+                  sum = sum * working_space[ic];
                }
-               lda = lda * working_space[i];
+               working_space[3 * ssize + ic] = sum;
             }
-            working_space[3 * ssize + i] = lda;
-         }
+         };
+         ForEachChannel(0, ssize - lh_gold + 1, Double_t(lh_gold) * lh_gold, iterate);
          for (i = 0; i < ssize; i++)
             working_space[i] = working_space[3 * ssize + i];
       }
@@ -3050,35 +3082,34 @@ Int_t TSpectrum::SearchHighRes(Double_t *source,Double_t *destVector, int ssize,
       working_space[i] = 1;
 //START OF ITERATIONS
    for(lindex = 0; lindex < deconIterations; lindex++){
-      for(i = 0; i < size_ext; i++){
-         if(TMath::Abs(working_space[2 * size_ext + i]) > 0.00001 && TMath::Abs(working_space[i]) > 0.00001){
-            lda=0;
-            jmin = lh_gold - 1;
-            if(jmin > i)
-               jmin = i;
-
-            jmin = -jmin;
-            jmax = lh_gold - 1;
-            if(jmax > (size_ext - 1 - i))
-               jmax=size_ext-1-i;
-
-            for(j = jmin; j <= jmax; j++){
-               ldb = working_space[j + lh_gold - 1 + size_ext];
-               ldc = working_space[i + j];
-               lda = lda + ldb * ldc;
-            }
-            ldb = working_space[2 * size_ext + i];
-            if(lda != 0)
-               lda = ldb / lda;
+      // each channel only reads the current solution, the channels are
+      // updated in parallel
+      auto iterate = [&](Int_t ifirst, Int_t ilast) {
+         for(Int_t ic = ifirst; ic < ilast; ic++){
+            if(TMath::Abs(working_space[2 * size_ext + ic]) > 0.00001 && TMath::Abs(working_space[ic]) > 0.00001){
+               Double_t sum = 0;
+               Int_t jcmin = lh_gold - 1;
+               if(jcmin > ic)
+                  jcmin = ic;
+
+               jcmin = -jcmin;
+               Int_t jcmax = lh_gold - 1;
+               if(jcmax > (size_ext - 1 - ic))
+                  jcmax = size_ext - 1 - ic;
+
+               for(Int_t jc = jcmin; jc <= jcmax; jc++)
+                  sum = sum + working_space[jc + lh_gold - 1 + size_ext] * working_space[ic + jc];
+               if(sum != 0)
+                  sum = working_space[2 * size_ext + ic] / sum;
 
-            else
-               lda = 0;
+               else
+                  sum = 0;
 
-            ldb = working_space[i];
-            lda = lda * ldb;
-            working_space[3 * size_ext + i] = lda;
+               working_space[3 * size_ext + ic] = sum * working_space[ic];
+            }
          }
-      }
+      };
+      ForEachChannel(0, size_ext, 2. * lh_gold, iterate);
       for(i = 0; i < size_ext; i++){
          working_space[i] = working_space[3 * size_ext + i];
       }
@@ -44,6 +44,15 @@
 #include "TList.h"
 #include "TH1.h"
 #include "TMath.h"
+#include "TROOT.h"
+
+#include <string.h>
+
+#ifdef R__USE_IMT
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#endif
+
 #define PEAK_WINDOW 1024
 
 Int_t TSpectrum2::fgIterations    = 3;
@@ -51,6 +60,146 @@ Int_t TSpectrum2::fgAverageWindow = 3;
 
 ClassImp(TSpectrum2)
 
+////////////////////////////////////////////////////////////////////////////////
+/// Call f(first, last) on subranges of the x columns [first, last), from
+/// several threads when implicit multithreading is enabled and the columns
+/// hold enough work. f must only write to its own columns.
+
+template <class F>
+static void ForEachColumn(Int_t first, Int_t last, Double_t workPerColumn, F f)
+{
+   if (last <= first) return;
+#ifdef R__USE_IMT
+   // below this amount of work per call the threads do not pay off
+   const Double_t kMinParallelWork = 1 << 16;
+   if (ROOT::IsImplicitMTEnabled() && workPerColumn * (last - first) >= kMinParallelWork) {
+      tbb::parallel_for(tbb::blocked_range<Int_t>(first, last),
+                        [&](const tbb::blocked_range<Int_t> &r) { f(r.begin(), r.end()); });
+      return;
+   }
+#else
+   (void) workPerColumn;
+#endif
+   f(first, last);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Apply one SNIP clipping window (r1, r2) to the channels of in, read from
+/// offset inOffset of each y column, and write the clipped channels to out
+/// at offset outOffset. Channels closer than the window to the edges are
+/// not written. A clipped value replaces the channel only if it is smaller
+/// and, when positive is set, greater than 0.
+/// The x columns are processed in parallel.
+
+static void ClipWindow(Double_t **in, Int_t inOffset, Double_t **out, Int_t outOffset,
+                       Int_t ssizex, Int_t ssizey, Int_t r1, Int_t r2, Bool_t oneStep, Bool_t positive)
+{
+   auto clip = [&](Int_t xfirst, Int_t xlast) {
+      Double_t a, b, p1, p2, p3, p4, s1, s2, s3, s4;
+      for (Int_t x = xfirst; x < xlast; x++) {
+         const Double_t *xm = in[x - r1] + inOffset;
+         const Double_t *x0 = in[x] + inOffset;
+         const Double_t *xp = in[x + r1] + inOffset;
+         Double_t *dest = out[x] + outOffset;
+         for (Int_t y = r2; y < ssizey - r2; y++) {
+            a = x0[y];
+            if (oneStep) {
+               b = -(xm[y - r2] + xm[y + r2] + xp[y - r2] + xp[y + r2]) / 4 +
+                   (x0[y - r2] + xm[y] + xp[y] + x0[y + r2]) / 2;
+            } else {
+               p1 = xm[y - r2];
+               p2 = xm[y + r2];
+               p3 = xp[y - r2];
+               p4 = xp[y + r2];
+               s1 = x0[y - r2];
+               s2 = xm[y];
+               s3 = xp[y];
+               s4 = x0[y + r2];
+               b = (p1 + p2) / 2.0;
+               if (b > s2)
+                  s2 = b;
+               b = (p1 + p3) / 2.0;
+               if (b > s1)
+                  s1 = b;
+               b = (p2 + p4) / 2.0;
+               if (b > s4)
+                  s4 = b;
+               b = (p3 + p4) / 2.0;
+               if (b > s3)
+                  s3 = b;
+               s1 = s1 - (p1 + p3) / 2.0;
+               s2 = s2 - (p1 + p2) / 2.0;
+               s3 = s3 - (p3 + p4) / 2.0;
+               s4 = s4 - (p2 + p4) / 2.0;
+               b = (s1 + s4) / 2.0 + (s2 + s3) / 2.0 + (p1 + p2 + p3 + p4) / 4.0;
+            }
+            if (b < a && (!positive || b > 0))
+               a = b;
+            dest[y] = a;
+         }
+      }
+   };
+   ForEachColumn(r1, ssizex - r1, 30. * ssizey, clip);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy the channels [r1, ssizex - r1) x [r2, ssizey - r2) of from, at
+/// offset fromOffset of each y column, to to at offset toOffset.
+
+static void CopyWindow(Double_t **from, Int_t fromOffset, Double_t **to, Int_t toOffset,
+                       Int_t ssizex, Int_t ssizey, Int_t r1, Int_t r2)
+{
+   if (ssizey - 2 * r2 <= 0) return;
+   auto copy = [&](Int_t xfirst, Int_t xlast) {
+      for (Int_t x = xfirst; x < xlast; x++)
+         memcpy(to[x] + toOffset + r2, from[x] + fromOffset + r2, (ssizey - 2 * r2) * sizeof(Double_t));
+   };
+   ForEachColumn(r1, ssizex - r1, ssizey, copy);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// One iteration of the Gold deconvolution. The y columns of ws hold, at
+/// offsets k * ssizey, the vector ht*y (k=1), the matrix ht*h (k=2), the
+/// current solution (k=3) and the next one (k=4), which is copied to the
+/// current one at the end.
+/// The x columns are processed in parallel.
+
+static void GoldIteration(Double_t **ws, Int_t ssizex, Int_t ssizey, Int_t lhx, Int_t lhy)
+{
+   const Int_t i1min = -(lhx - 1), i2min = -(lhy - 1);
+   auto iterate = [&](Int_t xfirst, Int_t xlast) {
+      for (Int_t i1 = xfirst; i1 < xlast; i1++) {
+         const Int_t j1min = -TMath::Min(i1, lhx - 1);
+         const Int_t j1max = TMath::Min(ssizex - i1 - 1, lhx - 1);
+         const Double_t *hty = ws[i1] + ssizey;
+         const Double_t *x = ws[i1] + 3 * ssizey;
+         Double_t *xnew = ws[i1] + 4 * ssizey;
+         for (Int_t i2 = 0; i2 < ssizey; i2++) {
+            const Int_t j2min = -TMath::Min(i2, lhy - 1);
+            const Int_t j2max = TMath::Min(ssizey - i2 - 1, lhy - 1);
+            Double_t lda, ldc, ldb = 0;
+            for (Int_t j1 = j1min; j1 <= j1max; j1++) {
+               const Double_t *b = ws[j1 - i1min] + 2 * ssizey - i2min;
+               const Double_t *xj = ws[i1 + j1] + 3 * ssizey + i2;
+               for (Int_t j2 = j2min; j2 <= j2max; j2++)
+                  ldb += xj[j2] * b[j2];
+            }
+            lda = x[i2];
+            ldc = hty[i2];
+            if (ldc * lda != 0 && ldb != 0) {
+               lda = lda * ldc / ldb;
+            }
+
+            else
+               lda = 0;
+            xnew[i2] = lda;
+         }
+      }
+   };
+   ForEachColumn(0, ssizex, Double_t(ssizey) * lhx * lhy, iterate);
+   CopyWindow(ws, 4 * ssizey, ws, 3 * ssizey, ssizex, ssizey, 0, 0);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Constructor.
 
@@ -487,8 +636,7 @@ const char *TSpectrum2::Background(Double_t **spectrum,
                        Int_t direction,
                        Int_t filterType)
 {
-   Int_t i, x, y, sampling, r1, r2;
-   Double_t a, b, p1, p2, p3, p4, s1, s2, s3, s4;
+   Int_t i, k, sampling, r1, r2;
    if (ssizex <= 0 || ssizey <= 0)
       return "Wrong parameters";
    if (numberIterationsX < 1 || numberIterationsY < 1)
@@ -501,153 +649,21 @@ const char *TSpectrum2::Background(Double_t **spectrum,
       working_space[i] = new Double_t[ssizey];
    sampling =
        (Int_t) TMath::Max(numberIterationsX, numberIterationsY);
-   if (direction == kBackIncreasingWindow) {
-      if (filterType == kBackSuccessiveFiltering) {
-         for (i = 1; i <= sampling; i++) {
-            r1 = (Int_t) TMath::Min(i, numberIterationsX), r2 =
-                (Int_t) TMath::Min(i, numberIterationsY);
-            for (y = r2; y < ssizey - r2; y++) {
-               for (x = r1; x < ssizex - r1; x++) {
-                  a = spectrum[x][y];
-                  p1 = spectrum[x - r1][y - r2];
-                  p2 = spectrum[x - r1][y + r2];
-                  p3 = spectrum[x + r1][y - r2];
-                  p4 = spectrum[x + r1][y + r2];
-                  s1 = spectrum[x][y - r2];
-                  s2 = spectrum[x - r1][y];
-                  s3 = spectrum[x + r1][y];
-                  s4 = spectrum[x][y + r2];
-                  b = (p1 + p2) / 2.0;
-                  if (b > s2)
-                     s2 = b;
-                  b = (p1 + p3) / 2.0;
-                  if (b > s1)
-                     s1 = b;
-                  b = (p2 + p4) / 2.0;
-                  if (b > s4)
-                     s4 = b;
-                  b = (p3 + p4) / 2.0;
-                  if (b > s3)
-                     s3 = b;
-                  s1 = s1 - (p1 + p3) / 2.0;
-                  s2 = s2 - (p1 + p2) / 2.0;
-                  s3 = s3 - (p3 + p4) / 2.0;
-                  s4 = s4 - (p2 + p4) / 2.0;
-                  b = (s1 + s4) / 2.0 + (s2 + s3) / 2.0 + (p1 + p2 +
-                                                            p3 +
-                                                            p4) / 4.0;
-                  if (b < a && b > 0)
-                     a = b;
-                  working_space[x][y] = a;
-               }
-            }
-            for (y = r2; y < ssizey - r2; y++) {
-               for (x = r1; x < ssizex - r1; x++) {
-                  spectrum[x][y] = working_space[x][y];
-               }
-            }
-         }
-      }
-
-      else if (filterType == kBackOneStepFiltering) {
-         for (i = 1; i <= sampling; i++) {
-            r1 = (Int_t) TMath::Min(i, numberIterationsX), r2 =
-                (Int_t) TMath::Min(i, numberIterationsY);
-            for (y = r2; y < ssizey - r2; y++) {
-               for (x = r1; x < ssizex - r1; x++) {
-                  a = spectrum[x][y];
-                  b = -(spectrum[x - r1][y - r2] +
-                         spectrum[x - r1][y + r2] + spectrum[x + r1][y -
-                                                                     r2]
-                         + spectrum[x + r1][y + r2]) / 4 +
-                      (spectrum[x][y - r2] + spectrum[x - r1][y] +
-                       spectrum[x + r1][y] + spectrum[x][y + r2]) / 2;
-                  if (b < a && b > 0)
-                     a = b;
-                  working_space[x][y] = a;
-               }
-            }
-            for (y = i; y < ssizey - i; y++) {
-               for (x = i; x < ssizex - i; x++) {
-                  spectrum[x][y] = working_space[x][y];
-               }
-            }
-         }
-      }
-   }
-
-   else if (direction == kBackDecreasingWindow) {
-      if (filterType == kBackSuccessiveFiltering) {
-         for (i = sampling; i >= 1; i--) {
-            r1 = (Int_t) TMath::Min(i, numberIterationsX), r2 =
-                (Int_t) TMath::Min(i, numberIterationsY);
-            for (y = r2; y < ssizey - r2; y++) {
-               for (x = r1; x < ssizex - r1; x++) {
-                  a = spectrum[x][y];
-                  p1 = spectrum[x - r1][y - r2];
-                  p2 = spectrum[x - r1][y + r2];
-                  p3 = spectrum[x + r1][y - r2];
-                  p4 = spectrum[x + r1][y + r2];
-                  s1 = spectrum[x][y - r2];
-                  s2 = spectrum[x - r1][y];
-                  s3 = spectrum[x + r1][y];
-                  s4 = spectrum[x][y + r2];
-                  b = (p1 + p2) / 2.0;
-                  if (b > s2)
-                     s2 = b;
-                  b = (p1 + p3) / 2.0;
-                  if (b > s1)
-                     s1 = b;
-                  b = (p2 + p4) / 2.0;
-                  if (b > s4)
-                     s4 = b;
-                  b = (p3 + p4) / 2.0;
-                  if (b > s3)
-                     s3 = b;
-                  s1 = s1 - (p1 + p3) / 2.0;
-                  s2 = s2 - (p1 + p2) / 2.0;
-                  s3 = s3 - (p3 + p4) / 2.0;
-                  s4 = s4 - (p2 + p4) / 2.0;
-                  b = (s1 + s4) / 2.0 + (s2 + s3) / 2.0 + (p1 + p2 +
-                                                            p3 +
-                                                            p4) / 4.0;
-                  if (b < a && b > 0)
-                     a = b;
-                  working_space[x][y] = a;
-               }
-            }
-            for (y = r2; y < ssizey - r2; y++) {
-               for (x = r1; x < ssizex - r1; x++) {
-                  spectrum[x][y] = working_space[x][y];
-               }
-            }
-         }
-      }
-
-      else if (filterType == kBackOneStepFiltering) {
-         for (i = sampling; i >= 1; i--) {
-            r1 = (Int_t) TMath::Min(i, numberIterationsX), r2 =
-                (Int_t) TMath::Min(i, numberIterationsY);
-            for (y = r2; y < ssizey - r2; y++) {
-               for (x = r1; x < ssizex - r1; x++) {
-                  a = spectrum[x][y];
-                  b = -(spectrum[x - r1][y - r2] +
-                         spectrum[x - r1][y + r2] + spectrum[x + r1][y -
-                                                                     r2]
-                         + spectrum[x + r1][y + r2]) / 4 +
-                      (spectrum[x][y - r2] + spectrum[x - r1][y] +
-                       spectrum[x + r1][y] + spectrum[x][y + r2]) / 2;
-                  if (b < a && b > 0)
-                     a = b;
-                  working_space[x][y] = a;
-               }
-            }
-            for (y = i; y < ssizey - i; y++) {
-               for (x = i; x < ssizex - i; x++) {
-                  spectrum[x][y] = working_space[x][y];
-               }
-            }
-         }
+   Bool_t increasing = (direction == kBackIncreasingWindow);
+   Bool_t oneStep = (filterType == kBackOneStepFiltering);
+   if ((increasing || direction == kBackDecreasingWindow)
+       && (oneStep || filterType == kBackSuccessiveFiltering)) {
+      for (k = 1; k <= sampling; k++) {
+         i = increasing ? k : sampling + 1 - k;
+         r1 = (Int_t) TMath::Min(i, numberIterationsX), r2 =
+             (Int_t) TMath::Min(i, numberIterationsY);
+         ClipWindow(spectrum, 0, working_space, 0, ssizex, ssizey, r1, r2, oneStep, kTRUE);
+         // the one step filter copies back only the channels at distance i
+         // from the edges
+         if (oneStep)
+            CopyWindow(working_space, 0, spectrum, 0, ssizex, ssizey, i, i);
+         else
+            CopyWindow(working_space, 0, spectrum, 0, ssizex, ssizey, r1, r2);
       }
    }
    for (i = 0; i < ssizex; i++)
@@ -1241,48 +1257,8 @@ const char *TSpectrum2::Deconvolution(Double_t **source, Double_t **resp,
             }
          }
       }
-      for (lindex = 0; lindex < numberIterations; lindex++) {
-         for (i2 = 0; i2 < ssizey; i2++) {
-            for (i1 = 0; i1 < ssizex; i1++) {
-               ldb = 0;
-               j2min = i2;
-               if (j2min > lhy - 1)
-                  j2min = lhy - 1;
-               j2min = -j2min;
-               j2max = ssizey - i2 - 1;
-               if (j2max > lhy - 1)
-                  j2max = lhy - 1;
-               j1min = i1;
-               if (j1min > lhx - 1)
-                  j1min = lhx - 1;
-               j1min = -j1min;
-               j1max = ssizex - i1 - 1;
-               if (j1max > lhx - 1)
-                  j1max = lhx - 1;
-               for (j2 = j2min; j2 <= j2max; j2++) {
-                  for (j1 = j1min; j1 <= j1max; j1++) {
-                     ldc =  working_space[j1 - i1min][j2 - i2min + 2 * ssizey];
-                     lda = working_space[i1 + j1][i2 + j2 + 3 * ssizey];
-                     ldb = ldb + lda * ldc;
-                  }
-               }
-               lda = working_space[i1][i2 + 3 * ssizey];
-               ldc = working_space[i1][i2 + 1 * ssizey];
-               if (ldc * lda != 0 && ldb != 0) {
-                  lda = lda * ldc / ldb;
-               }
-
-               else
-                  lda = 0;
-               working_space[i1][i2 + 4 * ssizey] = lda;
-            }
-         }
-         for (i2 = 0; i2 < ssizey; i2++) {
-            for (i1 = 0; i1 < ssizex; i1++)
-               working_space[i1][i2 + 3 * ssizey] =
-                   working_space[i1][i2 + 4 * ssizey];
-         }
-      }
+      for (lindex = 0; lindex < numberIterations; lindex++)
+         GoldIteration(working_space, ssizex, ssizey, lhx, lhy);
    }
    for (i = 0; i < ssizex; i++) {
       for (j = 0; j < ssizey; j++)
@@ -1599,8 +1575,6 @@ Int_t TSpectrum2::SearchHighRes(Double_t **source, Double_t **dest, Int_t ssizex
    Int_t ymin, ymax, i, j;
    Double_t a, b, ax, ay, maxch, plocha = 0;
    Double_t nom, nip, nim, sp, sm, spx, spy, smx, smy;
-   Double_t p1, p2, p3, p4, s1, s2, s3, s4;
-   Int_t x, y;
    Int_t lhx, lhy, i1, i2, j1, j2, k1, k2, i1min, i1max, i2min, i2max, j1min, j1max, j2min, j2max, positx, posity;
    if (sigma < 1) {
       Error("SearchHighRes", "Invalid sigma, must be greater than or equal to 1");
@@ -1675,44 +1649,8 @@ Int_t TSpectrum2::SearchHighRes(Double_t **source, Double_t **dest, Int_t ssizex
    }
    if(backgroundRemove == true){
       for(i = 1; i <= number_of_iterations; i++){
-         for(y = i; y < ssizey_ext - i; y++){
-            for(x = i; x < ssizex_ext - i; x++){
-               a = working_space[x][y + ssizey_ext];
-               p1 = working_space[x - i][y + ssizey_ext - i];
-               p2 = working_space[x - i][y + ssizey_ext + i];
-               p3 = working_space[x + i][y + ssizey_ext - i];
-               p4 = working_space[x + i][y + ssizey_ext + i];
-               s1 = working_space[x][y + ssizey_ext - i];
-               s2 = working_space[x - i][y + ssizey_ext];
-               s3 = working_space[x + i][y + ssizey_ext];
-               s4 = working_space[x][y + ssizey_ext + i];
-               b = (p1 + p2) / 2.0;
-               if(b > s2)
-                  s2 = b;
-               b = (p1 + p3) / 2.0;
-               if(b > s1)
-                  s1 = b;
-               b = (p2 + p4) / 2.0;
-               if(b > s4)
-                  s4 = b;
-               b = (p3 + p4) / 2.0;
-               if(b > s3)
-                  s3 = b;
-               s1 = s1 - (p1 + p3) / 2.0;
-               s2 = s2 - (p1 + p2) / 2.0;
-               s3 = s3 - (p3 + p4) / 2.0;
-               s4 = s4 - (p2 + p4) / 2.0;
-               b = (s1 + s4) / 2.0 + (s2 + s3) / 2.0 + (p1 + p2 + p3 + p4) / 4.0;
-               if(b < a)
-                  a = b;
-               working_space[x][y] = a;
-            }
-         }
-         for(y = i;y < ssizey_ext - i; y++){
-            for(x = i; x < ssizex_ext - i; x++){
-               working_space[x][y + ssizey_ext] = working_space[x][y];
-            }
-         }
+         ClipWindow(working_space, ssizey_ext, working_space, 0, ssizex_ext, ssizey_ext, i, i, kFALSE, kFALSE);
+         CopyWindow(working_space, 0, working_space, ssizey_ext, ssizex_ext, ssizey_ext, i, i);
       }
       for(j = 0;j < ssizey_ext; j++){
          for(i = 0; i < ssizex_ext; i++){
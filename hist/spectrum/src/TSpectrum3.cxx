@@ -48,10 +48,316 @@
 #include "TSpectrum3.h"
 #include "TH1.h"
 #include "TMath.h"
+#include "TROOT.h"
+
+#include <string.h>
+
+#ifdef R__USE_IMT
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#endif
+
 #define PEAK_WINDOW 1024
 
 ClassImp(TSpectrum3)
 
+////////////////////////////////////////////////////////////////////////////////
+/// Call f(first, last) on subranges of the x slices [first, last), from
+/// several threads when implicit multithreading is enabled and the slices
+/// hold enough work. f must only write to its own slices.
+
+template <class F>
+static void ForEachSlice(Int_t first, Int_t last, Double_t workPerSlice, F f)
+{
+   if (last <= first) return;
+#ifdef R__USE_IMT
+   // below this amount of work per call the threads do not pay off
+   const Double_t kMinParallelWork = 1 << 16;
+   if (ROOT::IsImplicitMTEnabled() && workPerSlice * (last - first) >= kMinParallelWork) {
+      tbb::parallel_for(tbb::blocked_range<Int_t>(first, last),
+                        [&](const tbb::blocked_range<Int_t> &r) { f(r.begin(), r.end()); });
+      return;
+   }
+#else
+   (void) workPerSlice;
+#endif
+   f(first, last);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// One step of the successive SNIP clipping filter at channel z of the row
+/// rows[1][1]. rows[i][j] are the rows at x+(i-1)*q1, y+(j-1)*q2 so that the
+/// loop over z runs over contiguous memory.
+
+static inline Double_t ClipSuccessive(const Double_t *const rows[3][3], Int_t z, Int_t q3)
+{
+   Double_t a, b, p1, p2, p3, p4, p5, p6, p7, p8, s1, s2, s3, s4, s5, s6, s7, s8, s9, s10, s11, s12, r1, r2, r3, r4, r5, r6;
+   a = rows[1][1][z];
+   p1 = rows[2][2][z - q3];
+   p2 = rows[0][2][z - q3];
+   p3 = rows[2][0][z - q3];
+   p4 = rows[0][0][z - q3];
+   p5 = rows[2][2][z + q3];
+   p6 = rows[0][2][z + q3];
+   p7 = rows[2][0][z + q3];
+   p8 = rows[0][0][z + q3];
+   s1 = rows[2][1][z - q3];
+   s2 = rows[1][2][z - q3];
+   s3 = rows[0][1][z - q3];
+   s4 = rows[1][0][z - q3];
+   s5 = rows[2][1][z + q3];
+   s6 = rows[1][2][z + q3];
+   s7 = rows[0][1][z + q3];
+   s8 = rows[1][0][z + q3];
+   s9 = rows[0][2][z];
+   s10 = rows[0][0][z];
+   s11 = rows[2][2][z];
+   s12 = rows[2][0][z];
+   r1 = rows[1][1][z - q3];
+   r2 = rows[1][1][z + q3];
+   r3 = rows[0][1][z];
+   r4 = rows[2][1][z];
+   r5 = rows[1][2][z];
+   r6 = rows[1][0][z];
+   b = (p1 + p3) / 2.0;
+   if(b > s1)
+      s1 = b;
+   b = (p1 + p2) / 2.0;
+   if(b > s2)
+      s2 = b;
+   b = (p2 + p4) / 2.0;
+   if(b > s3)
+      s3 = b;
+   b = (p3 + p4) / 2.0;
+   if(b > s4)
+      s4 = b;
+   b = (p5 + p7) / 2.0;
+   if(b > s5)
+      s5 = b;
+   b = (p5 + p6) / 2.0;
+   if(b > s6)
+      s6 = b;
+   b = (p6 + p8) / 2.0;
+   if(b > s7)
+      s7 = b;
+   b = (p7 + p8) / 2.0;
+   if(b > s8)
+      s8 = b;
+   b = (p2 + p6) / 2.0;
+   if(b > s9)
+      s9 = b;
+   b = (p4 + p8) / 2.0;
+   if(b > s10)
+      s10 = b;
+   b = (p1 + p5) / 2.0;
+   if(b > s11)
+      s11 = b;
+   b = (p3 + p7) / 2.0;
+   if(b > s12)
+      s12 = b;
+   s1 = s1 - (p1 + p3) / 2.0;
+   s2 = s2 - (p1 + p2) / 2.0;
+   s3 = s3 - (p2 + p4) / 2.0;
+   s4 = s4 - (p3 + p4) / 2.0;
+   s5 = s5 - (p5 + p7) / 2.0;
+   s6 = s6 - (p5 + p6) / 2.0;
+   s7 = s7 - (p6 + p8) / 2.0;
+   s8 = s8 - (p7 + p8) / 2.0;
+   s9 = s9 - (p2 + p6) / 2.0;
+   s10 = s10 - (p4 + p8) / 2.0;
+   s11 = s11 - (p1 + p5) / 2.0;
+   s12 = s12 - (p3 + p7) / 2.0;
+   b = (s1 + s3) / 2.0 + (s2 + s4) / 2.0 + (p1 + p2 + p3 + p4) / 4.0;
+   if(b > r1)
+      r1 = b;
+   b = (s5 + s7) / 2.0 + (s6 + s8) / 2.0 + (p5 + p6 + p7 + p8) / 4.0;
+   if(b > r2)
+      r2 = b;
+   b = (s3 + s7) / 2.0 + (s9 + s10) / 2.0 + (p2 + p4 + p6 + p8) / 4.0;
+   if(b > r3)
+      r3 = b;
+   b = (s1 + s5) / 2.0 + (s11 + s12) / 2.0 + (p1 + p3 + p5 + p7) / 4.0;
+   if(b > r4)
+      r4 = b;
+   b = (s9 + s11) / 2.0 + (s2 + s6) / 2.0 + (p1 + p2 + p5 + p6) / 4.0;
+   if(b > r5)
+      r5 = b;
+   b = (s4 + s8) / 2.0 + (s10 + s12) / 2.0 + (p3 + p4 + p7 + p8) / 4.0;
+   if(b > r6)
+      r6 = b;
+   r1 = r1 - ((s1 + s3) / 2.0 + (s2 + s4) / 2.0 + (p1 + p2 + p3 + p4) / 4.0);
+   r2 = r2 - ((s5 + s7) / 2.0 + (s6 + s8) / 2.0 + (p5 + p6 + p7 + p8) / 4.0);
+   r3 = r3 - ((s3 + s7) / 2.0 + (s9 + s10) / 2.0 + (p2 + p4 + p6 + p8) / 4.0);
+   r4 = r4 - ((s1 + s5) / 2.0 + (s11 + s12) / 2.0 + (p1 + p3 + p5 + p7) / 4.0);
+   r5 = r5 - ((s9 + s11) / 2.0 + (s2 + s6) / 2.0 + (p1 + p2 + p5 + p6) / 4.0);
+   r6 = r6 - ((s4 + s8) / 2.0 + (s10 + s12) / 2.0 + (p3 + p4 + p7 + p8) / 4.0);
+   b = (r1 + r2) / 2.0 + (r3 + r4) / 2.0 + (r5 + r6) / 2.0 + (s1 + s3 + s5 + s7) / 4.0 + (s2 + s4 + s6 + s8) / 4.0 + (s9 + s10 + s11 + s12) / 4.0 + (p1 + p2 + p3 + p4 + p5 + p6 + p7 + p8) / 8.0;
+   if(b < a)
+      a = b;
+   return a;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// One step of the one-step SNIP clipping filter, see ClipSuccessive.
+
+static inline Double_t ClipOneStep(const Double_t *const rows[3][3], Int_t z, Int_t q3)
+{
+   Double_t a, b, c, d, p, s, r;
+   a = rows[1][1][z];
+   p = rows[2][2][z - q3] + rows[0][2][z - q3] + rows[2][0][z - q3] + rows[0][0][z - q3]
+     + rows[2][2][z + q3] + rows[0][2][z + q3] + rows[2][0][z + q3] + rows[0][0][z + q3];
+   s = rows[2][1][z - q3] + rows[1][2][z - q3] + rows[0][1][z - q3] + rows[1][0][z - q3]
+     + rows[2][1][z + q3] + rows[1][2][z + q3] + rows[0][1][z + q3] + rows[1][0][z + q3]
+     + rows[0][2][z] + rows[0][0][z] + rows[2][2][z] + rows[2][0][z];
+   r = rows[1][1][z - q3] + rows[1][1][z + q3] + rows[0][1][z] + rows[2][1][z] + rows[1][2][z] + rows[1][0][z];
+   b = p / 8 - s / 4 + r / 2;
+   c = -s / 4 + r / 2;
+   d = -p / 8 + s / 12;
+   if(b < a && b >= 0 && c >=0 && d >= 0)
+      a = b;
+   return a;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Apply one SNIP clipping window (q1, q2, q3) to the channels of in, read
+/// from offset inOffset of each z row, and write the clipped channels to
+/// out at offset outOffset. Channels closer than the window to the edges
+/// are not written. The x slices are processed in parallel.
+
+static void ClipWindow(Double_t ***in, Int_t inOffset, Double_t ***out, Int_t outOffset,
+                       Int_t ssizex, Int_t ssizey, Int_t ssizez, Int_t q1, Int_t q2, Int_t q3,
+                       Bool_t oneStep)
+{
+   auto clip = [&](Int_t xfirst, Int_t xlast) {
+      const Double_t *rows[3][3];
+      for (Int_t x = xfirst; x < xlast; x++) {
+         for (Int_t y = q2; y < ssizey - q2; y++) {
+            for (Int_t i = 0; i < 3; i++) {
+               for (Int_t j = 0; j < 3; j++)
+                  rows[i][j] = in[x + (i - 1) * q1][y + (j - 1) * q2] + inOffset;
+            }
+            Double_t *dest = out[x][y] + outOffset;
+            if (oneStep) {
+               for (Int_t z = q3; z < ssizez - q3; z++)
+                  dest[z] = ClipOneStep(rows, z, q3);
+            } else {
+               for (Int_t z = q3; z < ssizez - q3; z++)
+                  dest[z] = ClipSuccessive(rows, z, q3);
+            }
+         }
+      }
+   };
+   ForEachSlice(q1, ssizex - q1, 30. * ssizey * ssizez, clip);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy the channels [q1, ssizex - q1) x [q2, ssizey - q2) x [q3, ssizez - q3)
+/// of from, at offset fromOffset of each z row, to to at offset toOffset.
+
+static void CopyWindow(Double_t ***from, Int_t fromOffset, Double_t ***to, Int_t toOffset,
+                       Int_t ssizex, Int_t ssizey, Int_t ssizez, Int_t q1, Int_t q2, Int_t q3)
+{
+   if (ssizez - 2 * q3 <= 0) return;
+   auto copy = [&](Int_t xfirst, Int_t xlast) {
+      for (Int_t x = xfirst; x < xlast; x++) {
+         for (Int_t y = q2; y < ssizey - q2; y++)
+            memcpy(to[x][y] + toOffset + q3, from[x][y] + fromOffset + q3, (ssizez - 2 * q3) * sizeof(Double_t));
+      }
+   };
+   ForEachSlice(q1, ssizex - q1, ssizey * ssizez, copy);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Correlate the channels of in, at offset inOffset of each z row, with the
+/// response of size lhx x lhy x lhz stored at offset 0 of resp and write
+/// out[i] = sum_j resp[j] * in[i + j] at offset outOffset of out, the sum
+/// running over the channels j inside the spectrum.
+/// The innermost loop runs along z over contiguous memory and the x slices
+/// are processed in parallel.
+
+static void CorrelateResponse(Double_t ***resp, Double_t ***in, Int_t inOffset, Double_t ***out, Int_t outOffset,
+                              Int_t ssizex, Int_t ssizey, Int_t ssizez, Int_t lhx, Int_t lhy, Int_t lhz)
+{
+   auto correlate = [&](Int_t xfirst, Int_t xlast) {
+      for (Int_t i1 = xfirst; i1 < xlast; i1++) {
+         const Int_t j1max = TMath::Min(lhx - 1, ssizex - 1 - i1);
+         for (Int_t i2 = 0; i2 < ssizey; i2++) {
+            const Int_t j2max = TMath::Min(lhy - 1, ssizey - 1 - i2);
+            Double_t *dest = out[i1][i2] + outOffset;
+            for (Int_t i3 = 0; i3 < ssizez; i3++)
+               dest[i3] = 0;
+            for (Int_t j1 = 0; j1 <= j1max; j1++) {
+               for (Int_t j2 = 0; j2 <= j2max; j2++) {
+                  const Double_t *r = resp[j1][j2];
+                  const Double_t *y = in[i1 + j1][i2 + j2] + inOffset;
+                  for (Int_t i3 = 0; i3 < ssizez; i3++) {
+                     const Int_t j3max = TMath::Min(lhz - 1, ssizez - 1 - i3);
+                     Double_t ldc = 0;
+                     for (Int_t j3 = 0; j3 <= j3max; j3++)
+                        ldc += r[j3] * y[i3 + j3];
+                     dest[i3] += ldc;
+                  }
+               }
+            }
+         }
+      }
+   };
+   ForEachSlice(0, ssizex, Double_t(ssizey) * ssizez * lhx * lhy * lhz, correlate);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// One iteration of the Gold deconvolution. The z rows of ws hold, at
+/// offsets k * ssizez, the vector ht*y (k=1), the matrix ht*h (k=2), the
+/// current solution (k=3) and the next one (k=4), which is copied to the
+/// current one at the end. If skipSmall is set the channels where the
+/// solution or ht*y vanish are left unchanged.
+/// The x slices are processed in parallel.
+
+static void GoldIteration(Double_t ***ws, Int_t ssizex, Int_t ssizey, Int_t ssizez,
+                          Int_t lhx, Int_t lhy, Int_t lhz, Bool_t skipSmall)
+{
+   const Int_t i1min = -(lhx - 1), i2min = -(lhy - 1), i3min = -(lhz - 1);
+   auto iterate = [&](Int_t xfirst, Int_t xlast) {
+      for (Int_t i1 = xfirst; i1 < xlast; i1++) {
+         const Int_t j1min = -TMath::Min(i1, lhx - 1);
+         const Int_t j1max = TMath::Min(ssizex - i1 - 1, lhx - 1);
+         for (Int_t i2 = 0; i2 < ssizey; i2++) {
+            const Int_t j2min = -TMath::Min(i2, lhy - 1);
+            const Int_t j2max = TMath::Min(ssizey - i2 - 1, lhy - 1);
+            const Double_t *hty = ws[i1][i2] + ssizez;
+            const Double_t *x = ws[i1][i2] + 3 * ssizez;
+            Double_t *xnew = ws[i1][i2] + 4 * ssizez;
+            for (Int_t i3 = 0; i3 < ssizez; i3++) {
+               if (skipSmall && !(TMath::Abs(x[i3]) > 1e-6 && TMath::Abs(hty[i3]) > 1e-6))
+                  continue;
+               const Int_t j3min = -TMath::Min(i3, lhz - 1);
+               const Int_t j3max = TMath::Min(ssizez - i3 - 1, lhz - 1);
+               Double_t lda, ldc, ldb = 0;
+               for (Int_t j1 = j1min; j1 <= j1max; j1++) {
+                  for (Int_t j2 = j2min; j2 <= j2max; j2++) {
+                     const Double_t *b = ws[j1 - i1min][j2 - i2min] + 2 * ssizez - i3min + i3;
+                     const Double_t *xj = ws[i1 + j1][i2 + j2] + 3 * ssizez + i3;
+                     for (Int_t j3 = j3min; j3 <= j3max; j3++)
+                        ldb += xj[j3] * b[j3 - i3];
+                  }
+               }
+               lda = x[i3];
+               ldc = hty[i3];
+               if (ldc * lda != 0 && ldb != 0) {
+                  lda = lda * ldc / ldb;
+               }
+
+               else
+                  lda = 0;
+               xnew[i3] = lda;
+            }
+         }
+      }
+   };
+   ForEachSlice(0, ssizex, Double_t(ssizey) * ssizez * lhx * lhy * lhz, iterate);
+   CopyWindow(ws, 4 * ssizez, ws, 3 * ssizez, ssizex, ssizey, ssizez, 0, 0, 0);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Constructor.
 
@@ -389,8 +695,7 @@ const char *TSpectrum3::Background(Double_t***spectrum,
                        Int_t direction,
                        Int_t filterType)
 {
-   Int_t i, j, x, y, z, sampling, q1, q2, q3;
-   Double_t a, b, c, d, p1, p2, p3, p4, p5, p6, p7, p8, s1, s2, s3, s4, s5, s6, s7, s8, s9, s10, s11, s12, r1, r2, r3, r4, r5, r6;
+   Int_t i, j, k, sampling, q1, q2, q3;
    if (ssizex <= 0 || ssizey <= 0 || ssizez <= 0)
       return "Wrong parameters";
    if (numberIterationsX < 1 || numberIterationsY < 1 || numberIterationsZ < 1)
@@ -405,355 +710,14 @@ const char *TSpectrum3::Background(Double_t***spectrum,
    }
    sampling =(Int_t) TMath::Max(numberIterationsX, numberIterationsY);
    sampling =(Int_t) TMath::Max(sampling, numberIterationsZ);
-   if (direction == kBackIncreasingWindow) {
-      if (filterType == kBackSuccessiveFiltering) {
-         for (i = 1; i <= sampling; i++) {
-            q1 = (Int_t) TMath::Min(i, numberIterationsX), q2 =(Int_t) TMath::Min(i, numberIterationsY), q3 =(Int_t) TMath::Min(i, numberIterationsZ);
-            for (z = q3; z < ssizez - q3; z++) {
-               for (y = q2; y < ssizey - q2; y++) {
-                  for (x = q1; x < ssizex - q1; x++) {
-                     a = spectrum[x][y][z];
-                     p1 = spectrum[x + q1][y + q2][z - q3];
-                     p2 = spectrum[x - q1][y + q2][z - q3];
-                     p3 = spectrum[x + q1][y - q2][z - q3];
-                     p4 = spectrum[x - q1][y - q2][z - q3];
-                     p5 = spectrum[x + q1][y + q2][z + q3];
-                     p6 = spectrum[x - q1][y + q2][z + q3];
-                     p7 = spectrum[x + q1][y - q2][z + q3];
-                     p8 = spectrum[x - q1][y - q2][z + q3];
-                     s1 = spectrum[x + q1][y     ][z - q3];
-                     s2 = spectrum[x     ][y + q2][z - q3];
-                     s3 = spectrum[x - q1][y     ][z - q3];
-                     s4 = spectrum[x     ][y - q2][z - q3];
-                     s5 = spectrum[x + q1][y     ][z + q3];
-                     s6 = spectrum[x     ][y + q2][z + q3];
-                     s7 = spectrum[x - q1][y     ][z + q3];
-                     s8 = spectrum[x     ][y - q2][z + q3];
-                     s9 = spectrum[x - q1][y + q2][z     ];
-                     s10 = spectrum[x - q1][y - q2][z     ];
-                     s11 = spectrum[x + q1][y + q2][z     ];
-                     s12 = spectrum[x + q1][y - q2][z     ];
-                     r1 = spectrum[x     ][y     ][z - q3];
-                     r2 = spectrum[x     ][y     ][z + q3];
-                     r3 = spectrum[x - q1][y     ][z     ];
-                     r4 = spectrum[x + q1][y     ][z     ];
-                     r5 = spectrum[x     ][y + q2][z     ];
-                     r6 = spectrum[x     ][y - q2][z     ];
-                     b = (p1 + p3) / 2.0;
-                     if(b > s1)
-                        s1 = b;
-                     b = (p1 + p2) / 2.0;
-                     if(b > s2)
-                        s2 = b;
-                     b = (p2 + p4) / 2.0;
-                     if(b > s3)
-                        s3 = b;
-                     b = (p3 + p4) / 2.0;
-                     if(b > s4)
-                        s4 = b;
-                     b = (p5 + p7) / 2.0;
-                     if(b > s5)
-                        s5 = b;
-                     b = (p5 + p6) / 2.0;
-                     if(b > s6)
-                        s6 = b;
-                     b = (p6 + p8) / 2.0;
-                     if(b > s7)
-                        s7 = b;
-                     b = (p7 + p8) / 2.0;
-                     if(b > s8)
-                        s8 = b;
-                     b = (p2 + p6) / 2.0;
-                     if(b > s9)
-                        s9 = b;
-                     b = (p4 + p8) / 2.0;
-                     if(b > s10)
-                        s10 = b;
-                     b = (p1 + p5) / 2.0;
-                     if(b > s11)
-                        s11 = b;
-                     b = (p3 + p7) / 2.0;
-                     if(b > s12)
-                        s12 = b;
-                     s1 = s1 - (p1 + p3) / 2.0;
-                     s2 = s2 - (p1 + p2) / 2.0;
-                     s3 = s3 - (p2 + p4) / 2.0;
-                     s4 = s4 - (p3 + p4) / 2.0;
-                     s5 = s5 - (p5 + p7) / 2.0;
-                     s6 = s6 - (p5 + p6) / 2.0;
-                     s7 = s7 - (p6 + p8) / 2.0;
-                     s8 = s8 - (p7 + p8) / 2.0;
-                     s9 = s9 - (p2 + p6) / 2.0;
-                     s10 = s10 - (p4 + p8) / 2.0;
-                     s11 = s11 - (p1 + p5) / 2.0;
-                     s12 = s12 - (p3 + p7) / 2.0;
-                     b = (s1 + s3) / 2.0 + (s2 + s4) / 2.0 + (p1 + p2 + p3 + p4) / 4.0;
-                     if(b > r1)
-                        r1 = b;
-                     b = (s5 + s7) / 2.0 + (s6 + s8) / 2.0 + (p5 + p6 + p7 + p8) / 4.0;
-                     if(b > r2)
-                        r2 = b;
-                     b = (s3 + s7) / 2.0 + (s9 + s10) / 2.0 + (p2 + p4 + p6 + p8) / 4.0;
-                     if(b > r3)
-                        r3 = b;
-                     b = (s1 + s5) / 2.0 + (s11 + s12) / 2.0 + (p1 + p3 + p5 + p7) / 4.0;
-                     if(b > r4)
-                        r4 = b;
-                     b = (s9 + s11) / 2.0 + (s2 + s6) / 2.0 + (p1 + p2 + p5 + p6) / 4.0;
-                     if(b > r5)
-                        r5 = b;
-                     b = (s4 + s8) / 2.0 + (s10 + s12) / 2.0 + (p3 + p4 + p7 + p8) / 4.0;
-                     if(b > r6)
-                        r6 = b;
-                     r1 = r1 - ((s1 + s3) / 2.0 + (s2 + s4) / 2.0 + (p1 + p2 + p3 + p4) / 4.0);
-                     r2 = r2 - ((s5 + s7) / 2.0 + (s6 + s8) / 2.0 + (p5 + p6 + p7 + p8) / 4.0);
-                     r3 = r3 - ((s3 + s7) / 2.0 + (s9 + s10) / 2.0 + (p2 + p4 + p6 + p8) / 4.0);
-                     r4 = r4 - ((s1 + s5) / 2.0 + (s11 + s12) / 2.0 + (p1 + p3 + p5 + p7) / 4.0);
-                     r5 = r5 - ((s9 + s11) / 2.0 + (s2 + s6) / 2.0 + (p1 + p2 + p5 + p6) / 4.0);
-                     r6 = r6 - ((s4 + s8) / 2.0 + (s10 + s12) / 2.0 + (p3 + p4 + p7 + p8) / 4.0);
-                     b = (r1 + r2) / 2.0 + (r3 + r4) / 2.0 + (r5 + r6) / 2.0 + (s1 + s3 + s5 + s7) / 4.0 + (s2 + s4 + s6 + s8) / 4.0 + (s9 + s10 + s11 + s12) / 4.0 + (p1 + p2 + p3 + p4 + p5 + p6 + p7 + p8) / 8.0;
-                     if(b < a)
-                        a = b;
-                     working_space[x][y][z] = a;
-                  }
-               }
-            }
-            for (z = q3; z < ssizez - q3; z++) {
-               for (y = q2; y < ssizey - q2; y++) {
-                  for (x = q1; x < ssizex - q1; x++) {
-                     spectrum[x][y][z] = working_space[x][y][z];
-                  }
-               }
-            }
-         }
-      }
-
-      else if (filterType == kBackOneStepFiltering) {
-         for (i = 1; i <= sampling; i++) {
-            q1 = (Int_t) TMath::Min(i, numberIterationsX), q2 =(Int_t) TMath::Min(i, numberIterationsY), q3 =(Int_t) TMath::Min(i, numberIterationsZ);
-            for (z = q3; z < ssizez - q3; z++) {
-               for (y = q2; y < ssizey - q2; y++) {
-                  for (x = q1; x < ssizex - q1; x++) {
-                     a = spectrum[x][y][z];
-                     p1 = spectrum[x + q1][y + q2][z - q3];
-                     p2 = spectrum[x - q1][y + q2][z - q3];
-                     p3 = spectrum[x + q1][y - q2][z - q3];
-                     p4 = spectrum[x - q1][y - q2][z - q3];
-                     p5 = spectrum[x + q1][y + q2][z + q3];
-                     p6 = spectrum[x - q1][y + q2][z + q3];
-                     p7 = spectrum[x + q1][y - q2][z + q3];
-                     p8 = spectrum[x - q1][y - q2][z + q3];
-                     s1 = spectrum[x + q1][y     ][z - q3];
-                     s2 = spectrum[x     ][y + q2][z - q3];
-                     s3 = spectrum[x - q1][y     ][z - q3];
-                     s4 = spectrum[x     ][y - q2][z - q3];
-                     s5 = spectrum[x + q1][y     ][z + q3];
-                     s6 = spectrum[x     ][y + q2][z + q3];
-                     s7 = spectrum[x - q1][y     ][z + q3];
-                     s8 = spectrum[x     ][y - q2][z + q3];
-                     s9 = spectrum[x - q1][y + q2][z     ];
-                     s10 = spectrum[x - q1][y - q2][z     ];
-                     s11 = spectrum[x + q1][y + q2][z     ];
-                     s12 = spectrum[x + q1][y - q2][z     ];
-                     r1 = spectrum[x     ][y     ][z - q3];
-                     r2 = spectrum[x     ][y     ][z + q3];
-                     r3 = spectrum[x - q1][y     ][z     ];
-                     r4 = spectrum[x + q1][y     ][z     ];
-                     r5 = spectrum[x     ][y + q2][z     ];
-                     r6 = spectrum[x     ][y - q2][z     ];
-                     b=(p1 + p2 + p3 + p4 + p5 + p6 + p7 + p8) / 8 - (s1 + s2 + s3 + s4 + s5 + s6 + s7 + s8 + s9 + s10 + s11 + s12) / 4 + (r1 + r2 + r3 + r4 + r5 + r6) / 2;
-                     c = -(s1 + s2 + s3 + s4 + s5 + s6 + s7 + s8 + s9 + s10 + s11 + s12) / 4 + (r1 + r2 + r3 + r4 + r5 + r6) / 2;
-                     d = -(p1 + p2 + p3 + p4 + p5 + p6 + p7 + p8) / 8 + (s1 + s2 + s3 + s4 + s5 + s6 + s7 + s8 + s9 + s10 + s11 + s12) / 12;
-                     if(b < a && b >= 0 && c >=0 && d >= 0)
-                        a = b;
-                     working_space[x][y][z] = a;
-                  }
-               }
-            }
-            for (z = q3; z < ssizez - q3; z++) {
-               for (y = q2; y < ssizey - q2; y++) {
-                  for (x = q1; x < ssizex - q1; x++) {
-                     spectrum[x][y][z] = working_space[x][y][z];
-                  }
-               }
-            }
-         }
-      }
-   }
-
-   else if (direction == kBackDecreasingWindow) {
-      if (filterType == kBackSuccessiveFiltering) {
-         for (i = sampling; i >= 1; i--) {
-            q1 = (Int_t) TMath::Min(i, numberIterationsX), q2 =(Int_t) TMath::Min(i, numberIterationsY), q3 =(Int_t) TMath::Min(i, numberIterationsZ);
-            for (z = q3; z < ssizez - q3; z++) {
-               for (y = q2; y < ssizey - q2; y++) {
-                  for (x = q1; x < ssizex - q1; x++) {
-                     a = spectrum[x][y][z];
-                     p1 = spectrum[x + q1][y + q2][z - q3];
-                     p2 = spectrum[x - q1][y + q2][z - q3];
-                     p3 = spectrum[x + q1][y - q2][z - q3];
-                     p4 = spectrum[x - q1][y - q2][z - q3];
-                     p5 = spectrum[x + q1][y + q2][z + q3];
-                     p6 = spectrum[x - q1][y + q2][z + q3];
-                     p7 = spectrum[x + q1][y - q2][z + q3];
-                     p8 = spectrum[x - q1][y - q2][z + q3];
-                     s1 = spectrum[x + q1][y     ][z - q3];
-                     s2 = spectrum[x     ][y + q2][z - q3];
-                     s3 = spectrum[x - q1][y     ][z - q3];
-                     s4 = spectrum[x     ][y - q2][z - q3];
-                     s5 = spectrum[x + q1][y     ][z + q3];
-                     s6 = spectrum[x     ][y + q2][z + q3];
-                     s7 = spectrum[x - q1][y     ][z + q3];
-                     s8 = spectrum[x     ][y - q2][z + q3];
-                     s9 = spectrum[x - q1][y + q2][z     ];
-                     s10 = spectrum[x - q1][y - q2][z     ];
-                     s11 = spectrum[x + q1][y + q2][z     ];
-                     s12 = spectrum[x + q1][y - q2][z     ];
-                     r1 = spectrum[x     ][y     ][z - q3];
-                     r2 = spectrum[x     ][y     ][z + q3];
-                     r3 = spectrum[x - q1][y     ][z     ];
-                     r4 = spectrum[x + q1][y     ][z     ];
-                     r5 = spectrum[x     ][y + q2][z     ];
-                     r6 = spectrum[x     ][y - q2][z     ];
-                     b = (p1 + p3) / 2.0;
-                     if(b > s1)
-                        s1 = b;
-                     b = (p1 + p2) / 2.0;
-                     if(b > s2)
-                        s2 = b;
-                     b = (p2 + p4) / 2.0;
-                     if(b > s3)
-                        s3 = b;
-                     b = (p3 + p4) / 2.0;
-                     if(b > s4)
-                        s4 = b;
-                     b = (p5 + p7) / 2.0;
-                     if(b > s5)
-                        s5 = b;
-                     b = (p5 + p6) / 2.0;
-                     if(b > s6)
-                        s6 = b;
-                     b = (p6 + p8) / 2.0;
-                     if(b > s7)
-                        s7 = b;
-                     b = (p7 + p8) / 2.0;
-                     if(b > s8)
-                        s8 = b;
-                     b = (p2 + p6) / 2.0;
-                     if(b > s9)
-                        s9 = b;
-                     b = (p4 + p8) / 2.0;
-                     if(b > s10)
-                        s10 = b;
-                     b = (p1 + p5) / 2.0;
-                     if(b > s11)
-                        s11 = b;
-                     b = (p3 + p7) / 2.0;
-                     if(b > s12)
-                        s12 = b;
-                     s1 = s1 - (p1 + p3) / 2.0;
-                     s2 = s2 - (p1 + p2) / 2.0;
-                     s3 = s3 - (p2 + p4) / 2.0;
-                     s4 = s4 - (p3 + p4) / 2.0;
-                     s5 = s5 - (p5 + p7) / 2.0;
-                     s6 = s6 - (p5 + p6) / 2.0;
-                     s7 = s7 - (p6 + p8) / 2.0;
-                     s8 = s8 - (p7 + p8) / 2.0;
-                     s9 = s9 - (p2 + p6) / 2.0;
-                     s10 = s10 - (p4 + p8) / 2.0;
-                     s11 = s11 - (p1 + p5) / 2.0;
-                     s12 = s12 - (p3 + p7) / 2.0;
-                     b = (s1 + s3) / 2.0 + (s2 + s4) / 2.0 + (p1 + p2 + p3 + p4) / 4.0;
-                     if(b > r1)
-                        r1 = b;
-                     b = (s5 + s7) / 2.0 + (s6 + s8) / 2.0 + (p5 + p6 + p7 + p8) / 4.0;
-                     if(b > r2)
-                        r2 = b;
-                     b = (s3 + s7) / 2.0 + (s9 + s10) / 2.0 + (p2 + p4 + p6 + p8) / 4.0;
-                     if(b > r3)
-                        r3 = b;
-                     b = (s1 + s5) / 2.0 + (s11 + s12) / 2.0 + (p1 + p3 + p5 + p7) / 4.0;
-                     if(b > r4)
-                        r4 = b;
-                     b = (s9 + s11) / 2.0 + (s2 + s6) / 2.0 + (p1 + p2 + p5 + p6) / 4.0;
-                     if(b > r5)
-                        r5 = b;
-                     b = (s4 + s8) / 2.0 + (s10 + s12) / 2.0 + (p3 + p4 + p7 + p8) / 4.0;
-                     if(b > r6)
-                        r6 = b;
-                     r1 = r1 - ((s1 + s3) / 2.0 + (s2 + s4) / 2.0 + (p1 + p2 + p3 + p4) / 4.0);
-                     r2 = r2 - ((s5 + s7) / 2.0 + (s6 + s8) / 2.0 + (p5 + p6 + p7 + p8) / 4.0);
-                     r3 = r3 - ((s3 + s7) / 2.0 + (s9 + s10) / 2.0 + (p2 + p4 + p6 + p8) / 4.0);
-                     r4 = r4 - ((s1 + s5) / 2.0 + (s11 + s12) / 2.0 + (p1 + p3 + p5 + p7) / 4.0);
-                     r5 = r5 - ((s9 + s11) / 2.0 + (s2 + s6) / 2.0 + (p1 + p2 + p5 + p6) / 4.0);
-                     r6 = r6 - ((s4 + s8) / 2.0 + (s10 + s12) / 2.0 + (p3 + p4 + p7 + p8) / 4.0);
-                     b = (r1 + r2) / 2.0 + (r3 + r4) / 2.0 + (r5 + r6) / 2.0 + (s1 + s3 + s5 + s7) / 4.0 + (s2 + s4 + s6 + s8) / 4.0 + (s9 + s10 + s11 + s12) / 4.0 + (p1 + p2 + p3 + p4 + p5 + p6 + p7 + p8) / 8.0;
-                     if(b < a)
-                        a = b;
-                     working_space[x][y][z] = a;
-                  }
-               }
-            }
-            for (z = q3; z < ssizez - q3; z++) {
-               for (y = q2; y < ssizey - q2; y++) {
-                  for (x = q1; x < ssizex - q1; x++) {
-                     spectrum[x][y][z] = working_space[x][y][z];
-                  }
-               }
-            }
-         }
-      }
-
-      else if (filterType == kBackOneStepFiltering) {
-         for (i = sampling; i >= 1; i--) {
-            q1 = (Int_t) TMath::Min(i, numberIterationsX), q2 =(Int_t) TMath::Min(i, numberIterationsY), q3 =(Int_t) TMath::Min(i, numberIterationsZ);
-            for (z = q3; z < ssizez - q3; z++) {
-               for (y = q2; y < ssizey - q2; y++) {
-                  for (x = q1; x < ssizex - q1; x++) {
-                     a = spectrum[x][y][z];
-                     p1 = spectrum[x + q1][y + q2][z - q3];
-                     p2 = spectrum[x - q1][y + q2][z - q3];
-                     p3 = spectrum[x + q1][y - q2][z - q3];
-                     p4 = spectrum[x - q1][y - q2][z - q3];
-                     p5 = spectrum[x + q1][y + q2][z + q3];
-                     p6 = spectrum[x - q1][y + q2][z + q3];
-                     p7 = spectrum[x + q1][y - q2][z + q3];
-                     p8 = spectrum[x - q1][y - q2][z + q3];
-                     s1 = spectrum[x + q1][y     ][z - q3];
-                     s2 = spectrum[x     ][y + q2][z - q3];
-                     s3 = spectrum[x - q1][y     ][z - q3];
-                     s4 = spectrum[x     ][y - q2][z - q3];
-                     s5 = spectrum[x + q1][y     ][z + q3];
-                     s6 = spectrum[x     ][y + q2][z + q3];
-                     s7 = spectrum[x - q1][y     ][z + q3];
-                     s8 = spectrum[x     ][y - q2][z + q3];
-                     s9 = spectrum[x - q1][y + q2][z     ];
-                     s10 = spectrum[x - q1][y - q2][z     ];
-                     s11 = spectrum[x + q1][y + q2][z     ];
-                     s12 = spectrum[x + q1][y - q2][z     ];
-                     r1 = spectrum[x     ][y     ][z - q3];
-                     r2 = spectrum[x     ][y     ][z + q3];
-                     r3 = spectrum[x - q1][y     ][z     ];
-                     r4 = spectrum[x + q1][y     ][z     ];
-                     r5 = spectrum[x     ][y + q2][z     ];
-                     r6 = spectrum[x     ][y - q2][z     ];
-                     b = (p1 + p2 + p3 + p4 + p5 + p6 + p7 + p8) / 8 - (s1 + s2 + s3 + s4 + s5 + s6 + s7 + s8 + s9 + s10 + s11 + s12) / 4 + (r1 + r2 + r3 + r4 + r5 + r6) / 2;
-                     c = -(s1 + s2 + s3 + s4 + s5 + s6 + s7 + s8 + s9 + s10 + s11 + s12) / 4+(r1 + r2 + r3 + r4 + r5 + r6) / 2;
-                     d = -(p1 + p2 + p3 + p4 + p5 + p6 + p7 + p8)/8 + (s1 + s2 + s3 + s4 + s5 + s6 + s7 + s8 + s9 + s10 + s11 + s12) / 12;
-                     if(b < a && b >= 0 && c >=0 && d >= 0)
-                        a = b;
-                     working_space[x][y][z] = a;
-                  }
-               }
-            }
-            for (z = q3; z < ssizez - q3; z++) {
-               for (y = q2; y < ssizey - q2; y++) {
-                  for (x = q1; x < ssizex - q1; x++) {
-                     spectrum[x][y][z] = working_space[x][y][z];
-                  }
-               }
-            }
-         }
+   if ((direction == kBackIncreasingWindow || direction == kBackDecreasingWindow) &&
+       (filterType == kBackSuccessiveFiltering || filterType == kBackOneStepFiltering)) {
+      for (k = 1; k <= sampling; k++) {
+         i = (direction == kBackIncreasingWindow) ? k : sampling + 1 - k;
+         q1 = (Int_t) TMath::Min(i, numberIterationsX), q2 =(Int_t) TMath::Min(i, numberIterationsY), q3 =(Int_t) TMath::Min(i, numberIterationsZ);
+         ClipWindow(spectrum, 0, working_space, 0, ssizex, ssizey, ssizez, q1, q2, q3,
+                    filterType == kBackOneStepFiltering);
+         CopyWindow(working_space, 0, spectrum, 0, ssizex, ssizey, ssizez, q1, q2, q3);
       }
    }
    for(i = 0;i < ssizex; i++){
@@ -1341,7 +1305,7 @@ const char* TSpectrum3::SmoothMarkov(Double_t***source, Int_t ssizex, Int_t ssiz
             nip = source[i + 1][j + 1][k] / maxch;
             nim = source[i + 1][j + 1][k + 1] / maxch;
             for(l = 1;l <= averWindow; l++){
-               if(j + l > zmax)
+               if(k + l > zmax)
                   a = source[i][j][zmax] / maxch;
 
                else
@@ -1357,7 +1321,7 @@ const char* TSpectrum3::SmoothMarkov(Double_t***source, Int_t ssizex, Int_t ssiz
                b = b / a;
                b = TMath::Exp(b);
                spz = spz + b;
-               if(j - l + 1 < ymin)
+               if(k - l + 1 < zmin)
                   a = source[i][j][zmin] / maxch;
 
                else
@@ -1595,7 +1559,7 @@ const char *TSpectrum3::Deconvolution(Double_t***source, const Double_t***resp,
                                        Int_t numberRepetitions,
                                        Double_t boost)
 {
-   Int_t i, j, k, lhx, lhy, lhz, i1, i2, i3, j1, j2, j3, k1, k2, k3, lindex, i1min, i1max, i2min, i2max, i3min, i3max, j1min, j1max, j2min, j2max, j3min, j3max, positx = 0, posity = 0, positz = 0, repet;
+   Int_t i, j, k, lhx, lhy, lhz, i1, i2, i3, j1, j2, j3, lindex, i1min, i1max, i2min, i2max, i3min, i3max, j1min, j1max, j2min, j2max, j3min, j3max, positx = 0, posity = 0, positz = 0, repet;
    Double_t lda, ldb, ldc, area, maximum = 0;
    if (ssizex <= 0 || ssizey <= 0 || ssizez <= 0)
       return "Wrong parameters";
@@ -1638,26 +1602,7 @@ const char *TSpectrum3::Deconvolution(Double_t***source, const Double_t***resp,
    }
 
 //calculate ht*y and write into p
-   for (i3 = 0; i3 < ssizez; i3++) {
-      for (i2 = 0; i2 < ssizey; i2++) {
-         for (i1 = 0; i1 < ssizex; i1++) {
-            ldc = 0;
-            for (j3 = 0; j3 <= (lhz - 1); j3++) {
-               for (j2 = 0; j2 <= (lhy - 1); j2++) {
-                  for (j1 = 0; j1 <= (lhx - 1); j1++) {
-                     k3 = i3 + j3, k2 = i2 + j2, k1 = i1 + j1;
-                     if (k3 >= 0 && k3 < ssizez && k2 >= 0 && k2 < ssizey && k1 >= 0 && k1 < ssizex) {
-                        lda = working_space[j1][j2][j3];
-                        ldb = source[k1][k2][k3];
-                        ldc = ldc + lda * ldb;
-                     }
-                  }
-               }
-            }
-            working_space[i1][i2][i3 + ssizez] = ldc;
-         }
-      }
-   }
+   CorrelateResponse(working_space, source, 0, working_space, ssizez, ssizex, ssizey, ssizez, lhx, lhy, lhz);
 
 //calculate matrix b=ht*h
    i1min = -(lhx - 1), i1max = lhx - 1;
@@ -1723,60 +1668,8 @@ const char *TSpectrum3::Deconvolution(Double_t***source, const Double_t***resp,
             }
          }
       }
-      for (lindex = 0; lindex < numberIterations; lindex++) {
-         for (i3 = 0; i3 < ssizez; i3++) {
-            for (i2 = 0; i2 < ssizey; i2++) {
-               for (i1 = 0; i1 < ssizex; i1++) {
-                  ldb = 0;
-                  j3min = i3;
-                  if (j3min > lhz - 1)
-                     j3min = lhz - 1;
-                  j3min = -j3min;
-                  j3max = ssizez - i3 - 1;
-                  if (j3max > lhz - 1)
-                     j3max = lhz - 1;
-                  j2min = i2;
-                  if (j2min > lhy - 1)
-                     j2min = lhy - 1;
-                  j2min = -j2min;
-                  j2max = ssizey - i2 - 1;
-                  if (j2max > lhy - 1)
-                     j2max = lhy - 1;
-                  j1min = i1;
-                  if (j1min > lhx - 1)
-                     j1min = lhx - 1;
-                  j1min = -j1min;
-                  j1max = ssizex - i1 - 1;
-                  if (j1max > lhx - 1)
-                     j1max = lhx - 1;
-                  for (j3 = j3min; j3 <= j3max; j3++) {
-                     for (j2 = j2min; j2 <= j2max; j2++) {
-                        for (j1 = j1min; j1 <= j1max; j1++) {
-                           ldc =  working_space[j1 - i1min][j2 - i2min][j3 - i3min + 2 * ssizez];
-                           lda = working_space[i1 + j1][i2 + j2][i3 + j3 + 3 * ssizez];
-                           ldb = ldb + lda * ldc;
-                        }
-                     }
-                  }
-                  lda = working_space[i1][i2][i3 + 3 * ssizez];
-                  ldc = working_space[i1][i2][i3 + 1 * ssizez];
-                  if (ldc * lda != 0 && ldb != 0) {
-                     lda = lda * ldc / ldb;
-                  }
-
-                  else
-                     lda = 0;
-                  working_space[i1][i2][i3 + 4 * ssizez] = lda;
-               }
-            }
-         }
-         for (i3 = 0; i3 < ssizez; i3++) {
-            for (i2 = 0; i2 < ssizey; i2++) {
-               for (i1 = 0; i1 < ssizex; i1++)
-                  working_space[i1][i2][i3 + 3 * ssizez] = working_space[i1][i2][i3 + 4 * ssizez];
-            }
-         }
-      }
+      for (lindex = 0; lindex < numberIterations; lindex++)
+         GoldIteration(working_space, ssizex, ssizey, ssizez, lhx, lhy, lhz, kFALSE);
    }
    for (i = 0; i < ssizex; i++) {
       for (j = 0; j < ssizey; j++){
@@ -1941,10 +1834,8 @@ Int_t TSpectrum3::SearchHighRes(const Double_t***source,Double_t***dest, Int_t s
    Int_t ymin,ymax,zmin,zmax,i,j;
    Double_t a,b,maxch,plocha = 0,plocha_markov = 0;
    Double_t nom,nip,nim,sp,sm,spx,spy,smx,smy,spz,smz;
-   Double_t p1,p2,p3,p4,p5,p6,p7,p8,s1,s2,s3,s4,s5,s6,s7,s8,s9,s10,s11,s12,r1,r2,r3,r4,r5,r6;
-   Int_t x,y,z;
    Double_t pocet_sigma = 5;
-   Int_t lhx,lhy,lhz,i1,i2,i3,j1,j2,j3,k1,k2,k3,i1min,i1max,i2min,i2max,i3min,i3max,j1min,j1max,j2min,j2max,j3min,j3max,positx,posity,positz;
+   Int_t lhx,lhy,lhz,i1,i2,i3,j1,j2,j3,i1min,i1max,i2min,i2max,i3min,i3max,j1min,j1max,j2min,j2max,j3min,j3max,positx,posity,positz;
    if(sigma < 1){
       Error("SearchHighRes", "Invalid sigma, must be greater than or equal to 1");
       return 0;
@@ -2095,141 +1986,8 @@ Int_t TSpectrum3::SearchHighRes(const Double_t***source,Double_t***dest, Int_t s
    }
    if(backgroundRemove == true){
       for(i = 1;i <= number_of_iterations; i++){
-        for(z = i;z < sizez_ext - i; z++){
-           for(y = i;y < sizey_ext - i; y++){
-             for(x = i;x < sizex_ext - i; x++){
-               a = working_space[x][y][z + sizez_ext];
-                  p1 = working_space[x + i][y + i][z - i + sizez_ext];
-                  p2 = working_space[x - i][y + i][z - i + sizez_ext];
-                  p3 = working_space[x + i][y - i][z - i + sizez_ext];
-                  p4 = working_space[x - i][y - i][z - i + sizez_ext];
-                  p5 = working_space[x + i][y + i][z + i + sizez_ext];
-                  p6 = working_space[x - i][y + i][z + i + sizez_ext];
-                  p7 = working_space[x + i][y - i][z + i + sizez_ext];
-                  p8 = working_space[x - i][y - i][z + i + sizez_ext];
-                  s1 = working_space[x + i][y    ][z - i + sizez_ext];
-                  s2 = working_space[x    ][y + i][z - i + sizez_ext];
-                  s3 = working_space[x - i][y    ][z - i + sizez_ext];
-                  s4 = working_space[x    ][y - i][z - i + sizez_ext];
-                  s5 = working_space[x + i][y    ][z + i + sizez_ext];
-                  s6 = working_space[x    ][y + i][z + i + sizez_ext];
-                  s7 = working_space[x - i][y    ][z + i + sizez_ext];
-                  s8 = working_space[x    ][y - i][z + i + sizez_ext];
-                  s9 = working_space[x - i][y + i][z     + sizez_ext];
-                  s10 = working_space[x - i][y - i][z     +sizez_ext];
-                  s11 = working_space[x + i][y + i][z     +sizez_ext];
-                  s12 = working_space[x + i][y - i][z     +sizez_ext];
-                  r1 = working_space[x    ][y    ][z - i + sizez_ext];
-                  r2 = working_space[x    ][y    ][z + i + sizez_ext];
-                  r3 = working_space[x - i][y    ][z     + sizez_ext];
-                  r4 = working_space[x + i][y    ][z     + sizez_ext];
-                  r5 = working_space[x    ][y + i][z     + sizez_ext];
-                  r6 = working_space[x    ][y - i][z     + sizez_ext];
-                  b = (p1 + p3) / 2.0;
-                  if(b > s1)
-                     s1 = b;
-
-                  b = (p1 + p2) / 2.0;
-                  if(b > s2)
-                     s2 = b;
-
-                  b = (p2 + p4) / 2.0;
-                  if(b > s3)
-                     s3 = b;
-
-                  b = (p3 + p4) / 2.0;
-                  if(b > s4)
-                     s4 = b;
-
-                  b = (p5 + p7) / 2.0;
-                  if(b > s5)
-                     s5 = b;
-
-                  b = (p5 + p6) / 2.0;
-                  if(b > s6)
-                     s6 = b;
-
-                  b = (p6 + p8) / 2.0;
-                  if(b > s7)
-                     s7 = b;
-
-                  b = (p7 + p8) / 2.0;
-                  if(b > s8)
-                     s8 = b;
-
-                  b = (p2 + p6) / 2.0;
-                  if(b > s9)
-                     s9 = b;
-
-                  b = (p4 + p8) / 2.0;
-                  if(b > s10)
-                     s10 = b;
-
-                  b = (p1 + p5) / 2.0;
-                  if(b > s11)
-                     s11 = b;
-
-                  b = (p3 + p7) / 2.0;
-                  if(b > s12)
-                     s12 = b;
-
-                  s1 = s1 - (p1 + p3) / 2.0;
-                  s2 = s2 - (p1 + p2) / 2.0;
-                  s3 = s3 - (p2 + p4) / 2.0;
-                  s4 = s4 - (p3 + p4) / 2.0;
-                  s5 = s5 - (p5 + p7) / 2.0;
-                  s6 = s6 - (p5 + p6) / 2.0;
-                  s7 = s7 - (p6 + p8) / 2.0;
-                  s8 = s8 - (p7 + p8) / 2.0;
-                  s9 = s9 - (p2 + p6) / 2.0;
-                  s10 = s10 - (p4 + p8) / 2.0;
-                  s11 = s11 - (p1 + p5) / 2.0;
-                  s12 = s12 - (p3 + p7) / 2.0;
-                  b = (s1 + s3) / 2.0 + (s2 + s4) / 2.0 + (p1 + p2 + p3 + p4) / 4.0;
-                  if(b > r1)
-                     r1 = b;
-
-                  b = (s5 + s7) / 2.0 + (s6 + s8) / 2.0 + (p5 + p6 + p7 + p8) / 4.0;
-                  if(b > r2)
-                     r2 = b;
-
-                  b = (s3 + s7) / 2.0 + (s9 + s10) / 2.0 + (p2 + p4 + p6 + p8) / 4.0;
-                  if(b > r3)
-                     r3 = b;
-
-                  b = (s1 + s5) / 2.0 + (s11 + s12) / 2.0 + (p1 + p3 + p5 + p7) / 4.0;
-                  if(b > r4)
-                     r4 = b;
-
-                  b = (s9 + s11) / 2.0 + (s2 + s6) / 2.0 + (p1 + p2 + p5 + p6) / 4.0;
-                  if(b > r5)
-                     r5 = b;
-
-                  b = (s4 + s8) / 2.0 + (s10 + s12) / 2.0 + (p3 + p4 + p7 + p8) / 4.0;
-                  if(b > r6)
-                     r6 = b;
-
-                  r1 = r1 - ((s1 + s3) / 2.0 + (s2 + s4) / 2.0 + (p1 + p2 + p3 + p4) / 4.0);
-                  r2 = r2 - ((s5 + s7) / 2.0 + (s6 + s8) / 2.0 + (p5 + p6 + p7 + p8) / 4.0);
-                  r3 = r3 - ((s3 + s7) / 2.0 + (s9 + s10) / 2.0 + (p2 + p4 + p6 + p8) / 4.0);
-                  r4 = r4 - ((s1 + s5) / 2.0 + (s11 + s12) / 2.0 + (p1 + p3 + p5 + p7) / 4.0);
-                  r5 = r5 - ((s9 + s11) / 2.0 + (s2 + s6) / 2.0 + (p1 + p2 + p5 + p6) / 4.0);
-                  r6 = r6 - ((s4 + s8) / 2.0 + (s10 + s12) / 2.0 + (p3 + p4 + p7 + p8) / 4.0);
-                  b = (r1 + r2) / 2.0 + (r3 + r4) / 2.0 + (r5 + r6) / 2.0 + (s1 + s3 + s5 + s7) / 4.0 + (s2 + s4 + s6 + s8) / 4.0 + (s9 + s10 + s11 + s12) / 4.0 + (p1 + p2 + p3 + p4 + p5 + p6 + p7 + p8) / 8.0;
-                  if(b < a)
-                     a = b;
-
-                  working_space[x][y][z] = a;
-               }
-            }
-         }
-         for(z = i;z < sizez_ext - i; z++){
-            for(y = i;y < sizey_ext - i; y++){
-               for(x = i;x < sizex_ext - i; x++){
-                  working_space[x][y][z + sizez_ext] = working_space[x][y][z];
-               }
-            }
-         }
+         ClipWindow(working_space, sizez_ext, working_space, 0, sizex_ext, sizey_ext, sizez_ext, i, i, i, kFALSE);
+         CopyWindow(working_space, 0, working_space, sizez_ext, sizex_ext, sizey_ext, sizez_ext, i, i, i);
       }
       for(k = 0;k < sizez_ext; k++){
          for(j = 0;j < sizey_ext; j++){
@@ -2825,7 +2583,7 @@ Int_t TSpectrum3::SearchHighRes(const Double_t***source,Double_t***dest, Int_t s
                nip = working_space[i + 1][j + 1][k + 2 * sizez_ext] / maxch;
                nim = working_space[i + 1][j + 1][k + 1 + 2 * sizez_ext] / maxch;
                for(l = 1;l <= averWindow; l++ ){
-                  if(j + l > zmax)
+                  if(k + l > zmax)
                      a = working_space[i][j][zmax + 2 * sizez_ext] / maxch;
 
                   else
@@ -2841,7 +2599,7 @@ Int_t TSpectrum3::SearchHighRes(const Double_t***source,Double_t***dest, Int_t s
                   b = b / a;
                   b = TMath::Exp(b);
                   spz = spz + b;
-                  if(j - l + 1 < ymin)
+                  if(k - l + 1 < zmin)
                      a = working_space[i][j][zmin + 2 * sizez_ext] / maxch;
 
                   else
@@ -2924,26 +2682,8 @@ Int_t TSpectrum3::SearchHighRes(const Double_t***source,Double_t***dest, Int_t s
       }
    }
    //calculate ht*y and write into p
-   for (i3 = 0; i3 < sizez_ext; i3++) {
-      for (i2 = 0; i2 < sizey_ext; i2++) {
-         for (i1 = 0; i1 < sizex_ext; i1++) {
-            ldc = 0;
-            for (j3 = 0; j3 <= (lhz - 1); j3++) {
-               for (j2 = 0; j2 <= (lhy - 1); j2++) {
-                  for (j1 = 0; j1 <= (lhx - 1); j1++) {
-                     k3 = i3 + j3, k2 = i2 + j2, k1 = i1 + j1;
-                     if (k3 >= 0 && k3 < sizez_ext && k2 >= 0 && k2 < sizey_ext && k1 >= 0 && k1 < sizex_ext) {
-                        lda = working_space[j1][j2][j3];
-                        ldb = working_space[k1][k2][k3+2*sizez_ext];
-                        ldc = ldc + lda * ldb;
-                     }
-                  }
-               }
-            }
-            working_space[i1][i2][i3 + sizez_ext] = ldc;
-         }
-      }
-   }
+   CorrelateResponse(working_space, working_space, 2 * sizez_ext, working_space, sizez_ext,
+                     sizex_ext, sizey_ext, sizez_ext, lhx, lhy, lhz);
 //calculate b=ht*h
    i1min = -(lhx - 1), i1max = lhx - 1;
    i2min = -(lhy - 1), i2max = lhy - 1;
@@ -3005,68 +2745,8 @@ Int_t TSpectrum3::SearchHighRes(const Double_t***source,Double_t***dest, Int_t s
    }
 
 //START OF ITERATIONS
-   for (lindex=0;lindex<deconIterations;lindex++){
-      for (i3 = 0; i3 < sizez_ext; i3++) {
-         for (i2 = 0; i2 < sizey_ext; i2++) {
-            for (i1 = 0; i1 < sizex_ext; i1++) {
-               if (TMath::Abs(working_space[i1][i2][i3 + 3 * sizez_ext])>1e-6 && TMath::Abs(working_space[i1][i2][i3 + 1 * sizez_ext])>1e-6){
-                  ldb = 0;
-                  j3min = i3;
-                  if (j3min > lhz - 1)
-                     j3min = lhz - 1;
-
-                  j3min = -j3min;
-                  j3max = sizez_ext - i3 - 1;
-                  if (j3max > lhz - 1)
-                     j3max = lhz - 1;
-
-                  j2min = i2;
-                  if (j2min > lhy - 1)
-                     j2min = lhy - 1;
-
-                  j2min = -j2min;
-                  j2max = sizey_ext - i2 - 1;
-                  if (j2max > lhy - 1)
-                     j2max = lhy - 1;
-
-                  j1min = i1;
-                  if (j1min > lhx - 1)
-                     j1min = lhx - 1;
-
-                  j1min = -j1min;
-                  j1max = sizex_ext - i1 - 1;
-                  if (j1max > lhx - 1)
-                     j1max = lhx - 1;
-
-                  for (j3 = j3min; j3 <= j3max; j3++) {
-                     for (j2 = j2min; j2 <= j2max; j2++) {
-                        for (j1 = j1min; j1 <= j1max; j1++) {
-                           ldc =  working_space[j1 - i1min][j2 - i2min][j3 - i3min + 2 * sizez_ext];
-                           lda = working_space[i1 + j1][i2 + j2][i3 + j3 + 3 * sizez_ext];
-                           ldb = ldb + lda * ldc;
-                        }
-                     }
-                  }
-                  lda = working_space[i1][i2][i3 + 3 * sizez_ext];
-                  ldc = working_space[i1][i2][i3 + 1 * sizez_ext];
-                  if (ldc * lda != 0 && ldb != 0) {
-                     lda = lda * ldc / ldb;
-                  }
-
-                  else
-                     lda = 0;
-                  working_space[i1][i2][i3 + 4 * sizez_ext] = lda;
-               }
-            }
-         }
-      }
-      for (i3 = 0; i3 < sizez_ext; i3++) {
-         for (i2 = 0; i2 < sizey_ext; i2++) {
-            for (i1 = 0; i1 < sizex_ext; i1++)
-               working_space[i1][i2][i3 + 3 * sizez_ext] = working_space[i1][i2][i3 + 4 * sizez_ext];
-         }
-      }
-   }
+   for (lindex=0;lindex<deconIterations;lindex++)
+      GoldIteration(working_space, sizex_ext, sizey_ext, sizez_ext, lhx, lhy, lhz, kTRUE);
 //write back resulting spectrum
    maximum=0;
   for(i = 0;i < sizex_ext; i++){
@@ -3160,7 +2840,6 @@ Int_t TSpectrum3::SearchFast(const Double_t***source, Double_t***dest, Int_t ssi
    Double_t norma,val,val1,val2,val3,val4,val5,val6,val7,val8,val9,val10,val11,val12,val13,val14,val15,val16,val17,val18,val19,val20,val21,val22,val23,val24,val25,val26;
    Double_t a,b,s,f,maximum;
    Int_t x,y,z,peak_index=0;
-   Double_t p1,p2,p3,p4,p5,p6,p7,p8,s1,s2,s3,s4,s5,s6,s7,s8,s9,s10,s11,s12,r1,r2,r3,r4,r5,r6;
    Double_t pocet_sigma = 5;
    Int_t number_of_iterations=(Int_t)(4 * sigma + 0.5);
    Int_t sizex_ext=ssizex + 4 * number_of_iterations,sizey_ext = ssizey + 4 * number_of_iterations,sizez_ext = ssizez + 4 * number_of_iterations,shift = 2 * number_of_iterations;
@@ -3313,141 +2992,8 @@ Int_t TSpectrum3::SearchFast(const Double_t***source, Double_t***dest, Int_t ssi
       }
    }
    for(i = 1;i <= number_of_iterations; i++){
-      for(z = i;z < sizez_ext - i; z++){
-         for(y = i;y < sizey_ext - i; y++){
-            for(x = i;x < sizex_ext - i; x++){
-               a = working_space[x][y][z + sizez_ext];
-               p1 = working_space[x + i][y + i][z - i + sizez_ext];
-               p2 = working_space[x - i][y + i][z - i + sizez_ext];
-               p3 = working_space[x + i][y - i][z - i + sizez_ext];
-               p4 = working_space[x - i][y - i][z - i + sizez_ext];
-               p5 = working_space[x + i][y + i][z + i + sizez_ext];
-               p6 = working_space[x - i][y + i][z + i + sizez_ext];
-               p7 = working_space[x + i][y - i][z + i + sizez_ext];
-               p8 = working_space[x - i][y - i][z + i + sizez_ext];
-               s1 = working_space[x + i][y    ][z - i + sizez_ext];
-               s2 = working_space[x    ][y + i][z - i + sizez_ext];
-               s3 = working_space[x - i][y    ][z - i + sizez_ext];
-               s4 = working_space[x    ][y - i][z - i + sizez_ext];
-               s5 = working_space[x + i][y    ][z + i + sizez_ext];
-               s6 = working_space[x    ][y + i][z + i + sizez_ext];
-               s7 = working_space[x - i][y    ][z + i + sizez_ext];
-               s8 = working_space[x    ][y - i][z + i + sizez_ext];
-               s9 = working_space[x - i][y + i][z     + sizez_ext];
-               s10 = working_space[x - i][y - i][z     +sizez_ext];
-               s11 = working_space[x + i][y + i][z     +sizez_ext];
-               s12 = working_space[x + i][y - i][z     +sizez_ext];
-               r1 = working_space[x    ][y    ][z - i + sizez_ext];
-               r2 = working_space[x    ][y    ][z + i + sizez_ext];
-               r3 = working_space[x - i][y    ][z     + sizez_ext];
-               r4 = working_space[x + i][y    ][z     + sizez_ext];
-               r5 = working_space[x    ][y + i][z     + sizez_ext];
-               r6 = working_space[x    ][y - i][z     + sizez_ext];
-               b = (p1 + p3) / 2.0;
-               if(b > s1)
-                  s1 = b;
-
-               b = (p1 + p2) / 2.0;
-               if(b > s2)
-                  s2 = b;
-
-               b = (p2 + p4) / 2.0;
-               if(b > s3)
-                  s3 = b;
-
-               b = (p3 + p4) / 2.0;
-               if(b > s4)
-                  s4 = b;
-
-               b = (p5 + p7) / 2.0;
-               if(b > s5)
-                  s5 = b;
-
-               b = (p5 + p6) / 2.0;
-               if(b > s6)
-                  s6 = b;
-
-               b = (p6 + p8) / 2.0;
-               if(b > s7)
-                  s7 = b;
-
-               b = (p7 + p8) / 2.0;
-               if(b > s8)
-                  s8 = b;
-
-               b = (p2 + p6) / 2.0;
-               if(b > s9)
-                  s9 = b;
-
-               b = (p4 + p8) / 2.0;
-               if(b > s10)
-                  s10 = b;
-
-               b = (p1 + p5) / 2.0;
-               if(b > s11)
-                  s11 = b;
-
-               b = (p3 + p7) / 2.0;
-               if(b > s12)
-                  s12 = b;
-
-               s1 = s1 - (p1 + p3) / 2.0;
-               s2 = s2 - (p1 + p2) / 2.0;
-               s3 = s3 - (p2 + p4) / 2.0;
-               s4 = s4 - (p3 + p4) / 2.0;
-               s5 = s5 - (p5 + p7) / 2.0;
-               s6 = s6 - (p5 + p6) / 2.0;
-               s7 = s7 - (p6 + p8) / 2.0;
-               s8 = s8 - (p7 + p8) / 2.0;
-               s9 = s9 - (p2 + p6) / 2.0;
-               s10 = s10 - (p4 + p8) / 2.0;
-               s11 = s11 - (p1 + p5) / 2.0;
-               s12 = s12 - (p3 + p7) / 2.0;
-               b = (s1 + s3) / 2.0 + (s2 + s4) / 2.0 + (p1 + p2 + p3 + p4) / 4.0;
-               if(b > r1)
-                  r1 = b;
-
-               b = (s5 + s7) / 2.0 + (s6 + s8) / 2.0 + (p5 + p6 + p7 + p8) / 4.0;
-               if(b > r2)
-                  r2 = b;
-
-               b = (s3 + s7) / 2.0 + (s9 + s10) / 2.0 + (p2 + p4 + p6 + p8) / 4.0;
-               if(b > r3)
-                  r3 = b;
-
-               b = (s1 + s5) / 2.0 + (s11 + s12) / 2.0 + (p1 + p3 + p5 + p7) / 4.0;
-               if(b > r4)
-                  r4 = b;
-
-               b = (s9 + s11) / 2.0 + (s2 + s6) / 2.0 + (p1 + p2 + p5 + p6) / 4.0;
-               if(b > r5)
-                  r5 = b;
-
-               b = (s4 + s8) / 2.0 + (s10 + s12) / 2.0 + (p3 + p4 + p7 + p8) / 4.0;
-               if(b > r6)
-                  r6 = b;
-
-               r1 = r1 - ((s1 + s3) / 2.0 + (s2 + s4) / 2.0 + (p1 + p2 + p3 + p4) / 4.0);
-               r2 = r2 - ((s5 + s7) / 2.0 + (s6 + s8) / 2.0 + (p5 + p6 + p7 + p8) / 4.0);
-               r3 = r3 - ((s3 + s7) / 2.0 + (s9 + s10) / 2.0 + (p2 + p4 + p6 + p8) / 4.0);
-               r4 = r4 - ((s1 + s5) / 2.0 + (s11 + s12) / 2.0 + (p1 + p3 + p5 + p7) / 4.0);
-               r5 = r5 - ((s9 + s11) / 2.0 + (s2 + s6) / 2.0 + (p1 + p2 + p5 + p6) / 4.0);
-               r6 = r6 - ((s4 + s8) / 2.0 + (s10 + s12) / 2.0 + (p3 + p4 + p7 + p8) / 4.0);
-               b = (r1 + r2) / 2.0 + (r3 + r4) / 2.0 + (r5 + r6) / 2.0 + (s1 + s3 + s5 + s7) / 4.0 + (s2 + s4 + s6 + s8) / 4.0 + (s9 + s10 + s11 + s12) / 4.0 + (p1 + p2 + p3 + p4 + p5 + p6 + p7 + p8) / 8.0;
-               if(b < a)
-                  a = b;
-
-               working_space[x][y][z] = a;
-            }
-         }
-      }
-      for(z = i;z < sizez_ext - i; z++){
-         for(y = i;y < sizey_ext - i; y++){
-            for(x = i;x < sizex_ext - i; x++){
-               working_space[x][y][z + sizez_ext] = working_space[x][y][z];
-            }
-         }
-      }
+      ClipWindow(working_space, sizez_ext, working_space, 0, sizex_ext, sizey_ext, sizez_ext, i, i, i, kFALSE);
+      CopyWindow(working_space, 0, working_space, sizez_ext, sizex_ext, sizey_ext, sizez_ext, i, i, i);
    }
    for(k = 0;k < sizez_ext; k++){
       for(j = 0;j < sizey_ext; j++){
@@ -4048,7 +3594,7 @@ Int_t TSpectrum3::SearchFast(const Double_t***source, Double_t***dest, Int_t ssi
                nip = working_space[i + 1][j + 1][k + 2 * sizez_ext] / maxch;
                nim = working_space[i + 1][j + 1][k + 1 + 2 * sizez_ext] / maxch;
                for(l = 1;l <= averWindow; l++ ){
-                  if(j + l > zmax)
+                  if(k + l > zmax)
                      a = working_space[i][j][zmax + 2 * sizez_ext] / maxch;
 
                   else
@@ -4064,7 +3610,7 @@ Int_t TSpectrum3::SearchFast(const Double_t***source, Double_t***dest, Int_t ssi
                   b = b / a;
                   b = TMath::Exp(b);
                   spz = spz + b;
-                  if(j - l + 1 < ymin)
+                  if(k - l + 1 < zmin)
                      a = working_space[i][j][zmin + 2 * sizez_ext] / maxch;
 
                   else
@@ -21,6 +21,8 @@ a Grid environment where the files might be accessable via Castor,
 rfio, dcap, etc.
 The merging interface allows files containing histograms and trees
 to be merged, like the standalone hadd program.
+Histograms with the same binning are merged in parallel when implicit
+multithreading is enabled (see ROOT::EnableImplicitMT and TH1::Merge).
 */
 
 #include "TFileMerger.h"
@@ -51,6 +51,11 @@
   If the option -cachedsize is used, hadd will resize (or disable if 0) the
   prefetching cache use to speed up I/O operations.
 
+  If the option -j is used, hadd enables the implicit multithreading of ROOT:
+  the bins of large histograms with identical binning are merged in parallel.
+  The number of threads can follow the option (-j 8), by default it is chosen
+  by ROOT.
+
   For options that takes a size as argument, a decimal number of bytes is expected.
   If the number ends with a ``k'', ``m'', ``g'', etc., the number is multiplied
   by 1000 (1K), 1000000 (1MB), 1000000000 (1G), etc.
@@ -80,6 +85,7 @@
 #include "TClass.h"
 #include "TSystem.h"
 #include "ROOT/StringConv.h"
+#include "TROOT.h"
 #include <stdlib.h>
 #include <climits>
 
@@ -91,7 +97,7 @@ int main( int argc, char **argv )
 {
    if ( argc < 3 || "-h" == std::string(argv[1]) || "--help" == std::string(argv[1]) ) {
       std::cout << "Usage: " << argv[0] << " [-f[fk][0-9]] [-k] [-T] [-O] [-a] \n"
-      "            [-n maxopenedfiles] [-cachesize size] [-v [verbosity]] \n"
+      "            [-n maxopenedfiles] [-cachesize size] [-j [nthreads]] [-v [verbosity]] \n"
       "            targetfile source1 [source2 source3 ...]\n" << std::endl;
       std::cout << "This program will add histograms from a list of root files and write them" << std::endl;
       std::cout << "   to a target root file. The target file is newly created and must not" << std::endl;
@@ -108,6 +114,8 @@ int main( int argc, char **argv )
                    "   to request to use the system maximum." << std::endl;
       std::cout << "If the option -cachedsize is used, hadd will resize (or disable if 0) the\n"
                    "   prefetching cache use to speed up I/O operations." << std::endl;
+      std::cout << "If the option -j is used, the bins of large histograms are merged by several\n"
+                   "   threads; the number of threads can follow -j, by default ROOT chooses it." << std::endl;
       std::cout << "When -the -f option is specified, one can also specify the compression level of\n"
                    "   the target file.  By default the compression level is 1." <<std::endl;
       std::cout << "If \"-fk\" is specified, the target file contain the baskets with the same\n"
@@ -141,6 +149,8 @@ int main( int argc, char **argv )
    Bool_t useFirstInputCompression = kFALSE;
    Int_t maxopenedfiles = 0;
    Int_t verbosity = 99;
+   Bool_t multithread = kFALSE;
+   Int_t nthreads = 0;
    TString cacheSize;
 
    int outputPlace = 0;
@@ -221,6 +231,19 @@ int main( int argc, char **argv )
             }
          }
          ++ffirst;
+      } else if ( strcmp(argv[a],"-j") == 0 ) {
+         multithread = kTRUE;
+         if (a+1 < argc && isdigit(argv[a+1][0])) {
+            Long_t request = strtol(argv[a+1], 0, 10);
+            if (request < kMaxInt && request >= 0) {
+               nthreads = (Int_t)request;
+               ++a;
+               ++ffirst;
+            } else {
+               std::cerr << "Error: could not parse the number of threads passed after -j: " << argv[a+1] << ". We will let ROOT choose it.\n";
+            }
+         }
+         ++ffirst;
       } else if ( strcmp(argv[a],"-v") == 0 ) {
          if (a+1 == argc || argv[a+1][0] == '-') {
             // Verbosity level was not specified use the default:
@@ -297,6 +320,14 @@ int main( int argc, char **argv )
 
    gSystem->Load("libTreePlayer");
 
+   if (multithread) {
+#ifdef R__USE_IMT
+      ROOT::EnableImplicitMT(nthreads);
+#else
+      std::cerr << "Warning: ROOT was built without implicit multithreading, option -j is ignored.\n";
+#endif
+   }
+
    const char *targetname = 0;
    if (outputPlace) {
       targetname = argv[outputPlace];
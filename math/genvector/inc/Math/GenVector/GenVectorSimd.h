@@ -0,0 +1,85 @@
+// @(#)root/mathcore:$Id$
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2016 , LCG ROOT MathLib Team                         *
+ *                                                                    *
+ *                                                                    *
+ **********************************************************************/
+
+// Header file for the functions moving vectors to and from SIMD batches
+//
+#ifndef ROOT_Math_GenVector_GenVectorSimd
+#define ROOT_Math_GenVector_GenVectorSimd  1
+
+#include "Math/GenVector/LorentzVector.h"
+#include "Math/GenVector/DisplacementVector3D.h"
+#include "Math/Types.h"
+
+namespace ROOT {
+
+   namespace Math {
+
+      /**
+         A LorentzVector or DisplacementVector3D whose coordinates are of a SIMD
+         type, like LorentzVector<PxPyPzE4D<ROOT::Double_v> >, holds one vector per
+         SIMD lane. Sums, invariant masses, VectorUtil::InvariantMass, BoostToCM and
+         VectorUtil::boost are then applied lane-wise to all of them at once.
+         SimdLoad and SimdStore move scalar vectors to and from the lanes; when n is
+         smaller than the number of lanes the remaining lanes are filled with src[n-1],
+         and dst is not changed if n is 0.
+
+         @ingroup GenVector
+      */
+
+      template <template <class> class Coord, class V, class T>
+      void SimdLoad(LorentzVector<Coord<V> > & dst, const LorentzVector<Coord<T> > * src,
+                    unsigned int n = SimdTraits<V>::kSize) {
+         if (n == 0) return;
+         V c[4];
+         for (unsigned int k = 0; k < static_cast<unsigned int>(SimdTraits<V>::kSize); ++k) {
+            T x[4];
+            src[k < n ? k : n-1].GetCoordinates(x);
+            for (unsigned int i = 0; i < 4; ++i) SimdTraits<V>::Set(c[i], k, x[i]);
+         }
+         dst.SetCoordinates(c);
+      }
+
+      template <template <class> class Coord, class V, class T>
+      void SimdStore(const LorentzVector<Coord<V> > & src, LorentzVector<Coord<T> > * dst,
+                     unsigned int n = SimdTraits<V>::kSize) {
+         V c[4];
+         src.GetCoordinates(c);
+         for (unsigned int k = 0; k < n; ++k)
+            dst[k].SetCoordinates(SimdTraits<V>::Get(c[0], k), SimdTraits<V>::Get(c[1], k),
+                                  SimdTraits<V>::Get(c[2], k), SimdTraits<V>::Get(c[3], k));
+      }
+
+      template <template <class> class Coord, class V, class T, class Tag>
+      void SimdLoad(DisplacementVector3D<Coord<V>, Tag> & dst, const DisplacementVector3D<Coord<T>, Tag> * src,
+                    unsigned int n = SimdTraits<V>::kSize) {
+         if (n == 0) return;
+         V c[3];
+         for (unsigned int k = 0; k < static_cast<unsigned int>(SimdTraits<V>::kSize); ++k) {
+            T x[3];
+            src[k < n ? k : n-1].GetCoordinates(x);
+            for (unsigned int i = 0; i < 3; ++i) SimdTraits<V>::Set(c[i], k, x[i]);
+         }
+         dst.SetCoordinates(c);
+      }
+
+      template <template <class> class Coord, class V, class T, class Tag>
+      void SimdStore(const DisplacementVector3D<Coord<V>, Tag> & src, DisplacementVector3D<Coord<T>, Tag> * dst,
+                     unsigned int n = SimdTraits<V>::kSize) {
+         V c[3];
+         src.GetCoordinates(c);
+         for (unsigned int k = 0; k < n; ++k)
+            dst[k].SetCoordinates(SimdTraits<V>::Get(c[0], k), SimdTraits<V>::Get(c[1], k),
+                                  SimdTraits<V>::Get(c[2], k));
+      }
+
+   } // end namespace Math
+
+} // end namespace ROOT
+
+#endif /* ROOT_Math_GenVector_GenVectorSimd  */
@@ -541,16 +541,17 @@ namespace ROOT {
           its center of mass frame (zero momentum)
        */
        BetaVector BoostToCM( ) const {
-          if (E() == 0) {
-             if (P() == 0) {
+          if (AnyOf(E() == 0)) {
+             if (AllOf(E() == 0 && P2() == 0)) {
                 return BetaVector();
              } else {
                 // TODO - should attempt to Throw with msg about
                 // boostVector computed for LorentzVector with t=0
-                return -Vect()/E();
+                // Null vectors in a SIMD batch get beta = 0.
+                return -Vect()/Select(E() == 0 && P2() == 0, Scalar(1), E());
              }
           }
-          if (M2() <= 0) {
+          if (AnyOf(M2() <= 0)) {
              // TODO - should attempt to Throw with msg about
              // boostVector computed for a non-timelike LorentzVector
           }
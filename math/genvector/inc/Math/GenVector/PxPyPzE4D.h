@@ -27,6 +27,8 @@
 #endif
 
 
+#include "Math/Types.h"
+
 #include <cmath>
 
 namespace ROOT {
@@ -139,7 +141,7 @@ public :
    /**
       magnitude of spatial components (magnitude of 3-momentum)
    */
-   Scalar P() const { return std::sqrt(P2()); }
+   Scalar P() const { using std::sqrt; return sqrt(P2()); }
    Scalar R() const { return P(); }
 
    /**
@@ -152,13 +154,15 @@ public :
       invariant mass
    */
    Scalar M() const    {
+      using std::sqrt;
       Scalar mm = M2();
-      if (mm >= 0) {
-         return std::sqrt(mm);
+      if (AllOf(mm >= 0)) {
+         return sqrt(mm);
       } else {
          GenVector::Throw ("PxPyPzE4D::M() - Tachyonic:\n"
                    "    P^2 > E^2 so the mass would be imaginary");
-         return -std::sqrt(-mm);
+         Scalar m = sqrt(Select(mm >= 0, mm, -mm));
+         return Select(mm >= 0, m, -m);
       }
    }
    Scalar Mag() const    { return M(); }
@@ -172,7 +176,7 @@ public :
    /**
       Transverse spatial component (P_perp or rho)
    */
-   Scalar Pt()   const { return std::sqrt(Perp2());}
+   Scalar Pt()   const { using std::sqrt; return sqrt(Perp2());}
    Scalar Perp() const { return Pt();}
    Scalar Rho()  const { return Pt();}
 
@@ -185,13 +189,15 @@ public :
       transverse mass
    */
    Scalar Mt() const {
+      using std::sqrt;
       Scalar mm = Mt2();
-      if (mm >= 0) {
-         return std::sqrt(mm);
+      if (AllOf(mm >= 0)) {
+         return sqrt(mm);
       } else {
          GenVector::Throw ("PxPyPzE4D::Mt() - Tachyonic:\n"
                            "    Pz^2 > E^2 so the transverse mass would be imaginary");
-         return -std::sqrt(-mm);
+         Scalar m = sqrt(Select(mm >= 0, mm, -mm));
+         return Select(mm >= 0, m, -m);
       }
    }
 
@@ -201,15 +207,16 @@ public :
    Scalar Et2() const {  // is (E^2 * pt ^2) / p^2
       // but it is faster to form p^2 from pt^2
       Scalar pt2 = Pt2();
-      return pt2 == 0 ? 0 : fT*fT * pt2/( pt2 + fZ*fZ );
+      return Select(pt2 == 0, Scalar(0), fT*fT * pt2/( pt2 + fZ*fZ ));
    }
 
    /**
       transverse energy
    */
    Scalar Et() const {
-      Scalar etet = Et2();
-      return fT < 0.0 ? -std::sqrt(etet) : std::sqrt(etet);
+      using std::sqrt;
+      Scalar et = sqrt(Et2());
+      return Select(fT < 0.0, -et, et);
    }
 
    /**
@@ -24,6 +24,7 @@
 
 
 #include "Math/GenVector/Boost.h"
+#include "Math/Types.h"
 
 namespace ROOT {
 
@@ -221,7 +222,9 @@ namespace ROOT {
             Scalar yy = (v1.Y() + v2.Y() );
             Scalar zz = (v1.Z() + v2.Z() );
             Scalar mm2 = ee*ee - xx*xx - yy*yy - zz*zz;
-            return mm2 < 0.0 ? -std::sqrt(-mm2) : std::sqrt(mm2);
+            using std::sqrt;
+            Scalar m = sqrt(Select(mm2 < 0.0, -mm2, mm2));
+            return Select(mm2 < 0.0, -m, m);
             //  PxPyPzE4D<double> q(xx,yy,zz,ee);
             //  return q.M();
             //return ( v1 + v2).mag();
@@ -324,24 +327,29 @@ namespace ROOT {
           The requirement on the boost vector is that needs to implement the
           X(), Y() , Z()  retorning the vector elements describing the boost
           The beta of the boost must be <= 1 or a nul Lorentz Vector will be returned
+          The vectors can be SIMD batches (e.g. of ROOT::Double_v), each lane being boosted
+          by its own beta; a null Lorentz Vector is then returned if any beta is >= 1
           */
          template <class LVector, class BoostVector>
          LVector boost(const LVector & v, const BoostVector & b) {
-            double bx = b.X();
-            double by = b.Y();
-            double bz = b.Z();
-            double b2 = bx*bx + by*by + bz*bz;
-            if (b2 >= 1) {
+            // computed in double precision, or with the SIMD type of the vectors
+            typedef decltype(typename LVector::Scalar() * 1.0) Scalar;
+            Scalar bx = b.X();
+            Scalar by = b.Y();
+            Scalar bz = b.Z();
+            Scalar b2 = bx*bx + by*by + bz*bz;
+            if (AnyOf(b2 >= 1)) {
                GenVector::Throw ( "Beta Vector supplied to set Boost represents speed >= c");
                return LVector();
             }
-            double gamma = 1.0 / std::sqrt(1.0 - b2);
-            double bp = bx*v.X() + by*v.Y() + bz*v.Z();
-            double gamma2 = b2 > 0 ? (gamma - 1.0)/b2 : 0.0;
-            double x2 = v.X() + gamma2*bp*bx + gamma*bx*v.T();
-            double y2 = v.Y() + gamma2*bp*by + gamma*by*v.T();
-            double z2 = v.Z() + gamma2*bp*bz + gamma*bz*v.T();
-            double t2 = gamma*(v.T() + bp);
+            using std::sqrt;
+            Scalar gamma = 1.0 / sqrt(1.0 - b2);
+            Scalar bp = bx*v.X() + by*v.Y() + bz*v.Z();
+            Scalar gamma2 = Select(b2 > 0, (gamma - 1.0)/b2, Scalar(0.0));
+            Scalar x2 = v.X() + gamma2*bp*bx + gamma*bx*v.T();
+            Scalar y2 = v.Y() + gamma2*bp*by + gamma*by*v.T();
+            Scalar z2 = v.Z() + gamma2*bp*bz + gamma*bz*v.T();
+            Scalar t2 = gamma*(v.T() + bp);
             LVector lv;
             lv.SetXYZT(x2,y2,z2,t2);
             return lv;
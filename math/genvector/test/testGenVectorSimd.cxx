@@ -0,0 +1,151 @@
+// test of the LorentzVector and DisplacementVector3D of a SIMD type (Math/GenVector/GenVectorSimd.h):
+// the vectors moved to and from the lanes with SimdLoad and SimdStore must be unchanged, and the
+// operations applied to a batch (invariant mass, BoostToCM, VectorUtil::boost with a different
+// boost in each lane) must give in each lane the result of the scalar operation.
+// Without Vc, ROOT::Double_v is double and the batches have a single lane.
+
+#include "Math/Vector3D.h"
+#include "Math/Vector4D.h"
+#include "Math/VectorUtil.h"
+#include "Math/GenVector/GenVectorSimd.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cmath>
+
+using namespace ROOT::Math;
+
+typedef ROOT::Double_v Vec_t;
+const unsigned int kLanes = SimdTraits<Vec_t>::kSize;
+
+typedef LorentzVector<PxPyPzE4D<Vec_t> > PxPyPzEVectorV;
+typedef DisplacementVector3D<Cartesian3D<Vec_t> > XYZVectorV;
+
+int compare(double a, double b, const std::string & s, double tol = 0) {
+   if (std::abs(a - b) <= tol * std::max(std::abs(b), 1.)) return 0;
+   std::cout << "\n" << s << " : Failure " << a << " different than " << b << std::endl;
+   return 1;
+}
+
+double Lane(const Vec_t & v, unsigned int k) { return SimdTraits<Vec_t>::Get(v, k); }
+
+int compareVectors(const PxPyPzEVector & a, const PxPyPzEVector & b, const std::string & s, double tol = 0) {
+   return compare(a.Px(), b.Px(), s + " px", tol) | compare(a.Py(), b.Py(), s + " py", tol) |
+          compare(a.Pz(), b.Pz(), s + " pz", tol) | compare(a.E(), b.E(), s + " E", tol);
+}
+
+int test1() {
+   // load and store, for all numbers of vectors up to the number of lanes
+   std::mt19937 rndm(111);
+   std::uniform_real_distribution<double> u(-1, 1);
+   int iret = 0;
+   for (unsigned int n = 1; n <= kLanes; ++n) {
+      std::vector<PxPyPzEVector> p(n), pout(n);
+      std::vector<XYZVector> v(n), vout(n);
+      for (unsigned int k = 0; k < n; ++k) {
+         p[k].SetPxPyPzE(u(rndm), u(rndm), u(rndm), 3 + u(rndm));
+         v[k].SetXYZ(u(rndm), u(rndm), u(rndm));
+      }
+      PxPyPzEVectorV pv;
+      XYZVectorV vv;
+      SimdLoad(pv, &p[0], n);
+      SimdLoad(vv, &v[0], n);
+      // the lanes after n hold the last vector
+      for (unsigned int k = n; k < kLanes; ++k) {
+         iret |= compare(Lane(pv.E(), k), p[n-1].E(), "padded Lorentz vector lane");
+         iret |= compare(Lane(vv.Z(), k), v[n-1].Z(), "padded 3D vector lane");
+      }
+      SimdStore(pv, &pout[0], n);
+      SimdStore(vv, &vout[0], n);
+      for (unsigned int k = 0; k < n; ++k) {
+         iret |= compare(pout[k] == p[k], true, "stored Lorentz vector");
+         iret |= compare(vout[k] == v[k], true, "stored 3D vector");
+      }
+   }
+
+   // nothing is loaded or stored for n = 0
+   PxPyPzEVector p0(1, 2, 3, 4);
+   PxPyPzEVectorV pv(0, 0, 0, 5);
+   SimdLoad(pv, &p0, 0);
+   SimdStore(pv, &p0, 0);
+   iret |= compare(p0 == PxPyPzEVector(1, 2, 3, 4), true, "Lorentz vector after storing no vector");
+   for (unsigned int k = 0; k < kLanes; ++k)
+      iret |= compare(Lane(pv.E(), k), 5., "Lorentz vector after loading no vector");
+   return iret;
+}
+
+int test2() {
+   // operations on a batch, compared with the scalar operations on each lane. The boost of
+   // each lane is different, and one lane has a vector at rest
+   std::mt19937 rndm(222);
+   std::uniform_real_distribution<double> u(-1, 1);
+   const unsigned int n = 2 * kLanes + 1;
+   std::vector<PxPyPzEVector> p(n), q(n), boosted(n), inCM(n);
+   for (unsigned int k = 0; k < n; ++k) {
+      p[k].SetPxPyPzE(u(rndm), u(rndm), u(rndm), 3 + u(rndm));
+      q[k].SetPxPyPzE(u(rndm), u(rndm), u(rndm), 3 + u(rndm));
+   }
+   p[n / 2].SetPxPyPzE(0, 0, 0, 2);
+   std::vector<double> mass(n), invMass(n), pt(n), mt(n);
+
+   for (unsigned int k0 = 0; k0 < n; k0 += kLanes) {
+      const unsigned int nk = std::min(kLanes, n - k0);
+      PxPyPzEVectorV pv, qv;
+      SimdLoad(pv, &p[k0], nk);
+      SimdLoad(qv, &q[k0], nk);
+      Vec_t m = (pv + qv).M();
+      Vec_t im = VectorUtil::InvariantMass(pv, qv);
+      Vec_t pvPt = pv.Pt();
+      Vec_t qvMt = qv.Mt();
+      XYZVectorV beta = pv.BoostToCM();
+      PxPyPzEVectorV bv = VectorUtil::boost(qv, -0.5 * beta);
+      PxPyPzEVectorV cm = VectorUtil::boost(pv, beta);
+      SimdStore(bv, &boosted[k0], nk);
+      SimdStore(cm, &inCM[k0], nk);
+      for (unsigned int k = 0; k < nk; ++k) {
+         mass[k0 + k] = Lane(m, k);
+         invMass[k0 + k] = Lane(im, k);
+         pt[k0 + k] = Lane(pvPt, k);
+         mt[k0 + k] = Lane(qvMt, k);
+      }
+   }
+
+   int iret = 0;
+   const double tol = 1.E-14;
+   for (unsigned int k = 0; k < n; ++k) {
+      std::string s = "vector " + std::to_string(k);
+      iret |= compare(mass[k], (p[k] + q[k]).M(), s + " mass of the sum", tol);
+      iret |= compare(invMass[k], VectorUtil::InvariantMass(p[k], q[k]), s + " invariant mass", tol);
+      iret |= compare(pt[k], p[k].Pt(), s + " pt", tol);
+      iret |= compare(mt[k], q[k].Mt(), s + " mt", tol);
+      XYZVector beta = p[k].BoostToCM();
+      iret |= compareVectors(boosted[k], VectorUtil::boost(q[k], -0.5 * beta), s + " boost", tol);
+      // p is at rest in its center of mass frame
+      iret |= compareVectors(inCM[k], PxPyPzEVector(0, 0, 0, p[k].M()), s + " boost to the center of mass", 1.E-12);
+   }
+   return iret;
+}
+
+#define TEST(N)                                                                 \
+  itest = N;                                                                    \
+  if (test##N() == 0) std::cerr << " Test " << itest << "  OK " << std::endl; \
+  else { std::cerr << " Test " << itest << "  FAILED " << std::endl;    \
+     iret +=1; };
+
+int testGenVectorSimd() {
+   int iret = 0;
+   int itest;
+   TEST(1);
+   TEST(2);
+   return iret;
+}
+
+int main() {
+   int ret = testGenVectorSimd();
+   if (ret)  std::cerr << "test GenVector SIMD:\t  FAILED !!! " << std::endl;
+   else   std::cerr << "test GenVector SIMD: \t OK " << std::endl;
+   return ret;
+}
@@ -34,6 +34,7 @@ MATHCOREDICTH :=  TComplex.h \
                 Math/TRandomEngine.h \
                 Math/MersenneTwisterEngine.h \
                 Math/MixMaxEngine.h \
+                Math/PhiloxEngine.h \
                 Math/KDTree.h \
                 Math/TDataPoint.h \
                 Math/TDataPointN.h \
@@ -54,6 +54,12 @@ namespace ROOT {
               the data are inserted one by one using the Add method.
               It is mandatory to set the size before using the Add method.
 
+              The copied data are stored by default point by point (coordinates, value and errors of a point are
+              contiguous). With SetColumnLayout they can be stored instead in columns: the coordinates of all points
+              in one block (NDim() values per point), then one contiguous array for the values and for each error.
+              The access methods work in both cases, while ValueColumn and InvErrorColumn give the arrays to the
+              vectorized code evaluating the fit functions.
+
              @ingroup  FitData
 */
 
@@ -220,12 +226,50 @@ public :
    */
    void Add(const double *x, double val, const double * ex, double  elval, double  ehval);
 
+   /**
+      store the copied data in columns (coordinate block, values, errors) instead of point by point.
+      The existing data are re-arranged. It has no effect on data wrapping external arrays
+    */
+   void SetColumnLayout(bool on = true);
+
+   /**
+      query if the data are stored in columns
+    */
+   bool IsColumnLayout() const { return fColumnLayout; }
+
+   /**
+      return the distance between the coordinates of two consecutive points of the copied data,
+      i.e. Coords(i+1) == Coords(i) + CoordStride(). It is the point size when the data are stored
+      point by point and the dimension when they are stored in columns
+    */
+   unsigned int CoordStride() const {
+      return (fColumnLayout) ? fDim : fPointSize;
+   }
+
+   /**
+      return the array with the values of all points when the data are stored in columns,
+      otherwise a NULL pointer
+    */
+   const double * ValueColumn() const {
+      if (!fColumnLayout || fColumnSize == 0) return 0;
+      return &((fDataVector->Data())[ ColumnIndex(0, fDim) ]);
+   }
+
+   /**
+      return the array with the inverse of the error on the value of all points when the data
+      are stored in columns and the error type is kValueError, otherwise a NULL pointer
+    */
+   const double * InvErrorColumn() const {
+      if (!fColumnLayout || fColumnSize == 0 || fPointSize != fDim + 2) return 0;
+      return &((fDataVector->Data())[ ColumnIndex(0, fDim + 1) ]);
+   }
+
    /**
       return a pointer to the coordinates data for the given fit point
     */
    const double * Coords(unsigned int ipoint) const {
       if (fDataVector)
-         return &((fDataVector->Data())[ ipoint*fPointSize ] );
+         return &((fDataVector->Data())[ Index(ipoint, 0) ] );
 
       return fDataWrapper->Coords(ipoint);
    }
@@ -235,7 +279,7 @@ public :
     */
    double Value(unsigned int ipoint) const {
       if (fDataVector)
-         return (fDataVector->Data())[ ipoint*fPointSize + fDim ];
+         return (fDataVector->Data())[ Index(ipoint, fDim) ];
 
       return fDataWrapper->Value(ipoint);
    }
@@ -251,11 +295,11 @@ public :
          ErrorType type = GetErrorType();
          if (type == kNoError ) return 1;
          // error on the value is the last element in the point structure
-         double eval =  (fDataVector->Data())[ (ipoint+1)*fPointSize - 1];
+         double eval =  (fDataVector->Data())[ Index(ipoint, fPointSize - 1) ];
          if (type == kValueError ) // need to invert (inverror is stored)
             return eval != 0 ? 1.0/eval : 0;
          else if (type == kAsymError) {  // return 1/2(el + eh)
-            double el = (fDataVector->Data())[ (ipoint+1)*fPointSize - 2];
+            double el = (fDataVector->Data())[ Index(ipoint, fPointSize - 2) ];
             return 0.5 * (el+eval);
          }
          return eval; // case of coord errors
@@ -272,7 +316,7 @@ public :
    double InvError(unsigned int ipoint) const {
       if (fDataVector) {
          // error on the value is the last element in the point structure
-         double eval =  (fDataVector->Data())[ (ipoint+1)*fPointSize - 1];
+         double eval =  (fDataVector->Data())[ Index(ipoint, fPointSize - 1) ];
          return eval;
 //          if (!fWithCoordError) return eval;
 //          // when error in the coordinate is stored, need to invert it
@@ -291,7 +335,7 @@ public :
    const double * CoordErrors(unsigned int ipoint) const {
       if (fDataVector) {
          // error on the value is the last element in the point structure
-         return  &(fDataVector->Data())[ (ipoint)*fPointSize + fDim + 1];
+         return  &(fDataVector->Data())[ Index(ipoint, fDim + 1) ];
       }
 
       return fDataWrapper->CoordErrors(ipoint);
@@ -303,10 +347,9 @@ public :
     */
    const double * GetPoint(unsigned int ipoint, double & value) const {
       if (fDataVector) {
-         unsigned int j = ipoint*fPointSize;
          const std::vector<double> & v = (fDataVector->Data());
-         const double * x = &v[j];
-         value = v[j+fDim];
+         const double * x = &v[ Index(ipoint, 0) ];
+         value = v[ Index(ipoint, fDim) ];
          return x;
       }
       value = fDataWrapper->Value(ipoint);
@@ -322,14 +365,12 @@ public :
    const double * GetPoint(unsigned int ipoint, double & value, double & invError) const {
       if (fDataVector) {
          const std::vector<double> & v = (fDataVector->Data());
-         unsigned int j = ipoint*fPointSize;
-         const double * x = &v[j];
-         j += fDim;
-         value = v[j];
+         const double * x = &v[ Index(ipoint, 0) ];
+         value = v[ Index(ipoint, fDim) ];
          if (fPointSize == fDim +1) // value error (type=kNoError)
             invError = 1;
          else if (fPointSize == fDim +2) // value error (type=kNoError)
-            invError = v[j+1];
+            invError = v[ Index(ipoint, fDim + 1) ];
          else
             assert(0); // cannot be here
 
@@ -349,10 +390,9 @@ public :
    const double * GetPointError(unsigned int ipoint, double & errvalue) const {
       if (fDataVector) {
          assert(fPointSize > fDim + 2);
-         unsigned int j = ipoint*fPointSize;
          const std::vector<double> & v = (fDataVector->Data());
-         const double * ex = &v[j+fDim+1];
-         errvalue = v[j + 2*fDim +1];
+         const double * ex = &v[ Index(ipoint, fDim + 1) ];
+         errvalue = v[ Index(ipoint, 2*fDim + 1) ];
          return ex;
       }
       errvalue = fDataWrapper->Error(ipoint);
@@ -370,11 +410,10 @@ public :
       assert(fDataVector);
 
       assert(fPointSize > 2 * fDim + 2);
-      unsigned int j = ipoint*fPointSize;
       const std::vector<double> & v = (fDataVector->Data());
-      const double * ex = &v[j+fDim+1];
-      errlow  = v[j + 2*fDim +1];
-      errhigh = v[j + 2*fDim +2];
+      const double * ex = &v[ Index(ipoint, fDim + 1) ];
+      errlow  = v[ Index(ipoint, 2*fDim + 1) ];
+      errhigh = v[ Index(ipoint, 2*fDim + 2) ];
       return ex;
    }
 
@@ -382,17 +421,16 @@ public :
 #ifdef USE_BINPOINT_CLASS
    const BinPoint & GetPoint(unsigned int ipoint) const {
       if (fDataVector) {
-         unsigned int j = ipoint*fPointSize;
          const std::vector<double> & v = (fDataVector->Data());
-         const double * x = &v[j];
-         double value = v[j+fDim];
+         const double * x = &v[ Index(ipoint, 0) ];
+         double value = v[ Index(ipoint, fDim) ];
          if (fPointSize > fDim + 2) {
-            const double * ex = &v[j+fDim+1];
-            double err = v[j + 2*fDim +1];
+            const double * ex = &v[ Index(ipoint, fDim + 1) ];
+            double err = v[ Index(ipoint, 2*fDim + 1) ];
             fPoint.Set(x,value,ex,err);
          }
          else {
-            double invError = v[j+fDim+1];
+            double invError = v[ Index(ipoint, fDim + 1) ];
             fPoint.Set(x,value,invError);
          }
 
@@ -413,11 +451,10 @@ public :
 
    const BinPoint & GetPointError(unsigned int ipoint) const {
       if (fDataVector) {
-         unsigned int j = ipoint*fPointSize;
          const std::vector<double> & v = (fDataVector->Data());
-         const double * x = &v[j];
-         double value = v[j+fDim];
-         double invError = v[j+fDim+1];
+         const double * x = &v[ Index(ipoint, 0) ];
+         double value = v[ Index(ipoint, fDim) ];
+         double invError = v[ Index(ipoint, fDim + 1) ];
          fPoint.Set(x,value,invError);
       }
       else {
@@ -516,6 +553,26 @@ protected:
 
 private:
 
+   /**
+      position in the data vector of the element k of the given point, where the elements of a point are
+      ordered as coordinates, value, errors on the coordinates and errors on the value
+    */
+   unsigned int Index(unsigned int ipoint, unsigned int k) const {
+      return (fColumnLayout) ? ColumnIndex(ipoint, k) : ipoint*fPointSize + k;
+   }
+
+   /**
+      position of the element k of the given point in the column layout. The coordinates and their errors
+      are stored in blocks of fDim values per point, the value and the value errors in one array each
+    */
+   unsigned int ColumnIndex(unsigned int ipoint, unsigned int k) const {
+      if (k < fDim) return ipoint*fDim + k;
+      if (k > fDim && k < 2*fDim + 1 && fPointSize > fDim + 2)
+         return fColumnSize*(fDim + 1) + ipoint*fDim + k - fDim - 1;
+      // value and errors on the value: the blocks stored before take k values per point
+      return fColumnSize*k + ipoint;
+   }
+
 
    unsigned int fDim;       // coordinate dimension
    unsigned int fPointSize; // total point size including value and errors (= fDim + 2 for error in only Y )
@@ -523,6 +580,8 @@ private:
    double fSumContent;  // total sum of the bin data content
    double fSumError2;  // total sum square of the errors
    double fRefVolume;  // reference bin volume - used to normalize the bins in case of variable bins data
+   bool fColumnLayout;      // data are stored in columns instead of point by point
+   unsigned int fColumnSize; // number of points the columns can contain (column layout only)
 
    DataVector * fDataVector;  // pointer to the copied in data vector
    DataWrapper * fDataWrapper;  // pointer to the external data wrapper structure
@@ -144,6 +144,16 @@ public:
       FitUtil::EvaluateChi2Gradient(BaseFCN::ModelFunction(), BaseFCN::Data(), x, g, fNEffPoints);
    }
 
+   /// evaluate the chi2 at nset points reading the data only once
+   virtual void EvalBatch(unsigned int nset, const double * x, double * f) const {
+      if (BaseFCN::Data().HaveCoordErrors() ) {
+         BaseObjFunction::EvalBatch(nset, x, f);
+         return;
+      }
+      for (unsigned int k = 0; k < nset; ++k) this->UpdateNCalls();
+      FitUtil::EvaluateChi2Batch(BaseFCN::ModelFunction(), BaseFCN::Data(), nset, x, f, fNEffPoints);
+   }
+
    /// get type of fit method function
    virtual  typename BaseObjFunction::Type_t Type() const { return BaseObjFunction::kLeastSquare; }
 
@@ -40,6 +40,17 @@ namespace FitUtil {
    typedef  ROOT::Math::IParamMultiFunction IModelFunction;
    typedef  ROOT::Math::IParamMultiGradFunction IGradModelFunction;
 
+   /**
+      The Chi2 and likelihood functions and their gradients (except the effective Chi2) sum the
+      contributions of the data points in chunks of fixed size. The chunks are evaluated in
+      parallel only if implicit multithreading is enabled (ROOT::EnableImplicitMT), the data are
+      copied in the data sets and the model function declares that it can be evaluated
+      concurrently (IParamMultiFunction::IsThreadSafe). This is the case of WrappedMultiTF1,
+      used by TH1::Fit and TGraph::Fit, for the TF1 defined by a formula.
+      The chunk sums are always added in the same order, so the results do not depend on the
+      number of threads.
+   */
+
    /** Chi2 Functions */
 
    /**
@@ -48,6 +59,14 @@ namespace FitUtil {
    */
    double EvaluateChi2(const IModelFunction & func, const BinData & data, const double * x, unsigned int & nPoints);
 
+   /**
+       evaluate the Chi2 for nset points in the parameter space, stored one after the other in x,
+       and store the values in chi2. The data are read only once for all the points,
+       which is convenient for computing numerical derivatives on large data sets.
+       The values are identical to those of EvaluateChi2
+   */
+   void EvaluateChi2Batch(const IModelFunction & func, const BinData & data, unsigned int nset, const double * x, double * chi2, unsigned int & nPoints);
+
    /**
        evaluate the effective Chi2 given a model function and the data at the point x.
        The effective chi2 uses the errors on the coordinates : W = 1/(sigma_y**2 + ( sigma_x_i * df/dx_i )**2 )
@@ -67,6 +86,12 @@ namespace FitUtil {
    */
    double EvaluateLogL(const IModelFunction & func, const UnBinData & data, const double * x, int iWeight, bool extended, unsigned int & nPoints);
 
+   /**
+       evaluate the LogL for nset points in the parameter space, stored one after the other in x,
+       with a single pass over the data (see EvaluateChi2Batch)
+   */
+   void EvaluateLogLBatch(const IModelFunction & func, const UnBinData & data, unsigned int nset, const double * x, int iWeight, bool extended, double * logl, unsigned int & nPoints);
+
    /**
        evaluate the LogL gradient given a model function and the data at the point x.
        return also nPoints as the effective number of used points in the LogL evaluation
@@ -80,6 +105,12 @@ namespace FitUtil {
    */
    double EvaluatePoissonLogL(const IModelFunction & func, const BinData & data, const double * x, int iWeight, bool extended, unsigned int & nPoints);
 
+   /**
+       evaluate the Poisson LogL for nset points in the parameter space, stored one after the other in x,
+       with a single pass over the data (see EvaluateChi2Batch)
+   */
+   void EvaluatePoissonLogLBatch(const IModelFunction & func, const BinData & data, unsigned int nset, const double * x, int iWeight, bool extended, double * logl, unsigned int & nPoints);
+
    /**
        evaluate the Poisson LogL given a model function and the data at the point x.
        return also nPoints as the effective number of used points in the LogL evaluation
@@ -138,6 +138,12 @@ public:
       FitUtil::EvaluateLogLGradient(BaseFCN::ModelFunction(), BaseFCN::Data(), x, g, fNEffPoints);
    }
 
+   /// evaluate the likelihood at nset points reading the data only once
+   virtual void EvalBatch(unsigned int nset, const double * x, double * f) const {
+      for (unsigned int k = 0; k < nset; ++k) this->UpdateNCalls();
+      FitUtil::EvaluateLogLBatch(BaseFCN::ModelFunction(), BaseFCN::Data(), nset, x, fWeight, fIsExtended, f, fNEffPoints);
+   }
+
    /// get type of fit method function
    virtual  typename BaseObjFunction::Type_t Type() const { return BaseObjFunction::kLogLikelihood; }
 
@@ -135,6 +135,12 @@ public:
       FitUtil::EvaluatePoissonLogLGradient(BaseFCN::ModelFunction(), BaseFCN::Data(), x, g );
    }
 
+   /// evaluate the likelihood at nset points reading the data only once
+   virtual void EvalBatch(unsigned int nset, const double * x, double * f) const {
+      for (unsigned int k = 0; k < nset; ++k) this->UpdateNCalls();
+      FitUtil::EvaluatePoissonLogLBatch(BaseFCN::ModelFunction(), BaseFCN::Data(), nset, x, fWeight, fIsExtended, f, fNEffPoints);
+   }
+
    /// get type of fit method function
    virtual  typename BaseObjFunction::Type_t Type() const { return BaseObjFunction::kLogLikelihood; }
 
@@ -42,6 +42,9 @@ namespace ROOT {
               the data are inserted one by one using the Add method.
               It is mandatory to set the size before using the Add method.
 
+              With SetColumnLayout the weights of weighted data are stored in a separate array after the
+              block of the coordinates, instead of being interleaved with them.
+
              @ingroup  FitData
 */
 class UnBinData : public FitData {
@@ -95,6 +98,8 @@ public :
       fDim(dim),
       fPointSize( (isWeighted) ? dim +1 : dim),
       fNPoints(n),
+      fColumnLayout(false),
+      fColumnSize(0),
       fDataVector(0)
    {
       fDataWrapper = new DataWrapper(fPointSize, dataItr);
@@ -128,6 +133,8 @@ public :
       fDim(dim),
       fPointSize( (isWeighted) ? dim +1 : dim),
       fNPoints(0),
+      fColumnLayout(false),
+      fColumnSize(0),
       fDataVector(0),
       fDataWrapper(0)
    {
@@ -197,12 +204,11 @@ public:
       add one dim coordinate data (unweighted)
    */
    void Add(double x) {
-      int index = fNPoints*PointSize();
       assert(fDataVector != 0);
       assert(PointSize() == 1);
-      assert (index + PointSize() <= DataSize() );
+      assert ((fNPoints+1)*PointSize() <= DataSize() );
 
-      (fDataVector->Data())[ index ] = x;
+      (fDataVector->Data())[ Index(fNPoints, 0) ] = x;
 
       fNPoints++;
    }
@@ -213,13 +219,12 @@ public:
       can also be used to add 1-dim data with a weight
    */
    void Add(double x, double y) {
-      int index = fNPoints*PointSize();
       assert(fDataVector != 0);
       assert(PointSize() == 2);
-      assert (index + PointSize() <= DataSize() );
+      assert ((fNPoints+1)*PointSize() <= DataSize() );
 
-      (fDataVector->Data())[ index ] = x;
-      (fDataVector->Data())[ index+1 ] = y;
+      (fDataVector->Data())[ Index(fNPoints, 0) ] = x;
+      (fDataVector->Data())[ Index(fNPoints, 1) ] = y;
 
       fNPoints++;
    }
@@ -229,14 +234,13 @@ public:
       can also be used to add 2-dim data with a weight
    */
    void Add(double x, double y, double z) {
-      int index = fNPoints*PointSize();
       assert(fDataVector != 0);
       assert(PointSize() == 3);
-      assert (index + PointSize() <= DataSize() );
+      assert ((fNPoints+1)*PointSize() <= DataSize() );
 
-      (fDataVector->Data())[ index ] = x;
-      (fDataVector->Data())[ index+1 ] = y;
-      (fDataVector->Data())[ index+2 ] = z;
+      (fDataVector->Data())[ Index(fNPoints, 0) ] = x;
+      (fDataVector->Data())[ Index(fNPoints, 1) ] = y;
+      (fDataVector->Data())[ Index(fNPoints, 2) ] = z;
 
       fNPoints++;
    }
@@ -245,12 +249,11 @@ public:
       add multi-dim coordinate data
    */
    void Add(const double *x) {
-      int index = fNPoints*fPointSize;
 
       assert(fDataVector != 0);
-      assert (index + PointSize() <= DataSize() );
+      assert ((fNPoints+1)*PointSize() <= DataSize() );
 
-      double * itr = &( (fDataVector->Data()) [ index ]);
+      double * itr = &( (fDataVector->Data()) [ Index(fNPoints, 0) ]);
 
       for (unsigned int i = 0; i < fDim; ++i)
          *itr++ = x[i];
@@ -262,16 +265,15 @@ public:
       add multi-dim coordinate data + weight
    */
    void Add(const double *x, double w) {
-      int index = fNPoints*fPointSize;
 
       assert(fDataVector != 0);
-      assert (index + PointSize() <= DataSize() );
+      assert ((fNPoints+1)*PointSize() <= DataSize() );
 
-      double * itr = &( (fDataVector->Data()) [ index ]);
+      double * itr = &( (fDataVector->Data()) [ Index(fNPoints, 0) ]);
 
       for (unsigned int i = 0; i < fDim; ++i)
          *itr++ = x[i];
-      *itr = w;
+      (fDataVector->Data())[ Index(fNPoints, fDim) ] = w;
 
       fNPoints++;
    }
@@ -281,11 +283,39 @@ public:
     */
    const double * Coords(unsigned int ipoint) const {
       if (fDataVector)
-         return &( (fDataVector->Data()) [ ipoint*fPointSize ] );
+         return &( (fDataVector->Data()) [ Index(ipoint, 0) ] );
       else
          return fDataWrapper->Coords(ipoint);
    }
 
+   /**
+      store the copied data in columns (block of coordinates and array of weights) instead of
+      point by point. The existing data are re-arranged. It has no effect on data wrapping external arrays
+    */
+   void SetColumnLayout(bool on = true);
+
+   /**
+      query if the data are stored in columns
+    */
+   bool IsColumnLayout() const { return fColumnLayout; }
+
+   /**
+      return the distance between the coordinates of two consecutive points of the copied data,
+      i.e. Coords(i+1) == Coords(i) + CoordStride()
+    */
+   unsigned int CoordStride() const {
+      return (fColumnLayout) ? fDim : fPointSize;
+   }
+
+   /**
+      return the array with the weights of all points when weighted data are stored in columns,
+      otherwise a NULL pointer
+    */
+   const double * WeightColumn() const {
+      if (!fColumnLayout || fColumnSize == 0 || !IsWeighted()) return 0;
+      return &( (fDataVector->Data()) [ ColumnIndex(0, fDim) ] );
+   }
+
    bool IsWeighted() const {
       return (fPointSize == fDim+1);
    }
@@ -293,7 +323,7 @@ public:
    double Weight(unsigned int ipoint) const {
       if (fPointSize == fDim) return 1;
       if (fDataVector )
-         return  (fDataVector->Data()) [ ipoint*fPointSize + 1 ] ;
+         return  (fDataVector->Data()) [ Index(ipoint, fDim) ] ;
       else
          return 0; // weights are not supported for wrapper data sets
    }
@@ -342,9 +372,26 @@ protected:
 
 private:
 
+   /**
+      position in the data vector of the element k (coordinate or weight) of the given point
+    */
+   unsigned int Index(unsigned int ipoint, unsigned int k) const {
+      return (fColumnLayout) ? ColumnIndex(ipoint, k) : ipoint*fPointSize + k;
+   }
+
+   /**
+      position of the element k of the given point in the column layout, where the coordinates
+      are stored in a block of fDim values per point followed by the array of the weights
+    */
+   unsigned int ColumnIndex(unsigned int ipoint, unsigned int k) const {
+      return (k < fDim) ? ipoint*fDim + k : fColumnSize*fDim + ipoint;
+   }
+
    unsigned int fDim;         // coordinate data dimension
    unsigned int fPointSize;    // poit size dimension (coordinate + weight)
    unsigned int fNPoints;     // numer of fit points
+   bool fColumnLayout;        // data are stored in columns instead of point by point
+   unsigned int fColumnSize;  // number of points the columns can contain (column layout only)
 
    DataVector * fDataVector;     // pointer to internal data vector (null for external data)
    DataWrapper * fDataWrapper;   // pointer to structure wrapping external data (null when data are copied in)
@@ -42,13 +42,16 @@
 #pragma link C++ class ROOT::Math::LCGEngine+;
 #pragma link C++ class ROOT::Math::MersenneTwisterEngine+;
 #pragma link C++ class ROOT::Math::MixMaxEngine+;
+#pragma link C++ class ROOT::Math::PhiloxEngine+;
 #pragma link C++ class ROOT::Math::Random<ROOT::Math::LCGEngine>+;
 #pragma link C++ class ROOT::Math::Random<ROOT::Math::MersenneTwisterEngine>+;
 #pragma link C++ class ROOT::Math::Random<ROOT::Math::MixMaxEngine>+;
+#pragma link C++ class ROOT::Math::Random<ROOT::Math::PhiloxEngine>+;
 
 
 #pragma link C++ typedef ROOT::Math::RandomMixMax;
 #pragma link C++ typedef ROOT::Math::RandomMT19937;
+#pragma link C++ typedef ROOT::Math::RandomPhilox;
 
 // #pragma link C++ class TRandomNew3+;
 
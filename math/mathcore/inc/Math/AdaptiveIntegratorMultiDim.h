@@ -71,6 +71,13 @@ namespace Math {
      2.Numerical integration usually works best for smooth functions.
        Some analysis or suitable transformations of the integral prior to
        numerical work may contribute to numerical efficiency.
+     3.The nodes of the rule are evaluated with a single call to
+       IMultiGenFunction::EvalVec, and the nodes of the two halves of a divided
+       region together (in batches of at most 1024 nodes in high dimension,
+       where the rule has 2^n + 2n(n+1) + 1 nodes). Integrands re-implementing DoEvalVec with a vectorized
+       evaluation are therefore faster. If the integrand is thread safe, the
+       nodes can also be evaluated concurrently when implicit multi-threading
+       is enabled, see SetParallel. The result does not depend on it.
 
    References:
 
@@ -161,6 +168,10 @@ public:
    ///set max points
    void SetMaxPts(unsigned int n) { fMaxPts = n; }
 
+   /// evaluate the integrand at the nodes of the regions concurrently when implicit
+   /// multi-threading is enabled (the integrand must then be thread safe)
+   void SetParallel(bool on = true) { fParallel = on; }
+
    /// set the options
    void SetOptions(const ROOT::Math::IntegratorMultiDimOptions & opt);
 
@@ -172,6 +183,9 @@ protected:
    // internal function to compute the integral (if absVal is true compute abs value of function integral
    double DoIntegral(const double* xmin, const double * xmax, bool absVal = false);
 
+   // evaluate the integrand at npts points
+   void EvalNodes(unsigned int npts, const double * x, double * fval) const;
+
  private:
 
    unsigned int fDim;     // dimentionality of integrand
@@ -186,6 +200,7 @@ protected:
    double fRelError;      // Relative error
    int    fNEval;        // number of function evaluation
    int fStatus;   // status of algorithm (error if not zero)
+   bool fParallel;        // evaluate the nodes concurrently (if IMT is enabled)
 
    const IMultiGenFunction* fFun;   // pointer to integrand function
 
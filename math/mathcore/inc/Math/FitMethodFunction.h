@@ -70,6 +70,16 @@ public:
     */
    virtual double DataElement(const double *x, unsigned int i, double *g = 0) const = 0;
 
+   /**
+      evaluate the function at nset points, stored one after the other in x (nset * NDim() values),
+      and store the values in f.
+      The default implementation evaluates the points one by one; the fit method functions
+      re-implement it to read the data only once for all the points, as needed by the numerical derivatives
+    */
+   virtual void EvalBatch(unsigned int nset, const double * x, double * f) const {
+      for (unsigned int k = 0; k < nset; ++k) f[k] = (*this)(x + k * NDim());
+   }
+
 
    /**
       return the number of data points used in evaluating the function
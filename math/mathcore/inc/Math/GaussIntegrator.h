@@ -248,6 +248,7 @@ private:
    double fBoundary;
    bool fInfiniteInterval;
    double DoEval(double x, double boundary, int sign) const;
+   void DoEvalVec(unsigned int n, const double * x, double * result) const;
 };
 
 
@@ -93,6 +93,15 @@ namespace Math {
          return DoEval(x);
       }
 
+      /**
+         Evaluate the function at the n points whose coordinates are stored one after
+         the other in x (point i starts at x[i*NDim()]) and store the values in result.
+         Use the virtual private method DoEvalVec
+      */
+      void EvalVec(unsigned int n, const double * x, double * result) const {
+         DoEvalVec(n, x, result);
+      }
+
 #ifdef LATER
       /**
          Template method to eveluate the function using the begin of an iterator
@@ -113,6 +122,17 @@ namespace Math {
       */
       virtual double DoEval(const double * x) const = 0;
 
+      /**
+         Implementation of the evaluation on a set of points. By default DoEval is called
+         for each point; derived classes can re-implement it with a faster implementation
+         (e.g. a vectorized one)
+      */
+      virtual void DoEvalVec(unsigned int n, const double * x, double * result) const {
+         const unsigned int ndim = NDim();
+         for (unsigned int i = 0; i < n; ++i)
+            result[i] = DoEval(x + i * ndim);
+      }
+
 
   };
 
@@ -165,6 +185,14 @@ namespace Math {
          return DoEval(*x);
       }
 
+      /**
+          Evaluate the function at the n points x[i] and store the values in result.
+          Use the virtual private method DoEvalVec
+      */
+      void EvalVec(unsigned int n, const double * x, double * result) const {
+         DoEvalVec(n, x, result);
+      }
+
 
 
    private:
@@ -174,6 +202,13 @@ namespace Math {
       /// implementation of the evaluation function. Must be implemented by derived classes
       virtual double DoEval(double x) const = 0;
 
+      /// implementation of the evaluation on a set of points. By default DoEval is called for
+      /// each point; derived classes can re-implement it with a faster implementation
+      virtual void DoEvalVec(unsigned int n, const double * x, double * result) const {
+         for (unsigned int i = 0; i < n; ++i)
+            result[i] = DoEval(x[i]);
+      }
+
    };
 
 
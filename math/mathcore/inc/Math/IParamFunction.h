@@ -126,8 +126,25 @@ public:
       return DoEvalPar(x, p);
    }
 
+   /**
+      Evaluate function at the n points whose coordinates start at x + i * stride
+      for the given parameters p and store the values in result.
+      Use the virtual function DoEvalParVec to implement it
+   */
+   void EvalParVec(unsigned int n, const double * x, double * result, const double * p, unsigned int stride) const {
+      DoEvalParVec(n, x, result, p, stride);
+   }
+
    using BaseFunc::operator();
 
+   /**
+      Return true if the function (and its parameter gradient) can be evaluated concurrently
+      from several threads with different parameter values. The fit functions of
+      ROOT::Fit::FitUtil then evaluate the data points in parallel when implicit
+      multi-threading is enabled. By default false is returned
+   */
+   virtual bool IsThreadSafe() const { return false; }
+
 
 private:
 
@@ -137,6 +154,15 @@ private:
    */
    virtual double DoEvalPar(const double * x, const double * p) const = 0;
 
+   /**
+      Implementation of the evaluation on a set of points. By default DoEvalPar is called
+      for each point; derived classes can override it with a faster implementation
+   */
+   virtual void DoEvalParVec(unsigned int n, const double * x, double * result, const double * p, unsigned int stride) const {
+      for (unsigned int i = 0; i < n; ++i)
+         result[i] = DoEvalPar(x + i * stride, p);
+   }
+
    /**
       Implement the ROOT::Math::IBaseFunctionMultiDim interface DoEval(x) using the cached parameter values
    */
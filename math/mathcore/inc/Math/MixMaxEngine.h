@@ -86,6 +86,13 @@ namespace ROOT {
          /// set the generator seed using a 64 bits integer
          void SetSeed64(uint64_t seed);
 
+         /// set the state to the stream identified by the four IDs, derived from a fixed
+         /// initial state by a skip depending on the IDs. The streams which differ by at
+         /// least one bit of the IDs are guaranteed not to overlap for 10^100 numbers:
+         /// e.g. use the thread or task number as streamID and a different non-zero runID
+         /// per job. The IDs should not be all zero, which gives the initial state itself.
+         void SeedUniqueStream(unsigned int clusterID, unsigned int machineID, unsigned int runID, unsigned int streamID);
+
          ///set the full initial generator state and warm up generator by doing some iterations
          void SetState(const std::vector<StateInt_t> & state, bool warmup = true);
 
@@ -0,0 +1,124 @@
+// @(#)root/mathcore:$Id$
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2016  LCG ROOT Math Team, CERN/PH-SFT                *
+ *                                                                    *
+ *                                                                    *
+ **********************************************************************/
+
+// counter-based random engine
+
+#ifndef ROOT_Math_PhiloxEngine
+#define ROOT_Math_PhiloxEngine
+
+#include <cstdint>
+
+#ifndef ROOT_Math_TRandomEngine
+#include "Math/TRandomEngine.h"
+#endif
+
+
+namespace ROOT {
+
+   namespace Math {
+
+
+      /**
+         Philox4x32-10 counter-based random number generator, introduced in
+         J. K. Salmon, M. A. Moraes, R. O. Dror and D. E. Shaw,
+         _Parallel Random Numbers: As Easy as 1, 2, 3_, SC11 (2011)
+         [DOI Link](http://dx.doi.org/10.1145/2063384.2063405).
+
+         The n-th number of a stream is a bijective function of n, of the stream
+         number and of the seed: there is no state to iterate, so that
+          - the engine can jump to any position in O(1), see Skip ;
+          - the 2^64 streams selected by SetStream (or by the constructor)
+            are independent sequences of 2^65 numbers each: giving its own
+            stream number to each thread or task makes its sequence
+            reproducible and independent from the others ;
+          - RndmArray generates its numbers in batches which the compiler
+            vectorizes.
+
+         Each number uses 64 bits of the generator output; the period of a
+         stream is 2^65.
+
+         @ingroup Random
+      */
+
+      class PhiloxEngine : public TRandomEngine {
+
+
+      public:
+
+         typedef  TRandomEngine BaseType;
+
+         PhiloxEngine(uint64_t seed = 1, uint64_t stream = 0);
+
+         virtual ~PhiloxEngine() {}
+
+         /// maximum integer that can be generated
+         static uint64_t MaxInt() { return UINT64_MAX; }
+
+         /// set the generator seed; the stream is kept and the position reset
+         void SetSeed(unsigned int seed) { SetSeed64(seed); }
+
+         /// set the generator seed using a 64 bits integer
+         void SetSeed64(uint64_t seed);
+
+         /// select the stream and restart it from its first number
+         void SetStream(uint64_t stream);
+
+         /// get the stream number
+         uint64_t Stream() const { return fStream; }
+
+         /// get the number of random numbers generated since the start of the stream
+         uint64_t Position() const { return 2*fCounter + fIndex - 2; }
+
+         /// jump ahead by n numbers, as if they had been generated
+         void Skip(uint64_t n);
+
+         // generate a random number (virtual interface)
+         virtual double Rndm() { return Rndm_impl(); }
+
+         /// generate a double random number (faster interface)
+         inline double operator() () { return Rndm_impl(); }
+
+         /// generate an array of random numbers in ]0,1]
+         void RndmArray (int n, double * array);
+
+         /// generate a 64  bit integer number
+         uint64_t IntRndm() {
+            if (fIndex == 2) {
+               Generate(fCounter++, fBuffer);
+               fIndex = 0;
+            }
+            return fBuffer[fIndex++];
+         }
+
+      private:
+
+         /// implementation function to generate the random number
+         double Rndm_impl() {
+            // the 53 most significant bits, shifted to exclude 0
+            return int64_t((IntRndm() >> 11) + 1) * (1.0/9007199254740992.0);
+         }
+
+         /// compute the two 64 bits outputs for the given counter value
+         void Generate(uint64_t counter, uint64_t * out) const;
+
+         uint32_t fKey[2];       // key, made of the seed
+         uint64_t fStream;       // upper half of the counter
+         uint64_t fCounter;      // lower half of the counter for the next generation
+         uint64_t fBuffer[2];    // output of the last generation
+         int      fIndex;        // next element of fBuffer to be returned, 2 if none
+
+      };
+
+
+   } // end namespace Math
+
+} // end namespace ROOT
+
+
+#endif /* ROOT_Math_PhiloxEngine */
@@ -65,7 +65,7 @@ namespace Math {
          Function to preserve ROOT Trandom compatibility
       */
       void RndmArray(int n, double * array) {
-         fEngine.RandomArray(array, array+n);
+         fEngine.RndmArray(n, array);
       }
 
       /**
@@ -230,6 +230,7 @@ namespace Math {
 
 #include "Math/MixMaxEngine.h"
 #include "Math/MersenneTwisterEngine.h"
+#include "Math/PhiloxEngine.h"
 
 namespace ROOT {
 namespace Math {
@@ -238,6 +239,7 @@ namespace Math {
 
    typedef   Random<ROOT::Math::MixMaxEngine>            RandomMixMax;
    typedef   Random<ROOT::Math::MersenneTwisterEngine>   RandomMT19937;
+   typedef   Random<ROOT::Math::PhiloxEngine>            RandomPhilox;
 
 
 } // namespace Math
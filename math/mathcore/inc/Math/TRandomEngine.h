@@ -56,6 +56,10 @@ namespace ROOT {
          }
          inline double operator() () { return Rndm_impl(); }
 
+         void RndmArray (int n, double * array) {
+            for (int i = 0; i < n; ++i) array[i] = Rndm_impl();
+         }
+
          unsigned int IntRndm() {
             fSeed = (1103515245 * fSeed + 12345) & 0x7fffffffUL;
             return fSeed; 
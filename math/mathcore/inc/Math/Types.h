@@ -0,0 +1,85 @@
+// @(#)root/mathcore:$Id$
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2016  LCG ROOT Math Team, CERN/PH-SFT                *
+ *                                                                    *
+ *                                                                    *
+ **********************************************************************/
+
+// SIMD types and helper functions for the ROOT Math classes which can be
+// instantiated with a vector type, like SMatrix or LorentzVector.
+// One object of such a class holds one object per SIMD lane, and the
+// operations are applied lane-wise to all of them at once.
+
+#ifndef ROOT_Math_Types
+#define ROOT_Math_Types
+
+#include "RConfigure.h"
+
+#ifdef R__HAS_VC
+#include <Vc/Vc>
+#endif
+
+namespace ROOT {
+
+#ifdef R__HAS_VC
+   typedef Vc::double_v Double_v;
+   typedef Vc::float_v  Float_v;
+#else
+   // without Vc the SIMD types have a single lane
+   typedef double Double_v;
+   typedef float  Float_v;
+#endif
+
+   namespace Math {
+
+/**
+   Description of a SIMD type T: the type of one lane, the number of lanes
+   and read/write access to the lanes. A scalar is a SIMD type with one lane.
+
+   @ingroup MathCore
+*/
+template <class T>
+struct SimdTraits {
+   typedef T Scalar;
+   enum { kSize = 1 };
+   static Scalar Get(const T & v, unsigned int) { return v; }
+   static void Set(T & v, unsigned int, Scalar x) { v = x; }
+};
+
+/// return true if the condition is true in at least one lane
+inline bool AnyOf(bool mask) { return mask; }
+
+/// return true if the condition is true in all the lanes
+inline bool AllOf(bool mask) { return mask; }
+
+/// lane-wise selection: a where mask is true, b elsewhere
+template <class T>
+inline T Select(bool mask, const T & a, const T & b) { return mask ? a : b; }
+
+#ifdef R__HAS_VC
+template <class T, class Abi>
+struct SimdTraits<Vc::Vector<T, Abi> > {
+   typedef T Scalar;
+   enum { kSize = Vc::Vector<T, Abi>::Size };
+   static Scalar Get(const Vc::Vector<T, Abi> & v, unsigned int i) { return v[i]; }
+   static void Set(Vc::Vector<T, Abi> & v, unsigned int i, Scalar x) { v[i] = x; }
+};
+
+template <class T, class Abi>
+inline bool AnyOf(const Vc::Mask<T, Abi> & mask) { return Vc::any_of(mask); }
+
+template <class T, class Abi>
+inline bool AllOf(const Vc::Mask<T, Abi> & mask) { return Vc::all_of(mask); }
+
+template <class T, class Abi>
+inline Vc::Vector<T, Abi> Select(const Vc::Mask<T, Abi> & mask, const Vc::Vector<T, Abi> & a,
+                                 const Vc::Vector<T, Abi> & b) { return Vc::iif(mask, a, b); }
+#endif
+
+   }  // namespace Math
+
+}  // namespace ROOT
+
+#endif  // ROOT_Math_Types
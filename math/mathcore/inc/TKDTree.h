@@ -50,9 +50,11 @@ public:
    Index   GetBucketSize() {return fBucketSize;}
 
    void    FindNearestNeighbors(const Value *point, Int_t k, Index *ind, Value *dist);
+   void    FindNearestNeighbors(Index npoints, const Value *points, Int_t k, Index *ind, Value *dist);
    Index   FindNode(const Value * point) const;
    void    FindPoint(Value * point, Index &index, Int_t &iter);
    void    FindInRange(Value *point, Value range, std::vector<Index> &res);
+   void    FindInRange(Index npoints, const Value *points, Value range, std::vector<std::vector<Index> > &res);
    void    FindBNodeA(Value * point, Value * delta, Int_t &inode);
 
    Bool_t  IsTerminal(Index inode) const {return (inode>=fNNodes);}
@@ -62,6 +64,7 @@ public:
 
    void    MakeBoundaries(Value *range = 0x0);
    void    MakeBoundariesExact();
+   void    MakeBucketData();
    void    SetData(Index npoints, Index ndim, UInt_t bsize, Value **data);
    Int_t   SetData(Index idim, Value *data);
    void    SetOwner(Int_t owner) { fDataOwner = owner; }
@@ -71,9 +74,12 @@ public:
    TKDTree(const TKDTree &); // not implemented
    TKDTree<Index, Value>& operator=(const TKDTree<Index, Value>&); // not implemented
    void CookBoundaries(const Int_t node, Bool_t left);
+   void BuildNodes(Int_t cnode, Int_t crow, Int_t cpos, Int_t npoints, Bool_t parallel);
+   Bool_t DivideNode(Int_t cnode, Int_t crow, Int_t cpos, Int_t npoints, Int_t &nleft, Int_t &nright);
 
+   Double_t DistanceBucket(const Value *point, Index ipos) const;
    void UpdateNearestNeighbors(Index inode, const Value *point, Int_t kNN, Index *ind, Value *dist);
-   void UpdateRange(Index inode, Value *point, Value range, std::vector<Index> &res);
+   void UpdateRange(Index inode, const Value *point, Value range, std::vector<Index> &res);
 
  protected:
    Int_t   fDataOwner;  //! 0 - not owner, 2 - owner of the pointer array, 1 - owner of the whole 2-d array
@@ -92,6 +98,7 @@ public:
 
 
    Index   *fIndPoints; //! array of points indexes
+   Value   *fBucketData;//! coordinates of the points in the order of fIndPoints
    Int_t   fRowT0;      //! smallest terminal row - first row that contains terminal nodes
    Int_t   fCrossNode;  //! cross node - node that begins the last row (with terminal nodes only)
    Int_t   fOffset;     //! offset in fIndPoints - if there are 2 rows, that contain terminal nodes
@@ -34,6 +34,7 @@
 #include <algorithm>
 #include <limits>
 #include <cmath>
+#include <atomic>
 
 namespace TMath {
 
@@ -178,6 +179,17 @@ namespace TMath {
    inline Double_t SignalingNaN();
    inline Double_t Infinity();
 
+   /* ***************************************** */
+   /* * Elementary Functions on arrays: y=f(x) * */
+   /* ***************************************** */
+          void     EnableFastMath(Bool_t enable = kTRUE);
+   inline Bool_t   IsFastMathEnabled();
+          void     Exp(Long64_t n, const Double_t *x, Double_t *y);
+          void     Log(Long64_t n, const Double_t *x, Double_t *y);
+          void     Sin(Long64_t n, const Double_t *x, Double_t *y);
+          void     Cos(Long64_t n, const Double_t *x, Double_t *y);
+          void     ATan2(Long64_t n, const Double_t *y, const Double_t *x, Double_t *r);
+
    template <typename T>
    struct Limits {
       inline static T Min();
@@ -492,6 +504,18 @@ inline Int_t TMath::Nint(T x)
    return i;
 }
 
+namespace TMath {
+   namespace Internal {
+      // set by TMath::EnableFastMath
+      R__EXTERN std::atomic<Bool_t> gFastMath;
+   }
+}
+
+//______________________________________________________________________________
+// inline, with a relaxed load, since it is called for each value in the hot loops
+inline Bool_t TMath::IsFastMathEnabled()
+   { return Internal::gFastMath.load(std::memory_order_relaxed); }
+
 inline Double_t TMath::Exp(Double_t x)
    { return exp(x); }
 
@@ -8,6 +8,77 @@
 
 #include <cmath>
 #include <algorithm>
+#include <vector>
+
+#include "RConfigure.h"
+#ifdef R__USE_IMT
+#include "TROOT.h"
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#endif
+
+namespace {
+
+   // abscissae of the degree seven rule
+   const double xl2 = 0.358568582800318073;//lambda_2
+   const double xl4 = 0.948683298050513796;//lambda_4
+   const double xl5 = 0.688247201611685289;//lambda_5
+
+   // the nodes of the rules are evaluated in batches of at most kMaxBatch points, which
+   // bounds the size of the buffer of their coordinates in high dimension (2^n corners)
+   const unsigned int kMaxBatch = 1024;
+
+   // fill pts with the nodes first,...,first+npts-1 of the rule, which has 2^n + 2n(n+1) + 1
+   // nodes, for the region of centre ctr and half-widths wth. The nodes are numbered in the
+   // order in which their function values are summed: the centre, the 4 nodes on each axis,
+   // the 4 nodes of each pair of axes and the 2^n corners
+   void FillRuleNodes(unsigned int n, const double * ctr, const double * wth,
+                      unsigned int first, unsigned int npts, double * pts)
+   {
+      const unsigned int last = first + npts;
+      unsigned int inode = 0;
+      unsigned int j, k;
+      double * z = pts;
+      if (inode >= first && inode < last) {
+         std::copy(ctr, ctr+n, z);
+         z += n;
+      }
+      inode++;
+
+      for (j=0; j<n; j++) {
+         const double d[4] = { -xl2*wth[j], xl2*wth[j], -xl4*wth[j], xl4*wth[j] };
+         for (unsigned int l=0; l<4; l++, inode++) {
+            if (inode < first || inode >= last) continue;
+            std::copy(ctr, ctr+n, z);
+            z[j] = ctr[j] + d[l];
+            z += n;
+         }
+      }
+
+      for (j=0; j<n; j++) {
+         for (k=j+1; k<n; k++) {
+            for (unsigned int l=0; l<4; l++, inode++) {
+               if (inode < first || inode >= last) continue;
+               std::copy(ctr, ctr+n, z);
+               z[j] = ctr[j] + ((l < 2) ? -xl4*wth[j] : xl4*wth[j]);
+               z[k] = ctr[k] + ((l % 2 == 0) ? -xl4*wth[k] : xl4*wth[k]);
+               z += n;
+            }
+         }
+      }
+
+      // the corners, the bit j of ic giving the side along the coordinate j
+      if (last <= inode) return;
+      const unsigned int icfirst = (first > inode) ? first - inode : 0;
+      const unsigned int iclast = std::min(last - inode, 1u << n);
+      for (unsigned int ic=icfirst; ic<iclast; ic++) {
+         for (j=0; j<n; j++)
+            z[j] = ctr[j] + (((ic >> j) & 1) ? xl5*wth[j] : -xl5*wth[j]);
+         z += n;
+      }
+   }
+
+}
 
 namespace ROOT {
 namespace Math {
@@ -25,6 +96,7 @@ AdaptiveIntegratorMultiDim::AdaptiveIntegratorMultiDim(double absTol, double rel
    fError(0), fRelError(0),
    fNEval(0),
    fStatus(-1),
+   fParallel(false),
    fFun(0)
 {
    // constructor - without passing a function
@@ -45,6 +117,7 @@ AdaptiveIntegratorMultiDim::AdaptiveIntegratorMultiDim( const IMultiGenFunction
    fError(0), fRelError(0),
    fNEval(0),
    fStatus(-1),
+   fParallel(false),
    fFun(&f)
 {
    // constructur passing a multi-dimensional function interface
@@ -73,6 +146,24 @@ void AdaptiveIntegratorMultiDim::SetRelTolerance(double relTol){ this->fRelTol =
 void AdaptiveIntegratorMultiDim::SetAbsTolerance(double absTol){ this->fAbsTol = absTol; }
 
 
+void AdaptiveIntegratorMultiDim::EvalNodes(unsigned int npts, const double * x, double * fval) const
+{
+   // evaluate the function at the npts points x (stored one after the other);
+   // the points are shared among the threads when the parallel evaluation is enabled
+#ifdef R__USE_IMT
+   if (fParallel && ROOT::IsImplicitMTEnabled()) {
+      // grain size: number of points evaluated by a single call of the function in a task
+      const unsigned int kGrain = 8;
+      tbb::parallel_for(tbb::blocked_range<unsigned int>(0, npts, kGrain),
+                        [&](const tbb::blocked_range<unsigned int> & r) {
+                           fFun->EvalVec(r.size(), x + r.begin()*fDim, fval + r.begin());
+                        });
+      return;
+   }
+#endif
+   fFun->EvalVec(npts, x, fval);
+}
+
 double AdaptiveIntegratorMultiDim::DoIntegral(const double* xmin, const double * xmax, bool absValue)
 {
    // References:
@@ -96,11 +187,8 @@ double AdaptiveIntegratorMultiDim::DoIntegral(const double* xmin, const double *
    double relerr; //an estimation of the relative accuracy of the result
 
 
-   double ctr[15], wth[15], wthl[15], z[15];
+   double ctr[15], wth[15];
 
-   static const double xl2 = 0.358568582800318073;//lambda_2
-   static const double xl4 = 0.948683298050513796;//lambda_4
-   static const double xl5 = 0.688247201611685289;//lambda_5
    static const double w2  = 980./6561; //weights/2^n
    static const double w4  = 200./19683;
    static const double wp2 = 245./486;//error weights/2^n
@@ -180,17 +268,50 @@ double AdaptiveIntegratorMultiDim::DoIntegral(const double* xmin, const double *
    double rgnvol, sum1, sum2, sum3, sum4, sum5, difmax, f2, f3, dif, aresult;
    double rgncmp=0, rgnval, rgnerr;
 
-   unsigned int j1, k, l, m, idvaxn=0, idvax0=0, isbtmp, isbtpp;
+   unsigned int k, idvaxn=0, idvax0=0, isbtmp, isbtpp;
 
-   //InitArgs(z,fParams);
+   // The nodes of the rule are evaluated with a single call to IMultiGenFunction::EvalVec
+   // (or one per kMaxBatch nodes). When a region is divided the nodes of both halves are
+   // evaluated together, the values of the second half being kept in fval + irlcls until
+   // it is processed
+   std::vector<double> nodes(std::min(2*irlcls, kMaxBatch)*n);
+   std::vector<double> fvalues(2*irlcls);
+   const double * fval = &fvalues[0];
+   bool secondHalfDone = kFALSE;
 
 L20:
+   if (secondHalfDone) {
+      secondHalfDone = kFALSE;
+      fval = &fvalues[irlcls];
+   }
+   else {
+      unsigned int npts = irlcls;
+      double ctr2[15];
+      if (ldv) {
+         // second half of the divided region
+         std::copy(ctr, ctr+n, ctr2);
+         ctr2[idvax0-1] += 2*wth[idvax0-1];
+         npts += irlcls;
+         secondHalfDone = kTRUE;
+      }
+      for (unsigned int first = 0; first < npts; first += kMaxBatch) {
+         const unsigned int nbatch = std::min(kMaxBatch, npts - first);
+         const unsigned int nfirst = (first < irlcls) ? std::min(nbatch, irlcls - first) : 0;
+         if (nfirst > 0)
+            FillRuleNodes(n, ctr, wth, first, nfirst, &nodes[0]);
+         if (nfirst < nbatch)
+            FillRuleNodes(n, ctr2, wth, first + nfirst - irlcls, nbatch - nfirst, &nodes[nfirst*n]);
+         EvalNodes(nbatch, &nodes[0], &fvalues[first]);
+      }
+      fval = &fvalues[0];
+   }
+
    rgnvol = twondm;//=2^n
    for (j=0; j<n; j++) {
       rgnvol *= wth[j]; //region volume
-      z[j]    = ctr[j]; //temporary node
    }
-   sum1 = (*fFun)((const double*)z);//EvalPar(z,fParams); //evaluate function
+   sum1 = fval[0]; //function value at the centre
+   const double * fv = fval + 1;
 
    difmax = 0;
    sum2   = 0;
@@ -198,19 +319,19 @@ L20:
 
    //loop over coordinates
    for (j=0; j<n; j++) {
-      z[j]    = ctr[j] - xl2*wth[j];
-      if (absValue) f2 = std::abs((*fFun)(z));
-      else          f2 = (*fFun)(z);
-      z[j]    = ctr[j] + xl2*wth[j];
-      if (absValue) f2 += std::abs((*fFun)(z));
-      else          f2 += (*fFun)(z);
-      wthl[j] = xl4*wth[j];
-      z[j]    = ctr[j] - wthl[j];
-      if (absValue) f3 = std::abs((*fFun)(z));
-      else          f3 = (*fFun)(z);
-      z[j]    = ctr[j] + wthl[j];
-      if (absValue) f3 += std::abs((*fFun)(z));
-      else          f3 += (*fFun)(z);
+      if (absValue) {
+         f2  = std::abs(fv[0]);
+         f2 += std::abs(fv[1]);
+         f3  = std::abs(fv[2]);
+         f3 += std::abs(fv[3]);
+      }
+      else {
+         f2  = fv[0];
+         f2 += fv[1];
+         f3  = fv[2];
+         f3 += fv[3];
+      }
+      fv += 4;
       sum2   += f2;//sum func eval with different weights separately
       sum3   += f3;//for a given region
       dif     = std::abs(7*f2-f3-12*sum1);
@@ -219,41 +340,20 @@ L20:
          difmax=dif;
          idvaxn=j+1;
       }
-      z[j]    = ctr[j];
    }
 
    sum4 = 0;
-   for (j=1;j<n;j++) {
-      j1 = j-1;
-      for (k=j;k<n;k++) {
-         for (l=0;l<2;l++) {
-            wthl[j1] = -wthl[j1];
-            z[j1]    = ctr[j1] + wthl[j1];
-            for (m=0;m<2;m++) {
-               wthl[k] = -wthl[k];
-               z[k]    = ctr[k] + wthl[k];
-               if (absValue) sum4 += std::abs((*fFun)(z));
-               else            sum4 += (*fFun)(z);
-            }
-         }
-         z[k] = ctr[k];
-      }
-      z[j1] = ctr[j1];
+   for (k=0; k<2*n*(n-1); k++) {
+      if (absValue) sum4 += std::abs(fv[k]);
+      else          sum4 += fv[k];
    }
+   fv += 2*n*(n-1);
 
    sum5 = 0;
-
-   for (j=0;j<n;j++) {
-      wthl[j] = -xl5*wth[j];
-      z[j] = ctr[j] + wthl[j];
-   }
-L90: //sum over end nodes ~gray codes
-   if (absValue) sum5 += std::abs((*fFun)(z));
-   else          sum5 += (*fFun)(z);
-   for (j=0;j<n;j++) {
-      wthl[j] = -wthl[j];
-      z[j] = ctr[j] + wthl[j];
-      if (wthl[j] > 0) goto L90;
+   //sum over end nodes
+   for (k=0; k<(1u << n); k++) {
+      if (absValue) sum5 += std::abs(fv[k]);
+      else          sum5 += fv[k];
    }
 
    rgncmp  = rgnvol*(wpn1[n-2]*sum1+wp2*sum2+wpn3[n-2]*sum3+wp4*sum4);
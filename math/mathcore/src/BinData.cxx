@@ -35,6 +35,8 @@ BinData::BinData(unsigned int maxpoints , unsigned int dim , ErrorType err ) :
    fSumContent(0),
    fSumError2(0),
    fRefVolume(1.0),
+   fColumnLayout(false),
+   fColumnSize(0),
    fDataVector(0),
    fDataWrapper(0)
 {
@@ -55,6 +57,8 @@ BinData::BinData (const DataOptions & opt, unsigned int maxpoints, unsigned int
    fSumContent(0),
    fSumError2(0),
    fRefVolume(1.0),
+   fColumnLayout(false),
+   fColumnSize(0),
    fDataVector(0),
    fDataWrapper(0)
 {
@@ -79,6 +83,8 @@ BinData::BinData (const DataOptions & opt, const DataRange & range, unsigned int
    fSumContent(0),
    fSumError2(0),
    fRefVolume(1.0),
+   fColumnLayout(false),
+   fColumnSize(0),
    fDataVector(0),
    fDataWrapper(0)
 {
@@ -101,6 +107,8 @@ BinData::BinData(unsigned int n, const double * dataX, const double * val, const
    fSumContent(0),
    fSumError2(0),
    fRefVolume(1.0),
+   fColumnLayout(false),
+   fColumnSize(0),
    fDataVector(0)
 {
    if (eval != 0) {
@@ -122,6 +130,8 @@ BinData::BinData(unsigned int n, const double * dataX, const double * dataY, con
    fSumContent(0),
    fSumError2(0),
    fRefVolume(1.0),
+   fColumnLayout(false),
+   fColumnSize(0),
    fDataVector(0)
 {
    if (eval != 0) {
@@ -141,6 +151,8 @@ BinData::BinData(unsigned int n, const double * dataX, const double * dataY, con
    fSumContent(0),
    fSumError2(0),
    fRefVolume(1.0),
+   fColumnLayout(false),
+   fColumnSize(0),
    fDataVector(0)
 {
    if (eval != 0) {
@@ -160,6 +172,8 @@ BinData::BinData(const BinData & rhs) :
    fSumContent(rhs.fSumContent),
    fSumError2(rhs.fSumError2),
    fRefVolume(rhs.fRefVolume),
+   fColumnLayout(rhs.fColumnLayout),
+   fColumnSize(rhs.fColumnSize),
    fDataVector(0),
    fDataWrapper(0),
    fBinEdge(rhs.fBinEdge)
@@ -190,6 +204,8 @@ BinData & BinData::operator= (const BinData & rhs) {
    fSumError2 = rhs.fSumError2;
    fBinEdge = rhs.fBinEdge;
    fRefVolume = rhs.fRefVolume;
+   fColumnLayout = rhs.fColumnLayout;
+   fColumnSize = rhs.fColumnSize;
    // delete previous pointers
    if (fDataVector) delete fDataVector;
    if (fDataWrapper) delete fDataWrapper;
@@ -218,6 +234,9 @@ void BinData::Initialize(unsigned int maxpoints, unsigned int dim , ErrorType er
 //       need to be initialized with the  right dimension before
    if (fDataWrapper) delete fDataWrapper;
    fDataWrapper = 0;
+   // the columns are re-arranged after having added the new points
+   bool columnLayout = fColumnLayout;
+   SetColumnLayout(false);
    unsigned int pointSize = GetPointSize(err,dim);
    if ( pointSize != fPointSize && fDataVector) {
 //       MATH_INFO_MSGVAL("BinData::Initialize"," Reset amd re-initialize with a new fit point size of ",
@@ -230,6 +249,7 @@ void BinData::Initialize(unsigned int maxpoints, unsigned int dim , ErrorType er
    unsigned int n = fPointSize*maxpoints;
    if ( n > MaxSize() ) {
       MATH_ERROR_MSGVAL("BinData::Initialize"," Invalid data size  ", n );
+      SetColumnLayout(columnLayout);
       return;
    }
    if (fDataVector) {
@@ -239,6 +259,7 @@ void BinData::Initialize(unsigned int maxpoints, unsigned int dim , ErrorType er
    else {
       fDataVector = new DataVector(n);
    }
+   SetColumnLayout(columnLayout);
    // reserve space for bin width in case of integral options
    if (Opt().fIntegral) fBinEdge.reserve( maxpoints * fDim);
 }
@@ -255,23 +276,51 @@ void BinData::Resize(unsigned int npoints) {
    else if (nextraPoints < 0) {
       // delete extra points
       if (!fDataVector) return;
+      bool columnLayout = fColumnLayout;
+      SetColumnLayout(false);
       (fDataVector->Data()).resize( npoints * fPointSize);
+      SetColumnLayout(columnLayout);
    }
    else
       Initialize(nextraPoints, fDim, GetErrorType() );
 }
+
+void BinData::SetColumnLayout(bool on) {
+   // re-arrange the copied data in columns or point by point
+   if (on == fColumnLayout) return;
+   if (fDataWrapper) {
+      MATH_WARN_MSG("BinData::SetColumnLayout","Data wrapping external arrays cannot be stored in columns");
+      return;
+   }
+   fColumnLayout = on;
+   fColumnSize = (fDataVector && fPointSize > 0) ? fDataVector->Size()/fPointSize : 0;
+   if (fColumnSize == 0) return;
+
+   std::vector<double> & v = fDataVector->Data();
+   std::vector<double> tmp(v.size());
+   for (unsigned int i = 0; i < fColumnSize; ++i) {
+      for (unsigned int k = 0; k < fPointSize; ++k) {
+         if (on)
+            tmp[ ColumnIndex(i,k) ] = v[ i*fPointSize + k ];
+         else
+            tmp[ i*fPointSize + k ] = v[ ColumnIndex(i,k) ];
+      }
+   }
+   v.swap(tmp);
+}
+
    /**
    */
 void BinData::Add(double x, double y ) {
 //       add one dim data with only coordinate and values
-   int index = fNPoints*PointSize();
    assert (fDataVector != 0);
    assert (PointSize() == 2 );
-   assert (index + PointSize() <= DataSize() );
+   assert ((fNPoints+1)*PointSize() <= DataSize() );
 
-   double * itr = &((fDataVector->Data())[ index ]);
-   *itr++ = x;
-   *itr++ = y;
+   std::vector<double> & v = fDataVector->Data();
+   unsigned int k = 0;
+   v[ Index(fNPoints, k++) ] = x;
+   v[ Index(fNPoints, k++) ] = y;
 
    fNPoints++;
    fSumContent += y;
@@ -282,17 +331,17 @@ void BinData::Add(double x, double y ) {
 void BinData::Add(double x, double y, double ey) {
 //       add one dim data with no error in x
 //       in this case store the inverse of the error in y
-   int index = fNPoints*PointSize();
 
    assert( fDim == 1);
    assert (fDataVector != 0);
    assert (PointSize() == 3 );
-   assert (index + PointSize() <= DataSize() );
+   assert ((fNPoints+1)*PointSize() <= DataSize() );
 
-   double * itr = &((fDataVector->Data())[ index ]);
-   *itr++ = x;
-   *itr++ = y;
-   *itr++ =  (ey!= 0) ? 1.0/ey : 0;
+   std::vector<double> & v = fDataVector->Data();
+   unsigned int k = 0;
+   v[ Index(fNPoints, k++) ] = x;
+   v[ Index(fNPoints, k++) ] = y;
+   v[ Index(fNPoints, k++) ] = (ey!= 0) ? 1.0/ey : 0;
 
    fNPoints++;
    fSumContent += y;
@@ -304,17 +353,17 @@ void BinData::Add(double x, double y, double ey) {
 void BinData::Add(double x, double y, double ex, double ey) {
 //      add one dim data with  error in x
 //      in this case store the y error and not the inverse
-   int index = fNPoints*PointSize();
    assert (fDataVector != 0);
    assert( fDim == 1);
    assert (PointSize() == 4 );
-   assert (index + PointSize() <= DataSize() );
+   assert ((fNPoints+1)*PointSize() <= DataSize() );
 
-   double * itr = &((fDataVector->Data())[ index ]);
-   *itr++ = x;
-   *itr++ = y;
-   *itr++ = ex;
-   *itr++ = ey;
+   std::vector<double> & v = fDataVector->Data();
+   unsigned int k = 0;
+   v[ Index(fNPoints, k++) ] = x;
+   v[ Index(fNPoints, k++) ] = y;
+   v[ Index(fNPoints, k++) ] = ex;
+   v[ Index(fNPoints, k++) ] = ey;
 
    fNPoints++;
    fSumContent += y;
@@ -326,18 +375,18 @@ void BinData::Add(double x, double y, double ex, double ey) {
 void BinData::Add(double x, double y, double ex, double eyl , double eyh) {
 //      add one dim data with  error in x and asymmetric errors in y
 //      in this case store the y errors and not the inverse
-   int index = fNPoints*PointSize();
    assert (fDataVector != 0);
    assert( fDim == 1);
    assert (PointSize() == 5 );
-   assert (index + PointSize() <= DataSize() );
+   assert ((fNPoints+1)*PointSize() <= DataSize() );
 
-   double * itr = &((fDataVector->Data())[ index ]);
-   *itr++ = x;
-   *itr++ = y;
-   *itr++ = ex;
-   *itr++ = eyl;
-   *itr++ = eyh;
+   std::vector<double> & v = fDataVector->Data();
+   unsigned int k = 0;
+   v[ Index(fNPoints, k++) ] = x;
+   v[ Index(fNPoints, k++) ] = y;
+   v[ Index(fNPoints, k++) ] = ex;
+   v[ Index(fNPoints, k++) ] = eyl;
+   v[ Index(fNPoints, k++) ] = eyh;
 
    fNPoints++;
    fSumContent += y;
@@ -349,20 +398,20 @@ void BinData::Add(double x, double y, double ex, double eyl , double eyh) {
    */
 void BinData::Add(const double *x, double val) {
 //      add multi dim data with only value (no errors)
-   int index = fNPoints*PointSize();
    assert (fDataVector != 0);
    assert (PointSize() == fDim + 1 );
 
-   if (index + PointSize() > DataSize())
+   if ((fNPoints+1)*PointSize() > DataSize())
       MATH_ERROR_MSGVAL("BinData::Add","add a point beyond the data size", DataSize() );
 
-   assert (index + PointSize() <= DataSize() );
+   assert ((fNPoints+1)*PointSize() <= DataSize() );
 
-   double * itr = &((fDataVector->Data())[ index ]);
+   std::vector<double> & v = fDataVector->Data();
+   unsigned int k = 0;
 
    for (unsigned int i = 0; i < fDim; ++i)
-      *itr++ = x[i];
-   *itr++ = val;
+      v[ Index(fNPoints, k++) ] = x[i];
+   v[ Index(fNPoints, k++) ] = val;
 
    fNPoints++;
    fSumContent += val;
@@ -372,21 +421,21 @@ void BinData::Add(const double *x, double val) {
    */
 void BinData::Add(const double *x, double val, double  eval) {
 //      add multi dim data with only error in value
-   int index = fNPoints*PointSize();
    assert (fDataVector != 0);
    assert (PointSize() == fDim + 2 );
 
-   if (index + PointSize() > DataSize())
+   if ((fNPoints+1)*PointSize() > DataSize())
       MATH_ERROR_MSGVAL("BinData::Add","add a point beyond the data size", DataSize() );
 
-   assert (index + PointSize() <= DataSize() );
+   assert ((fNPoints+1)*PointSize() <= DataSize() );
 
-   double * itr = &((fDataVector->Data())[ index ]);
+   std::vector<double> & v = fDataVector->Data();
+   unsigned int k = 0;
 
    for (unsigned int i = 0; i < fDim; ++i)
-      *itr++ = x[i];
-   *itr++ = val;
-   *itr++ =  (eval!= 0) ? 1.0/eval : 0;
+      v[ Index(fNPoints, k++) ] = x[i];
+   v[ Index(fNPoints, k++) ] = val;
+   v[ Index(fNPoints, k++) ] = (eval!= 0) ? 1.0/eval : 0;
 
    fNPoints++;
    fSumContent += val;
@@ -398,23 +447,23 @@ void BinData::Add(const double *x, double val, double  eval) {
    */
 void BinData::Add(const double *x, double val, const double * ex, double  eval) {
    //      add multi dim data with error in coordinates and value
-   int index = fNPoints*PointSize();
    assert (fDataVector != 0);
    assert (PointSize() == 2*fDim + 2 );
 
-   if (index + PointSize() > DataSize())
+   if ((fNPoints+1)*PointSize() > DataSize())
       MATH_ERROR_MSGVAL("BinData::Add","add a point beyond the data size", DataSize() );
 
-   assert (index + PointSize() <= DataSize() );
+   assert ((fNPoints+1)*PointSize() <= DataSize() );
 
-   double * itr = &((fDataVector->Data())[ index ]);
+   std::vector<double> & v = fDataVector->Data();
+   unsigned int k = 0;
 
    for (unsigned int i = 0; i < fDim; ++i)
-      *itr++ = x[i];
-   *itr++ = val;
+      v[ Index(fNPoints, k++) ] = x[i];
+   v[ Index(fNPoints, k++) ] = val;
    for (unsigned int i = 0; i < fDim; ++i)
-      *itr++ = ex[i];
-   *itr++ = eval;
+      v[ Index(fNPoints, k++) ] = ex[i];
+   v[ Index(fNPoints, k++) ] = eval;
 
    fNPoints++;
    fSumContent += val;
@@ -425,24 +474,24 @@ void BinData::Add(const double *x, double val, const double * ex, double  eval)
    */
 void BinData::Add(const double *x, double val, const double * ex, double  elval, double  ehval) {
    //      add multi dim data with error in coordinates and asymmetric error in value
-   int index = fNPoints*PointSize();
    assert (fDataVector != 0);
    assert (PointSize() == 2*fDim + 3 );
 
-   if (index + PointSize() > DataSize())
+   if ((fNPoints+1)*PointSize() > DataSize())
       MATH_ERROR_MSGVAL("BinData::Add","add a point beyond the data size", DataSize() );
 
-   assert (index + PointSize() <= DataSize() );
+   assert ((fNPoints+1)*PointSize() <= DataSize() );
 
-   double * itr = &((fDataVector->Data())[ index ]);
+   std::vector<double> & v = fDataVector->Data();
+   unsigned int k = 0;
 
    for (unsigned int i = 0; i < fDim; ++i)
-      *itr++ = x[i];
-   *itr++ = val;
+      v[ Index(fNPoints, k++) ] = x[i];
+   v[ Index(fNPoints, k++) ] = val;
    for (unsigned int i = 0; i < fDim; ++i)
-      *itr++ = ex[i];
-   *itr++ = elval;
-   *itr++ = ehval;
+      v[ Index(fNPoints, k++) ] = ex[i];
+   v[ Index(fNPoints, k++) ] = elval;
+   v[ Index(fNPoints, k++) ] = ehval;
 
    fNPoints++;
    fSumContent += val;
@@ -482,6 +531,14 @@ BinData & BinData::LogTransform() {
 
    if (fNPoints == 0) return *this;
 
+   if (fColumnLayout) {
+      // transform the data stored point by point
+      SetColumnLayout(false);
+      LogTransform();
+      SetColumnLayout(true);
+      return *this;
+   }
+
    if (fDataVector) {
 
       ErrorType type = GetErrorType();
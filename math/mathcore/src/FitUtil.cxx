@@ -34,6 +34,13 @@
 #include <algorithm>
 //#include <memory>
 
+#include "RConfigure.h"
+#ifdef R__USE_IMT
+#include "TROOT.h"
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#endif
+
 //#define DEBUG
 #ifdef DEBUG
 #define NSAMPLE 10
@@ -165,6 +172,122 @@ namespace ROOT {
          };
 
 
+         // number of points evaluated by a single call of IParamMultiFunction::EvalParVec
+         const unsigned int kBlockSize = 256;
+
+         // internal class to evaluate the model function at the coordinates of the data points
+         // the function is evaluated on blocks of consecutive points with a single call to
+         // IParamMultiFunction::EvalParVec, which for compiled formulas is a vectorizable loop.
+         // The coordinates of copied data are passed directly, using the distance between the
+         // points of the data layout, while those of wrapped data are first copied in a packed buffer
+         template<class Data>
+         class VecEvaluator {
+
+         public:
+
+            VecEvaluator(const IModelFunction & func, const Data & data, const double * p) :
+               fBegin(0),
+               fEnd(0),
+               fDim(data.NDim()),
+               fParams(p),
+               fFunc(func),
+               fData(data),
+               fX((data.DataSize() > 0) ? 0 : kBlockSize * data.NDim()),
+               fValues(kBlockSize)
+            {}
+
+            // return the function value at the coordinates of point i
+            double operator() (unsigned int i) {
+               if (i < fBegin || i >= fEnd) Evaluate(i);
+               return fValues[i - fBegin];
+            }
+
+         private:
+
+            // evaluate the block of points starting at i
+            void Evaluate(unsigned int i) {
+               fBegin = i;
+               fEnd = std::min(i + kBlockSize, fData.Size());
+               if (fData.DataSize() > 0) {
+                  fFunc.EvalParVec(fEnd - fBegin, fData.Coords(fBegin), &fValues.front(), fParams, fData.CoordStride());
+                  return;
+               }
+               for (unsigned int k = fBegin; k < fEnd; ++k) {
+                  const double * x = fData.Coords(k);
+                  std::copy(x, x + fDim, &fX[(k - fBegin) * fDim]);
+               }
+               fFunc.EvalParVec(fEnd - fBegin, &fX.front(), &fValues.front(), fParams, fDim);
+            }
+
+            // objects of this class are not meant to be copied / assigned
+            VecEvaluator(const VecEvaluator& rhs);
+            VecEvaluator& operator=(const VecEvaluator& rhs);
+
+            unsigned int fBegin;           // first point of the evaluated block
+            unsigned int fEnd;             // end of the evaluated block
+            unsigned int fDim;
+            const double * fParams;
+            const IModelFunction & fFunc;
+            const Data & fData;
+            std::vector<double> fX;        // packed coordinates of the block (wrapped data only)
+            std::vector<double> fValues;   // function values of the block
+         };
+
+
+         // size of the chunks of data points evaluated by SumChunks. It is a multiple of
+         // kBlockSize so that the blocks of VecEvaluator do not cross chunks
+         const unsigned int kChunkSize = 2048;
+
+         // the chunks of data points can be evaluated in parallel only if the data are not
+         // wrapped and the model function declares that it can be evaluated concurrently
+         template <class Data>
+         bool UseParallel(const IModelFunction & func, const Data & data) {
+            return data.DataSize() > 0 && func.IsThreadSafe();
+         }
+
+         // add the contributions of the n data points to the nres values in result.
+         // The points are split in chunks of kChunkSize points and evalChunk(begin, end, r)
+         // must add the contributions of the points [begin, end) to r[0..nres-1].
+         // The chunks are evaluated in parallel when parallel is true and implicit
+         // multithreading is enabled. The chunk results are then added in a fixed order
+         // with a compensated summation, so the result does not depend on the number of threads
+         template <class F>
+         void SumChunks(unsigned int n, unsigned int nres, bool parallel, F evalChunk, double * result) {
+            if (n == 0) return;
+            const unsigned int nChunks = (n - 1) / kChunkSize + 1;
+            if (nChunks == 1) {
+               evalChunk(0, n, result);
+               return;
+            }
+            std::vector<double> chunkResults(nChunks * nres);
+            auto evalChunks = [&](unsigned int first, unsigned int last) {
+               for (unsigned int ic = first; ic < last; ++ic)
+                  evalChunk(ic * kChunkSize, std::min((ic + 1) * kChunkSize, n), &chunkResults[ic * nres]);
+            };
+#ifdef R__USE_IMT
+            if (parallel && ROOT::IsImplicitMTEnabled()) {
+               tbb::parallel_for(tbb::blocked_range<unsigned int>(0, nChunks),
+                                 [&](const tbb::blocked_range<unsigned int> & r) { evalChunks(r.begin(), r.end()); });
+            }
+            else
+#else
+            (void) parallel;
+#endif
+               evalChunks(0, nChunks);
+
+            for (unsigned int k = 0; k < nres; ++k) {
+               double sum = result[k];
+               double c = 0;
+               for (unsigned int ic = 0; ic < nChunks; ++ic) {
+                  double y = chunkResults[ic * nres + k] - c;
+                  double t = sum + y;
+                  c = (t - sum) - y;
+                  sum = t;
+               }
+               result[k] = sum;
+            }
+         }
+
          // derivative with respect of the parameter to be integrated
          template<class GradFunc = IGradModelFunction>
          struct ParamDerivFunc {
@@ -338,12 +461,20 @@ namespace ROOT {
 double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data, const double * p, unsigned int & nPoints) {
    // evaluate the chi2 given a  function reference  , the data and returns the value and also in nPoints
    // the actual number of used points
+   double chi2 = 0;
+   EvaluateChi2Batch(func, data, 1, p, &chi2, nPoints);
+   return chi2;
+}
+
+void FitUtil::EvaluateChi2Batch(const IModelFunction & func, const BinData & data, unsigned int nset, const double * p, double * chi2, unsigned int & nPoints) {
+   // evaluate the chi2 for nset sets of parameters stored one after the other in p.
    // normal chi2 using only error on values (from fitting histogram)
    // optionally the integral of function in the bin is used
 
    unsigned int n = data.Size();
 
-   double chi2 = 0;
+   unsigned int npar = func.NPar();
+   std::fill(chi2, chi2 + nset, 0.);
    nPoints = 0; // count the effective non-zero points
    // set parameters of the function to cache integral value
 #ifdef USE_PARAMCACHE
@@ -359,6 +490,13 @@ double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data,
    bool useBinVolume = (fitOpt.fBinVolume && data.HasBinEdges());
    bool useExpErrors = (fitOpt.fExpErrors);
 
+   // the bin integrals use the parameters set in the function: evaluate the sets one by one
+   if (nset > 1 && useBinIntegral) {
+      for (unsigned int ks = 0; ks < nset; ++ks)
+         EvaluateChi2Batch(func, data, 1, p + ks * npar, chi2 + ks, nPoints);
+      return;
+   }
+
 #ifdef DEBUG
    std::cout << "\n\nFit data size = " << n << std::endl;
    std::cout << "evaluate chi2 using function " << &func << "  " << p << std::endl;
@@ -367,105 +505,143 @@ double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data,
    std::cout << "use all error=1 " << fitOpt.fErrors1 << std::endl;
 #endif
 
-#ifdef USE_PARAMCACHE
-   IntegralEvaluator<> igEval( func, 0, useBinIntegral); 
-#else
-   IntegralEvaluator<> igEval( func, p, useBinIntegral); 
-#endif
    double maxResValue = std::numeric_limits<double>::max() /n;
    double wrefVolume = 1.0;
-   std::vector<double> xc;
    if (useBinVolume) {
       if (fitOpt.fNormBinVolume) wrefVolume /= data.RefVolume();
-      xc.resize(data.NDim() );
    }
 
-   (const_cast<IModelFunction &>(func)).SetParameters(p);
-   for (unsigned int i = 0; i < n; ++ i) {
-
-      double y = 0, invError = 1.;
+   // when the data are stored in columns with the inverse errors, the residuals are computed
+   // on blocks of points reading the values and the errors from contiguous arrays
+   const double * valueColumn = data.ValueColumn();
+   const double * invErrorColumn = data.InvErrorColumn();
+   bool useColumns = invErrorColumn != 0 && !useBinIntegral && !useBinVolume && !useExpErrors;
 
-      // in case of no error in y invError=1 is returned
-      const double * x1 = data.GetPoint(i,y, invError);
-
-      double fval = 0;
-
-      double binVolume = 1.0;
-        if (useBinVolume) {
-         unsigned int ndim = data.NDim();
-         const double * x2 = data.BinUpEdge(i);
-         for (unsigned int j = 0; j < ndim; ++j) {
-            binVolume *= std::abs( x2[j]-x1[j] );
-            xc[j] = 0.5*(x2[j]+ x1[j]);
+   (const_cast<IModelFunction &>(func)).SetParameters(p);
+   // evaluate the chi2 of the points [begin, end) for the parameters pk and add it to result
+   auto evalSet = [&](unsigned int begin, unsigned int end, const double * pk, double * result) {
+      if (useColumns) {
+         double fval[kBlockSize];
+         double resval[kBlockSize];
+         double chi2Chunk = 0;
+         for (unsigned int i = begin; i < end; i += kBlockSize) {
+            unsigned int nb = std::min(kBlockSize, end - i);
+            func.EvalParVec(nb, data.Coords(i), fval, pk, data.CoordStride());
+            const double * y = valueColumn + i;
+            const double * invError = invErrorColumn + i;
+            for (unsigned int k = 0; k < nb; ++k) {
+               double tmp = ( y[k] - fval[k] ) * invError[k];
+               double r = tmp * tmp;
+               // as below: points with zero error are skipped and infinities or nan are replaced
+               resval[k] = (invError[k] > 0) ? ( (r < maxResValue) ? r : maxResValue ) : 0;
+            }
+            for (unsigned int k = 0; k < nb; ++k) chi2Chunk += resval[k];
          }
-         // normalize the bin volume using a reference value
-         binVolume *= wrefVolume;
+         result[0] += chi2Chunk;
+         return;
       }
+#ifdef USE_PARAMCACHE
+      IntegralEvaluator<> igEval( func, 0, useBinIntegral);
+#else
+      IntegralEvaluator<> igEval( func, pk, useBinIntegral);
+#endif
+      // evaluate the function on blocks of points when neither the bin integral nor the bin volume is needed
+      VecEvaluator<BinData> vecEval( func, data, pk);
+      std::vector<double> xc;
+      if (useBinVolume) xc.resize(data.NDim() );
+      double chi2Chunk = 0;
+      for (unsigned int i = begin; i < end; ++ i) {
+
+         double y = 0, invError = 1.;
+
+         // in case of no error in y invError=1 is returned
+         const double * x1 = data.GetPoint(i,y, invError);
+
+         double fval = 0;
+
+         double binVolume = 1.0;
+           if (useBinVolume) {
+            unsigned int ndim = data.NDim();
+            const double * x2 = data.BinUpEdge(i);
+            for (unsigned int j = 0; j < ndim; ++j) {
+               binVolume *= std::abs( x2[j]-x1[j] );
+               xc[j] = 0.5*(x2[j]+ x1[j]);
+            }
+            // normalize the bin volume using a reference value
+            binVolume *= wrefVolume;
+         }
 
-      const double * x = (useBinVolume) ? &xc.front() : x1;
+         const double * x = (useBinVolume) ? &xc.front() : x1;
 
-      if (!useBinIntegral) {
+         if (!useBinIntegral) {
+            if (!useBinVolume)
+               fval = vecEval( i );
+            else
 #ifdef USE_PARAMCACHE
-         fval = func ( x );
+               fval = func ( x );
 #else
-         fval = func ( x, p );
+               fval = func ( x, pk );
 #endif
-      }
-      else {
-         // calculate integral normalized by bin volume
-         // need to set function and parameters here in case loop is parallelized
-         fval = igEval( x1, data.BinUpEdge(i)) ;
-      }
-      // normalize result if requested according to bin volume
-      if (useBinVolume) fval *= binVolume;
-
-      // expected errors
-      if (useExpErrors) {
-         // we need first to check if a weight factor needs to be applied
-         // weight = sumw2/sumw = error**2/content
-         double invWeight = y * invError * invError;
-         if (invError == 0) invWeight = (data.SumOfError2() > 0) ? data.SumOfContent()/ data.SumOfError2() : 1.0;
-         // compute expected error  as f(x) / weight
-         double invError2 = (fval > 0) ? invWeight / fval : 0.0;
-         invError = std::sqrt(invError2);
-      }
+         }
+         else {
+            // calculate integral normalized by bin volume
+            // need to set function and parameters here in case loop is parallelized
+            fval = igEval( x1, data.BinUpEdge(i)) ;
+         }
+         // normalize result if requested according to bin volume
+         if (useBinVolume) fval *= binVolume;
+
+         // expected errors
+         if (useExpErrors) {
+            // we need first to check if a weight factor needs to be applied
+            // weight = sumw2/sumw = error**2/content
+            double invWeight = y * invError * invError;
+            if (invError == 0) invWeight = (data.SumOfError2() > 0) ? data.SumOfContent()/ data.SumOfError2() : 1.0;
+            // compute expected error  as f(x) / weight
+            double invError2 = (fval > 0) ? invWeight / fval : 0.0;
+            invError = std::sqrt(invError2);
+         }
 
 //#define DEBUG
 #ifdef DEBUG
-      std::cout << x[0] << "  " << y << "  " << 1./invError << " params : ";
-      for (unsigned int ipar = 0; ipar < func.NPar(); ++ipar)
-         std::cout << p[ipar] << "\t";
-      std::cout << "\tfval = " << fval << " bin volume " << binVolume << " ref " << wrefVolume << std::endl;
+         std::cout << x[0] << "  " << y << "  " << 1./invError << " params : ";
+         for (unsigned int ipar = 0; ipar < func.NPar(); ++ipar)
+            std::cout << pk[ipar] << "\t";
+         std::cout << "\tfval = " << fval << " bin volume " << binVolume << " ref " << wrefVolume << std::endl;
 #endif
 //#undef DEBUG
 
 
-      if (invError > 0) {
-         nPoints++;
+         if (invError > 0) {
 
-         double tmp = ( y -fval )* invError;
-         double resval = tmp * tmp;
+            double tmp = ( y -fval )* invError;
+            double resval = tmp * tmp;
 
 
-         // avoid inifinity or nan in chi2 values due to wrong function values
-         if ( resval < maxResValue )
-            chi2 += resval;
-         else {
-            //nRejected++;
-            chi2 += maxResValue;
+            // avoid inifinity or nan in chi2 values due to wrong function values
+            if ( resval < maxResValue )
+               chi2Chunk += resval;
+            else {
+               //nRejected++;
+               chi2Chunk += maxResValue;
+            }
          }
-      }
 
 
-   }
+      }
+      result[0] += chi2Chunk;
+   };
+   // evaluate all the sets on the chunk of points [begin, end), which stays in the cache
+   auto evalChunk = [&](unsigned int begin, unsigned int end, double * result) {
+      for (unsigned int ks = 0; ks < nset; ++ks) evalSet(begin, end, p + ks * npar, result + ks);
+   };
+   SumChunks(n, nset, UseParallel(func, data), evalChunk, chi2);
+
    nPoints=n;
 
 #ifdef DEBUG
-   std::cout << "chi2 = " << chi2 << " n = " << nPoints  /*<< " rejected = " << nRejected */ << std::endl;
+   std::cout << "chi2 = " << chi2[0] << " n = " << nPoints  /*<< " rejected = " << nRejected */ << std::endl;
 #endif
-
-
-   return chi2;
 }
 
 
@@ -727,99 +903,104 @@ void FitUtil::EvaluateChi2Gradient(const IModelFunction & f, const BinData & dat
    bool useBinVolume = (fitOpt.fBinVolume && data.HasBinEdges());
 
    double wrefVolume = 1.0;
-   std::vector<double> xc;
    if (useBinVolume) {
       if (fitOpt.fNormBinVolume) wrefVolume /= data.RefVolume();
-      xc.resize(data.NDim() );
    }
 
-   IntegralEvaluator<> igEval( func, p, useBinIntegral);
-
    //int nRejected = 0;
    // set values of parameters
 
    unsigned int npar = func.NPar();
    //   assert (npar == NDim() );  // npar MUST be  Chi2 dimension
-   std::vector<double> gradFunc( npar );
-   // set all vector values to zero
-   std::vector<double> g( npar);
-
-   for (unsigned int i = 0; i < n; ++ i) {
-
-
-      double y, invError = 0;
-      const double * x1 = data.GetPoint(i,y, invError);
-
-      double fval = 0;
-      const double * x2 = 0;
-
-      double binVolume = 1;
-      if (useBinVolume) {
-         unsigned int ndim = data.NDim();
-         x2 = data.BinUpEdge(i);
-         for (unsigned int j = 0; j < ndim; ++j) {
-            binVolume *= std::abs( x2[j]-x1[j] );
-            xc[j] = 0.5*(x2[j]+ x1[j]);
+   // gradient followed by the number of rejected points
+   std::vector<double> g( npar + 1);
+
+   // add the gradient contributions of the points [begin, end) to result
+   auto evalChunk = [&](unsigned int begin, unsigned int end, double * result) {
+      IntegralEvaluator<> igEval( func, p, useBinIntegral);
+      std::vector<double> gradFunc( npar );
+      std::vector<double> xc;
+      if (useBinVolume) xc.resize(data.NDim() );
+      for (unsigned int i = begin; i < end; ++ i) {
+
+
+         double y, invError = 0;
+         const double * x1 = data.GetPoint(i,y, invError);
+
+         double fval = 0;
+         const double * x2 = 0;
+
+         double binVolume = 1;
+         if (useBinVolume) {
+            unsigned int ndim = data.NDim();
+            x2 = data.BinUpEdge(i);
+            for (unsigned int j = 0; j < ndim; ++j) {
+               binVolume *= std::abs( x2[j]-x1[j] );
+               xc[j] = 0.5*(x2[j]+ x1[j]);
+            }
+            // normalize the bin volume using a reference value
+            binVolume *= wrefVolume;
          }
-         // normalize the bin volume using a reference value
-         binVolume *= wrefVolume;
-      }
 
-      const double * x = (useBinVolume) ? &xc.front() : x1;
+         const double * x = (useBinVolume) ? &xc.front() : x1;
 
-      if (!useBinIntegral ) {
-         fval = func ( x, p );
-         func.ParameterGradient(  x , p, &gradFunc[0] );
-      }
-      else {
-         x2 = data.BinUpEdge(i);
-         // calculate normalized integral and gradient (divided by bin volume)
-         // need to set function and parameters here in case loop is parallelized
-         fval = igEval( x1, x2 ) ;
-         CalculateGradientIntegral( func, x1, x2, p, &gradFunc[0]);
-      }
-      if (useBinVolume) fval *= binVolume;
+         if (!useBinIntegral ) {
+            fval = func ( x, p );
+            func.ParameterGradient(  x , p, &gradFunc[0] );
+         }
+         else {
+            x2 = data.BinUpEdge(i);
+            // calculate normalized integral and gradient (divided by bin volume)
+            // need to set function and parameters here in case loop is parallelized
+            fval = igEval( x1, x2 ) ;
+            CalculateGradientIntegral( func, x1, x2, p, &gradFunc[0]);
+         }
+         if (useBinVolume) fval *= binVolume;
 
 #ifdef DEBUG
-      std::cout << x[0] << "  " << y << "  " << 1./invError << " params : ";
-      for (unsigned int ipar = 0; ipar < npar; ++ipar)
-         std::cout << p[ipar] << "\t";
-      std::cout << "\tfval = " << fval << std::endl;
+         std::cout << x[0] << "  " << y << "  " << 1./invError << " params : ";
+         for (unsigned int ipar = 0; ipar < npar; ++ipar)
+            std::cout << p[ipar] << "\t";
+         std::cout << "\tfval = " << fval << std::endl;
 #endif
-      if ( !CheckValue(fval) ) {
-         nRejected++;
-         continue;
-      }
+         if ( !CheckValue(fval) ) {
+            result[npar] += 1;
+            continue;
+         }
 
-      // loop on the parameters
-      unsigned int ipar = 0;
-      for ( ; ipar < npar ; ++ipar) {
+         // loop on the parameters
+         unsigned int ipar = 0;
+         for ( ; ipar < npar ; ++ipar) {
 
-         // correct gradient for bin volumes
-         if (useBinVolume) gradFunc[ipar] *= binVolume;
+            // correct gradient for bin volumes
+            if (useBinVolume) gradFunc[ipar] *= binVolume;
+
+            // avoid singularity in the function (infinity and nan ) in the chi2 sum
+            // eventually add possibility of excluding some points (like singularity)
+            double dfval = gradFunc[ipar];
+            if ( !CheckValue(dfval) ) {
+                  break; // exit loop on parameters
+            }
+
+            // calculate derivative point contribution
+            double tmp = - 2.0 * ( y -fval )* invError * invError * gradFunc[ipar];
+            result[ipar] += tmp;
 
-         // avoid singularity in the function (infinity and nan ) in the chi2 sum
-         // eventually add possibility of excluding some points (like singularity)
-         double dfval = gradFunc[ipar];
-         if ( !CheckValue(dfval) ) {
-               break; // exit loop on parameters
          }
 
-         // calculate derivative point contribution
-         double tmp = - 2.0 * ( y -fval )* invError * invError * gradFunc[ipar];
-         g[ipar] += tmp;
+         if ( ipar < npar ) {
+             // case loop was broken for an overflow in the gradient calculation
+            result[npar] += 1;
+            continue;
+         }
 
-      }
 
-      if ( ipar < npar ) {
-          // case loop was broken for an overflow in the gradient calculation
-         nRejected++;
-         continue;
       }
+   };
+   SumChunks(n, npar + 1, UseParallel(func, data), evalChunk, &g[0]);
+   nRejected = (unsigned int) g[npar];
 
 
-   }
-
    // correct the number of points
    nPoints = n;
    if (nRejected != 0)  {
@@ -829,7 +1010,7 @@ void FitUtil::EvaluateChi2Gradient(const IModelFunction & f, const BinData & dat
    }
 
    // copy result
-   std::copy(g.begin(), g.end(), grad);
+   std::copy(g.begin(), g.begin() + npar, grad);
 
 }
 
@@ -893,15 +1074,23 @@ double FitUtil::EvaluatePdf(const IModelFunction & func, const UnBinData & data,
 double FitUtil::EvaluateLogL(const IModelFunction & func, const UnBinData & data, const double * p,
                                    int iWeight,  bool extended, unsigned int &nPoints) {
    // evaluate the LogLikelihood
+   double nlogl = 0;
+   EvaluateLogLBatch(func, data, 1, p, iWeight, extended, &nlogl, nPoints);
+   return nlogl;
+}
+
+void FitUtil::EvaluateLogLBatch(const IModelFunction & func, const UnBinData & data, unsigned int nset, const double * p,
+                                int iWeight, bool extended, double * nlogl, unsigned int &nPoints) {
+   // evaluate the negative LogLikelihood for nset sets of parameters stored one after the other in p
 
    unsigned int n = data.Size();
+   unsigned int npar = func.NPar();
 
 #ifdef DEBUG
    std::cout << "\n\nFit data size = " << n << std::endl;
    std::cout << "func pointer is " << typeid(func).name() << std::endl;
 #endif
 
-   double logl = 0;
    //unsigned int nRejected = 0;
 
    // set parameters of the function to cache integral value
@@ -912,6 +1101,12 @@ double FitUtil::EvaluateLogL(const IModelFunction & func, const UnBinData & data
    // this is needed if function must be normalized 
    bool normalizeFunc = false; 
    double norm = 1.0;
+   // the normalization depends on the parameters: evaluate the sets one by one
+   if (nset > 1 && normalizeFunc) {
+      for (unsigned int ks = 0; ks < nset; ++ks)
+         EvaluateLogLBatch(func, data, 1, p + ks * npar, iWeight, extended, nlogl + ks, nPoints);
+      return;
+   }
    if (normalizeFunc) {
       // compute integral of the function
       std::vector<double> xmin(data.NDim());
@@ -921,82 +1116,95 @@ double FitUtil::EvaluateLogL(const IModelFunction & func, const UnBinData & data
       norm = igEval.Integral(&xmin[0],&xmax[0]);
    }
 
-   // needed to compue effective global weight in case of extended likelihood
-   double sumW = 0;
-   double sumW2 = 0;
-
-   for (unsigned int i = 0; i < n; ++ i) {
-      const double * x = data.Coords(i);
-#ifdef USE_PARAMCACHE
-       double fval = func ( x );
-#else
-       double fval = func ( x, p );
-#endif
-      if (normalizeFunc) fval = fval / norm;
+   // add the log likelihood of the points [begin, end) for the parameters pk to result[0]
+   // and the sums of weights and weights square to result[1] and result[2]
+   auto evalSet = [&](unsigned int begin, unsigned int end, const double * pk, double * result) {
+      VecEvaluator<UnBinData> vecEval( func, data, pk);
+      double loglChunk = 0;
+      for (unsigned int i = begin; i < end; ++ i) {
+         double fval = vecEval( i );
+         if (normalizeFunc) fval = fval / norm;
 
 #ifdef DEBUG
-      std::cout << "x [ " << data.NDim() << " ] = ";
-      for (unsigned int j = 0; j < data.NDim(); ++j)
-         std::cout << x[j] << "\t";
-      std::cout << "\tpar = [ " << func.NPar() << " ] =  ";
-      for (unsigned int ipar = 0; ipar < func.NPar(); ++ipar)
-         std::cout << p[ipar] << "\t";
-      std::cout << "\tfval = " << fval << std::endl;
+         const double * x = data.Coords(i);
+         std::cout << "x [ " << data.NDim() << " ] = ";
+         for (unsigned int j = 0; j < data.NDim(); ++j)
+            std::cout << x[j] << "\t";
+         std::cout << "\tpar = [ " << func.NPar() << " ] =  ";
+         for (unsigned int ipar = 0; ipar < func.NPar(); ++ipar)
+            std::cout << pk[ipar] << "\t";
+         std::cout << "\tfval = " << fval << std::endl;
 #endif
-      // function EvalLog protects against negative or too small values of fval
-      double logval =  ROOT::Math::Util::EvalLog( fval);
-      if (iWeight > 0) {
-         double weight = data.Weight(i);
-         logval *= weight;
-         if (iWeight ==2) {
-            logval *= weight; // use square of weights in likelihood
-            if (extended) {
-               // needed sum of weights and sum of weight square if likelkihood is extended
-               sumW += weight;
-               sumW2 += weight*weight;
+         // function EvalLog protects against negative or too small values of fval
+         double logval =  ROOT::Math::Util::EvalLog( fval);
+         if (iWeight > 0) {
+            double weight = data.Weight(i);
+            logval *= weight;
+            if (iWeight ==2) {
+               logval *= weight; // use square of weights in likelihood
+               if (extended) {
+                  // needed sum of weights and sum of weight square if likelkihood is extended
+                  result[1] += weight;
+                  result[2] += weight*weight;
+               }
             }
          }
+         loglChunk += logval;
       }
-      logl += logval;
-   }
+      result[0] += loglChunk;
+   };
+   // evaluate all the sets on the chunk of points [begin, end), which stays in the cache
+   auto evalChunk = [&](unsigned int begin, unsigned int end, double * result) {
+      for (unsigned int ks = 0; ks < nset; ++ks) evalSet(begin, end, p + ks * npar, result + ks * 3);
+   };
+   std::vector<double> sums(3 * nset);
+   SumChunks(n, 3 * nset, UseParallel(func, data), evalChunk, &sums[0]);
+
+   for (unsigned int ks = 0; ks < nset; ++ks) {
+      double logl = sums[3 * ks];
+      // needed to compue effective global weight in case of extended likelihood
+      double sumW = sums[3 * ks + 1];
+      double sumW2 = sums[3 * ks + 2];
+
+      if (extended) {
+         // add Poisson extended term
+         double extendedTerm = 0; // extended term in likelihood
+         double nuTot = 0;
+         // nuTot is integral of function in the range
+         // if function has been normalized integral has been already computed
+         if (!normalizeFunc) {
+            IntegralEvaluator<> igEval( func, p + ks * npar, true);
+            std::vector<double> xmin(data.NDim());
+            std::vector<double> xmax(data.NDim());
+            data.Range().GetRange(&xmin[0],&xmax[0]);
+            nuTot = igEval.Integral( &xmin[0], &xmax[0]);
+            // force to be last parameter value
+            //nutot = p[func.NDim()-1];
+            if (iWeight != 2)
+               extendedTerm = - nuTot;  // no need to add in this case n log(nu) since is already computed before
+            else {
+               // case use weight square in likelihood : compute total effective weight = sw2/sw
+               // ignore for the moment case when sumW is zero
+               extendedTerm = - (sumW2 / sumW) * nuTot;
+            }
 
-   if (extended) {
-      // add Poisson extended term
-      double extendedTerm = 0; // extended term in likelihood
-      double nuTot = 0;
-      // nuTot is integral of function in the range
-      // if function has been normalized integral has been already computed
-      if (!normalizeFunc) {
-         IntegralEvaluator<> igEval( func, p, true);
-         std::vector<double> xmin(data.NDim());
-         std::vector<double> xmax(data.NDim());
-         data.Range().GetRange(&xmin[0],&xmax[0]);
-         nuTot = igEval.Integral( &xmin[0], &xmax[0]);
-         // force to be last parameter value
-         //nutot = p[func.NDim()-1];
-         if (iWeight != 2)
-            extendedTerm = - nuTot;  // no need to add in this case n log(nu) since is already computed before
+         }
          else {
-            // case use weight square in likelihood : compute total effective weight = sw2/sw
-            // ignore for the moment case when sumW is zero
-            extendedTerm = - (sumW2 / sumW) * nuTot;
+            nuTot = norm;
+            extendedTerm = - nuTot + double(n) *  ROOT::Math::Util::EvalLog( nuTot);
+            // in case of weights need to use here sum of weights (to be done)
          }
-
-      }
-      else {
-         nuTot = norm;
-         extendedTerm = - nuTot + double(n) *  ROOT::Math::Util::EvalLog( nuTot);
-         // in case of weights need to use here sum of weights (to be done)
-      }
-      logl += extendedTerm;
+         logl += extendedTerm;
 
 #ifdef DEBUG
-      // for (unsigned int ipar = 0; ipar < func.NPar(); ++ipar)
-      //    std::cout << p[ipar] << "\t";
-      // std::cout << std::endl;
-      std::cout << "fit is extended n = " << n << " nutot " << nuTot << " extended LL term = " <<  extendedTerm << " logl = " << logl
-                << std::endl;
+         // for (unsigned int ipar = 0; ipar < func.NPar(); ++ipar)
+         //    std::cout << p[ipar] << "\t";
+         // std::cout << std::endl;
+         std::cout << "fit is extended n = " << n << " nutot " << nuTot << " extended LL term = " <<  extendedTerm << " logl = " << logl
+                   << std::endl;
 #endif
+      }
+      nlogl[ks] = -logl;
    }
 
    // reset the number of fitting data points
@@ -1009,10 +1217,8 @@ double FitUtil::EvaluateLogL(const IModelFunction & func, const UnBinData & data
 
 //    }
 #ifdef DEBUG
-   std::cout << "Logl = " << logl << " np = " << nPoints << std::endl;
+   std::cout << "Logl = " << -nlogl[0] << " np = " << nPoints << std::endl;
 #endif
-
-   return -logl;
 }
 
 void FitUtil::EvaluateLogLGradient(const IModelFunction & f, const UnBinData & data, const double * p, double * grad, unsigned int & ) {
@@ -1026,30 +1232,35 @@ void FitUtil::EvaluateLogLGradient(const IModelFunction & f, const UnBinData & d
    //int nRejected = 0;
 
    unsigned int npar = func.NPar();
-   std::vector<double> gradFunc( npar );
    std::vector<double> g( npar);
 
-   for (unsigned int i = 0; i < n; ++ i) {
-      const double * x = data.Coords(i);
-      double fval = func ( x , p);
-      func.ParameterGradient( x, p, &gradFunc[0] );
-      for (unsigned int kpar = 0; kpar < npar; ++ kpar) {
-         if (fval > 0)
-            g[kpar] -= 1./fval * gradFunc[ kpar ];
-         else if (gradFunc [ kpar] != 0) {
-            const double kdmax1 = std::sqrt( std::numeric_limits<double>::max() );
-            const double kdmax2 = std::numeric_limits<double>::max() / (4*n);
-            double gg = kdmax1 * gradFunc[ kpar ];
-            if ( gg > 0) gg = std::min( gg, kdmax2);
-            else gg = std::max(gg, - kdmax2);
-            g[kpar] -= gg;
+   // add the gradient contributions of the points [begin, end) to result
+   auto evalChunk = [&](unsigned int begin, unsigned int end, double * result) {
+      std::vector<double> gradFunc( npar );
+      for (unsigned int i = begin; i < end; ++ i) {
+         const double * x = data.Coords(i);
+         double fval = func ( x , p);
+         func.ParameterGradient( x, p, &gradFunc[0] );
+         for (unsigned int kpar = 0; kpar < npar; ++ kpar) {
+            if (fval > 0)
+               result[kpar] -= 1./fval * gradFunc[ kpar ];
+            else if (gradFunc [ kpar] != 0) {
+               const double kdmax1 = std::sqrt( std::numeric_limits<double>::max() );
+               const double kdmax2 = std::numeric_limits<double>::max() / (4*n);
+               double gg = kdmax1 * gradFunc[ kpar ];
+               if ( gg > 0) gg = std::min( gg, kdmax2);
+               else gg = std::max(gg, - kdmax2);
+               result[kpar] -= gg;
+            }
+            // if func derivative is zero term is also zero so do not add in g[kpar]
          }
-         // if func derivative is zero term is also zero so do not add in g[kpar]
       }
+   };
+   SumChunks(n, npar, UseParallel(func, data), evalChunk, &g[0]);
 
-    // copy result
+   // copy result
    std::copy(g.begin(), g.end(), grad);
-   }
+
 }
 //_________________________________________________________________________________________________
 // for binned log likelihood functions
@@ -1162,7 +1373,15 @@ double FitUtil::EvaluatePoissonBinPdf(const IModelFunction & func, const BinData
 
 double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData & data,
                                     const double * p, int iWeight, bool extended,  unsigned int &   nPoints ) {
-   // evaluate the Poisson Log Likelihood
+   // evaluate the Poisson Log Likelihood at the parameters p
+   double nloglike = 0;
+   EvaluatePoissonLogLBatch(func, data, 1, p, iWeight, extended, &nloglike, nPoints);
+   return nloglike;
+}
+
+void FitUtil::EvaluatePoissonLogLBatch(const IModelFunction & func, const BinData & data, unsigned int nset,
+                                       const double * p, int iWeight, bool extended, double * nloglike, unsigned int & nPoints ) {
+   // evaluate the Poisson Log Likelihood for nset sets of parameters stored one after the other in p.
    // for binned likelihood fits
    // this is Sum ( f(x_i)  -  y_i * log( f (x_i) ) )
    // add as well constant term for saturated model to make it like a Chi2/2
@@ -1185,7 +1404,8 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData &
    (const_cast<IModelFunction &>(func)).SetParameters(p);
 #endif
    
-   double nloglike = 0;  // negative loglikelihood 
+   unsigned int npar = func.NPar();
+   std::fill(nloglike, nloglike + nset, 0.);  // negative loglikelihood
    nPoints = 0;  // npoints
 
 
@@ -1194,13 +1414,18 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData &
    bool useBinIntegral = fitOpt.fIntegral && data.HasBinEdges();
    bool useBinVolume = (fitOpt.fBinVolume && data.HasBinEdges());
    bool useW2 = (iWeight == 2);
+
+   // the bin integrals use the parameters set in the function: evaluate the sets one by one
+   if (nset > 1 && useBinIntegral) {
+      for (unsigned int ks = 0; ks < nset; ++ks)
+         EvaluatePoissonLogLBatch(func, data, 1, p + ks * npar, iWeight, extended, nloglike + ks, nPoints);
+      return;
+   }
    
    // normalize if needed by a reference volume value
    double wrefVolume = 1.0;
-   std::vector<double> xc;
    if (useBinVolume) {
       if (fitOpt.fNormBinVolume) wrefVolume /= data.RefVolume();
-      xc.resize(data.NDim() );
    }
 
 #ifdef DEBUG
@@ -1210,112 +1435,134 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData &
              << useBinVolume << " useW2 " << useW2 << " wrefVolume = " << wrefVolume << std::endl;
 #endif
 
-#ifdef USE_PARAMCACHE
-   IntegralEvaluator<> igEval( func, 0, useBinIntegral); 
-#else
-   IntegralEvaluator<> igEval( func, p, useBinIntegral); 
-#endif
    // double nuTot = 0; // total number of expected events (needed for non-extended fits)
    // double wTot = 0; // sum of all weights
    // double w2Tot = 0; // sum of weight squared  (these are needed for useW2)
 
 
-   for (unsigned int i = 0; i < n; ++ i) {
-      const double * x1 = data.Coords(i);
-      double y = data.Value(i);
-
-      double fval = 0;
-      double binVolume = 1.0;
-
-      if (useBinVolume) {
-         unsigned int ndim = data.NDim();
-         const double * x2 = data.BinUpEdge(i);
-         for (unsigned int j = 0; j < ndim; ++j) {
-            binVolume *= std::abs( x2[j]-x1[j] );
-            xc[j] = 0.5*(x2[j]+ x1[j]);
+   // add the log likelihood of the points [begin, end) for the parameters pk to result[0]
+   // and the number of non empty bins to result[1]
+   auto evalSet = [&](unsigned int begin, unsigned int end, const double * pk, double * result) {
+#ifdef USE_PARAMCACHE
+      IntegralEvaluator<> igEval( func, 0, useBinIntegral);
+#else
+      IntegralEvaluator<> igEval( func, pk, useBinIntegral);
+#endif
+      // evaluate the function on blocks of points when neither the bin integral nor the bin volume is needed
+      VecEvaluator<BinData> vecEval( func, data, pk);
+      std::vector<double> xc;
+      if (useBinVolume) xc.resize(data.NDim() );
+      double nloglikeChunk = 0;
+      for (unsigned int i = begin; i < end; ++ i) {
+         const double * x1 = data.Coords(i);
+         double y = data.Value(i);
+
+         double fval = 0;
+         double binVolume = 1.0;
+
+         if (useBinVolume) {
+            unsigned int ndim = data.NDim();
+            const double * x2 = data.BinUpEdge(i);
+            for (unsigned int j = 0; j < ndim; ++j) {
+               binVolume *= std::abs( x2[j]-x1[j] );
+               xc[j] = 0.5*(x2[j]+ x1[j]);
+            }
+            // normalize the bin volume using a reference value
+            binVolume *= wrefVolume;
          }
-         // normalize the bin volume using a reference value
-         binVolume *= wrefVolume;
-      }
 
-      const double * x = (useBinVolume) ? &xc.front() : x1;
+         const double * x = (useBinVolume) ? &xc.front() : x1;
 
-      if (!useBinIntegral) {
+         if (!useBinIntegral) {
+            if (!useBinVolume)
+               fval = vecEval( i );
+            else
 #ifdef USE_PARAMCACHE
-         fval = func ( x );
+               fval = func ( x );
 #else
-         fval = func ( x, p );
+               fval = func ( x, pk );
 #endif
-      }
-      else {
-         // calculate integral (normalized by bin volume)
-         // need to set function and parameters here in case loop is parallelized
-         fval = igEval( x1, data.BinUpEdge(i)) ;
-      }
-      if (useBinVolume) fval *= binVolume;
+         }
+         else {
+            // calculate integral (normalized by bin volume)
+            // need to set function and parameters here in case loop is parallelized
+            fval = igEval( x1, data.BinUpEdge(i)) ;
+         }
+         if (useBinVolume) fval *= binVolume;
 
 
 
 #ifdef DEBUG
-      int NSAMPLE = 100;
-      if (i%NSAMPLE == 0) {
-         std::cout << "evt " << i << " x1 = [ ";
-         for (unsigned int j=0; j < func.NDim(); ++j) std::cout << x[j] << " , ";
-         std::cout << "]  ";
-         if (fitOpt.fIntegral) {
-            std::cout << "x2 = [ ";
-            for (unsigned int j=0; j < func.NDim(); ++j) std::cout << data.BinUpEdge(i)[j] << " , ";
-            std::cout << "] ";
+         int NSAMPLE = 100;
+         if (i%NSAMPLE == 0) {
+            std::cout << "evt " << i << " x1 = [ ";
+            for (unsigned int j=0; j < func.NDim(); ++j) std::cout << x[j] << " , ";
+            std::cout << "]  ";
+            if (fitOpt.fIntegral) {
+               std::cout << "x2 = [ ";
+               for (unsigned int j=0; j < func.NDim(); ++j) std::cout << data.BinUpEdge(i)[j] << " , ";
+               std::cout << "] ";
+            }
+            std::cout << "  y = " << y << " fval = " << fval << std::endl;
          }
-         std::cout << "  y = " << y << " fval = " << fval << std::endl;
-      }
 #endif
 
 
-      // EvalLog protects against 0 values of fval but don't want to add in the -log sum
-      // negative values of fval
-      fval = std::max(fval, 0.0);
-
-
-      double tmp = 0;
-      if (useW2) {
-         // apply weight correction . Effective weight is error^2/ y
-         // and expected events in bins is fval/weight
-         // can apply correction only when y is not zero otherwise weight is undefined
-         // (in case of weighted likelihood I don't care about the constant term due to
-         // the saturated model)
-         if (y != 0) {
-            double error = data.Error(i);
-            double weight = (error*error)/y;  // this is the bin effective weight
-            if (extended) {
-               tmp = fval * weight;
-               // wTot  += weight;
-               // w2Tot += weight*weight;
+         // EvalLog protects against 0 values of fval but don't want to add in the -log sum
+         // negative values of fval
+         fval = std::max(fval, 0.0);
+
+
+         double tmp = 0;
+         if (useW2) {
+            // apply weight correction . Effective weight is error^2/ y
+            // and expected events in bins is fval/weight
+            // can apply correction only when y is not zero otherwise weight is undefined
+            // (in case of weighted likelihood I don't care about the constant term due to
+            // the saturated model)
+            if (y != 0) {
+               double error = data.Error(i);
+               double weight = (error*error)/y;  // this is the bin effective weight
+               if (extended) {
+                  tmp = fval * weight;
+                  // wTot  += weight;
+                  // w2Tot += weight*weight;
+               }
+               tmp -= weight * y * ROOT::Math::Util::EvalLog( fval);
             }
-            tmp -= weight * y * ROOT::Math::Util::EvalLog( fval);
-         }
 
-         //  need to compute total weight and weight-square
-         // if (extended ) {
-         //    nuTot += fval;
-         // }
+            //  need to compute total weight and weight-square
+            // if (extended ) {
+            //    nuTot += fval;
+            // }
 
-      }
-      else {
-         // standard case no weights or iWeight=1
-         // this is needed for Poisson likelihood (which are extened and not for multinomial)
-         // the formula below  include constant term due to likelihood of saturated model (f(x) = y)
-         // (same formula as in Baker-Cousins paper, page 439 except a factor of 2
-         if (extended) tmp = fval -y ;
-         if (y >  0) {
-            tmp +=  y *  (ROOT::Math::Util::EvalLog( y) - ROOT::Math::Util::EvalLog(fval));
-            nPoints++;
          }
-      }
+         else {
+            // standard case no weights or iWeight=1
+            // this is needed for Poisson likelihood (which are extened and not for multinomial)
+            // the formula below  include constant term due to likelihood of saturated model (f(x) = y)
+            // (same formula as in Baker-Cousins paper, page 439 except a factor of 2
+            if (extended) tmp = fval -y ;
+            if (y >  0) {
+               tmp +=  y *  (ROOT::Math::Util::EvalLog( y) - ROOT::Math::Util::EvalLog(fval));
+               result[1] += 1;
+            }
+         }
 
 
-      nloglike +=  tmp;
-   }
+         nloglikeChunk +=  tmp;
+      }
+      result[0] += nloglikeChunk;
+   };
+   // evaluate all the sets on the chunk of points [begin, end), which stays in the cache
+   auto evalChunk = [&](unsigned int begin, unsigned int end, double * result) {
+      for (unsigned int ks = 0; ks < nset; ++ks) evalSet(begin, end, p + ks * npar, result + ks * 2);
+   };
+   std::vector<double> sums(2 * nset);
+   SumChunks(n, 2 * nset, UseParallel(func, data), evalChunk, &sums[0]);
+   for (unsigned int ks = 0; ks < nset; ++ks) nloglike[ks] = sums[2 * ks];
+   nPoints = (unsigned int) sums[1];
+
 
    // if (notExtended) {
    //    // not extended : remove from the Likelihood the global Poisson term
@@ -1335,10 +1582,8 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData &
 
 
 #ifdef DEBUG
-   std::cout << "Loglikelihood  = " << nloglike << std::endl;
+   std::cout << "Loglikelihood  = " << nloglike[0] << std::endl;
 #endif
-
-   return nloglike;
 }
 
 void FitUtil::EvaluatePoissonLogLGradient(const IModelFunction & f, const BinData & data, const double * p, double * grad ) {
@@ -1355,73 +1600,77 @@ void FitUtil::EvaluatePoissonLogLGradient(const IModelFunction & f, const BinDat
    bool useBinVolume = (fitOpt.fBinVolume && data.HasBinEdges());
 
    double wrefVolume = 1.0;
-   std::vector<double> xc;
    if (useBinVolume) {
       if (fitOpt.fNormBinVolume) wrefVolume /= data.RefVolume();
-      xc.resize(data.NDim() );
    }
 
-   IntegralEvaluator<> igEval( func, p, useBinIntegral);
-
    unsigned int npar = func.NPar();
-   std::vector<double> gradFunc( npar );
    std::vector<double> g( npar);
 
-   for (unsigned int i = 0; i < n; ++ i) {
-      const double * x1 = data.Coords(i);
-      double y = data.Value(i);
-      double fval = 0;
-      const double * x2 = 0;
-
-      double binVolume = 1.0;
-      if (useBinVolume) {
-         x2 = data.BinUpEdge(i);
-         unsigned int ndim = data.NDim();
-         for (unsigned int j = 0; j < ndim; ++j) {
-            binVolume *= std::abs( x2[j]-x1[j] );
-            xc[j] = 0.5*(x2[j]+ x1[j]);
+   // add the gradient contributions of the points [begin, end) to result
+   auto evalChunk = [&](unsigned int begin, unsigned int end, double * result) {
+      IntegralEvaluator<> igEval( func, p, useBinIntegral);
+      std::vector<double> gradFunc( npar );
+      std::vector<double> xc;
+      if (useBinVolume) xc.resize(data.NDim() );
+      for (unsigned int i = begin; i < end; ++ i) {
+         const double * x1 = data.Coords(i);
+         double y = data.Value(i);
+         double fval = 0;
+         const double * x2 = 0;
+
+         double binVolume = 1.0;
+         if (useBinVolume) {
+            x2 = data.BinUpEdge(i);
+            unsigned int ndim = data.NDim();
+            for (unsigned int j = 0; j < ndim; ++j) {
+               binVolume *= std::abs( x2[j]-x1[j] );
+               xc[j] = 0.5*(x2[j]+ x1[j]);
+            }
+            // normalize the bin volume using a reference value
+            binVolume *= wrefVolume;
          }
-         // normalize the bin volume using a reference value
-         binVolume *= wrefVolume;
-      }
 
-      const double * x = (useBinVolume) ? &xc.front() : x1;
+         const double * x = (useBinVolume) ? &xc.front() : x1;
 
-      if (!useBinIntegral) {
-         fval = func ( x, p );
-         func.ParameterGradient(  x , p, &gradFunc[0] );
-      }
-      else {
-         // calculate integral (normalized by bin volume)
-         // need to set function and parameters here in case loop is parallelized
-         x2 = data.BinUpEdge(i);
-         fval = igEval( x1, x2) ;
-         CalculateGradientIntegral( func, x1, x2, p, &gradFunc[0]);
-      }
-      if (useBinVolume) fval *= binVolume;
-
-      // correct the gradient
-      for (unsigned int kpar = 0; kpar < npar; ++ kpar) {
-
-         // correct gradient for bin volumes
-         if (useBinVolume) gradFunc[kpar] *= binVolume;
-
-         // df/dp * (1.  - y/f )
-         if (fval > 0)
-            g[kpar] += gradFunc[ kpar ] * ( 1. - y/fval );
-         else if (gradFunc [ kpar] != 0) {
-            const double kdmax1 = std::sqrt( std::numeric_limits<double>::max() );
-            const double kdmax2 = std::numeric_limits<double>::max() / (4*n);
-            double gg = kdmax1 * gradFunc[ kpar ];
-            if ( gg > 0) gg = std::min( gg, kdmax2);
-            else gg = std::max(gg, - kdmax2);
-            g[kpar] -= gg;
+         if (!useBinIntegral) {
+            fval = func ( x, p );
+            func.ParameterGradient(  x , p, &gradFunc[0] );
+         }
+         else {
+            // calculate integral (normalized by bin volume)
+            // need to set function and parameters here in case loop is parallelized
+            x2 = data.BinUpEdge(i);
+            fval = igEval( x1, x2) ;
+            CalculateGradientIntegral( func, x1, x2, p, &gradFunc[0]);
+         }
+         if (useBinVolume) fval *= binVolume;
+
+         // correct the gradient
+         for (unsigned int kpar = 0; kpar < npar; ++ kpar) {
+
+            // correct gradient for bin volumes
+            if (useBinVolume) gradFunc[kpar] *= binVolume;
+
+            // df/dp * (1.  - y/f )
+            if (fval > 0)
+               result[kpar] += gradFunc[ kpar ] * ( 1. - y/fval );
+            else if (gradFunc [ kpar] != 0) {
+               const double kdmax1 = std::sqrt( std::numeric_limits<double>::max() );
+               const double kdmax2 = std::numeric_limits<double>::max() / (4*n);
+               double gg = kdmax1 * gradFunc[ kpar ];
+               if ( gg > 0) gg = std::min( gg, kdmax2);
+               else gg = std::max(gg, - kdmax2);
+               result[kpar] -= gg;
+            }
          }
       }
+   };
+   SumChunks(n, npar, UseParallel(func, data), evalChunk, &g[0]);
+
+   // copy result
+   std::copy(g.begin(), g.end(), grad);
 
-      // copy result
-      std::copy(g.begin(), g.end(), grad);
-   }
 }
 
 }
@@ -14,6 +14,7 @@
 #include "Math/IFunction.h"
 #include "Math/IFunctionfwd.h"
 #include <cmath>
+#include <vector>
 
 namespace ROOT {
 namespace Math {
@@ -99,7 +100,9 @@ double GaussIntegrator::DoIntegral(double a, double b, const IGenFunction* funct
                       0.18260341504492359,  0.18945061045506850};
 
    double h, aconst, bb, aa, c1, c2, u, s8, s16, f1, f2;
-   double xx[1];
+   // the 24 abscissae of an interval (c1+u, c1-u for each x) and the function values,
+   // evaluated with a single call to IGenFunction::EvalVec
+   double xx[24], fx[24];
    int i;
 
    if ( fFunction == 0 )
@@ -119,25 +122,25 @@ CASE1:
 CASE2:
    c1 = kHF*(bb+aa);
    c2 = kHF*(bb-aa);
+   for (i=0;i<12;i++) {
+      u         = c2*x[i];
+      xx[2*i]   = c1+u;
+      xx[2*i+1] = c1-u;
+   }
+   function->EvalVec(24, xx, fx);
    s8 = 0;
    for (i=0;i<4;i++) {
-      u     = c2*x[i];
-      xx[0] = c1+u;
-      f1    = (*function)(xx);
+      f1    = fx[2*i];
       if (fgAbsValue) f1 = std::abs(f1);
-      xx[0] = c1-u;
-      f2    = (*function) (xx);
+      f2    = fx[2*i+1];
       if (fgAbsValue) f2 = std::abs(f2);
       s8   += w[i]*(f1 + f2);
    }
    s16 = 0;
    for (i=4;i<12;i++) {
-      u     = c2*x[i];
-      xx[0] = c1+u;
-      f1    = (*function) (xx);
+      f1    = fx[2*i];
       if (fgAbsValue) f1 = std::abs(f1);
-      xx[0] = c1-u;
-      f2    = (*function) (xx);
+      f2    = fx[2*i+1];
       if (fgAbsValue) f2 = std::abs(f2);
       s16  += w[i]*(f1 + f2);
    }
@@ -239,6 +242,23 @@ double IntegrandTransform::DoEval(double x, double boundary, int sign) const {
    return (*fIntegrand)(boundary + sign * mappedX) * std::pow(mappedX + 1., 2);;
 }
 
+void IntegrandTransform::DoEvalVec(unsigned int n, const double * x, double * result) const {
+   // map the points and evaluate the integrand on all of them with a single call
+   const unsigned int nmap = fInfiniteInterval ? 2*n : n;
+   std::vector<double> mapped(nmap), fmapped(nmap);
+   for (unsigned int i = 0; i < n; ++i) {
+      double mappedX = 1. / x[i] - 1.;
+      mapped[i] = fBoundary + fSign * mappedX;
+      if (fInfiniteInterval) mapped[n+i] = 0. - mappedX;
+   }
+   fIntegrand->EvalVec(nmap, &mapped[0], &fmapped[0]);
+   for (unsigned int i = 0; i < n; ++i) {
+      double jacobian = std::pow((1. / x[i] - 1.) + 1., 2);
+      result[i] = fmapped[i] * jacobian;
+      if (fInfiniteInterval) result[i] += fmapped[n+i] * jacobian;
+   }
+}
+
 double IntegrandTransform::operator()(double x) const {
    return DoEval(x);
 }
@@ -16,6 +16,7 @@
 #include <cmath>
 #include <string.h>
 #include <algorithm>
+#include <vector>
 
 namespace ROOT {
 namespace Math {
@@ -69,13 +70,16 @@ double GaussLegendreIntegrator::DoIntegral(double a, double b, const IGenFunctio
    const double a0 = (b + a)/2;
    const double b0 = (b - a)/2;
 
-   double xx[1];
+   // evaluate the function at all the sampling points with a single call
+   std::vector<double> xx(fNum), fx(fNum);
+   for (int i=0; i<fNum; i++)
+      xx[i] = a0 + b0*fX[i];
+   function->EvalVec(fNum, &xx[0], &fx[0]);
 
    double result = 0.0;
    for (int i=0; i<fNum; i++)
    {
-      xx[0] = a0 + b0*fX[i];
-      result += fW[i] * (*function)(xx);
+      result += fW[i] * fx[i];
    }
 
    fLastResult = result*b0;
@@ -15,6 +15,7 @@
 //
 //
 #include "Math/MixMaxEngine.h"
+#include "Math/Error.h"
 
 #include "mixmax.h"
 
@@ -32,9 +33,11 @@ namespace Math {
    }
 
 
-   // void MixMaxEngine::SeedUniqueStream(unsigned int clusterID, unsigned int machineID, unsigned int runID, unsigned int  streamID) { 
-   //    seed_uniquestream(fRngState, clusterID,  machineID,  runID,   streamID);
-   // }
+   void MixMaxEngine::SeedUniqueStream(unsigned int clusterID, unsigned int machineID, unsigned int runID, unsigned int  streamID) {
+      if (clusterID == 0 && machineID == 0 && runID == 0 && streamID == 0)
+         MATH_WARN_MSG("MixMaxEngine::SeedUniqueStream","All IDs are zero: the stream starts from a unit vector and its first numbers are not random");
+      seed_uniquestream(fRngState, clusterID,  machineID,  runID,   streamID);
+   }
 
    void MixMaxEngine::SetSeed(unsigned int seed) { 
       seed_spbox(fRngState, seed);
@@ -0,0 +1,123 @@
+// @(#)root/mathcore:$Id$
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2016 , ROOT MathLib Team                             *
+ *                                                                    *
+ *                                                                    *
+ **********************************************************************/
+
+// implementation file of the Philox4x32-10 engine
+//
+#include "Math/PhiloxEngine.h"
+
+
+namespace {
+
+   // multipliers and Weyl sequence constants of Philox4x32
+   const uint32_t kPhiloxM0 = 0xD2511F53;
+   const uint32_t kPhiloxM1 = 0xCD9E8D57;
+   const uint32_t kPhiloxW0 = 0x9E3779B9;
+   const uint32_t kPhiloxW1 = 0xBB67AE85;
+
+   // number of counters processed together by the batched generation
+   const int kPhiloxBatch = 16;
+
+   // apply the 10 rounds of Philox4x32 to the n counters c0[i],c1[i],c2[i],c3[i].
+   // The loops over the counters have no dependency and are vectorized.
+   inline void PhiloxRounds(int n, uint32_t * c0, uint32_t * c1, uint32_t * c2, uint32_t * c3,
+                            uint32_t k0, uint32_t k1)
+   {
+      for (int r = 0; r < 10; ++r) {
+         for (int i = 0; i < n; ++i) {
+            const uint64_t p0 = (uint64_t) kPhiloxM0 * c0[i];
+            const uint64_t p1 = (uint64_t) kPhiloxM1 * c2[i];
+            const uint32_t x0 = uint32_t(p1 >> 32) ^ c1[i] ^ k0;
+            const uint32_t x2 = uint32_t(p0 >> 32) ^ c3[i] ^ k1;
+            c0[i] = x0;
+            c1[i] = uint32_t(p1);
+            c2[i] = x2;
+            c3[i] = uint32_t(p0);
+         }
+         k0 += kPhiloxW0;
+         k1 += kPhiloxW1;
+      }
+   }
+
+}
+
+
+namespace ROOT {
+namespace Math {
+
+   PhiloxEngine::PhiloxEngine(uint64_t seed, uint64_t stream) :
+      fStream(stream), fCounter(0), fIndex(2)
+   {
+      SetSeed64(seed);
+   }
+
+   void PhiloxEngine::SetSeed64(uint64_t seed) {
+      fKey[0] = uint32_t(seed);
+      fKey[1] = uint32_t(seed >> 32);
+      fCounter = 0;
+      fIndex = 2;
+   }
+
+   void PhiloxEngine::SetStream(uint64_t stream) {
+      fStream = stream;
+      fCounter = 0;
+      fIndex = 2;
+   }
+
+   void PhiloxEngine::Skip(uint64_t n) {
+      const uint64_t pos = Position() + n;
+      fCounter = pos / 2;
+      fIndex = 2;
+      if (pos % 2) {
+         Generate(fCounter++, fBuffer);
+         fIndex = 1;
+      }
+   }
+
+   void PhiloxEngine::Generate(uint64_t counter, uint64_t * out) const {
+      uint32_t c0 = uint32_t(counter), c1 = uint32_t(counter >> 32);
+      uint32_t c2 = uint32_t(fStream), c3 = uint32_t(fStream >> 32);
+      PhiloxRounds(1, &c0, &c1, &c2, &c3, fKey[0], fKey[1]);
+      out[0] = (uint64_t(c1) << 32) | c0;
+      out[1] = (uint64_t(c3) << 32) | c2;
+   }
+
+   void PhiloxEngine::RndmArray(int n, double * array) {
+      // Return an array of n random numbers uniformly distributed in ]0,1],
+      // the same numbers as n calls to Rndm()
+      const double kScale = 1.0/9007199254740992.0; // 2^-53
+      int k = 0;
+      while (k < n && fIndex < 2) array[k++] = Rndm_impl();
+
+      uint32_t c0[kPhiloxBatch], c1[kPhiloxBatch], c2[kPhiloxBatch], c3[kPhiloxBatch];
+      while (n - k >= 2) {
+         int m = (n - k) / 2;
+         if (m > kPhiloxBatch) m = kPhiloxBatch;
+         for (int i = 0; i < m; ++i) {
+            const uint64_t counter = fCounter + i;
+            c0[i] = uint32_t(counter);
+            c1[i] = uint32_t(counter >> 32);
+            c2[i] = uint32_t(fStream);
+            c3[i] = uint32_t(fStream >> 32);
+         }
+         PhiloxRounds(m, c0, c1, c2, c3, fKey[0], fKey[1]);
+         double * out = array + k;
+         for (int i = 0; i < m; ++i) {
+            out[2*i]   = int64_t((((uint64_t(c1[i]) << 32) | c0[i]) >> 11) + 1) * kScale;
+            out[2*i+1] = int64_t((((uint64_t(c3[i]) << 32) | c2[i]) >> 11) + 1) * kScale;
+         }
+         fCounter += m;
+         k += 2*m;
+      }
+
+      if (k < n) array[k] = Rndm_impl();
+   }
+
+
+   } // namespace Math
+} // namespace ROOT
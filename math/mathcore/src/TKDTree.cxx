@@ -16,6 +16,19 @@
 #include <string.h>
 #include <limits>
 
+#include "RConfigure.h"
+#ifdef R__USE_IMT
+#include "TROOT.h"
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task_group.h"
+#endif
+
+namespace {
+   // minimal number of points of a subtree built as a separate task
+   const Int_t kKDTreeTaskMinPoints = 16384;
+}
+
 templateClassImp(TKDTree)
 
 
@@ -29,6 +42,7 @@ Contents:
 3. Using TKDTree
    a. Creating the kd-tree and setting the data
    b. Navigating the kd-tree
+   c. Searching many points
 4. TKDTree implementation - technical details
    a. The order of nodes in internal arrays
    b. Division algorithm
@@ -159,6 +173,19 @@ in the 2 subtrees as close as possible. The following section gives more details
     part of the index array. To find the number of point in the node
     (not only terminal), call TKDTree::GetNpointsNode(Index inode).
 
+#### 3c. Searching many points
+
+    FindNearestNeighbors() and FindInRange() have overloads taking an array of npoints
+    points (the coordinates of each point one after the other), which return the same
+    results as the single point functions called for each of them. When implicit
+    multi-threading is enabled (ROOT::EnableImplicitMT()), these points are processed in
+    parallel, and Build() builds the subtrees with many points as separate tasks.
+    The searches read the coordinates of the points of the terminal nodes from a copy of
+    the data, ordered like the index array (see MakeBucketData()). NOTE, that this copy
+    is allocated by the first search (of a single point or of many points) and is kept
+    until the tree is deleted or built again: it takes as much memory as the data
+    themselves, fNPoints*fNDim values.
+
 ### 4.  TKDtree implementation details - internal information, not needed to use the kd-tree.
 
 ####  4a. Order of nodes in the node information arrays:
@@ -282,6 +309,7 @@ TKDTree<Index, Value>::TKDTree() :
    ,fData(0x0)
    ,fBoundaries(0x0)
    ,fIndPoints(0x0)
+   ,fBucketData(0x0)
    ,fRowT0(0)
    ,fCrossNode(0)
    ,fOffset(0)
@@ -304,6 +332,7 @@ TKDTree<Index, Value>::TKDTree(Index npoints, Index ndim, UInt_t bsize) :
    ,fData(0x0)
    ,fBoundaries(0x0)
    ,fIndPoints(0x0)
+   ,fBucketData(0x0)
    ,fRowT0(0)
    ,fCrossNode(0)
    ,fOffset(0)
@@ -356,6 +385,7 @@ TKDTree<Index, Value>::TKDTree(Index npoints, Index ndim, UInt_t bsize, Value **
    ,fData(data) //Columnwise!!!!!
    ,fBoundaries(0x0)
    ,fIndPoints(0x0)
+   ,fBucketData(0x0)
    ,fRowT0(0)
    ,fCrossNode(0)
    ,fOffset(0)
@@ -377,6 +407,7 @@ TKDTree<Index, Value>::~TKDTree()
    if (fIndPoints) delete [] fIndPoints;
    if (fRange) delete [] fRange;
    if (fBoundaries) delete [] fBoundaries;
+   if (fBucketData) delete [] fBucketData;
    if (fData) {
       if (fDataOwner==1){
          //the tree owns all the data
@@ -405,7 +436,9 @@ TKDTree<Index, Value>::~TKDTree()
 ///
 ///
 /// The tree is divided recursively. See class description, section 4b for the details
-/// of the division alogrithm
+/// of the division alogrithm.
+/// When implicit multi-threading is enabled, the subtrees with many points are built
+/// as separate tasks. The resulting tree does not depend on it.
 
 template <typename  Index, typename Value>
 void TKDTree<Index, Value>::Build()
@@ -442,6 +475,10 @@ void TKDTree<Index, Value>::Build()
    Int_t   filled = ((1<<fRowT0)-over)*fBucketSize;
    fOffset = fNPoints-filled;
 
+   if (fBucketData) {
+      delete [] fBucketData;
+      fBucketData = 0x0;
+   }
    //
    //    printf("Row0      %d\n", fRowT0);
    //    printf("CrossNode %d\n", fCrossNode);
@@ -449,76 +486,56 @@ void TKDTree<Index, Value>::Build()
    //
    //
    //4.
+   Bool_t parallel = kFALSE;
+#ifdef R__USE_IMT
+   parallel = ROOT::IsImplicitMTEnabled() && fNPoints > kKDTreeTaskMinPoints;
+#endif
+   BuildNodes(0, 0, 0, fNPoints, parallel);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Build the subtree of node cnode, in row crow, made of the npoints points starting
+/// at position cpos of fIndPoints.
+/// The subtrees share no node and no part of fIndPoints: if parallel is true, those
+/// with more than kKDTreeTaskMinPoints points are built as separate tasks.
+
+template <typename  Index, typename Value>
+void TKDTree<Index, Value>::BuildNodes(Int_t cnode, Int_t crow, Int_t cpos, Int_t npoints, Bool_t parallel)
+{
+#ifdef R__USE_IMT
+   if (parallel && npoints > kKDTreeTaskMinPoints) {
+      Int_t nleft, nright;
+      if (!DivideNode(cnode, crow, cpos, npoints, nleft, nright)) return;
+      tbb::task_group g;
+      g.run([&]() { BuildNodes(cnode*2+1, crow+1, cpos, nleft, kTRUE); });
+      BuildNodes((cnode*2)+2, crow+1, cpos+nleft, nright, kTRUE);
+      g.wait();
+      return;
+   }
+#else
+   (void) parallel;
+#endif
+
    //    stack for non recursive build - size 128 bytes enough
    Int_t rowStack[128];
    Int_t nodeStack[128];
    Int_t npointStack[128];
    Int_t posStack[128];
    Int_t currentIndex = 0;
-   Int_t iter =0;
-   rowStack[0]    = 0;
-   nodeStack[0]   = 0;
-   npointStack[0] = fNPoints;
-   posStack[0]   = 0;
+   rowStack[0]    = crow;
+   nodeStack[0]   = cnode;
+   npointStack[0] = npoints;
+   posStack[0]    = cpos;
    //
-   Int_t nbucketsall =0;
    while (currentIndex>=0){
-      iter++;
-      //
-      Int_t npoints  = npointStack[currentIndex];
-      if (npoints<=fBucketSize) {
-         //printf("terminal node : index %d iter %d\n", currentIndex, iter);
+      Int_t nleft, nright;
+      crow    = rowStack[currentIndex];
+      cpos    = posStack[currentIndex];
+      cnode   = nodeStack[currentIndex];
+      if (!DivideNode(cnode, crow, cpos, npointStack[currentIndex], nleft, nright)) {
          currentIndex--;
-         nbucketsall++;
          continue; // terminal node
       }
-      Int_t crow     = rowStack[currentIndex];
-      Int_t cpos     = posStack[currentIndex];
-      Int_t cnode    = nodeStack[currentIndex];
-      //printf("currentIndex %d npoints %d node %d\n", currentIndex, npoints, cnode);
-      //
-      // divide points
-      Int_t nbuckets0 = npoints/fBucketSize;           //current number of  buckets
-      if (npoints%fBucketSize) nbuckets0++;            //
-      Int_t restRows = fRowT0-rowStack[currentIndex];  // rest of fully occupied node row
-      if (restRows<0) restRows =0;
-      for (;nbuckets0>(2<<restRows); restRows++) {}
-      Int_t nfull = 1<<restRows;
-      Int_t nrest = nbuckets0-nfull;
-      Int_t nleft =0, nright =0;
-      //
-      if (nrest>(nfull/2)){
-         nleft  = nfull*fBucketSize;
-         nright = npoints-nleft;
-      }else{
-         nright = nfull*fBucketSize/2;
-         nleft  = npoints-nright;
-      }
-
-      //
-      //find the axis with biggest spread
-      Value maxspread=0;
-      Value tempspread, min, max;
-      Index axspread=0;
-      Value *array;
-      for (Int_t idim=0; idim<fNDim; idim++){
-         array = fData[idim];
-         Spread(npoints, array, fIndPoints+cpos, min, max);
-         tempspread = max - min;
-         if (maxspread < tempspread) {
-            maxspread=tempspread;
-            axspread = idim;
-         }
-         if(cnode) continue;
-         //printf("set %d %6.3f %6.3f\n", idim, min, max);
-         fRange[2*idim] = min; fRange[2*idim+1] = max;
-      }
-      array = fData[axspread];
-      KOrdStat(npoints, array, nleft, fIndPoints+cpos);
-      fAxis[cnode]  = axspread;
-      fValue[cnode] = array[fIndPoints[cpos+nleft]];
-      //printf("Set node %d : ax %d val %f\n", cnode, node->fAxis, node->fValue);
-      //
       //
       npointStack[currentIndex] = nleft;
       rowStack[currentIndex]    = crow+1;
@@ -529,14 +546,70 @@ void TKDTree<Index, Value>::Build()
       rowStack[currentIndex]    = crow+1;
       posStack[currentIndex]    = cpos+nleft;
       nodeStack[currentIndex]   = (cnode*2)+2;
-      //
-      if (0){
-         // consistency check
-         Info("Build()", "%s", Form("points %d left %d right %d", npoints, nleft, nright));
-         if (nleft<nright) Warning("Build", "Problem Left-Right");
-         if (nleft<0 || nright<0) Warning("Build()", "Problem Negative number");
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Divide the npoints points of node cnode, starting at position cpos of fIndPoints,
+/// between its two daughters, see class description, section 4b.
+/// Set the axis and the value of the node and the numbers of points of the daughters.
+/// Return kFALSE, without doing anything, if the node is terminal
+
+template <typename  Index, typename Value>
+Bool_t TKDTree<Index, Value>::DivideNode(Int_t cnode, Int_t crow, Int_t cpos, Int_t npoints, Int_t &nleft, Int_t &nright)
+{
+   if (npoints<=fBucketSize) return kFALSE;
+   //
+   // divide points
+   Int_t nbuckets0 = npoints/fBucketSize;           //current number of  buckets
+   if (npoints%fBucketSize) nbuckets0++;            //
+   Int_t restRows = fRowT0-crow;                    // rest of fully occupied node row
+   if (restRows<0) restRows =0;
+   for (;nbuckets0>(2<<restRows); restRows++) {}
+   Int_t nfull = 1<<restRows;
+   Int_t nrest = nbuckets0-nfull;
+   nleft =0;
+   nright =0;
+   //
+   if (nrest>(nfull/2)){
+      nleft  = nfull*fBucketSize;
+      nright = npoints-nleft;
+   }else{
+      nright = nfull*fBucketSize/2;
+      nleft  = npoints-nright;
+   }
+
+   //
+   //find the axis with biggest spread
+   Value maxspread=0;
+   Value tempspread, min, max;
+   Index axspread=0;
+   Value *array;
+   for (Int_t idim=0; idim<fNDim; idim++){
+      array = fData[idim];
+      Spread(npoints, array, fIndPoints+cpos, min, max);
+      tempspread = max - min;
+      if (maxspread < tempspread) {
+         maxspread=tempspread;
+         axspread = idim;
       }
+      if(cnode) continue;
+      //printf("set %d %6.3f %6.3f\n", idim, min, max);
+      fRange[2*idim] = min; fRange[2*idim+1] = max;
+   }
+   array = fData[axspread];
+   KOrdStat(npoints, array, nleft, fIndPoints+cpos);
+   fAxis[cnode]  = axspread;
+   fValue[cnode] = array[fIndPoints[cpos+nleft]];
+   //printf("Set node %d : ax %d val %f\n", cnode, node->fAxis, node->fValue);
+   //
+   if (0){
+      // consistency check
+      Info("Build()", "%s", Form("points %d left %d right %d", npoints, nleft, nright));
+      if (nleft<nright) Warning("Build", "Problem Left-Right");
+      if (nleft<0 || nright<0) Warning("Build()", "Problem Negative number");
    }
+   return kTRUE;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -557,10 +630,50 @@ void TKDTree<Index, Value>::FindNearestNeighbors(const Value *point, const Int_t
       ind[i]=-1;
    }
    MakeBoundariesExact();
+   MakeBucketData();
    UpdateNearestNeighbors(0, point, kNN, ind, dist);
 
 }
 
+////////////////////////////////////////////////////////////////////////////////
+///Find the kNN nearest neighbors of each of the npoints points in the first argument
+///The coordinates of the point #i are points[i*ndim], ..., points[i*ndim+ndim-1]
+///and its neighbors are returned in ind[i*kNN], ... and dist[i*kNN], ...
+///(arrays provided by the user), as FindNearestNeighbors(point, kNN, ind, dist) would do.
+///When implicit multi-threading is enabled the points are processed in parallel.
+
+template <typename  Index, typename Value>
+void TKDTree<Index, Value>::FindNearestNeighbors(Index npoints, const Value *points, const Int_t kNN, Index *ind, Value *dist)
+{
+   if (!ind || !dist) {
+      Error("FindNearestNeighbors", "Working arrays must be allocated by the user!");
+      return;
+   }
+   // the boundaries and the bucket data are made before the threads share the tree
+   MakeBoundariesExact();
+   MakeBucketData();
+
+   auto findRange = [&](Index first, Index last) {
+      for (Index ip=first; ip<last; ip++){
+         Index *indp  = ind + (Long64_t)ip*kNN;
+         Value *distp = dist + (Long64_t)ip*kNN;
+         for (Int_t i=0; i<kNN; i++){
+            distp[i]=std::numeric_limits<Value>::max();
+            indp[i]=-1;
+         }
+         UpdateNearestNeighbors(0, points + (Long64_t)ip*fNDim, kNN, indp, distp);
+      }
+   };
+#ifdef R__USE_IMT
+   if (ROOT::IsImplicitMTEnabled()) {
+      tbb::parallel_for(tbb::blocked_range<Index>(0, npoints),
+                        [&](const tbb::blocked_range<Index> & r) { findRange(r.begin(), r.end()); });
+      return;
+   }
+#endif
+   findRange(0, npoints);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///Update the nearest neighbors values by examining the node inode
 
@@ -579,7 +692,7 @@ void TKDTree<Index, Value>::UpdateNearestNeighbors(Index inode, const Value *poi
       Index f1, l1, f2, l2;
       GetNodePointsIndexes(inode, f1, l1, f2, l2);
       for (Int_t ipoint=f1; ipoint<=l1; ipoint++){
-         Double_t d = Distance(point, fIndPoints[ipoint]);
+         Double_t d = DistanceBucket(point, ipoint);
          if (d<dist[kNN-1]){
             //found a closer point
             Int_t ishift=0;
@@ -631,6 +744,21 @@ Double_t TKDTree<Index, Value>::Distance(const Value *point, Index ind, Int_t ty
 
 }
 
+////////////////////////////////////////////////////////////////////////////////
+///Find the L2 distance between point of the first argument and the point at position ipos
+///of the index array, using the coordinates stored in the buckets (see MakeBucketData)
+
+template <typename Index, typename Value>
+Double_t TKDTree<Index, Value>::DistanceBucket(const Value *point, Index ipos) const
+{
+   const Value *x = fBucketData + (Long64_t)ipos*fNDim;
+   Double_t dist = 0;
+   for (Int_t idim=0; idim<fNDim; idim++){
+      dist+=(point[idim]-x[idim])*(point[idim]-x[idim]);
+   }
+   return TMath::Sqrt(dist);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///Find the minimal and maximal distance from a given point to a given node.
 ///Type argument specifies the metric: type=2 - L2 metric, type=1 - L1 metric
@@ -754,14 +882,46 @@ template <typename  Index, typename Value>
 void TKDTree<Index, Value>::FindInRange(Value * point, Value range, std::vector<Index> &res)
 {
    MakeBoundariesExact();
+   MakeBucketData();
    UpdateRange(0, point, range, res);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+///Find all points in the sphere of a given radius "range" around each of the npoints
+///points in the second argument (point #i at points[i*ndim], ..., points[i*ndim+ndim-1]).
+///The vector res is resized to npoints and res[i] contains the points found for the point #i,
+///as FindInRange(point, range, res[i]) would return them.
+///When implicit multi-threading is enabled the points are processed in parallel.
+
+template <typename  Index, typename Value>
+void TKDTree<Index, Value>::FindInRange(Index npoints, const Value *points, Value range, std::vector<std::vector<Index> > &res)
+{
+   // the boundaries and the bucket data are made before the threads share the tree
+   MakeBoundariesExact();
+   MakeBucketData();
+   res.resize(npoints);
+
+   auto findRange = [&](Index first, Index last) {
+      for (Index ip=first; ip<last; ip++){
+         res[ip].clear();
+         UpdateRange(0, points + (Long64_t)ip*fNDim, range, res[ip]);
+      }
+   };
+#ifdef R__USE_IMT
+   if (ROOT::IsImplicitMTEnabled()) {
+      tbb::parallel_for(tbb::blocked_range<Index>(0, npoints),
+                        [&](const tbb::blocked_range<Index> & r) { findRange(r.begin(), r.end()); });
+      return;
+   }
+#endif
+   findRange(0, npoints);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///Internal recursive function with the implementation of range searches
 
 template <typename  Index, typename Value>
-void TKDTree<Index, Value>::UpdateRange(Index inode, Value* point, Value range, std::vector<Index> &res)
+void TKDTree<Index, Value>::UpdateRange(Index inode, const Value* point, Value range, std::vector<Index> &res)
 {
    Value min, max;
    DistanceToNode(point, inode, min, max);
@@ -791,7 +951,7 @@ void TKDTree<Index, Value>::UpdateRange(Index inode, Value* point, Value range,
       Double_t d;
       GetNodePointsIndexes(inode, f1, l1, f2, l2);
       for (Int_t ipoint=f1; ipoint<=l1; ipoint++){
-         d = Distance(point, fIndPoints[ipoint]);
+         d = DistanceBucket(point, ipoint);
          if (d <= range){
             res.push_back(fIndPoints[ipoint]);
          }
@@ -1169,6 +1329,31 @@ void TKDTree<Index, Value>::MakeBoundariesExact()
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Copy the coordinates of the points in the order of the index array, so that the
+/// points of a terminal node are contiguous in memory:
+/// the coordinate idim of the point fIndPoints[ipos] is fBucketData[ipos*fNDim+idim].
+/// The searches of neighbors and points in range read the terminal nodes from this array.
+/// It is made when needed for the first time, and needs the original data.
+/// It holds a second full copy of the data (fNPoints*fNDim values), which is freed
+/// only when the tree is deleted or built again.
+
+template <typename Index, typename Value>
+void TKDTree<Index, Value>::MakeBucketData()
+{
+   if (fBucketData){
+      //bucket data were already made for this tree
+      return;
+   }
+   fBucketData = new Value[(Long64_t)fNPoints*fNDim];
+   for (Index ipos=0; ipos<fNPoints; ipos++){
+      Value *x = fBucketData + (Long64_t)ipos*fNDim;
+      const Index ind = fIndPoints[ipos];
+      for (Index idim=0; idim<fNDim; idim++)
+         x[idim] = fData[idim][ind];
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// find the smallest node covering the full range - start
@@ -22,8 +22,14 @@
 #include <math.h>
 #include <string.h>
 #include <algorithm>
+#include <atomic>
 #include "Riostream.h"
 #include "TString.h"
+#include "RConfigure.h"
+
+#ifdef R__HAS_VDT
+#include "vdt/vdtMath.h"
+#endif
 
 #include <Math/SpecFuncMathCore.h>
 #include <Math/PdfFuncMathCore.h>
@@ -62,6 +68,112 @@ Double_t TMath::Hypot(Double_t x, Double_t y)
    return hypot(x, y);
 }
 
+std::atomic<Bool_t> TMath::Internal::gFastMath(kFALSE);
+
+////////////////////////////////////////////////////////////////////////////////
+/// Enable (or disable) the evaluation of the transcendental functions with
+/// the vdt library (math/vdt) in the places which support it.
+/// The inline vdt functions are several times faster than the libm ones and
+/// are vectorized by the compiler in loops, but they are accurate to a few
+/// units in the last place only, do not set errno and, for sin and cos,
+/// lose accuracy for arguments much larger than 2*pi.
+/// Once enabled, vdt is used by:
+///  - the array functions TMath::Exp(n,x,y), Log, Sin, Cos and ATan2 ;
+///  - TFormula::EvalParVec, hence the fits of TF1 (e.g. the built-in gaus
+///    and expo functions), for the formulas evaluated after the call ;
+///  - the mathcore integrators (e.g. GaussIntegrator and
+///    AdaptiveIntegratorMultiDim) applied to a TF1 wrapped in a WrappedTF1 or
+///    WrappedMultiTF1, which evaluate the integrand with EvalParVec: the
+///    integrals can change in the last digits and, since the adaptive
+///    algorithms compare error estimates with the tolerance, occasionally use
+///    a different number of subdivisions. TF1::Integral and
+///    TF1::IntegralMultiple evaluate the function point by point and are not
+///    affected ;
+///  - RooGaussian and RooExponential.
+/// Fast math is disabled by default, and cannot be enabled if ROOT is built
+/// without vdt.
+
+void TMath::EnableFastMath(Bool_t enable)
+{
+#ifdef R__HAS_VDT
+   Internal::gFastMath = enable;
+#else
+   if (enable)
+      ::Warning("TMath::EnableFastMath", "ROOT is built without vdt, the libm functions are used");
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compute y[i] = exp(x[i]) for i = 0,...,n-1, with vdt if fast math is
+/// enabled (see TMath::EnableFastMath). x and y may be the same array.
+
+void TMath::Exp(Long64_t n, const Double_t *x, Double_t *y)
+{
+#ifdef R__HAS_VDT
+   if (IsFastMathEnabled()) {
+      for (Long64_t i = 0; i < n; ++i) y[i] = vdt::fast_exp(x[i]);
+      return;
+   }
+#endif
+   for (Long64_t i = 0; i < n; ++i) y[i] = exp(x[i]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compute y[i] = log(x[i]) for i = 0,...,n-1, see TMath::Exp(n,x,y).
+
+void TMath::Log(Long64_t n, const Double_t *x, Double_t *y)
+{
+#ifdef R__HAS_VDT
+   if (IsFastMathEnabled()) {
+      for (Long64_t i = 0; i < n; ++i) y[i] = vdt::fast_log(x[i]);
+      return;
+   }
+#endif
+   for (Long64_t i = 0; i < n; ++i) y[i] = log(x[i]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compute y[i] = sin(x[i]) for i = 0,...,n-1, see TMath::Exp(n,x,y).
+
+void TMath::Sin(Long64_t n, const Double_t *x, Double_t *y)
+{
+#ifdef R__HAS_VDT
+   if (IsFastMathEnabled()) {
+      for (Long64_t i = 0; i < n; ++i) y[i] = vdt::fast_sin(x[i]);
+      return;
+   }
+#endif
+   for (Long64_t i = 0; i < n; ++i) y[i] = sin(x[i]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compute y[i] = cos(x[i]) for i = 0,...,n-1, see TMath::Exp(n,x,y).
+
+void TMath::Cos(Long64_t n, const Double_t *x, Double_t *y)
+{
+#ifdef R__HAS_VDT
+   if (IsFastMathEnabled()) {
+      for (Long64_t i = 0; i < n; ++i) y[i] = vdt::fast_cos(x[i]);
+      return;
+   }
+#endif
+   for (Long64_t i = 0; i < n; ++i) y[i] = cos(x[i]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compute r[i] = atan2(y[i], x[i]) for i = 0,...,n-1, see TMath::Exp(n,x,y).
+
+void TMath::ATan2(Long64_t n, const Double_t *y, const Double_t *x, Double_t *r)
+{
+#ifdef R__HAS_VDT
+   if (IsFastMathEnabled()) {
+      for (Long64_t i = 0; i < n; ++i) r[i] = vdt::fast_atan2(y[i], x[i]);
+      return;
+   }
+#endif
+   for (Long64_t i = 0; i < n; ++i) r[i] = atan2(y[i], x[i]);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 Double_t TMath::ASinH(Double_t x)
@@ -26,6 +26,8 @@ UnBinData::UnBinData(unsigned int maxpoints, unsigned int dim, bool isWeighted
    fDim(dim),
    fPointSize( (isWeighted) ? dim +1 : dim),
    fNPoints(0),
+   fColumnLayout(false),
+   fColumnSize(0),
    fDataVector(0),
    fDataWrapper(0)
 {
@@ -42,6 +44,8 @@ UnBinData::UnBinData (const DataRange & range,  unsigned int maxpoints , unsigne
    fDim(dim),
    fPointSize( (isWeighted) ? dim +1 : dim),
    fNPoints(0),
+   fColumnLayout(false),
+   fColumnSize(0),
    fDataVector(0),
    fDataWrapper(0)
 {
@@ -58,6 +62,8 @@ UnBinData::UnBinData (const DataOptions & opt, const DataRange & range,  unsigne
    fDim(dim),
    fPointSize( (isWeighted) ? dim +1 : dim),
    fNPoints(0),
+   fColumnLayout(false),
+   fColumnSize(0),
    fDataVector(0),
    fDataWrapper(0)
 {
@@ -74,6 +80,8 @@ UnBinData::UnBinData(unsigned int n, const double * dataX ) :
    fDim(1),
    fPointSize(1),
    fNPoints(n),
+   fColumnLayout(false),
+   fColumnSize(0),
    fDataVector(0)
 {
    // constructor for 1D external data
@@ -85,6 +93,8 @@ UnBinData::UnBinData(unsigned int n, const double * dataX, const double * dataY,
    fDim( (isWeighted) ? 1 : 2),
    fPointSize(2),
    fNPoints(n),
+   fColumnLayout(false),
+   fColumnSize(0),
    fDataVector(0),
    fDataWrapper(0)
 {
@@ -97,6 +107,8 @@ UnBinData::UnBinData(unsigned int n, const double * dataX, const double * dataY,
    fDim( (isWeighted) ? 2 : 3),
    fPointSize(3),
    fNPoints(n),
+   fColumnLayout(false),
+   fColumnSize(0),
    fDataVector(0)
 {
    //   constructor for 3D external data
@@ -108,6 +120,8 @@ UnBinData::UnBinData(unsigned int n, const double * dataX, const DataRange & ran
    fDim(1),
    fPointSize(1),
    fNPoints(0),
+   fColumnLayout(false),
+   fColumnSize(0),
    fDataVector(0),
    fDataWrapper(0)
 {
@@ -131,6 +145,8 @@ UnBinData::UnBinData(unsigned int n, const double * dataX, const double * dataY,
    fDim( (isWeighted) ? 1 : 2 ),
    fPointSize(2),
    fNPoints(0),
+   fColumnLayout(false),
+   fColumnSize(0),
    fDataVector(0),
    fDataWrapper(0)
 {
@@ -156,6 +172,8 @@ UnBinData::UnBinData(unsigned int n, const double * dataX, const double * dataY,
    fDim( (isWeighted) ? 2 : 3 ),
    fPointSize(3),
    fNPoints(0),
+   fColumnLayout(false),
+   fColumnSize(0),
    fDataVector(0),
    fDataWrapper(0)
 {
@@ -177,6 +195,9 @@ UnBinData::UnBinData(unsigned int n, const double * dataX, const double * dataY,
 
 void UnBinData::Initialize(unsigned int maxpoints, unsigned int dim, bool isWeighted ) {
    //   preallocate a data set given size and dimension
+   // the columns are re-arranged after having added the new points
+   bool columnLayout = fColumnLayout;
+   SetColumnLayout(false);
    unsigned int pointSize = (isWeighted) ? dim+1 : dim;
    if ( (dim != fDim || pointSize != fPointSize) && fDataVector) {
 //       MATH_INFO_MSGVAL("BinData::Initialize"," Reset amd re-initialize with a new fit point size of ",
@@ -189,12 +210,14 @@ void UnBinData::Initialize(unsigned int maxpoints, unsigned int dim, bool isWeig
    unsigned int n = fPointSize*maxpoints;
    if ( n > MaxSize() ) {
       MATH_ERROR_MSGVAL("UnBinData::Initialize","Invalid data size", n );
+      SetColumnLayout(columnLayout);
       return;
    }
    if (fDataVector)
       (fDataVector->Data()).resize( fDataVector->Size() + n );
    else
       fDataVector = new DataVector( n);
+   SetColumnLayout(columnLayout);
 }
 
 void UnBinData::Resize(unsigned int npoints) {
@@ -208,7 +231,10 @@ void UnBinData::Resize(unsigned int npoints) {
       int nextraPoints = npoints -  fDataVector->Size()/fPointSize;
       if  (nextraPoints < 0) {
          // delete extra points
+         bool columnLayout = fColumnLayout;
+         SetColumnLayout(false);
          (fDataVector->Data()).resize( npoints * fPointSize);
+         SetColumnLayout(columnLayout);
       }
       else if (nextraPoints > 0) {
          // add extra points
@@ -221,6 +247,30 @@ void UnBinData::Resize(unsigned int npoints) {
       fDataVector = new DataVector( npoints*fPointSize);
 }
 
+void UnBinData::SetColumnLayout(bool on) {
+   // re-arrange the copied data in columns or point by point
+   if (on == fColumnLayout) return;
+   if (fDataWrapper) {
+      MATH_WARN_MSG("UnBinData::SetColumnLayout","Data wrapping external arrays cannot be stored in columns");
+      return;
+   }
+   fColumnLayout = on;
+   fColumnSize = (fDataVector && fPointSize > 0) ? fDataVector->Size()/fPointSize : 0;
+   if (fColumnSize == 0) return;
+
+   std::vector<double> & v = fDataVector->Data();
+   std::vector<double> tmp(v.size());
+   for (unsigned int i = 0; i < fColumnSize; ++i) {
+      for (unsigned int k = 0; k < fPointSize; ++k) {
+         if (on)
+            tmp[ ColumnIndex(i,k) ] = v[ i*fPointSize + k ];
+         else
+            tmp[ i*fPointSize + k ] = v[ ColumnIndex(i,k) ];
+      }
+   }
+   v.swap(tmp);
+}
+
 
 
    } // end namespace Fit
@@ -219,6 +219,20 @@ int testHisto1DFit() {
    }
    iret |= compareResult(fitter.Result().Chi2(), chi2ref,"1D histogram chi2 fit (2)",0.001);
 
+   // redo chi2fit with the data stored in columns
+   std::cout << "\n\nRedo Chi2 Hist Fit with data stored in columns" << std::endl;
+   ROOT::Fit::BinData dc(d);
+   dc.SetColumnLayout();
+   f.SetParameters(p);
+   ret = fitter.Fit(dc, f);
+   if (ret)
+      fitter.Result().Print(std::cout);
+   else {
+      std::cout << "Chi2 Fit Failed " << std::endl;
+      return -1;
+   }
+   iret |= compareResult(fitter.Result().Chi2(), chi2ref,"1D histogram chi2 fit (columns)",0.001);
+
 
 
    // test grapherrors fit
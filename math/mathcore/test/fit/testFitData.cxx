@@ -0,0 +1,237 @@
+// test of the storage of the fit data: the access methods of BinData and UnBinData must return
+// the same values when the data are stored point by point and in columns (SetColumnLayout),
+// for all the error types of the binned data and for weighted and unweighted unbinned data
+
+#include "TRandom3.h"
+
+#include "Fit/BinData.h"
+#include "Fit/UnBinData.h"
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cmath>
+
+using ROOT::Fit::BinData;
+using ROOT::Fit::UnBinData;
+
+int compareResult(double v1, double v2, const std::string & s) {
+   // the stored values must be returned exactly
+   if (v1 == v2) return 0;
+   std::cerr << s << " Failed comparison  \t value = " << v1 << "   it should be = " << v2 << std::endl;
+   return -1;
+}
+
+// reference values of the points, with the coordinate errors and the low and high value errors
+struct PointValues {
+   std::vector<double> fX, fEx;
+   double fValue, fEl, fEh;
+};
+
+std::vector<PointValues> generatePoints(unsigned int n, unsigned int dim) {
+   TRandom3 rndm(111);
+   std::vector<PointValues> points(n);
+   for (unsigned int i = 0; i < n; ++i) {
+      for (unsigned int k = 0; k < dim; ++k) {
+         points[i].fX.push_back(rndm.Uniform(-5, 5));
+         points[i].fEx.push_back(rndm.Uniform(0.1, 1));
+      }
+      points[i].fValue = rndm.Uniform(0, 100);
+      points[i].fEl = rndm.Uniform(1, 10);
+      points[i].fEh = rndm.Uniform(1, 10);
+   }
+   return points;
+}
+
+void fillBinData(BinData & data, const std::vector<PointValues> & points) {
+   for (unsigned int i = 0; i < points.size(); ++i) {
+      const PointValues & p = points[i];
+      switch (data.GetErrorType()) {
+         case BinData::kNoError:    data.Add(&p.fX[0], p.fValue); break;
+         case BinData::kValueError: data.Add(&p.fX[0], p.fValue, p.fEh); break;
+         case BinData::kCoordError: data.Add(&p.fX[0], p.fValue, &p.fEx[0], p.fEh); break;
+         case BinData::kAsymError:  data.Add(&p.fX[0], p.fValue, &p.fEx[0], p.fEl, p.fEh); break;
+      }
+   }
+}
+
+int checkBinData(const BinData & data, const std::vector<PointValues> & points, const std::string & name) {
+   int iret = 0;
+   const unsigned int dim = data.NDim();
+   const BinData::ErrorType type = data.GetErrorType();
+   if (data.Size() != points.size()) {
+      std::cerr << name << " Failed: " << data.Size() << " points instead of " << points.size() << std::endl;
+      return -1;
+   }
+   const unsigned int stride = data.IsColumnLayout() ? dim : data.PointSize();
+   iret |= compareResult(data.CoordStride(), stride, name + " coordinate stride");
+   // the value and inverse error columns are available only for the column layout with value errors
+   const double * valueColumn = data.ValueColumn();
+   const double * invErrorColumn = data.InvErrorColumn();
+   if ((valueColumn != 0) != data.IsColumnLayout() ||
+       (invErrorColumn != 0) != (data.IsColumnLayout() && type == BinData::kValueError)) {
+      std::cerr << name << " Failed: wrong value or error columns" << std::endl;
+      iret = -1;
+      valueColumn = 0;
+      invErrorColumn = 0;
+   }
+
+   for (unsigned int i = 0; i < points.size(); ++i) {
+      const PointValues & p = points[i];
+      const std::string s = name + " point " + std::to_string(i);
+      const double * x = data.Coords(i);
+      for (unsigned int k = 0; k < dim; ++k) {
+         iret |= compareResult(x[k], p.fX[k], s + " coordinate");
+         iret |= compareResult(data.Coords(0)[i * data.CoordStride() + k], p.fX[k], s + " strided coordinate");
+      }
+      iret |= compareResult(data.Value(i), p.fValue, s + " value");
+      if (valueColumn) iret |= compareResult(valueColumn[i], p.fValue, s + " value column");
+
+      double value = 0;
+      iret |= compareResult(data.GetPoint(i, value)[0], p.fX[0], s + " GetPoint coordinate");
+      iret |= compareResult(value, p.fValue, s + " GetPoint value");
+
+      switch (type) {
+         case BinData::kNoError:
+            iret |= compareResult(data.Error(i), 1., s + " error");
+            break;
+         case BinData::kValueError:
+            iret |= compareResult(data.InvError(i), 1. / p.fEh, s + " inverse error");
+            iret |= compareResult(data.Error(i), 1. / (1. / p.fEh), s + " error");
+            if (invErrorColumn) iret |= compareResult(invErrorColumn[i], 1. / p.fEh, s + " inverse error column");
+            break;
+         case BinData::kCoordError: {
+            iret |= compareResult(data.Error(i), p.fEh, s + " error");
+            double ey = 0;
+            const double * ex = data.GetPointError(i, ey);
+            iret |= compareResult(ey, p.fEh, s + " GetPointError value error");
+            for (unsigned int k = 0; k < dim; ++k) {
+               iret |= compareResult(ex[k], p.fEx[k], s + " GetPointError coordinate error");
+               iret |= compareResult(data.CoordErrors(i)[k], p.fEx[k], s + " coordinate error");
+            }
+            break;
+         }
+         case BinData::kAsymError: {
+            iret |= compareResult(data.Error(i), 0.5 * (p.fEl + p.fEh), s + " error");
+            double el = 0, eh = 0;
+            const double * ex = data.GetPointError(i, el, eh);
+            iret |= compareResult(el, p.fEl, s + " GetPointError low error");
+            iret |= compareResult(eh, p.fEh, s + " GetPointError high error");
+            for (unsigned int k = 0; k < dim; ++k) {
+               iret |= compareResult(ex[k], p.fEx[k], s + " GetPointError coordinate error");
+               iret |= compareResult(data.CoordErrors(i)[k], p.fEx[k], s + " coordinate error");
+            }
+            break;
+         }
+      }
+   }
+   return iret;
+}
+
+int testBinData() {
+   int iret = 0;
+   const unsigned int npoints = 50;
+   const char * typeNames[4] = { "no error", "value error", "coordinate error", "asymmetric error" };
+   for (unsigned int dim = 1; dim <= 3; ++dim) {
+      std::vector<PointValues> points = generatePoints(npoints, dim);
+      for (int itype = BinData::kNoError; itype <= BinData::kAsymError; ++itype) {
+         BinData::ErrorType type = BinData::ErrorType(itype);
+         const std::string name = std::string("BinData ") + typeNames[itype] + " dim " + std::to_string(dim);
+
+         BinData data(npoints, dim, type);
+         fillBinData(data, points);
+         iret |= checkBinData(data, points, name + " points");
+         // re-arrange the filled data in columns and back
+         data.SetColumnLayout();
+         iret |= checkBinData(data, points, name + " columns");
+         data.SetColumnLayout(false);
+         iret |= checkBinData(data, points, name + " points again");
+
+         // fill the data already stored in columns
+         BinData cdata(npoints, dim, type);
+         cdata.SetColumnLayout();
+         fillBinData(cdata, points);
+         iret |= checkBinData(cdata, points, name + " filled in columns");
+         // a copy keeps the values
+         BinData copy(cdata);
+         copy.SetColumnLayout();
+         iret |= checkBinData(copy, points, name + " copy in columns");
+      }
+   }
+   if (iret != 0) std::cerr << "testBinData :\t FAILED " << std::endl;
+   else std::cout << "testBinData :\t OK " << std::endl;
+   return iret;
+}
+
+int checkUnBinData(const UnBinData & data, const std::vector<PointValues> & points, bool weighted,
+                   const std::string & name) {
+   int iret = 0;
+   const unsigned int dim = data.NDim();
+   if (data.Size() != points.size() || data.IsWeighted() != weighted) {
+      std::cerr << name << " Failed: " << data.Size() << " points instead of " << points.size() << std::endl;
+      return -1;
+   }
+   const unsigned int stride = data.IsColumnLayout() ? dim : data.PointSize();
+   iret |= compareResult(data.CoordStride(), stride, name + " coordinate stride");
+   const double * weightColumn = data.WeightColumn();
+   if ((weightColumn != 0) != (data.IsColumnLayout() && weighted)) {
+      std::cerr << name << " Failed: wrong weight column" << std::endl;
+      iret = -1;
+      weightColumn = 0;
+   }
+   for (unsigned int i = 0; i < points.size(); ++i) {
+      const PointValues & p = points[i];
+      const std::string s = name + " point " + std::to_string(i);
+      const double * x = data.Coords(i);
+      for (unsigned int k = 0; k < dim; ++k) {
+         iret |= compareResult(x[k], p.fX[k], s + " coordinate");
+         iret |= compareResult(data.Coords(0)[i * data.CoordStride() + k], p.fX[k], s + " strided coordinate");
+      }
+      // the weight is stored after the last coordinate
+      iret |= compareResult(data.Weight(i), weighted ? p.fValue : 1., s + " weight");
+      if (weightColumn) iret |= compareResult(weightColumn[i], p.fValue, s + " weight column");
+   }
+   return iret;
+}
+
+void fillUnBinData(UnBinData & data, const std::vector<PointValues> & points, bool weighted) {
+   for (unsigned int i = 0; i < points.size(); ++i) {
+      if (weighted) data.Add(&points[i].fX[0], points[i].fValue);
+      else data.Add(&points[i].fX[0]);
+   }
+}
+
+int testUnBinData() {
+   int iret = 0;
+   const unsigned int npoints = 50;
+   for (unsigned int dim = 1; dim <= 3; ++dim) {
+      std::vector<PointValues> points = generatePoints(npoints, dim);
+      for (int iw = 0; iw < 2; ++iw) {
+         const bool weighted = (iw == 1);
+         const std::string name = std::string("UnBinData ") + (weighted ? "weighted" : "unweighted") + " dim " + std::to_string(dim);
+
+         UnBinData data(npoints, dim, weighted);
+         fillUnBinData(data, points, weighted);
+         iret |= checkUnBinData(data, points, weighted, name + " points");
+         data.SetColumnLayout();
+         iret |= checkUnBinData(data, points, weighted, name + " columns");
+         data.SetColumnLayout(false);
+         iret |= checkUnBinData(data, points, weighted, name + " points again");
+
+         UnBinData cdata(npoints, dim, weighted);
+         cdata.SetColumnLayout();
+         fillUnBinData(cdata, points, weighted);
+         iret |= checkUnBinData(cdata, points, weighted, name + " filled in columns");
+      }
+   }
+   if (iret != 0) std::cerr << "testUnBinData :\t FAILED " << std::endl;
+   else std::cout << "testUnBinData :\t OK " << std::endl;
+   return iret;
+}
+
+int main() {
+   int iret = 0;
+   iret |= testBinData();
+   iret |= testUnBinData();
+   return iret;
+}
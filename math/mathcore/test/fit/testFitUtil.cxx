@@ -0,0 +1,294 @@
+// test of the FitUtil functions evaluating the fit objective functions and their gradients
+// on large data sets. The results obtained with implicit multi-threading enabled must be
+// the same as those of the sequential evaluation, and the evaluation of several sets of
+// parameters in one pass (Evaluate*Batch) must give the values of the single evaluations
+
+#include "TF1.h"
+#include "TH1.h"
+#include "TFitResult.h"
+#include "TRandom3.h"
+#include "TROOT.h"
+
+#include "Fit/BinData.h"
+#include "Fit/UnBinData.h"
+#include "Fit/FitUtil.h"
+#include "Fit/DataRange.h"
+
+#include "Math/IParamFunction.h"
+#include "Math/WrappedMultiTF1.h"
+#include "RConfigure.h"
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cmath>
+
+// gaussian model with an analytical parameter gradient, which can be evaluated concurrently
+class GausModel : public ROOT::Math::IParamMultiGradFunction {
+public:
+   GausModel() {
+      fParams[0] = 1; fParams[1] = 0; fParams[2] = 1;
+   }
+   ROOT::Math::IMultiGenFunction * Clone() const {
+      GausModel * g = new GausModel();
+      g->SetParameters(fParams);
+      return g;
+   }
+   unsigned int NDim() const { return 1; }
+   unsigned int NPar() const { return 3; }
+   const double * Parameters() const { return fParams; }
+   void SetParameters(const double * p) { std::copy(p, p + 3, fParams); }
+   bool IsThreadSafe() const { return true; }
+
+   void ParameterGradient(const double * x, const double * p, double * grad) const {
+      double t = (x[0] - p[1]) / p[2];
+      double e = std::exp(-0.5 * t * t);
+      grad[0] = e;
+      grad[1] = p[0] * e * t / p[2];
+      grad[2] = p[0] * e * t * t / p[2];
+   }
+
+private:
+   double DoEvalPar(const double * x, const double * p) const {
+      double t = (x[0] - p[1]) / p[2];
+      return p[0] * std::exp(-0.5 * t * t);
+   }
+   double DoParameterDerivative(const double * x, const double * p, unsigned int ipar) const {
+      double grad[3];
+      ParameterGradient(x, p, grad);
+      return grad[ipar];
+   }
+
+   double fParams[3];
+};
+
+int compareResult(double v1, double v2, std::string s = "", double tol = 1.E-10) {
+   // compare v1 with reference v2
+   if (std::abs(v1-v2) <= tol * std::abs(v2) ) return 0;
+   std::cerr << s << " Failed comparison  \t value = " << v1 << "   it should be = " << v2 << std::endl;
+   return -1;
+}
+
+// evaluate the three gradients with the given model
+void evalGradients(const ROOT::Math::IParamMultiGradFunction & func, const ROOT::Fit::BinData & bdata,
+                   const ROOT::Fit::UnBinData & udata, const double * p, std::vector<double> & grad) {
+   const unsigned int npar = func.NPar();
+   grad.assign(3 * npar, 0.);
+   unsigned int nPoints = 0;
+   ROOT::Fit::FitUtil::EvaluateChi2Gradient(func, bdata, p, &grad[0], nPoints);
+   ROOT::Fit::FitUtil::EvaluateLogLGradient(func, udata, p, &grad[npar], nPoints);
+   ROOT::Fit::FitUtil::EvaluatePoissonLogLGradient(func, bdata, p, &grad[2 * npar]);
+}
+
+int testGradients(ROOT::Math::IParamMultiGradFunction & func, const std::string & name) {
+
+   // use several chunks of data points
+   const int nbins = 10000;
+   const int nevt = 20000;
+   TRandom3 rndm(111);
+
+   ROOT::Fit::BinData bdata(nbins);
+   for (int i = 0; i < nbins; ++i) {
+      double x = -5. + 10. * (i + 0.5) / nbins;
+      double y = rndm.Poisson(100. * std::exp(-0.5 * x * x) + 1.);
+      bdata.Add(x, y, std::sqrt(y + 1.));
+   }
+   ROOT::Fit::UnBinData udata(nevt);
+   for (int i = 0; i < nevt; ++i) udata.Add(rndm.Gaus(0, 1));
+
+   const double p[3] = { 90., 0.1, 1.2 };
+   func.SetParameters(p);
+
+   std::vector<double> gseq;
+   evalGradients(func, bdata, udata, p, gseq);
+
+   int iret = 0;
+#ifdef R__USE_IMT
+   ROOT::EnableImplicitMT();
+   std::vector<double> gpar;
+   evalGradients(func, bdata, udata, p, gpar);
+   ROOT::DisableImplicitMT();
+
+   const char * fcnNames[3] = { "chi2", "logL", "poisson" };
+   const unsigned int npar = func.NPar();
+   for (unsigned int i = 0; i < gseq.size(); ++i) {
+      std::string s = name + " " + fcnNames[i / npar] + " gradient " + std::to_string(i % npar);
+      iret |= compareResult(gpar[i], gseq[i], s);
+   }
+#endif
+   // the parameters of the model are not changed by the evaluation
+   for (unsigned int i = 0; i < 3; ++i)
+      iret |= compareResult(func.Parameters()[i], p[i], name + " parameter " + std::to_string(i), 0);
+
+   if (iret == 0) std::cout << "Test gradients of " << name << " model :\t OK" << std::endl;
+   return iret;
+}
+
+// evaluate chi2, log-likelihood (non extended, extended, weighted) and Poisson likelihood
+// (extended and not) for nset parameter sets, either in a single batch or one set at a time
+void evalBatch(const ROOT::Math::IParamMultiFunction & func, const ROOT::Fit::BinData & bdata,
+               const ROOT::Fit::UnBinData & udata, unsigned int nset, const double * p,
+               bool batch, std::vector<double> & result) {
+   using namespace ROOT::Fit::FitUtil;
+   const unsigned int npar = func.NPar();
+   const unsigned int nfcn = 7;
+   result.assign(nfcn * nset, 0.);
+   unsigned int nPoints = 0;
+   for (unsigned int ifcn = 0; ifcn < nfcn; ++ifcn) {
+      double * r = &result[ifcn * nset];
+      for (unsigned int ks = 0; ks < nset; ++ks) {
+         const unsigned int n = batch ? nset : 1;
+         const double * pk = batch ? p : p + ks * npar;
+         double * rk = batch ? r : r + ks;
+         switch (ifcn) {
+            case 0: EvaluateChi2Batch(func, bdata, n, pk, rk, nPoints); break;
+            case 1: EvaluateLogLBatch(func, udata, n, pk, 0, false, rk, nPoints); break;
+            case 2: EvaluateLogLBatch(func, udata, n, pk, 0, true, rk, nPoints); break;
+            case 3: EvaluateLogLBatch(func, udata, n, pk, 1, true, rk, nPoints); break;
+            case 4: EvaluateLogLBatch(func, udata, n, pk, 2, true, rk, nPoints); break;
+            case 5: EvaluatePoissonLogLBatch(func, bdata, n, pk, 0, true, rk, nPoints); break;
+            case 6: EvaluatePoissonLogLBatch(func, bdata, n, pk, 0, false, rk, nPoints); break;
+         }
+         if (batch) break;
+      }
+   }
+}
+
+int testBatch(ROOT::Math::IParamMultiFunction & func, const std::string & name) {
+
+   const int nbins = 10000;
+   const int nevt = 20000;
+   TRandom3 rndm(222);
+
+   ROOT::Fit::BinData bdata(nbins);
+   for (int i = 0; i < nbins; ++i) {
+      double x = -5. + 10. * (i + 0.5) / nbins;
+      double y = rndm.Poisson(10. * std::exp(-0.5 * x * x));
+      bdata.Add(x, y, std::sqrt(y + 1.));
+   }
+   ROOT::Fit::UnBinData udata(ROOT::Fit::DataRange(-5, 5), nevt, 1, true);
+   for (int i = 0; i < nevt; ++i) {
+      double x = rndm.Gaus(0, 1);
+      udata.Add(&x, rndm.Uniform(0.5, 1.5));
+   }
+
+   const unsigned int nset = 5;
+   const double p[3 * nset] = { 9., 0.1, 1.2,   10., 0., 1.,   11., -0.1, 0.9,   8.5, 0.3, 1.1,   10.5, -0.2, 1.05 };
+   func.SetParameters(p);
+
+   const char * fcnNames[7] = { "chi2", "logL", "extended logL", "weighted logL", "weight2 logL",
+                                "poisson", "non extended poisson" };
+   std::vector<double> single, batch;
+   evalBatch(func, bdata, udata, nset, p, false, single);
+   evalBatch(func, bdata, udata, nset, p, true, batch);
+
+   int iret = 0;
+   for (unsigned int i = 0; i < single.size(); ++i) {
+      std::string s = name + " " + fcnNames[i / nset] + " batch set " + std::to_string(i % nset);
+      iret |= compareResult(batch[i], single[i], s, 1.E-12);
+   }
+
+   // reference values of the non-extended functions computed with a plain loop on the data
+   for (unsigned int ks = 0; ks < nset; ++ks) {
+      const double * pk = p + 3 * ks;
+      double chi2 = 0, poisson = 0, poissonNonExt = 0, logl = 0;
+      for (unsigned int i = 0; i < bdata.Size(); ++i) {
+         double f = func(bdata.Coords(i), pk);
+         double y = bdata.Value(i);
+         double r = (y - f) / bdata.Error(i);
+         chi2 += r * r;
+         poisson += f - y;
+         if (y > 0) {
+            poisson += y * (std::log(y) - std::log(f));
+            poissonNonExt += y * (std::log(y) - std::log(f));
+         }
+      }
+      for (unsigned int i = 0; i < udata.Size(); ++i) logl -= std::log(func(udata.Coords(i), pk));
+      std::string s = name + " set " + std::to_string(ks);
+      iret |= compareResult(batch[ks], chi2, s + " chi2 reference");
+      iret |= compareResult(batch[nset + ks], logl, s + " logL reference");
+      iret |= compareResult(batch[5 * nset + ks], poisson, s + " poisson reference");
+      iret |= compareResult(batch[6 * nset + ks], poissonNonExt, s + " non extended poisson reference");
+   }
+
+#ifdef R__USE_IMT
+   ROOT::EnableImplicitMT();
+   std::vector<double> batchPar;
+   evalBatch(func, bdata, udata, nset, p, true, batchPar);
+   ROOT::DisableImplicitMT();
+   for (unsigned int i = 0; i < batch.size(); ++i) {
+      std::string s = name + " " + fcnNames[i / nset] + " parallel batch set " + std::to_string(i % nset);
+      iret |= compareResult(batchPar[i], single[i], s);
+   }
+#endif
+
+   if (iret == 0) std::cout << "Test batch evaluation of " << name << " model :\t OK" << std::endl;
+   return iret;
+}
+
+// fit a histogram with TH1::Fit, with and without implicit multi-threading: the formula
+// based TF1 are evaluated in parallel and the fit results must be the same
+int testTF1Fit() {
+   int iret = 0;
+
+   TF1 * f1 = new TF1("fgausfit", "gaus", -5, 5);
+   if (!ROOT::Math::WrappedMultiTF1(*f1, 1).IsThreadSafe()) {
+      std::cerr << "WrappedMultiTF1 of a formula is not thread safe" << std::endl;
+      iret = -1;
+   }
+
+   TH1D * h1 = new TH1D("hfit", "hfit", 10000, -5, 5);
+   TRandom3 rndm(333);
+   for (int i = 0; i < 200000; ++i) h1->Fill(rndm.Gaus(0, 1));
+
+   const double p0[3] = { 20., 0.2, 1.2 };
+   const char * fitOpts[3] = { "Q0S", "LQ0S", "GQ0S" };
+   for (int iopt = 0; iopt < 3; ++iopt) {
+      std::string opt = fitOpts[iopt];
+      f1->SetParameters(p0);
+      TFitResultPtr rseq = h1->Fit(f1, opt.c_str());
+      iret |= compareResult(rseq->Status(), 0, "fit " + opt + " status", 0);
+#ifdef R__USE_IMT
+      ROOT::EnableImplicitMT();
+      f1->SetParameters(p0);
+      TFitResultPtr rpar = h1->Fit(f1, opt.c_str());
+      ROOT::DisableImplicitMT();
+
+      iret |= compareResult(rpar->MinFcnValue(), rseq->MinFcnValue(), "fit " + opt + " minimum");
+      for (unsigned int i = 0; i < 3; ++i) {
+         std::string s = "fit " + opt + " parameter " + std::to_string(i);
+         iret |= compareResult(rpar->Parameter(i), rseq->Parameter(i), s);
+         iret |= compareResult(rpar->ParError(i), rseq->ParError(i), s + " error");
+      }
+#endif
+   }
+
+   if (iret == 0) std::cout << "Test TF1 fit :\t OK" << std::endl;
+   delete h1;
+   delete f1;
+   return iret;
+}
+
+int testFitUtil() {
+   int iret = 0;
+
+   TF1 * f1 = new TF1("fgaus", "gaus", -5, 5);
+   ROOT::Math::WrappedMultiTF1 wf(*f1, 1);
+   iret |= testGradients(wf, "TF1");
+   iret |= testBatch(wf, "TF1");
+
+   GausModel gm;
+   iret |= testGradients(gm, "thread safe");
+   iret |= testBatch(gm, "thread safe");
+
+   iret |= testTF1Fit();
+
+   delete f1;
+   if (iret != 0) std::cerr << "testFitUtil :\t FAILED " << std::endl;
+   else std::cerr << "testFitUtil :\t OK " << std::endl;
+   return iret;
+}
+
+int main() {
+   return testFitUtil();
+}
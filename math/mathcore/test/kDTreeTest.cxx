@@ -5,6 +5,7 @@
   TestSpeed();       // test the CPU consumption to build kdTree
   TestkdtreeIF();    // test functionality of the kdTree
   TestSizeIF();      // test the size of kdtree - search application - Alice TPC tracker situation
+  TestBatch();       // test the searches of many points at once
   //
 */
 
@@ -17,7 +18,11 @@
 #include "TKDTree.h"
 #include "TApplication.h"
 #include "TCanvas.h"
+#include "TROOT.h"
 #include <iostream>
+#include <vector>
+#include <algorithm>
+#include <utility>
 
 
 bool showGraphics = false;
@@ -26,6 +31,7 @@ bool showGraphics = false;
 void TestBuild(const Int_t npoints = 1000000, const Int_t bsize = 100);
 void TestConstr(const Int_t npoints = 1000000, const Int_t bsize = 100);
 void TestSpeed(Int_t npower2 = 20, Int_t bsize = 10);
+Int_t TestBatch(Int_t npoints = 100000, Int_t nquery = 10000, Int_t bsize = 10);
 
 //void TestkdtreeIF(Int_t npoints=1000, Int_t bsize=9, Int_t nloop=1000, Int_t mode = 2);
 //void TestSizeIF(Int_t nsec=36, Int_t nrows=159, Int_t npoints=1000,  Int_t bsize=10, Int_t mode=1);
@@ -45,12 +51,14 @@ Float_t Mem()
 ///
 ///
 
-void kDTreeTest()
+Int_t kDTreeTest()
 {
   printf("\n\tTesting kDTree memory usage ...\n");
   TestBuild();
   printf("\n\tTesting kDTree speed ...\n");
   TestSpeed();
+  printf("\n\tTesting kDTree searches of many points ...\n");
+  return TestBatch();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -552,6 +560,137 @@ void TestRange()
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+///Test the TKDTree::FindNearestNeighbors() and TKDTree::FindInRange() functions
+///searching many points at once: they must give the same results as the
+///searches point by point and, for the first points, as a brute-force search.
+///The tree built and searched in parallel must be the same as the sequential one
+///and give the same results.
+
+Int_t TestBatch(Int_t npoints, Int_t nquery, Int_t bsize)
+{
+   const Int_t nn = 10;
+   const Double_t range = 5;
+   const Int_t nbrute = 100;
+   Double_t *x = new Double_t[npoints];
+   Double_t *y = new Double_t[npoints];
+   Double_t *z = new Double_t[npoints];
+   for (Int_t i=0; i<npoints; i++){
+      x[i] = gRandom->Uniform(-100, 100);
+      y[i] = gRandom->Uniform(-100, 100);
+      z[i] = gRandom->Uniform(-100, 100);
+   }
+   std::vector<Double_t> points(3*nquery);
+   for (Int_t i=0; i<3*nquery; i++) points[i] = gRandom->Uniform(-100, 100);
+
+   Int_t ndiff = 0;
+   std::vector<Int_t> index1(nn*nquery), index2(nn*nquery);
+   std::vector<Double_t> dist1(nn*nquery), dist2(nn*nquery);
+   std::vector<std::vector<Int_t> > res1(nquery), res2;
+   // results and tree structure of the sequential pass
+   std::vector<Int_t> indexSeq, indPointsSeq;
+   std::vector<Double_t> distSeq, valueSeq;
+   std::vector<UChar_t> axisSeq;
+   std::vector<std::vector<Int_t> > resSeq;
+
+   for (Int_t imt=0; imt<2; imt++){
+#ifdef R__USE_IMT
+      if (imt) ROOT::EnableImplicitMT();
+#else
+      if (imt) break;
+#endif
+      TKDTreeID *kdtree = new TKDTreeID(npoints, 3, bsize);
+      kdtree->SetData(0, x);
+      kdtree->SetData(1, y);
+      kdtree->SetData(2, z);
+      kdtree->Build();
+
+      TStopwatch timer;
+      for (Int_t i=0; i<nquery; i++){
+         kdtree->FindNearestNeighbors(&points[3*i], nn, &index1[nn*i], &dist1[nn*i]);
+         res1[i].clear();
+         kdtree->FindInRange(&points[3*i], range, res1[i]);
+      }
+      Double_t time1 = timer.RealTime();
+      timer.Start();
+      kdtree->FindNearestNeighbors(nquery, &points[0], nn, &index2[0], &dist2[0]);
+      kdtree->FindInRange(nquery, &points[0], range, res2);
+      Double_t time2 = timer.RealTime();
+
+      if (index1 != index2 || dist1 != dist2) ndiff++;
+      if (res1 != res2) ndiff++;
+      printf("%s: %d points searched one by one in %f s, at once in %f s\n",
+             imt ? "multi-threaded" : "sequential", nquery, time1, time2);
+
+      const Int_t *indPoints = kdtree->GetIndPoints();
+      std::vector<Int_t> indPointsPass(indPoints, indPoints+npoints);
+      std::vector<UChar_t> axisPass(kdtree->GetNNodes());
+      std::vector<Double_t> valuePass(kdtree->GetNNodes());
+      for (Int_t inode=0; inode<kdtree->GetNNodes(); inode++){
+         axisPass[inode] = kdtree->GetNodeAxis(inode);
+         valuePass[inode] = kdtree->GetNodeValue(inode);
+      }
+      if (imt == 0) {
+         indexSeq = index2;
+         distSeq = dist2;
+         resSeq = res2;
+         indPointsSeq = indPointsPass;
+         axisSeq = axisPass;
+         valueSeq = valuePass;
+      } else {
+         if (indPointsPass != indPointsSeq || axisPass != axisSeq || valuePass != valueSeq) {
+            printf("the tree built in parallel differs from the sequential one\n");
+            ndiff++;
+         }
+         if (index2 != indexSeq || dist2 != distSeq || res2 != resSeq) {
+            printf("the multi-threaded searches differ from the sequential ones\n");
+            ndiff++;
+         }
+      }
+      delete kdtree;
+#ifdef R__USE_IMT
+      if (imt) ROOT::DisableImplicitMT();
+#endif
+   }
+
+   // brute-force search of the first points, with the distance computed as in the tree
+   std::vector<std::pair<Double_t, Int_t> > all(npoints);
+   for (Int_t i=0; i<nbrute && i<nquery; i++){
+      const Double_t *p = &points[3*i];
+      std::vector<Int_t> inRange;
+      for (Int_t j=0; j<npoints; j++){
+         Double_t d = 0;
+         d += (p[0]-x[j])*(p[0]-x[j]);
+         d += (p[1]-y[j])*(p[1]-y[j]);
+         d += (p[2]-z[j])*(p[2]-z[j]);
+         all[j] = std::make_pair(TMath::Sqrt(d), j);
+         if (all[j].first <= range) inRange.push_back(j);
+      }
+      std::partial_sort(all.begin(), all.begin()+nn, all.end());
+      for (Int_t k=0; k<nn; k++){
+         if (index2[nn*i+k] != all[k].second || dist2[nn*i+k] != all[k].first) {
+            printf("point %d: neighbor %d is %d at %g, brute force gives %d at %g\n",
+                   i, k, index2[nn*i+k], dist2[nn*i+k], all[k].second, all[k].first);
+            ndiff++;
+            break;
+         }
+      }
+      std::vector<Int_t> found = res2[i];
+      std::sort(found.begin(), found.end());
+      if (found != inRange) {
+         printf("point %d: %d points in range, brute force gives %d\n",
+                i, (Int_t)found.size(), (Int_t)inRange.size());
+         ndiff++;
+      }
+   }
+   printf("%d differences found between the searches one by one, at once and by brute force\n", ndiff);
+
+   delete [] x;
+   delete [] y;
+   delete [] z;
+   return ndiff;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 int main(int argc, char **argv) {
@@ -579,7 +718,7 @@ int main(int argc, char **argv) {
    if ( showGraphics )
       theApp = new TApplication("App",&argc,argv);
 
-   kDTreeTest();
+   Int_t iret = kDTreeTest();
 
    if ( showGraphics )
    {
@@ -588,5 +727,5 @@ int main(int argc, char **argv) {
       theApp = 0;
    }
 
-   return 0;
+   return iret;
 }
@@ -0,0 +1,138 @@
+// test of the accuracy of the fast-math mode (TMath::EnableFastMath): the array functions
+// of TMath and the conversions of the LorentzVector arrays (VectorUtil::FastConvert) must
+// give the libm results, exactly when fast math is off and within a few units in the last
+// place when the vdt functions are used, also for eta and pz close to 0
+
+#include "TMath.h"
+#include "TRandom3.h"
+
+#include "Math/Vector4D.h"
+#include "Math/GenVector/FastConversion.h"
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cmath>
+
+// largest relative difference allowed with the vdt functions (they are accurate to about 2 ulp)
+const double kFastTolerance = 1.E-14;
+
+int compareResult(double v1, double v2, const std::string & s, double tol, double scale) {
+   // compare v1 with reference v2, the tolerance is relative to scale
+   if (std::abs(v1 - v2) <= tol * scale) return 0;
+   std::cerr.precision(18);
+   std::cerr << s << " Failed comparison  \t value = " << v1 << "   it should be = " << v2 << std::endl;
+   return -1;
+}
+
+int compareArrays(const std::vector<double> & y, const std::vector<double> & ref, const std::string & name,
+                  bool fast, bool absolute = false) {
+   // sin and cos are compared with an absolute tolerance, their relative accuracy is lost at the zeros
+   const double tol = fast ? kFastTolerance : 0;
+   int iret = 0;
+   for (unsigned int i = 0; i < y.size() && iret == 0; ++i)
+      iret |= compareResult(y[i], ref[i], name + " " + std::to_string(i), tol, absolute ? 1. : std::abs(ref[i]));
+   return iret;
+}
+
+int testArrayFunctions(bool fast) {
+   const int n = 10000;
+   TRandom3 rndm(111);
+   std::vector<double> x(n), x2(n), y(n), ref(n);
+   for (int i = 0; i < n; ++i) {
+      x[i] = rndm.Uniform(-20, 20);
+      x2[i] = rndm.Uniform(-20, 20);
+   }
+
+   int iret = 0;
+   std::string mode = fast ? " fast" : " libm";
+   TMath::Exp(n, &x[0], &y[0]);
+   for (int i = 0; i < n; ++i) ref[i] = std::exp(x[i]);
+   iret |= compareArrays(y, ref, "Exp" + mode, fast);
+
+   TMath::Sin(n, &x[0], &y[0]);
+   for (int i = 0; i < n; ++i) ref[i] = std::sin(x[i]);
+   iret |= compareArrays(y, ref, "Sin" + mode, fast, true);
+
+   TMath::Cos(n, &x[0], &y[0]);
+   for (int i = 0; i < n; ++i) ref[i] = std::cos(x[i]);
+   iret |= compareArrays(y, ref, "Cos" + mode, fast, true);
+
+   TMath::ATan2(n, &x[0], &x2[0], &y[0]);
+   for (int i = 0; i < n; ++i) ref[i] = std::atan2(x[i], x2[i]);
+   iret |= compareArrays(y, ref, "ATan2" + mode, fast);
+
+   // log on many decades, and in place
+   for (int i = 0; i < n; ++i) y[i] = std::pow(10., x[i] * 10);
+   for (int i = 0; i < n; ++i) ref[i] = std::log(y[i]);
+   TMath::Log(n, &y[0], &y[0]);
+   iret |= compareArrays(y, ref, "Log" + mode, fast);
+
+   if (iret != 0) std::cerr << "Test TMath array functions" << mode << " :\t FAILED " << std::endl;
+   else std::cout << "Test TMath array functions" << mode << " :\t OK" << std::endl;
+   return iret;
+}
+
+int testFastConvert() {
+   // FastConvert always uses vdt (when ROOT is built with it), its result is compared with
+   // the one of the assignment operator and with the libm asinh
+   using ROOT::Math::PtEtaPhiEVector;
+   using ROOT::Math::PxPyPzEVector;
+   const int n = 10000;
+   TRandom3 rndm(222);
+   std::vector<PtEtaPhiEVector> vin(n), vback(n);
+   std::vector<PxPyPzEVector> vout(n);
+   for (int i = 0; i < n; ++i) {
+      // a quarter of the vectors have eta close to 0, down to 1e-12
+      double eta = (i % 4 == 0) ? rndm.Uniform(-1, 1) * std::pow(10., -rndm.Uniform(0, 12)) : rndm.Uniform(-5, 5);
+      vin[i].SetCoordinates(rndm.Uniform(1, 100), eta, rndm.Uniform(-TMath::Pi(), TMath::Pi()), 1000.);
+   }
+
+   int iret = 0;
+   ROOT::Math::VectorUtil::FastConvert(n, &vin[0], &vout[0]);
+   for (int i = 0; i < n && iret == 0; ++i) {
+      PxPyPzEVector ref(vin[i]);
+      std::string s = "FastConvert to PxPyPzE vector " + std::to_string(i);
+      iret |= compareResult(vout[i].Px(), ref.Px(), s + " px", kFastTolerance, ref.Pt());
+      iret |= compareResult(vout[i].Py(), ref.Py(), s + " py", kFastTolerance, ref.Pt());
+      iret |= compareResult(vout[i].Pz(), ref.Pz(), s + " pz", kFastTolerance, std::abs(ref.Pz()));
+      iret |= compareResult(vout[i].E(), ref.E(), s + " E", 0, 1);
+   }
+
+   ROOT::Math::VectorUtil::FastConvert(n, &vout[0], &vback[0]);
+   for (int i = 0; i < n && iret == 0; ++i) {
+      PtEtaPhiEVector ref(vout[i]);
+      std::string s = "FastConvert to PtEtaPhiE vector " + std::to_string(i);
+      iret |= compareResult(vback[i].Pt(), ref.Pt(), s + " pt", kFastTolerance, ref.Pt());
+      // the eta of the assignment operator, log(a + sqrt(a*a + 1)), loses the digits at small pz
+      const double eta = std::asinh(vout[i].Pz() / vout[i].Pt());
+      iret |= compareResult(vback[i].Eta(), eta, s + " eta", kFastTolerance, std::abs(eta));
+      iret |= compareResult(vback[i].Phi(), ref.Phi(), s + " phi", kFastTolerance, TMath::Pi());
+      iret |= compareResult(vback[i].E(), ref.E(), s + " E", 0, 1);
+   }
+
+   if (iret != 0) std::cerr << "Test FastConvert :\t FAILED " << std::endl;
+   else std::cout << "Test FastConvert :\t OK" << std::endl;
+   return iret;
+}
+
+int testFastMath() {
+   int iret = 0;
+   TMath::EnableFastMath(false);
+   iret |= testArrayFunctions(false);
+   if (TMath::IsFastMathEnabled())
+      iret = -1;
+   TMath::EnableFastMath();
+   // without vdt the libm functions are still used
+   iret |= testArrayFunctions(TMath::IsFastMathEnabled());
+   TMath::EnableFastMath(false);
+   iret |= testFastConvert();
+
+   if (iret != 0) std::cerr << "testFastMath :\t FAILED " << std::endl;
+   else std::cout << "testFastMath :\t OK " << std::endl;
+   return iret;
+}
+
+int main() {
+   return testFastMath();
+}
@@ -20,6 +20,7 @@
 #include "Math/AdaptiveIntegratorMultiDim.h"
 #include "Math/IFunctionfwd.h"
 #include "TF1.h"
+#include "TROOT.h"
 
 // for graphical comparison of performance
 #include "TGraph.h"
@@ -138,6 +139,85 @@ double integral_TF1(unsigned int dim, double* a, double* b, double* p)
   return timeTF1;
 }
 
+  // ################################################################
+  //
+  //      testing the batched and parallel evaluation of the integrand
+  //
+  // ################################################################
+
+// SimpleFun re-implementing the evaluation on a set of points
+class VecSimpleFun : public ROOT::Math::IBaseFunctionMultiDim {
+public:
+   VecSimpleFun(unsigned int dim) : fDim(dim), fNVecCalls(0) {}
+   ROOT::Math::IBaseFunctionMultiDim * Clone() const { return new VecSimpleFun(fDim); }
+   unsigned int NDim() const { return fDim; }
+   unsigned int NVecCalls() const { return fNVecCalls; }
+private:
+   double DoEval(const double * x) const {
+      double p = fDim;
+      return SimpleFun(x, &p);
+   }
+   void DoEvalVec(unsigned int n, const double * x, double * result) const {
+      ++fNVecCalls;   // not protected: the test counts it only in the sequential mode
+      for (unsigned int i = 0; i < n; ++i) result[i] = DoEval(x + i*fDim);
+   }
+   unsigned int fDim;
+   mutable unsigned int fNVecCalls;
+};
+
+int testBatchedEvaluation()
+{
+   // the result must not depend on the way the integrand is evaluated, and must be the one
+   // of the algorithm evaluating the nodes one by one (reference values below, obtained with
+   // ROOT 6.06). The tolerances allow for the contraction of the operations in FMA instructions.
+   // In 9 dimensions the nodes of a rule are evaluated in several batches
+   std::cout << "Testing batched and parallel evaluation of the integrand\n";
+   const unsigned int dims[4] = { 2, 3, 4, 9 };
+   const double refResult[4] = { 0.51772012163284997, 0.77329173452917177, 1.1550258857192286, 8.3757427900433488 };
+   const double refError[4] = { 9.1431334752175089e-06, 9.8550031700176674e-06, 1.1539349607149056e-05, 1.8907798102203608 };
+   const int refNEval[4] = { 833, 9603, 66633, 99099 };
+   int iret = 0;
+   for (unsigned int idim = 0; idim < 4; idim++) {
+      const unsigned int N = dims[idim];
+      std::vector<double> a(N, -1.), b(N, 1.);
+      double p[1] = { double(N) };
+      ROOT::Math::WrappedParamFunction<> f1(&SimpleFun, N, p, p+1);
+      VecSimpleFun f2(N);
+
+      ROOT::Math::AdaptiveIntegratorMultiDim ig1(f1, 1.E-5, 1.E-5, 100000);
+      double r1 = ig1.Integral(&a[0], &b[0]);
+      ROOT::Math::AdaptiveIntegratorMultiDim ig2(f2, 1.E-5, 1.E-5, 100000);
+      double r2 = ig2.Integral(&a[0], &b[0]);
+      if (std::abs(r1 - refResult[idim]) > 1.E-12 * std::abs(refResult[idim]) ||
+          std::abs(ig1.Error() - refError[idim]) > 1.E-9 * refError[idim] || ig1.NEval() != refNEval[idim]) {
+         std::cerr.precision(17);
+         std::cerr << "Error: integral in " << N << " dimensions = " << r1 << " +/- " << ig1.Error()
+                   << " with " << ig1.NEval() << " calls, it should be " << refResult[idim] << " +/- "
+                   << refError[idim] << " with " << refNEval[idim] << " calls" << std::endl;
+         iret = 1;
+      }
+      if (r1 != r2 || ig1.Error() != ig2.Error() || ig1.NEval() != ig2.NEval()) {
+         std::cerr << "Error: batched evaluation gives " << r2 << " instead of " << r1 << std::endl;
+         iret = 1;
+      }
+      // one call for the first region, then one per division, when the nodes of two
+      // regions fit in a single batch
+      unsigned int nrule = (1u << N) + 2*N*(N+1) + 1;
+      if (N <= 4 && f2.NVecCalls() != 1 + (ig2.NEval()/nrule - 1)/2) {
+         std::cerr << "Error: integrand not evaluated in batches" << std::endl;
+         iret = 1;
+      }
+
+      ig2.SetParallel();
+      double r3 = ig2.Integral(&a[0], &b[0]);
+      if (r1 != r3 || ig1.Error() != ig2.Error()) {
+         std::cerr << "Error: parallel evaluation gives " << r3 << " instead of " << r1 << std::endl;
+         iret = 1;
+      }
+   }
+   return iret;
+}
+
 void performance()
 {
   //dimensionality
@@ -227,6 +307,14 @@ int main(int argc, char **argv)
    if ( showGraphics )
       theApp = new TApplication("App",&argc,argv);
 
+#ifdef R__USE_IMT
+   ROOT::EnableImplicitMT();
+#endif
+   int iret = testBatchedEvaluation();
+#ifdef R__USE_IMT
+   ROOT::DisableImplicitMT();
+#endif
+
    performance();
 
    if ( showGraphics )
@@ -236,6 +324,6 @@ int main(int argc, char **argv)
       theApp = 0;
    }
 
-   return 0;
+   return iret;
 
 }
@@ -2,6 +2,7 @@
 #include "Math/TRandomEngine.h"
 #include "Math/MersenneTwisterEngine.h"
 #include "Math/MixMaxEngine.h"
+#include "Math/PhiloxEngine.h"
 //#include "Math/MyMixMaxEngine.h"
 //#include "Math/GSLRndmEngines.h"
 #include "Math/GoFTest.h"
@@ -164,6 +165,86 @@ bool test2() {
    return ret; 
 }
 
+bool test3() {
+
+   bool ret = true;
+
+   std::cout << "\nTesting PHILOX vs MT " << std::endl;
+
+   Random<PhiloxEngine> rph;
+   Random<MersenneTwisterEngine> rmt;
+   ret &= testUniform(rph, rmt);
+   ret &= testGauss(rph, rmt);
+   return ret;
+}
+
+bool test4() {
+
+   bool ret = true;
+
+   std::cout << "\nTesting PHILOX and MIXMAX streams" << std::endl;
+
+   // known answer of Philox4x32-10 for a null counter and key (Random123 test vectors)
+   PhiloxEngine ph0(0, 0);
+   uint64_t r0 = ph0.IntRndm();
+   uint64_t r1 = ph0.IntRndm();
+   if (r0 != 0xe169c58d6627e8d5ULL || r1 != 0x9b00dbd8bc57ac4cULL) {
+      std::cout << "Error: wrong PHILOX output " << std::hex << r0 << " " << r1 << std::dec << std::endl;
+      ret = false;
+   }
+
+   // RndmArray and Skip must give the same sequence as Rndm
+   const int n = 1001;
+   std::vector<double> v(n);
+   PhiloxEngine ph1(1234, 5), ph2(1234, 5), ph3(1234, 5);
+   ph1.Rndm();
+   ph1.RndmArray(n, v.data());
+   ph3.Skip(n + 1);
+   ph2.Rndm();
+   for (int i = 0; i < n; ++i) {
+      if (v[i] != ph2.Rndm()) {
+         std::cout << "Error: PHILOX RndmArray differs from Rndm at " << i << std::endl;
+         ret = false;
+         break;
+      }
+   }
+   if (ph3.Rndm() != ph2.Rndm() || ph3.Position() != ph1.Position() + 1) {
+      std::cout << "Error: PHILOX Skip is not consistent with Rndm" << std::endl;
+      ret = false;
+   }
+
+   // different streams are independent, the same stream is reproduced
+   PhiloxEngine ph4(1234, 6);
+   Random<MixMaxEngine> rmx1, rmx2, rmx3;
+   rmx1.Rng().SeedUniqueStream(0, 0, 1, 1);
+   rmx2.Rng().SeedUniqueStream(0, 0, 1, 2);
+   rmx3.Rng().SeedUniqueStream(0, 0, 1, 1);
+   int nsame = 0;
+   ph1.SetStream(5);
+   ph2.SetStream(5);
+   for (int i = 0; i < n; ++i) {
+      double x1 = ph1.Rndm(), x2 = ph2.Rndm();
+      double y1 = rmx1.Rndm(), y3 = rmx3.Rndm();
+      if (x1 != x2 || y1 != y3) {
+         std::cout << "Error: a stream is not reproducible" << std::endl;
+         ret = false;
+         break;
+      }
+      if (x1 == ph4.Rndm() || y1 == rmx2.Rndm()) nsame++;
+   }
+   if (nsame > 0) {
+      std::cout << "Error: " << nsame << " identical numbers in different streams" << std::endl;
+      ret = false;
+   }
+
+   // the streams have the right distribution
+   PhiloxEngine ph5(1234, 7);
+   MixMaxEngine mx5;
+   mx5.SeedUniqueStream(0, 0, 1, 7);
+   ret &= testUniform(ph5, mx5);
+
+   return ret;
+}
 
 bool testMathRandom() {
 
@@ -181,6 +262,8 @@ bool testMathRandom() {
 
    ret &= test1(); 
    ret &= test2(); 
+   ret &= test3();
+   ret &= test4();
 
    if (!ret) Error("testMathRandom","Test Failed");
    else
@@ -26,6 +26,7 @@
 
 #include "TDecompChol.h"
 #include "TMath.h"
+#include "TMatrixTKernels.h"
 
 ClassImp(TDecompChol)
 
@@ -115,32 +116,39 @@ Bool_t TDecompChol::Decompose()
    Int_t i,j,icol,irow;
    const Int_t     n  = fU.GetNrows();
          Double_t *pU = fU.GetMatrixArray();
-   for (icol = 0; icol < n; icol++) {
-      const Int_t rowOff = icol*n;
-
-      //Compute fU(j,j) and test for non-positive-definiteness.
-      Double_t ujj = pU[rowOff+icol];
-      for (irow = 0; irow < icol; irow++) {
-         const Int_t pos_ij = irow*n+icol;
-         ujj -= pU[pos_ij]*pU[pos_ij];
-      }
-      if (ujj <= 0) {
-         Error("Decompose()","matrix not positive definite");
-         return kFALSE;
-      }
-      ujj = TMath::Sqrt(ujj);
-      pU[rowOff+icol] = ujj;
-
-      if (icol < n-1) {
-         for (j = icol+1; j < n; j++) {
-            for (i = 0; i < icol; i++) {
-               const Int_t rowOff2 = i*n;
-               pU[rowOff+j] -= pU[rowOff2+j]*pU[rowOff2+icol];
-            }
+
+   // The rows of U are computed in panels of kBlockDecomp. Inside a panel the
+   // contributions of each new row are subtracted right away; the trailing
+   // upper triangle is then updated at once with U22 -= U12^T * U12 by the
+   // blocked (and possibly multithreaded) multiplication kernel. Each element
+   // receives its terms in the same order as in the row by row algorithm (the
+   // results agree up to rounding when the compiler contracts to FMA instructions).
+   const Int_t nb = TMatrixTKernels::kBlockDecomp;
+   for (Int_t kb = 0; kb < n; kb += nb) {
+      const Int_t ke = TMath::Min(kb+nb,n);
+      for (icol = kb; icol < ke; icol++) {
+         const Int_t rowOff = icol*n;
+
+         //Compute fU(j,j) and test for non-positive-definiteness.
+         Double_t ujj = pU[rowOff+icol];
+         if (ujj <= 0) {
+            Error("Decompose()","matrix not positive definite");
+            return kFALSE;
          }
+         ujj = TMath::Sqrt(ujj);
+         pU[rowOff+icol] = ujj;
+
          for (j = icol+1; j < n; j++)
             pU[rowOff+j] /= ujj;
+         for (i = icol+1; i < ke; i++) {
+            const Int_t rowOff2 = i*n;
+            const Double_t uci = pU[rowOff+i];
+            for (j = i; j < n; j++)
+               pU[rowOff2+j] -= uci*pU[rowOff+j];
+         }
       }
+      if (ke < n)
+         TMatrixTKernels::MultAdd(n-ke,-1.0,pU+kb*n+ke,1,n,ke-kb,pU+kb*n+ke,n,n-ke,pU+ke*n+ke,n,kTRUE);
    }
 
    for (irow = 0; irow < n; irow++) {
@@ -11,6 +11,7 @@
 
 #include "TDecompLU.h"
 #include "TMath.h"
+#include "TMatrixTKernels.h"
 
 ClassImp(TDecompLU)
 
@@ -589,6 +590,27 @@ TDecompLU &TDecompLU::operator=(const TDecompLU &source)
    return *this;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Apply the eliminations of the factorized panel of columns [jb,je) of the
+/// n x n matrix pLU to the columns [je,n): first to the rows of the panel,
+/// which gives U12, then to the trailing rows with A22 -= L21 * U12 through
+/// the blocked (and possibly multithreaded) multiplication kernel.
+
+static void UpdateTrailing(Double_t *pLU,Int_t n,Int_t jb,Int_t je)
+{
+   if (je >= n) return;
+   for (Int_t j = jb; j < je; j++) {
+      const Double_t * const urp = pLU+j*n;
+      for (Int_t i = j+1; i < je; i++) {
+         Double_t * const rp = pLU+i*n;
+         const Double_t lij = rp[j];
+         for (Int_t k = je; k < n; k++)
+            rp[k] -= lij*urp[k];
+      }
+   }
+   TMatrixTKernels::MultAdd(n-je,-1.0,pLU+je*n+jb,n,1,je-jb,pLU+jb*n+je,n,n-je,pLU+je*n+je,n);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Crout/Doolittle algorithm of LU decomposing a square matrix, with implicit partial
 /// pivoting.  The decomposition is stored in fLU: U is explicit in the upper triag
@@ -624,70 +646,67 @@ Bool_t TDecompLU::DecomposeLUCrout(TMatrixD &lu,Int_t *index,Double_t &sign,
       scale[i] = (max == 0.0 ? 0.0 : 1.0/max);
    }
 
-   for (Int_t j = 0; j < n; j++) {
-      const Int_t off_j = j*n;
-      // Run down jth column from top to diag, to form the elements of U.
-      for (Int_t i = 0; i < j; i++) {
-         const Int_t off_i = i*n;
-         Double_t r = pLU[off_i+j];
-         for (Int_t k = 0; k < i; k++) {
-            const Int_t off_k = k*n;
-            r -= pLU[off_i+k]*pLU[off_k+j];
-         }
-         pLU[off_i+j] = r;
-      }
-
-      // Run down jth subdiag to form the residuals after the elimination of
-      // the first j-1 subdiags.  These residuals divided by the appropriate
-      // diagonal term will become the multipliers in the elimination of the jth.
-      // subdiag. Find fIndex of largest scaled term in imax.
+   // The columns are processed in panels of kBlockDecomp: the eliminations of
+   // a panel are applied right away inside the panel and then at once to the
+   // rest of the matrix by UpdateTrailing. Each element receives its terms in
+   // the same order as in the column by column Crout algorithm (the results
+   // agree up to rounding when the compiler contracts to FMA instructions).
+   const Int_t nb = TMatrixTKernels::kBlockDecomp;
+   for (Int_t jb = 0; jb < n; jb += nb) {
+      const Int_t je = TMath::Min(jb+nb,n);
+      for (Int_t j = jb; j < je; j++) {
+         const Int_t off_j = j*n;
 
-      Double_t max = 0.0;
-      Int_t imax = 0;
-      for (Int_t i = j; i < n; i++) {
-         const Int_t off_i = i*n;
-         Double_t r = pLU[off_i+j];
-         for (Int_t k = 0; k < j; k++) {
-            const Int_t off_k = k*n;
-            r -= pLU[off_i+k]*pLU[off_k+j];
-         }
-         pLU[off_i+j] = r;
-         const Double_t tmp = scale[i]*TMath::Abs(r);
-         if (tmp >= max) {
-            max = tmp;
-            imax = i;
+         // The jth subdiag holds the residuals after the elimination of the
+         // first j-1 subdiags.  These residuals divided by the appropriate
+         // diagonal term will become the multipliers in the elimination of the jth.
+         // subdiag. Find fIndex of largest scaled term in imax.
+
+         Double_t max = 0.0;
+         Int_t imax = 0;
+         for (Int_t i = j; i < n; i++) {
+            const Double_t tmp = scale[i]*TMath::Abs(pLU[i*n+j]);
+            if (tmp >= max) {
+               max = tmp;
+               imax = i;
+            }
          }
-      }
 
-      // Permute current row with imax
-      if (j != imax) {
-         const Int_t off_imax = imax*n;
-         for (Int_t k = 0; k < n; k++ ) {
-            const Double_t tmp = pLU[off_imax+k];
-            pLU[off_imax+k] = pLU[off_j+k];
-            pLU[off_j+k]    = tmp;
+         // Permute current row with imax
+         if (j != imax) {
+            const Int_t off_imax = imax*n;
+            for (Int_t k = 0; k < n; k++ ) {
+               const Double_t tmp = pLU[off_imax+k];
+               pLU[off_imax+k] = pLU[off_j+k];
+               pLU[off_j+k]    = tmp;
+            }
+            sign = -sign;
+            scale[imax] = scale[j];
          }
-         sign = -sign;
-         scale[imax] = scale[j];
-      }
-      index[j] = imax;
-
-      // If diag term is not zero divide subdiag to form multipliers.
-      if (pLU[off_j+j] != 0.0) {
-         if (TMath::Abs(pLU[off_j+j]) < tol)
-            nrZeros++;
-         if (j != n-1) {
-            const Double_t tmp = 1.0/pLU[off_j+j];
-            for (Int_t i = j+1; i < n; i++) {
-               const Int_t off_i = i*n;
-               pLU[off_i+j] *= tmp;
+         index[j] = imax;
+
+         // If diag term is not zero divide subdiag to form multipliers and
+         // eliminate them from the remaining columns of the panel.
+         if (pLU[off_j+j] != 0.0) {
+            if (TMath::Abs(pLU[off_j+j]) < tol)
+               nrZeros++;
+            if (j != n-1) {
+               const Double_t tmp = 1.0/pLU[off_j+j];
+               for (Int_t i = j+1; i < n; i++) {
+                  const Int_t off_i = i*n;
+                  pLU[off_i+j] *= tmp;
+                  const Double_t lij = pLU[off_i+j];
+                  for (Int_t k = j+1; k < je; k++)
+                     pLU[off_i+k] -= lij*pLU[off_j+k];
+               }
             }
+         } else {
+            ::Error("TDecompLU::DecomposeLUCrout","matrix is singular");
+            if (isAllocated)  delete [] scale;
+            return kFALSE;
          }
-      } else {
-         ::Error("TDecompLU::DecomposeLUCrout","matrix is singular");
-         if (isAllocated)  delete [] scale;
-         return kFALSE;
       }
+      UpdateTrailing(pLU,n,jb,je);
    }
 
    if (isAllocated)
@@ -714,56 +733,62 @@ Bool_t TDecompLU::DecomposeLUGauss(TMatrixD &lu,Int_t *index,Double_t &sign,
    sign    = 1.0;
    nrZeros = 0;
 
+   // The columns are processed in panels of kBlockDecomp, as in DecomposeLUCrout
+   const Int_t nb = TMatrixTKernels::kBlockDecomp;
    index[n-1] = n-1;
-   for (Int_t j = 0; j < n-1; j++) {
-      const Int_t off_j = j*n;
+   for (Int_t jb = 0; jb < n-1; jb += nb) {
+      const Int_t je = TMath::Min(jb+nb,n);
+      for (Int_t j = jb; j < TMath::Min(je,n-1); j++) {
+         const Int_t off_j = j*n;
 
-      // Find maximum in the j-th column
+         // Find maximum in the j-th column
 
-      Double_t max = TMath::Abs(pLU[off_j+j]);
-      Int_t i_pivot = j;
+         Double_t max = TMath::Abs(pLU[off_j+j]);
+         Int_t i_pivot = j;
 
-      for (Int_t i = j+1; i < n; i++) {
-         const Int_t off_i = i*n;
-         const Double_t mLUij = TMath::Abs(pLU[off_i+j]);
+         for (Int_t i = j+1; i < n; i++) {
+            const Int_t off_i = i*n;
+            const Double_t mLUij = TMath::Abs(pLU[off_i+j]);
 
-         if (mLUij > max) {
-            max = mLUij;
-            i_pivot = i;
+            if (mLUij > max) {
+               max = mLUij;
+               i_pivot = i;
+            }
          }
-      }
 
-      if (i_pivot != j) {
-         const Int_t off_ipov = i_pivot*n;
-         for (Int_t k = 0; k < n; k++ ) {
-            const Double_t tmp = pLU[off_ipov+k];
-            pLU[off_ipov+k] = pLU[off_j+k];
-            pLU[off_j+k]    = tmp;
+         if (i_pivot != j) {
+            const Int_t off_ipov = i_pivot*n;
+            for (Int_t k = 0; k < n; k++ ) {
+               const Double_t tmp = pLU[off_ipov+k];
+               pLU[off_ipov+k] = pLU[off_j+k];
+               pLU[off_j+k]    = tmp;
+            }
+            sign = -sign;
          }
-         sign = -sign;
-      }
-      index[j] = i_pivot;
-
-      const Double_t mLUjj = pLU[off_j+j];
+         index[j] = i_pivot;
 
-      if (mLUjj != 0.0) {
-         if (TMath::Abs(mLUjj) < tol)
-            nrZeros++;
-         for (Int_t i = j+1; i < n; i++) {
-            const Int_t off_i = i*n;
-            const Double_t mLUij = pLU[off_i+j]/mLUjj;
-            pLU[off_i+j] = mLUij;
+         const Double_t mLUjj = pLU[off_j+j];
 
-            for (Int_t k = j+1; k < n; k++) {
-               const Double_t mLUik = pLU[off_i+k];
-               const Double_t mLUjk = pLU[off_j+k];
-               pLU[off_i+k] = mLUik-mLUij*mLUjk;
+         if (mLUjj != 0.0) {
+            if (TMath::Abs(mLUjj) < tol)
+               nrZeros++;
+            for (Int_t i = j+1; i < n; i++) {
+               const Int_t off_i = i*n;
+               const Double_t mLUij = pLU[off_i+j]/mLUjj;
+               pLU[off_i+j] = mLUij;
+
+               for (Int_t k = j+1; k < je; k++) {
+                  const Double_t mLUik = pLU[off_i+k];
+                  const Double_t mLUjk = pLU[off_j+k];
+                  pLU[off_i+k] = mLUik-mLUij*mLUjk;
+               }
             }
+         } else {
+            ::Error("TDecompLU::DecomposeLUGauss","matrix is singular");
+            return kFALSE;
          }
-      } else {
-         ::Error("TDecompLU::DecomposeLUGauss","matrix is singular");
-         return kFALSE;
       }
+      UpdateTrailing(pLU,n,jb,je);
    }
 
    return kTRUE;
@@ -19,6 +19,7 @@
 
 #include <iostream>
 #include <typeinfo>
+#include <vector>
 
 #include "TMatrixT.h"
 #include "TBuffer.h"
@@ -29,6 +30,7 @@
 #include "TMatrixDEigen.h"
 #include "TClass.h"
 #include "TMath.h"
+#include "TMatrixTKernels.h"
 
 templateClassImp(TMatrixT)
 
@@ -3072,25 +3074,22 @@ TMatrixT<Element> &ElementDiv(TMatrixT<Element> &target,const TMatrixTSym<Elemen
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Elementary routine to calculate matrix multiplication A*B
+///
+/// The product is computed by the cache-blocked kernel of TMatrixTKernels,
+/// from several threads for large matrices when implicit multithreading is
+/// enabled. The terms of each element are summed in the same order as in
+/// the textbook loop, so the result does not depend on the blocking; it
+/// may only differ in the last bits when the compiler uses FMA instructions.
 
 template<class Element>
 void AMultB(const Element * const ap,Int_t na,Int_t ncolsa,
             const Element * const bp,Int_t nb,Int_t ncolsb,Element *cp)
 {
-   const Element *arp0 = ap;                     // Pointer to  A[i,0];
-   while (arp0 < ap+na) {
-      for (const Element *bcp = bp; bcp < bp+ncolsb; ) { // Pointer to the j-th column of B, Start bcp = B[0,0]
-         const Element *arp = arp0;                       // Pointer to the i-th row of A, reset to A[i,0]
-         Element cij = 0;
-         while (bcp < bp+nb) {                     // Scan the i-th row of A and
-            cij += *arp++ * *bcp;                   // the j-th col of B
-            bcp += ncolsb;
-         }
-         *cp++ = cij;
-         bcp -= nb-1;                              // Set bcp to the (j+1)-th col
-      }
-      arp0 += ncolsa;                             // Set ap to the (i+1)-th row
-   }
+   if (ncolsa <= 0) return;
+   const Int_t nrowsa = na/ncolsa;
+   memset(cp,0,nrowsa*ncolsb*sizeof(Element));
+   TMatrixTKernels::MultAdd(nrowsa,Element(1),ap,ncolsa,1,ncolsa,bp,ncolsb,ncolsb,cp,ncolsb);
+   (void) nb;   // B has ncolsa rows
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -3100,30 +3099,36 @@ template<class Element>
 void AtMultB(const Element * const ap,Int_t ncolsa,
              const Element * const bp,Int_t nb,Int_t ncolsb,Element *cp)
 {
-   const Element *acp0 = ap;           // Pointer to  A[i,0];
-   while (acp0 < ap+ncolsa) {
-      for (const Element *bcp = bp; bcp < bp+ncolsb; ) { // Pointer to the j-th column of B, Start bcp = B[0,0]
-         const Element *acp = acp0;                       // Pointer to the i-th column of A, reset to A[0,i]
-         Element cij = 0;
-         while (bcp < bp+nb) {           // Scan the i-th column of A and
-            cij += *acp * *bcp;           // the j-th col of B
-            acp += ncolsa;
-            bcp += ncolsb;
-         }
-         *cp++ = cij;
-         bcp -= nb-1;                    // Set bcp to the (j+1)-th col
-      }
-      acp0++;                           // Set acp0 to the (i+1)-th col
-   }
+   if (ncolsb <= 0) return;
+   const Int_t nrowsb = nb/ncolsb;
+   memset(cp,0,ncolsa*ncolsb*sizeof(Element));
+   TMatrixTKernels::MultAdd(ncolsa,Element(1),ap,1,ncolsa,nrowsb,bp,ncolsb,ncolsb,cp,ncolsb);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Elementary routine to calculate matrix multiplication A*B^T
+///
+/// Large products transpose B in a work array and use the blocked kernel.
 
 template<class Element>
 void AMultBt(const Element * const ap,Int_t na,Int_t ncolsa,
              const Element * const bp,Int_t nb,Int_t ncolsb,Element *cp)
 {
+   // below this number of multiply-adds the row by row scalar products are faster
+   const Double_t kMinBlockedWork = 1 << 15;
+
+   if (ncolsb > 0 && Double_t(na)*nb/ncolsb >= kMinBlockedWork) {
+      const Int_t nrowsa = na/ncolsa;
+      const Int_t nrowsb = nb/ncolsb;
+      std::vector<Element> bt(nb);
+      for (Int_t i = 0; i < nrowsb; i++)
+         for (Int_t k = 0; k < ncolsb; k++)
+            bt[k*nrowsb+i] = bp[i*ncolsb+k];
+      memset(cp,0,nrowsa*nrowsb*sizeof(Element));
+      TMatrixTKernels::MultAdd(nrowsa,Element(1),ap,ncolsa,1,ncolsb,bt.data(),nrowsb,nrowsb,cp,nrowsb);
+      return;
+   }
+
    const Element *arp0 = ap;                    // Pointer to  A[i,0];
    while (arp0 < ap+na) {
       const Element *brp0 = bp;                  // Pointer to  B[j,0];
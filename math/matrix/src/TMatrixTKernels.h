@@ -0,0 +1,135 @@
+// @(#)root/matrix:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+// Cache-blocked multiplication kernels used internally by the matrix
+// multiplications and the blocked LU and Cholesky decompositions
+
+#ifndef ROOT_TMatrixTKernels
+#define ROOT_TMatrixTKernels
+
+#include "RConfigure.h"
+#include "Rtypes.h"
+
+#ifdef R__USE_IMT
+#include "TROOT.h"
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#endif
+
+namespace TMatrixTKernels {
+
+   enum {
+      kBlockK    = 128,     // rows of B kept in cache by the multiplication kernel
+      kBlockCols = 128,     // columns of B kept in cache by the multiplication kernel
+      kBlockDecomp = 64     // panel width of the blocked decompositions
+   };
+
+   // below this number of multiply-adds per call the threads do not pay off
+   const Double_t kMinParallelWork = 1 << 18;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Call f(first, last) on subranges of the rows [first, last), from several
+/// threads when implicit multithreading is enabled and the rows hold enough
+/// work. f must only write to its own rows.
+
+template <class F>
+void ForEachRowRange(Int_t first, Int_t last, Double_t workPerRow, F f)
+{
+   if (last <= first) return;
+#ifdef R__USE_IMT
+   if (ROOT::IsImplicitMTEnabled() && workPerRow * (last - first) >= kMinParallelWork) {
+      tbb::parallel_for(tbb::blocked_range<Int_t>(first, last),
+                        [&](const tbb::blocked_range<Int_t> &r) { f(r.begin(), r.end()); });
+      return;
+   }
+#else
+   (void) workPerRow;
+#endif
+   f(first, last);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add alpha * A * B to the rows [first, last) of C, where
+///  - A(i,k) = ap[i*arow+k*acol], k = 0,...,nk-1, so that A or A^T can be used ;
+///  - B(k,j) = bp[k*ldb+j] and C(i,j) = cp[i*ldc+j], j = 0,...,ncols-1 .
+/// B is traversed in blocks of kBlockK x kBlockCols which stay in cache while
+/// they are applied to all the rows, and the innermost loop runs along the
+/// contiguous rows of B and C so that it is vectorized by the compiler.
+/// Each C(i,j) receives its terms in increasing k, as in the textbook loop, so
+/// the result is the one of that loop unless the compiler contracts the
+/// multiply-adds into FMA instructions, which changes the last bits.
+/// If upper is true, C is square and only its upper triangle j >= i is updated.
+
+template <class Element>
+void MultAddRows(Int_t first, Int_t last, Element alpha,
+                 const Element *ap, Int_t arow, Int_t acol, Int_t nk,
+                 const Element *bp, Int_t ldb, Int_t ncols, Element *cp, Int_t ldc,
+                 Bool_t upper = kFALSE)
+{
+   for (Int_t kb = 0; kb < nk; kb += kBlockK) {
+      const Int_t ke = (kb+kBlockK < nk) ? kb+kBlockK : nk;
+      for (Int_t jb = 0; jb < ncols; jb += kBlockCols) {
+         const Int_t je = (jb+kBlockCols < ncols) ? jb+kBlockCols : ncols;
+         const Int_t iend = (upper && je < last) ? je : last;
+         Int_t i = first;
+         // micro-kernel: 4 rows of C share each load of a row of B
+         for (; i+4 <= iend && (!upper || i+3 <= jb); i += 4) {
+            Element * const crp0 = cp+i*ldc;
+            Element * const crp1 = crp0+ldc;
+            Element * const crp2 = crp1+ldc;
+            Element * const crp3 = crp2+ldc;
+            for (Int_t k = kb; k < ke; k++) {
+               const Element * const arp = ap+i*arow+k*acol;
+               const Element a0 = alpha*arp[0];
+               const Element a1 = alpha*arp[arow];
+               const Element a2 = alpha*arp[2*arow];
+               const Element a3 = alpha*arp[3*arow];
+               const Element * const brp = bp+k*ldb;
+               for (Int_t j = jb; j < je; j++) {
+                  const Element bkj = brp[j];
+                  crp0[j] += a0*bkj;
+                  crp1[j] += a1*bkj;
+                  crp2[j] += a2*bkj;
+                  crp3[j] += a3*bkj;
+               }
+            }
+         }
+         for (; i < iend; i++) {
+            Element * const crp = cp+i*ldc;
+            const Int_t j0 = (upper && i > jb) ? i : jb;
+            for (Int_t k = kb; k < ke; k++) {
+               const Element aik = alpha*ap[i*arow+k*acol];
+               const Element * const brp = bp+k*ldb;
+               for (Int_t j = j0; j < je; j++)
+                  crp[j] += aik*brp[j];
+            }
+         }
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add alpha * A * B to the nrows rows of C, see MultAddRows. The rows are
+/// shared among threads for large products.
+
+template <class Element>
+void MultAdd(Int_t nrows, Element alpha,
+             const Element *ap, Int_t arow, Int_t acol, Int_t nk,
+             const Element *bp, Int_t ldb, Int_t ncols, Element *cp, Int_t ldc,
+             Bool_t upper = kFALSE)
+{
+   ForEachRowRange(0, nrows, Double_t(nk)*ncols, [&](Int_t first, Int_t last) {
+      MultAddRows(first, last, alpha, ap, arow, acol, nk, bp, ldb, ncols, cp, ldc, upper);
+   });
+}
+
+}  // namespace TMatrixTKernels
+
+#endif
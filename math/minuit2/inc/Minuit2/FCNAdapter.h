@@ -14,6 +14,12 @@
 #include "Minuit2/FCNBase.h"
 #endif
 
+#ifndef ROOT_Math_FitMethodFunction
+#include "Math/FitMethodFunction.h"
+#endif
+
+#include <algorithm>
+
 namespace ROOT {
 
    namespace Minuit2 {
@@ -36,7 +42,9 @@ public:
 
    FCNAdapter(const Function & f, double up = 1.) :
       fFunc(f) ,
-      fUp (up)
+      fUp (up) ,
+      fThreadSafe(false),
+      fBatchFunc(0)
    {}
 
    ~FCNAdapter() {}
@@ -52,6 +60,28 @@ public:
 
    void SetErrorDef(double up) { fUp = up; }
 
+   /// declare that the wrapped function can be evaluated concurrently
+   void SetThreadSafe(bool on = true) { fThreadSafe = on; }
+
+   bool IsThreadSafe() const { return fThreadSafe; }
+
+   /// set the fit method function used to evaluate several points with a single pass over the data
+   /// (it must be the same function as the wrapped one)
+   void SetBatchFunction(const ROOT::Math::FitMethodFunction * f) { fBatchFunc = f; }
+
+   void EvaluateBatch(const std::vector<std::vector<double> >& x, std::vector<double>& f) const {
+      if (!fBatchFunc || x.empty() ) {
+         FCNBase::EvaluateBatch(x, f);
+         return;
+      }
+      unsigned int npar = x[0].size();
+      std::vector<double> points(x.size() * npar);
+      for (unsigned int k = 0; k < x.size(); ++k)
+         std::copy(x[k].begin(), x[k].end(), points.begin() + k * npar);
+      f.resize(x.size());
+      fBatchFunc->EvalBatch(x.size(), &points[0], &f[0]);
+   }
+
    //virtual std::vector<double> Gradient(const std::vector<double>&) const;
 
    // forward interface
@@ -60,6 +90,8 @@ public:
 private:
    const Function & fFunc;
    double fUp;
+   bool fThreadSafe;
+   const ROOT::Math::FitMethodFunction * fBatchFunc;
 };
 
    } // end namespace Minuit2
@@ -77,6 +77,18 @@ public:
 
    virtual double operator()(const std::vector<double>& x) const = 0;
 
+   /**
+      Evaluate the function at several points of the parameter space and store
+      the values in f. It is used for the numerical derivatives, which need many
+      points at once. The default implementation calls operator() for each point;
+      re-implement it when the function can evaluate all the points with a single
+      pass over its data.
+   */
+   virtual void EvaluateBatch(const std::vector<std::vector<double> >& x, std::vector<double>& f) const {
+      f.resize(x.size());
+      for (unsigned int k = 0; k < x.size(); ++k) f[k] = (*this)(x[k]);
+   }
+
 
    /**
 
@@ -113,6 +125,14 @@ public:
    */
    virtual void SetErrorDef(double ) {};
 
+   /**
+       return true if the function can be evaluated concurrently from several threads.
+       In that case, when implicit multi-threading is enabled in ROOT, the numerical
+       derivatives, the Hessian and the Minos errors are computed in parallel.
+       Re-implement this function if operator() has no side effects.
+   */
+   virtual bool IsThreadSafe() const { return false; }
+
 };
 
   }  // namespace Minuit2
@@ -14,6 +14,7 @@
 #include "Minuit2/MnMatrix.h"
 
 #include <vector>
+#include <atomic>
 
 namespace ROOT {
 
@@ -42,6 +43,10 @@ public:
   virtual double operator()(const MnAlgebraicVector&) const;
   unsigned int NumOfCalls() const {return fNumCall;}
 
+  /// evaluate the function at all the points v with a single call to FCNBase::EvaluateBatch,
+  /// or concurrently when the FCN is thread safe
+  void EvaluateBatch(const std::vector<MnAlgebraicVector>& v, std::vector<double>& f) const;
+
   //
   //forward interface
   //
@@ -56,7 +61,10 @@ private:
 
 protected:
 
-  mutable int fNumCall;
+  /// convert the internal parameter values in the vector passed to the FCN
+  virtual std::vector<double> Transform(const MnAlgebraicVector& v) const;
+
+  mutable std::atomic<int> fNumCall;  // atomic since a thread-safe FCN can be called concurrently
 };
 
   }  // namespace Minuit2
@@ -34,6 +34,10 @@ public:
 
   virtual double operator()(const MnAlgebraicVector&) const;
 
+protected:
+
+  virtual std::vector<double> Transform(const MnAlgebraicVector&) const;
+
 private:
 
   const MnUserTransformation& fTransform;
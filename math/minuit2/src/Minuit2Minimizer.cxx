@@ -38,6 +38,7 @@
 #include "Minuit2/MnContours.h"
 #include "Minuit2/MnTraceObject.h"
 #include "Minuit2/MinimumBuilder.h"
+#include "MnParallel.h"
 
 #include <cassert>
 #include <iostream>
@@ -346,7 +347,23 @@ void Minuit2Minimizer::SetFunction(const  ROOT::Math::IMultiGenFunction & func)
    if (fMinuitFCN) delete fMinuitFCN;
    fDim = func.NDim();
    if (!fUseFumili) {
-      fMinuitFCN = new ROOT::Minuit2::FCNAdapter<ROOT::Math::IMultiGenFunction> (func, ErrorDef() );
+      ROOT::Minuit2::FCNAdapter<ROOT::Math::IMultiGenFunction> * fcn = new ROOT::Minuit2::FCNAdapter<ROOT::Math::IMultiGenFunction> (func, ErrorDef() );
+      // the function can be declared thread safe with the extra option "ThreadSafeFCN"
+      // to evaluate the numerical derivatives, the Hessian and the Minos errors in parallel
+      int threadSafe = 0;
+      ROOT::Math::IOptions * minuit2Opt = ROOT::Math::MinimizerOptions::FindDefault("Minuit2");
+      if (minuit2Opt) minuit2Opt->GetValue("ThreadSafeFCN",threadSafe);
+      const ROOT::Math::FitMethodFunction * fitFunc = dynamic_cast<const ROOT::Math::FitMethodFunction *>(&func);
+      if (threadSafe && fitFunc) {
+         // the fit method functions (chi2, likelihoods) count their calls and set the
+         // parameters of the shared model function, so they cannot run concurrently
+         MN_INFO_MSG2("Minuit2Minimizer::SetFunction","the fit method functions are not thread safe: option ThreadSafeFCN is ignored");
+         threadSafe = 0;
+      }
+      fcn->SetThreadSafe(threadSafe != 0);
+      // the fit method functions evaluate the points needed by the numerical derivatives with a single pass over the data
+      fcn->SetBatchFunction(fitFunc);
+      fMinuitFCN = fcn;
    }
    else {
       // for Fumili the fit method function interface is required
@@ -827,8 +844,11 @@ bool Minuit2Minimizer::GetMinosError(unsigned int i, double & errLow, double & e
    }
 
 
-   if (runLower) low = minos.Loval(i,maxfcn,tol);
-   if (runUpper) up  = minos.Upval(i,maxfcn,tol);
+   // the lower and upper crossings are independent: run them concurrently when the FCN is thread safe
+   MnParallelFor(2, runLower && runUpper && MnUseParallel(*fMinuitFCN), [&](unsigned int k) {
+      if (k == 0 && runLower) low = minos.Loval(i,maxfcn,tol);
+      if (k == 1 && runUpper) up  = minos.Upval(i,maxfcn,tol);
+   });
 
    ROOT::Minuit2::MinosError me(i, fMinimum->UserState().Value(i),low, up);
 
@@ -10,6 +10,7 @@
 #include "Minuit2/MnFcn.h"
 #include "Minuit2/FCNBase.h"
 #include "Minuit2/MnVectorTransform.h"
+#include "MnParallel.h"
 
 namespace ROOT {
 
@@ -23,7 +24,27 @@ MnFcn::~MnFcn() {
 double MnFcn::operator()(const MnAlgebraicVector& v) const {
    // evaluate FCN converting from from MnAlgebraicVector to std::vector
    fNumCall++;
-   return fFCN(MnVectorTransform()(v));
+   return fFCN(Transform(v));
+}
+
+void MnFcn::EvaluateBatch(const std::vector<MnAlgebraicVector>& v, std::vector<double>& f) const {
+   // evaluate FCN at all the points v. A thread safe FCN is called concurrently for each point,
+   // otherwise all the points are passed at once to FCNBase::EvaluateBatch
+   unsigned int n = v.size();
+   f.resize(n);
+   if (n == 0) return;
+   if (MnUseParallel(fFCN)) {
+      MnParallelFor(n, true, [&](unsigned int k) { f[k] = (*this)(v[k]); });
+      return;
+   }
+   std::vector<std::vector<double> > x(n);
+   for (unsigned int k = 0; k < n; ++k) x[k] = Transform(v[k]);
+   fNumCall += n;
+   fFCN.EvaluateBatch(x, f);
+}
+
+std::vector<double> MnFcn::Transform(const MnAlgebraicVector& v) const {
+   return MnVectorTransform()(v);
 }
 
 // double MnFcn::operator()(const std::vector<double>& par) const {
@@ -29,6 +29,7 @@
 #endif
 
 #include "Minuit2/MPIProcess.h"
+#include "MnParallel.h"
 
 namespace ROOT {
 
@@ -246,37 +247,55 @@ L30:
    //off-diagonal Elements
    // initial starting values
    MPIProcess mpiprocOffDiagonal(n*(n-1)/2,0);
-   unsigned int startParIndexOffDiagonal = mpiprocOffDiagonal.StartElementIndex();
-   unsigned int endParIndexOffDiagonal = mpiprocOffDiagonal.EndElementIndex();
+   if (mpiprocOffDiagonal.GetMPISize() == 1) {
+      // the rows are independent: compute them concurrently when the FCN is thread safe.
+      // The points of a row are evaluated with a single call (see FCNBase::EvaluateBatch).
+      // The result is identical to the sequential loop
+      MnParallelFor(n > 0 ? n-1 : 0, MnUseParallel(mfcn.Fcn()), [&](unsigned int i) {
+         std::vector<MnAlgebraicVector> points(n-1-i, x);
+         for (unsigned int j = i+1; j < n; j++) {
+            points[j-i-1](i) += dirin(i);
+            points[j-i-1](j) += dirin(j);
+         }
+         std::vector<double> fs1;
+         mfcn.EvaluateBatch(points, fs1);
+         for (unsigned int j = i+1; j < n; j++)
+            vhmat(i,j) = (fs1[j-i-1] + amin - yy(i) - yy(j))/(dirin(i)*dirin(j));
+      });
+   }
+   else {
+      unsigned int startParIndexOffDiagonal = mpiprocOffDiagonal.StartElementIndex();
+      unsigned int endParIndexOffDiagonal = mpiprocOffDiagonal.EndElementIndex();
 
-   unsigned int offsetVect = 0;
-   for (unsigned int in = 0; in<startParIndexOffDiagonal; in++)
-      if ((in+offsetVect)%(n-1)==0) offsetVect += (in+offsetVect)/(n-1);
+      unsigned int offsetVect = 0;
+      for (unsigned int in = 0; in<startParIndexOffDiagonal; in++)
+         if ((in+offsetVect)%(n-1)==0) offsetVect += (in+offsetVect)/(n-1);
 
-   for (unsigned int in = startParIndexOffDiagonal;
-        in<endParIndexOffDiagonal; in++) {
+      for (unsigned int in = startParIndexOffDiagonal;
+           in<endParIndexOffDiagonal; in++) {
 
-      int i = (in+offsetVect)/(n-1);
-      if ((in+offsetVect)%(n-1)==0) offsetVect += i;
-      int j = (in+offsetVect)%(n-1)+1;
+         int i = (in+offsetVect)/(n-1);
+         if ((in+offsetVect)%(n-1)==0) offsetVect += i;
+         int j = (in+offsetVect)%(n-1)+1;
 
-      if ((i+1)==j || in==startParIndexOffDiagonal)
-         x(i) += dirin(i);
+         if ((i+1)==j || in==startParIndexOffDiagonal)
+            x(i) += dirin(i);
 
-      x(j) += dirin(j);
+         x(j) += dirin(j);
 
-      double fs1 = mfcn(x);
-      double elem = (fs1 + amin - yy(i) - yy(j))/(dirin(i)*dirin(j));
-      vhmat(i,j) = elem;
+         double fs1 = mfcn(x);
+         double elem = (fs1 + amin - yy(i) - yy(j))/(dirin(i)*dirin(j));
+         vhmat(i,j) = elem;
 
-      x(j) -= dirin(j);
+         x(j) -= dirin(j);
 
-      if (j%(n-1)==0 || in==endParIndexOffDiagonal-1)
-         x(i) -= dirin(i);
+         if (j%(n-1)==0 || in==endParIndexOffDiagonal-1)
+            x(i) -= dirin(i);
 
-   }
+      }
 
-   mpiprocOffDiagonal.SyncSymMatrixOffDiagonal(vhmat);
+      mpiprocOffDiagonal.SyncSymMatrixOffDiagonal(vhmat);
+   }
 
    //verify if matrix pos-def (still 2nd derivative)
 
@@ -13,6 +13,7 @@
 #include "Minuit2/MnFunctionCross.h"
 #include "Minuit2/MnCross.h"
 #include "Minuit2/MinosError.h"
+#include "MnParallel.h"
 
 //#define DEBUG
 
@@ -91,13 +92,17 @@ MinosError MnMinos::Minos(unsigned int par, unsigned int maxcalls, double toler)
    assert(!fMinimum.UserState().Parameter(par).IsFixed());
    assert(!fMinimum.UserState().Parameter(par).IsConst());
 
-   MnCross up = Upval(par, maxcalls,toler);
+   // the two crossings are independent and run concurrently when the FCN is thread safe
+   MnCross up;
+   MnCross lo;
+   MnParallelFor(2, MnUseParallel(fFCN), [&](unsigned int k) {
+      if (k == 0) up = Upval(par, maxcalls,toler);
+      else        lo = Loval(par, maxcalls,toler);
+   });
 #ifdef DEBUG
    std::cout << "Function calls to find upper error " << up.NFcn() << std::endl;
 #endif
 
-   MnCross lo = Loval(par, maxcalls,toler);
-
 #ifdef DEBUG
    std::cout << "Function calls to find lower error " << lo.NFcn() << std::endl;
 #endif
@@ -105,6 +110,23 @@ MinosError MnMinos::Minos(unsigned int par, unsigned int maxcalls, double toler)
    return MinosError(par, fMinimum.UserState().Value(par), lo, up);
 }
 
+std::vector<MinosError> MnMinos::Minos(const std::vector<unsigned int>& pars, unsigned int maxcalls, double toler) const {
+   // do full minos error analysis for all the given parameters
+   // all the crossings (lower and upper for each parameter) run concurrently when the FCN is thread safe
+   assert(fMinimum.IsValid());
+   unsigned int npar = pars.size();
+   std::vector<MnCross> cross(2*npar);
+   MnParallelFor(2*npar, MnUseParallel(fFCN), [&](unsigned int k) {
+      cross[k] = FindCrossValue( (k%2 == 0) ? -1 : 1, pars[k/2], maxcalls, toler);
+   });
+
+   std::vector<MinosError> result;
+   result.reserve(npar);
+   for (unsigned int i = 0; i < npar; ++i)
+      result.push_back(MinosError(pars[i], fMinimum.UserState().Value(pars[i]), cross[2*i], cross[2*i+1]) );
+   return result;
+}
+
 
 MnCross MnMinos::FindCrossValue(int direction, unsigned int par, unsigned int maxcalls, double toler) const {
    // get crossing value in the parameter direction :
@@ -0,0 +1,67 @@
+// @(#)root/minuit2:$Id$
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2016 LCG ROOT Math team,  CERN/PH-SFT                *
+ *                                                                    *
+ **********************************************************************/
+
+#ifndef ROOT_Minuit2_MnParallel
+#define ROOT_Minuit2_MnParallel
+
+#include "Minuit2/FCNBase.h"
+
+#ifdef USE_ROOT_ERROR
+#include "RConfigure.h"
+#endif
+
+#ifdef R__USE_IMT
+#include "TROOT.h"
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+#endif
+
+/// utility functions to spread independent function evaluations over the ROOT thread pool
+
+namespace ROOT {
+
+   namespace Minuit2 {
+
+/**
+   return true if the FCN evaluations can run concurrently, i.e. the function
+   is declared thread safe and implicit multi-threading is enabled in ROOT
+*/
+inline bool MnUseParallel(const FCNBase& fcn) {
+#ifdef R__USE_IMT
+   return fcn.IsThreadSafe() && ROOT::IsImplicitMTEnabled();
+#else
+   (void) fcn;
+   return false;
+#endif
+}
+
+/**
+   call func(i) for i = 0,...,n-1. The calls are distributed on the ROOT thread pool
+   when parallel is true, otherwise they are done in sequence
+*/
+template<class Func>
+void MnParallelFor(unsigned int n, bool parallel, const Func& func) {
+#ifdef R__USE_IMT
+   if (parallel && n > 1) {
+      tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n, 1),
+                        [&](const tbb::blocked_range<unsigned int>& r) {
+                           for (unsigned int i = r.begin(); i != r.end(); ++i) func(i);
+                        });
+      return;
+   }
+#else
+   (void) parallel;
+#endif
+   for (unsigned int i = 0; i < n; ++i) func(i);
+}
+
+   }  // namespace Minuit2
+
+}  // namespace ROOT
+
+#endif  // ROOT_Minuit2_MnParallel
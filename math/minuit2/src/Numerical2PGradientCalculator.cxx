@@ -20,13 +20,6 @@
 //#define DEBUG
 #if defined(DEBUG) || defined(WARNINGMSG)
 #include "Minuit2/MnPrint.h"
-#ifdef _OPENMP
-#include <omp.h>
-#include <iomanip>
-#ifdef DEBUG
-#define DEBUG_MP
-#endif
-#endif
 #endif
 
 #include <math.h>
@@ -100,9 +93,7 @@ FunctionGradient Numerical2PGradientCalculator::operator()(const MinimumParamete
    MnAlgebraicVector g2 = Gradient.G2();
    MnAlgebraicVector gstep = Gradient.Gstep();
 
-#ifndef _OPENMP
    MPIProcess mpiproc(n,0);
-#endif
 
 #ifdef DEBUG
    std::cout << "Calculating Gradient at x =   " << par.Vec() << std::endl;
@@ -111,42 +102,30 @@ FunctionGradient Numerical2PGradientCalculator::operator()(const MinimumParamete
    std::cout.precision(pr);
 #endif
 
-#ifndef _OPENMP
-   // for serial execution this can be outside the loop
-   MnAlgebraicVector x = par.Vec();
-
    unsigned int startElementIndex = mpiproc.StartElementIndex();
    unsigned int endElementIndex = mpiproc.EndElementIndex();
 
+   const MnAlgebraicVector& x = par.Vec();
+   std::vector<double> epspri(n);
+   std::vector<double> stepb4(n, 0.);
+   std::vector<unsigned int> active;
    for(unsigned int i = startElementIndex; i < endElementIndex; i++) {
+      epspri[i] = eps2 + fabs(grd(i)*eps2);
+      active.push_back(i);
+   }
 
-#else
-
- // parallelize this loop using OpenMP
-//#define N_PARALLEL_PAR 5
-#pragma omp parallel
-#pragma omp for
-//#pragma omp for schedule (static, N_PARALLEL_PAR)
-
-   for(int i = 0; i < int(n); i++) {
-
-#endif
-
-#ifdef DEBUG_MP
-      int ith = omp_get_thread_num();
-      //std::cout << "Thread number " << ith << "  " << i << std::endl;
-#endif
-
-#ifdef _OPENMP
-       // create in loop since each thread will use its own copy
-      MnAlgebraicVector x = par.Vec();
-#endif
-
-      double xtf = x(i);
-      double epspri = eps2 + fabs(grd(i)*eps2);
-      double stepb4 = 0.;
-      for(unsigned int j = 0; j < ncycle; j++)  {
-         double optstp = sqrt(dfmin/(fabs(g2(i))+epspri));
+   // the cycles are done for all the parameters together: the points needed by the parameters
+   // still being refined are evaluated with a single call to the FCN (see FCNBase::EvaluateBatch),
+   // which lets a function reading large data sets evaluate them all in one pass
+   std::vector<unsigned int> evaluated;
+   std::vector<MnAlgebraicVector> points;
+   std::vector<double> fvals;
+   for(unsigned int j = 0; j < ncycle && active.size() > 0; j++)  {
+      evaluated.clear();
+      points.clear();
+      for(unsigned int k = 0; k < active.size(); k++) {
+         unsigned int i = active[k];
+         double optstp = sqrt(dfmin/(fabs(g2(i))+epspri[i]));
          double step = std::max(optstp, fabs(0.1*gstep(i)));
          //       std::cout<<"step: "<<step;
          if(Trafo().Parameter(Trafo().ExtOfInt(i)).HasLimits()) {
@@ -159,24 +138,31 @@ FunctionGradient Numerical2PGradientCalculator::operator()(const MinimumParamete
          if(step < stpmin) step = stpmin;
          //       std::cout<<" "<<step<<std::endl;
          //       std::cout<<"step: "<<step<<std::endl;
-         if(fabs((step-stepb4)/step) < StepTolerance()) {
+         if(fabs((step-stepb4[i])/step) < StepTolerance()) {
             //    std::cout<<"(step-stepb4)/step"<<std::endl;
             //    std::cout<<"j= "<<j<<std::endl;
             //    std::cout<<"step= "<<step<<std::endl;
-            break;
+            continue;
          }
          gstep(i) = step;
-         stepb4 = step;
-         //       MnAlgebraicVector pstep(n);
-         //       pstep(i) = step;
-         //       double fs1 = Fcn()(pstate + pstep);
-         //       double fs2 = Fcn()(pstate - pstep);
-
-         x(i) = xtf + step;
-         double fs1 = Fcn()(x);
-         x(i) = xtf - step;
-         double fs2 = Fcn()(x);
-         x(i) = xtf;
+         stepb4[i] = step;
+
+         MnAlgebraicVector xs = x;
+         xs(i) = x(i) + step;
+         points.push_back(xs);
+         xs(i) = x(i) - step;
+         points.push_back(xs);
+         evaluated.push_back(i);
+      }
+
+      Fcn().EvaluateBatch(points, fvals);
+
+      active.clear();
+      for(unsigned int k = 0; k < evaluated.size(); k++) {
+         unsigned int i = evaluated[k];
+         double step = gstep(i);
+         double fs1 = fvals[2*k];
+         double fs2 = fvals[2*k+1];
 
          double grdb4 = grd(i);
          grd(i) = 0.5*(fs1 - fs2)/step;
@@ -194,36 +180,24 @@ FunctionGradient Numerical2PGradientCalculator::operator()(const MinimumParamete
             //    std::cout<<"step= "<<step<<std::endl;
             //    std::cout<<"fs1, fs2: "<<fs1<<" "<<fs2<<std::endl;
             //    std::cout<<"fs1-fs2: "<<fs1-fs2<<std::endl;
-            break;
+            continue;
          }
+         active.push_back(i);
       }
-
-
-#ifdef DEBUG_MP
-#pragma omp critical
-      {
-         std::cout << "Gradient for thread " << ith << "  " << i << "  " << std::setprecision(15)  << grd(i) << "  " << g2(i) << std::endl;
-      }
-#endif
-
-      //     vgrd(i) = grd;
-      //     vgrd2(i) = g2;
-      //     vgstp(i) = gstep;
-
+   }
 
 #ifdef DEBUG
+   for(unsigned int i = startElementIndex; i < endElementIndex; i++) {
       pr = std::cout.precision(13);
       int iext = Trafo().ExtOfInt(i);
       std::cout << "Parameter " << Trafo().Name(iext) << " Gradient =   " << grd(i) << " g2 = " << g2(i) << " step " << gstep(i) << std::endl;
       std::cout.precision(pr);
-#endif
    }
+#endif
 
-#ifndef _OPENMP
    mpiproc.SyncVector(grd);
    mpiproc.SyncVector(g2);
    mpiproc.SyncVector(gstep);
-#endif
 
    return FunctionGradient(grd, g2, gstep);
 }
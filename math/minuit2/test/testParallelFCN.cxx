@@ -0,0 +1,348 @@
+// test of the parallel evaluation of the numerical derivatives, of the Hessian and of the
+// Minos errors in Minuit2 for a thread safe FCN. The results obtained with implicit
+// multi-threading enabled must be identical to the sequential ones.
+// The fit method functions (chi2) must not be evaluated concurrently, even when the
+// option ThreadSafeFCN is set.
+// The numerical gradient and the Hessian computed with batches of points (FCNBase::EvaluateBatch)
+// must be the ones of the point-by-point evaluation, with the same number of calls
+
+#include "Minuit2/FCNBase.h"
+#include "Minuit2/FunctionMinimum.h"
+#include "Minuit2/MnMigrad.h"
+#include "Minuit2/MnHesse.h"
+#include "Minuit2/MnMinos.h"
+#include "Minuit2/MinosError.h"
+#include "Minuit2/MnUserParameterState.h"
+#include "Minuit2/MnUserParameters.h"
+#include "Minuit2/MnUserFcn.h"
+#include "Minuit2/MnStrategy.h"
+#include "Minuit2/MinimumParameters.h"
+#include "Minuit2/FunctionGradient.h"
+#include "Minuit2/Numerical2PGradientCalculator.h"
+
+#include "Fit/Fitter.h"
+#include "Fit/BinData.h"
+#include "Math/WrappedMultiTF1.h"
+#include "Math/MinimizerOptions.h"
+#include "Math/GenAlgoOptions.h"
+
+#include "TF1.h"
+#include "TRandom3.h"
+#include "TROOT.h"
+#include "RConfigure.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <iostream>
+
+using namespace ROOT::Minuit2;
+
+// negative log-likelihood of a multi-dimensional gaussian with independent
+// coordinates: the evaluation has no side effects
+class MultiGausLogL : public FCNBase {
+public:
+   MultiGausLogL(const std::vector<std::vector<double> > & data) : fData(data) {}
+
+   double operator() (const std::vector<double> & p) const {
+      double logl = 0;
+      for (unsigned int i = 0; i < fData.size(); ++i) {
+         for (unsigned int k = 0; k < fData[i].size(); ++k) {
+            double t = (fData[i][k] - p[2*k]) / p[2*k+1];
+            logl += 0.5 * t * t + std::log(std::fabs(p[2*k+1]));
+         }
+      }
+      return logl;
+   }
+   double Up() const { return 0.5; }
+   bool IsThreadSafe() const { return true; }
+
+private:
+   const std::vector<std::vector<double> > & fData;
+};
+
+int compareResult(double v1, double v2, const std::string & s, double tol = 1.E-12) {
+   // compare v1 with reference v2
+   if (std::fabs(v1-v2) <= tol * std::fabs(v2) ) return 0;
+   std::cerr << s << " Failed comparison  \t value = " << v1 << "   it should be = " << v2 << std::endl;
+   return -1;
+}
+
+struct MinuitResult {
+   std::vector<double> fValues;
+   std::vector<double> fCov;
+   std::vector<double> fLower;
+   std::vector<double> fUpper;
+   double fFval;
+   int fNFcn;
+};
+
+// minimize, compute the Hessian and the Minos errors of all parameters
+MinuitResult doMinuit(const FCNBase & fcn, unsigned int npar, bool minosVector) {
+   std::vector<double> par(npar), err(npar, 0.1);
+   for (unsigned int k = 0; k < npar; ++k) par[k] = (k % 2) ? 1.5 : 0.;
+
+   MnMigrad migrad(fcn, par, err);
+   FunctionMinimum min = migrad();
+
+   MinuitResult res;
+   res.fFval = min.Fval();
+   res.fNFcn = min.NFcn();
+   MnHesse hesse;
+   MnUserParameterState state = hesse(fcn, min.UserState());
+   for (unsigned int i = 0; i < npar; ++i) {
+      res.fValues.push_back(state.Value(i));
+      for (unsigned int j = 0; j <= i; ++j) res.fCov.push_back(state.Covariance()(i,j));
+   }
+
+   MnMinos minos(fcn, min);
+   std::vector<MinosError> errors;
+   if (minosVector) {
+      std::vector<unsigned int> pars(npar);
+      for (unsigned int i = 0; i < npar; ++i) pars[i] = i;
+      errors = minos.Minos(pars);
+   }
+   else {
+      for (unsigned int i = 0; i < npar; ++i) errors.push_back(minos.Minos(i));
+   }
+   for (unsigned int i = 0; i < npar; ++i) {
+      res.fLower.push_back(errors[i].Lower());
+      res.fUpper.push_back(errors[i].Upper());
+   }
+   return res;
+}
+
+int compareMinuit(const MinuitResult & r, const MinuitResult & ref, const std::string & name, double tol = 1.E-12) {
+   int iret = 0;
+   iret |= compareResult(r.fFval, ref.fFval, name + " fval", tol);
+   if (r.fNFcn != ref.fNFcn) {
+      std::cerr << name << " Failed comparison of the number of calls " << r.fNFcn << " should be " << ref.fNFcn << std::endl;
+      iret = -1;
+   }
+   for (unsigned int i = 0; i < ref.fValues.size(); ++i) {
+      iret |= compareResult(r.fValues[i], ref.fValues[i], name + " value " + std::to_string(i), tol);
+      iret |= compareResult(r.fLower[i], ref.fLower[i], name + " Minos lower " + std::to_string(i), tol);
+      iret |= compareResult(r.fUpper[i], ref.fUpper[i], name + " Minos upper " + std::to_string(i), tol);
+   }
+   for (unsigned int i = 0; i < ref.fCov.size(); ++i)
+      iret |= compareResult(r.fCov[i], ref.fCov[i], name + " covariance " + std::to_string(i), tol);
+   return iret;
+}
+
+int testThreadSafeFCN() {
+   const int ndim = 4;
+   const int ndata = 2000;
+   TRandom3 rndm(4357);
+   std::vector<std::vector<double> > data(ndata, std::vector<double>(ndim));
+   for (int i = 0; i < ndata; ++i)
+      for (int k = 0; k < ndim; ++k) data[i][k] = rndm.Gaus(k - 1., 1. + 0.2 * k);
+
+   MultiGausLogL fcn(data);
+   MinuitResult seq = doMinuit(fcn, 2 * ndim, false);
+   int iret = 0;
+   // the Minos errors of several parameters must be the ones of the single parameters
+   MinuitResult seqVec = doMinuit(fcn, 2 * ndim, true);
+   iret |= compareMinuit(seqVec, seq, "sequential Minos(vector)", 0);
+
+#ifdef R__USE_IMT
+   ROOT::EnableImplicitMT();
+   MinuitResult par = doMinuit(fcn, 2 * ndim, false);
+   MinuitResult parVec = doMinuit(fcn, 2 * ndim, true);
+   ROOT::DisableImplicitMT();
+   iret |= compareMinuit(par, seq, "parallel");
+   iret |= compareMinuit(parVec, seq, "parallel Minos(vector)");
+#endif
+
+   if (iret != 0) std::cerr << "testThreadSafeFCN :\t FAILED " << std::endl;
+   else std::cout << "testThreadSafeFCN :\t OK " << std::endl;
+   return iret;
+}
+
+// fit a gaussian to a histogram-like data set with the chi2 method function
+ROOT::Fit::FitResult doChi2Fit(const ROOT::Fit::BinData & data) {
+   TF1 f1("fgaus", "gaus", -5, 5);
+   f1.SetParameters(10, 0.2, 1.5);
+   ROOT::Math::WrappedMultiTF1 wf(f1, 1);
+   ROOT::Fit::Fitter fitter;
+   fitter.SetFunction(wf, false);
+   fitter.Config().SetMinimizer("Minuit2");
+   fitter.Config().SetMinosErrors(true);
+   fitter.Fit(data);
+   return fitter.Result();
+}
+
+int testChi2ThreadSafeOption() {
+   TRandom3 rndm(111);
+   ROOT::Fit::BinData data(100);
+   for (int i = 0; i < 100; ++i) {
+      double x = -5. + 0.1 * (i + 0.5);
+      double y = rndm.Poisson(100. * std::exp(-0.5 * x * x) + 1.);
+      data.Add(x, y, std::sqrt(y + 1.));
+   }
+
+   ROOT::Fit::FitResult ref = doChi2Fit(data);
+
+   ROOT::Math::IOptions & opt = ROOT::Math::GenAlgoOptions::Default("Minuit2");
+   opt.SetValue("ThreadSafeFCN", 1);
+#ifdef R__USE_IMT
+   ROOT::EnableImplicitMT();
+#endif
+   ROOT::Fit::FitResult res = doChi2Fit(data);
+#ifdef R__USE_IMT
+   ROOT::DisableImplicitMT();
+#endif
+   opt.SetValue("ThreadSafeFCN", 0);
+
+   int iret = 0;
+   iret |= compareResult(res.MinFcnValue(), ref.MinFcnValue(), "chi2 fval");
+   for (unsigned int i = 0; i < ref.NPar(); ++i) {
+      iret |= compareResult(res.Parameter(i), ref.Parameter(i), "chi2 parameter " + std::to_string(i));
+      iret |= compareResult(res.Error(i), ref.Error(i), "chi2 error " + std::to_string(i));
+      iret |= compareResult(res.LowerError(i), ref.LowerError(i), "chi2 Minos lower " + std::to_string(i));
+      iret |= compareResult(res.UpperError(i), ref.UpperError(i), "chi2 Minos upper " + std::to_string(i));
+   }
+
+   if (iret != 0) std::cerr << "testChi2ThreadSafeOption :\t FAILED " << std::endl;
+   else std::cout << "testChi2ThreadSafeOption :\t OK " << std::endl;
+   return iret;
+}
+
+// function with correlated parameters and no side effects
+class DerivativeFCN : public FCNBase {
+public:
+   DerivativeFCN(bool threadSafe = false) : fThreadSafe(threadSafe) {}
+
+   double operator() (const std::vector<double> & p) const {
+      double a = p[1] - p[0] * p[0];
+      double b = 1. - p[0];
+      double c = p[2] - 0.5 * p[1];
+      double d = std::exp(-p[3]) + p[3] - 1.2;
+      return 10. * a * a + b * b + 4. * c * c + 3. * d * d + 0.3 * p[0] * p[2] + 0.4 * p[1] * p[3];
+   }
+   double Up() const { return 1.; }
+   bool IsThreadSafe() const { return fThreadSafe; }
+
+private:
+   bool fThreadSafe;
+};
+
+// same function evaluating the batches of points itself, in reverse order
+class DerivativeBatchFCN : public DerivativeFCN {
+public:
+   DerivativeBatchFCN() : fNBatch(0), fNPoints(0) {}
+
+   void EvaluateBatch(const std::vector<std::vector<double> > & x, std::vector<double> & f) const {
+      f.resize(x.size());
+      for (unsigned int k = x.size(); k > 0; --k) f[k-1] = (*this)(x[k-1]);
+      ++fNBatch;
+      fNPoints += x.size();
+   }
+
+   mutable int fNBatch;
+   mutable int fNPoints;
+};
+
+MnUserParameters derivativePars(double a, double b, double c, double d) {
+   MnUserParameters upar;
+   upar.Add("a", a, 0.1);
+   upar.Add("b", b, 0.1);
+   upar.Add("c", c, 0.1, -2., 2.);
+   upar.Add("d", d, 0.2, 0., 5.);
+   return upar;
+}
+
+// compare the numerical gradient (value, second derivative and step) and the Hesse covariance
+// with the reference values obtained with the point-by-point algorithm
+int checkDerivatives(const FCNBase & fcn, unsigned int istra, const std::string & name) {
+   // gradient, second derivative and step of the 4 parameters with strategy 0 and 1 (2 is as 1)
+   const double refGrad[2][12] = {
+      { -25.430001367550979, 134.80000042841127, 0.00016879187114727157,
+        -7.7999999999993008, 22.000000011529785, 0.00041781608480918967,
+        -3.8756495489915417, 31.867997366515301, 0.00050595249814385553,
+        0.26901049955629958, 1.6833944800320739, 0.0013602994076048554 },
+      { -25.430001367550979, 134.80000042841127, 0.00016879187114727157,
+        -7.7999999999993008, 22.000000011529785, 0.00041781608480918967,
+        -3.8756493150405098, 31.867998765145551, 0.00034715154718885848,
+        0.26901049955629958, 1.6833944800320739, 0.0013602994076048554 } };
+   const unsigned int refGradCalls[2] = { 13, 15 };
+   // covariance (lower triangle) computed by Hesse at a point close to the minimum
+   const double refCov[10] = {
+      0.76918973021376968,
+      0.92189923697854526, 1.2054198093346413,
+      0.43153568914993357, 0.56739013935323623, 0.51683151016929219,
+      -0.23226893875584098, -0.30370084778129564, -0.14295174599699501, 1.3360116403872053 };
+   const unsigned int refHesseCalls[2] = { 32, 40 };
+
+   const unsigned int iref = (istra > 0) ? 1 : 0;
+   const std::string s = name + " strategy " + std::to_string(istra);
+   const double tol = 1.E-8;
+   int iret = 0;
+
+   MnUserParameterState st(derivativePars(-1.2, 1.0, 0.3, 0.5));
+   MnUserFcn mfcn(fcn, st.Trafo());
+   MnStrategy stra(istra);
+   Numerical2PGradientCalculator gc(mfcn, st.Trafo(), stra);
+   const std::vector<double> & ip = st.IntParameters();
+   MnAlgebraicVector v(ip.size());
+   for (unsigned int i = 0; i < ip.size(); ++i) v(i) = ip[i];
+   MinimumParameters par(v, mfcn(v));
+   FunctionGradient g = gc(par);
+   for (unsigned int i = 0; i < 4; ++i) {
+      iret |= compareResult(g.Vec()(i), refGrad[iref][3*i], s + " gradient " + std::to_string(i), tol);
+      iret |= compareResult(g.G2()(i), refGrad[iref][3*i+1], s + " G2 " + std::to_string(i), tol);
+      iret |= compareResult(g.Gstep()(i), refGrad[iref][3*i+2], s + " Gstep " + std::to_string(i), tol);
+   }
+   if (mfcn.NumOfCalls() != refGradCalls[iref]) {
+      std::cerr << s << " Failed comparison of the number of gradient calls " << mfcn.NumOfCalls()
+                << " should be " << refGradCalls[iref] << std::endl;
+      iret = -1;
+   }
+
+   MnHesse hesse(istra);
+   MnUserParameterState hs = hesse(fcn, derivativePars(0.6, 0.35, 0.1, 0.7));
+   if (!hs.IsValid() || hs.NFcn() != refHesseCalls[iref]) {
+      std::cerr << s << " Failed comparison of the number of Hesse calls " << hs.NFcn()
+                << " should be " << refHesseCalls[iref] << std::endl;
+      iret = -1;
+   }
+   unsigned int k = 0;
+   for (unsigned int i = 0; i < 4; ++i)
+      for (unsigned int j = 0; j <= i; ++j, ++k)
+         iret |= compareResult(hs.Covariance()(i,j), refCov[k], s + " covariance " + std::to_string(k), tol);
+   return iret;
+}
+
+int testBatchDerivatives() {
+   int iret = 0;
+   DerivativeFCN fcn;
+   DerivativeBatchFCN batchFcn;
+   for (unsigned int istra = 0; istra < 3; ++istra) {
+      iret |= checkDerivatives(fcn, istra, "point by point");
+      iret |= checkDerivatives(batchFcn, istra, "batch");
+   }
+   // the batch interface must have been used, with several points in each batch
+   if (batchFcn.fNBatch == 0 || batchFcn.fNPoints < 2 * batchFcn.fNBatch) {
+      std::cerr << "batch Failed: " << batchFcn.fNBatch << " batches of " << batchFcn.fNPoints << " points" << std::endl;
+      iret = -1;
+   }
+
+#ifdef R__USE_IMT
+   DerivativeFCN tsFcn(true);
+   ROOT::EnableImplicitMT();
+   for (unsigned int istra = 0; istra < 3; ++istra)
+      iret |= checkDerivatives(tsFcn, istra, "parallel");
+   ROOT::DisableImplicitMT();
+#endif
+
+   if (iret != 0) std::cerr << "testBatchDerivatives :\t FAILED " << std::endl;
+   else std::cout << "testBatchDerivatives :\t OK " << std::endl;
+   return iret;
+}
+
+int main() {
+   int iret = 0;
+   iret |= testThreadSafeFCN();
+   iret |= testChi2ThreadSafeOption();
+   iret |= testBatchDerivatives();
+   return iret;
+}
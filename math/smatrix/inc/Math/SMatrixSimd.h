@@ -0,0 +1,117 @@
+// @(#)root/smatrix:$Id$
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2016  LCG ROOT Math Team, CERN/PH-SFT                *
+ *                                                                    *
+ *                                                                    *
+ **********************************************************************/
+
+#ifndef ROOT_Math_SMatrixSimd
+#define ROOT_Math_SMatrixSimd
+
+#include "Math/SMatrix.h"
+#include "Math/SVector.h"
+#include "Math/StaticCheck.h"
+#include "Math/Types.h"
+
+/**
+   @defgroup SMatrixSimd SIMD batches of SMatrix and SVector
+   @ingroup SMatrixGroup
+
+   An SMatrix or SVector of a SIMD type, like SMatrix<ROOT::Double_v,5,5>,
+   holds one matrix per SIMD lane: the expression templates, the Cholesky
+   decomposition and the Cholesky inversion are then applied lane-wise to
+   all of them at once. The functions below move scalar objects to and from
+   the lanes of such a batch:
+
+   \code
+   std::vector<SMatrixSym5D> cov(n);
+   const unsigned int nlanes = ROOT::Math::SimdTraits<ROOT::Double_v>::kSize;
+   for (unsigned int i = 0; i < n; i += nlanes) {
+      SMatrix<ROOT::Double_v,5,5,MatRepSym<ROOT::Double_v,5> > batch;
+      ROOT::Math::SimdLoad(batch, &cov[i], std::min(nlanes, n-i));
+      batch.InvertChol();
+      ROOT::Math::SimdStore(batch, &cov[i], std::min(nlanes, n-i));
+   }
+   \endcode
+*/
+
+namespace ROOT {
+
+   namespace Math {
+
+/**
+   Load the matrices src[0],...,src[n-1] in the lanes of dst. The remaining
+   lanes, if n is smaller than the number of lanes, are filled with src[n-1]
+   so that they do not make a batched decomposition fail. dst is not changed
+   if n is 0. The two matrices must have the same storage representation.
+
+   @ingroup SMatrixSimd
+*/
+template <class V, class T, unsigned int D1, unsigned int D2, class RV, class RT>
+void SimdLoad(SMatrix<V,D1,D2,RV> & dst, const SMatrix<T,D1,D2,RT> * src,
+              unsigned int n = SimdTraits<V>::kSize) {
+   STATIC_CHECK(static_cast<unsigned int>(RV::kSize) == static_cast<unsigned int>(RT::kSize),
+                SimdLoad_requires_the_same_matrix_representation);
+   if (n == 0) return;
+   V * a = dst.Array();
+   for (unsigned int k = 0; k < static_cast<unsigned int>(SimdTraits<V>::kSize); ++k) {
+      const T * s = src[k < n ? k : n-1].Array();
+      for (unsigned int i = 0; i < RV::kSize; ++i)
+         SimdTraits<V>::Set(a[i], k, s[i]);
+   }
+}
+
+/**
+   Store the first n lanes of src in the matrices dst[0],...,dst[n-1].
+
+   @ingroup SMatrixSimd
+*/
+template <class V, class T, unsigned int D1, unsigned int D2, class RV, class RT>
+void SimdStore(const SMatrix<V,D1,D2,RV> & src, SMatrix<T,D1,D2,RT> * dst,
+               unsigned int n = SimdTraits<V>::kSize) {
+   STATIC_CHECK(static_cast<unsigned int>(RV::kSize) == static_cast<unsigned int>(RT::kSize),
+                SimdStore_requires_the_same_matrix_representation);
+   const V * a = src.Array();
+   for (unsigned int k = 0; k < n; ++k) {
+      T * d = dst[k].Array();
+      for (unsigned int i = 0; i < RV::kSize; ++i)
+         d[i] = SimdTraits<V>::Get(a[i], k);
+   }
+}
+
+/**
+   Load the vectors src[0],...,src[n-1] in the lanes of dst, see the
+   SMatrix version.
+
+   @ingroup SMatrixSimd
+*/
+template <class V, class T, unsigned int D>
+void SimdLoad(SVector<V,D> & dst, const SVector<T,D> * src, unsigned int n = SimdTraits<V>::kSize) {
+   if (n == 0) return;
+   for (unsigned int k = 0; k < static_cast<unsigned int>(SimdTraits<V>::kSize); ++k) {
+      const SVector<T,D> & s = src[k < n ? k : n-1];
+      for (unsigned int i = 0; i < D; ++i)
+         SimdTraits<V>::Set(dst[i], k, s[i]);
+   }
+}
+
+/**
+   Store the first n lanes of src in the vectors dst[0],...,dst[n-1].
+
+   @ingroup SMatrixSimd
+*/
+template <class V, class T, unsigned int D>
+void SimdStore(const SVector<V,D> & src, SVector<T,D> * dst, unsigned int n = SimdTraits<V>::kSize) {
+   for (unsigned int k = 0; k < n; ++k) {
+      for (unsigned int i = 0; i < D; ++i)
+         dst[k][i] = SimdTraits<V>::Get(src[i], k);
+   }
+}
+
+   }  // namespace Math
+
+}  // namespace ROOT
+
+#endif  // ROOT_Math_SMatrixSimd
@@ -0,0 +1,156 @@
+// test of the SMatrix and SVector of a SIMD type (Math/SMatrixSimd.h): the matrices moved
+// to and from the lanes with SimdLoad and SimdStore must be unchanged, and the Cholesky
+// inversion of a batch must give in each lane the result of the scalar inversion.
+// Without Vc, ROOT::Double_v is double and the batches have a single lane.
+
+#include "Math/SMatrix.h"
+#include "Math/SVector.h"
+#include "Math/SMatrixSimd.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cmath>
+
+using namespace ROOT::Math;
+
+typedef ROOT::Double_v Vec_t;
+const unsigned int kLanes = SimdTraits<Vec_t>::kSize;
+
+typedef SMatrix<double,5,5,MatRepSym<double,5> > SymMatrix;
+typedef SMatrix<Vec_t,5,5,MatRepSym<Vec_t,5> > SymMatrixV;
+typedef SVector<double,5> Vector;
+typedef SVector<Vec_t,5> VectorV;
+
+int compare(double a, double b, const std::string & s, double tol = 0) {
+   if (std::abs(a - b) <= tol * std::abs(b)) return 0;
+   std::cout << "\n" << s << " : Failure " << a << " different than " << b << std::endl;
+   return 1;
+}
+
+// positive definite matrices A*A^T + 1
+void fillMatrices(SymMatrix * m, unsigned int n, std::mt19937 & rndm) {
+   std::uniform_real_distribution<double> u(-1, 1);
+   for (unsigned int k = 0; k < n; ++k) {
+      SMatrix<double,5,5> a;
+      for (unsigned int i = 0; i < 5; ++i)
+         for (unsigned int j = 0; j < 5; ++j) a(i,j) = u(rndm);
+      for (unsigned int i = 0; i < 5; ++i) {
+         for (unsigned int j = 0; j <= i; ++j) {
+            double s = (i == j) ? 1 : 0;
+            for (unsigned int l = 0; l < 5; ++l) s += a(i,l) * a(j,l);
+            m[k](i,j) = s;
+         }
+      }
+   }
+}
+
+int test1() {
+   // load and store of matrices and vectors, for all numbers of objects up to the number of lanes
+   std::mt19937 rndm(111);
+   std::uniform_real_distribution<double> u(-1, 1);
+   int iret = 0;
+   for (unsigned int n = 1; n <= kLanes; ++n) {
+      std::vector<SymMatrix> m(n), mout(n);
+      std::vector<Vector> v(n), vout(n);
+      fillMatrices(&m[0], n, rndm);
+      for (unsigned int k = 0; k < n; ++k)
+         for (unsigned int i = 0; i < 5; ++i) v[k][i] = u(rndm);
+
+      SymMatrixV mv;
+      VectorV vv;
+      SimdLoad(mv, &m[0], n);
+      SimdLoad(vv, &v[0], n);
+      // the lanes after n hold the last object
+      for (unsigned int k = n; k < kLanes; ++k) {
+         for (unsigned int i = 0; i < 5; ++i) {
+            iret |= compare(SimdTraits<Vec_t>::Get(mv(i,i), k), m[n-1](i,i), "padded matrix lane");
+            iret |= compare(SimdTraits<Vec_t>::Get(vv[i], k), v[n-1][i], "padded vector lane");
+         }
+      }
+      SimdStore(mv, &mout[0], n);
+      SimdStore(vv, &vout[0], n);
+      for (unsigned int k = 0; k < n; ++k) {
+         iret |= compare(mout[k] == m[k], true, "stored matrix");
+         iret |= compare(vout[k] == v[k], true, "stored vector");
+      }
+   }
+
+   // nothing is loaded or stored for n = 0
+   SymMatrix m0[1];
+   fillMatrices(m0, 1, rndm);
+   const SymMatrix m0ref = m0[0];
+   SymMatrixV mv = SymMatrixV(SMatrixIdentity());
+   SimdLoad(mv, m0, 0);
+   SimdStore(mv, m0, 0);
+   iret |= compare(m0[0] == m0ref, true, "matrix after storing no object");
+   for (unsigned int i = 0; i < 5; ++i)
+      for (unsigned int k = 0; k < kLanes; ++k)
+         iret |= compare(SimdTraits<Vec_t>::Get(mv(i,i), k), 1., "matrix after loading no object");
+   return iret;
+}
+
+int test2() {
+   // Cholesky inversion of a batch, compared with the scalar inversion of each matrix
+   std::mt19937 rndm(222);
+   std::uniform_real_distribution<double> u(-1, 1);
+   const unsigned int n = 2 * kLanes + 1;
+   std::vector<SymMatrix> m(n), minv(n), mref(n);
+   std::vector<Vector> v(n), y(n);
+   fillMatrices(&m[0], n, rndm);
+   for (unsigned int k = 0; k < n; ++k)
+      for (unsigned int i = 0; i < 5; ++i) v[k][i] = u(rndm);
+
+   int iret = 0;
+   for (unsigned int k0 = 0; k0 < n; k0 += kLanes) {
+      const unsigned int nk = std::min(kLanes, n - k0);
+      SymMatrixV mv;
+      VectorV vv;
+      SimdLoad(mv, &m[k0], nk);
+      SimdLoad(vv, &v[k0], nk);
+      iret |= compare(mv.InvertChol(), true, "batch inversion");
+      VectorV yv = mv * vv;
+      SimdStore(mv, &minv[k0], nk);
+      SimdStore(yv, &y[k0], nk);
+   }
+   for (unsigned int k = 0; k < n; ++k) {
+      mref[k] = m[k];
+      iret |= compare(mref[k].InvertChol(), true, "scalar inversion");
+      Vector yref = mref[k] * v[k];
+      for (unsigned int i = 0; i < 5; ++i) {
+         iret |= compare(y[k][i], yref[i], "inverse times vector", 1.E-12);
+         for (unsigned int j = 0; j <= i; ++j)
+            iret |= compare(minv[k](i,j), mref[k](i,j), "inverse element", 1.E-12);
+      }
+   }
+
+   // the inversion fails if the matrix of a single lane is not positive definite
+   m[kLanes - 1](2,2) = -1;
+   SymMatrixV mv;
+   SimdLoad(mv, &m[0], kLanes);
+   iret |= compare(mv.InvertChol(), false, "batch inversion with a non positive definite matrix");
+   return iret;
+}
+
+#define TEST(N)                                                                 \
+  itest = N;                                                                    \
+  if (test##N() == 0) std::cerr << " Test " << itest << "  OK " << std::endl; \
+  else { std::cerr << " Test " << itest << "  FAILED " << std::endl;    \
+     iret +=1; };
+
+int testSimd() {
+   int iret = 0;
+   int itest;
+   TEST(1);
+   TEST(2);
+   return iret;
+}
+
+int main() {
+   int ret = testSimd();
+   if (ret)  std::cerr << "test SMatrix SIMD:\t  FAILED !!! " << std::endl;
+   else   std::cerr << "test SMatrix SIMD: \t OK " << std::endl;
+   return ret;
+}
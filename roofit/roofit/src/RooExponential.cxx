@@ -27,6 +27,11 @@ Exponential p.d.f
 #include "Riostream.h"
 #include "Riostream.h"
 #include <math.h>
+#include "TMath.h"
+#include "RConfigure.h"
+#ifdef R__HAS_VDT
+#include "vdt/exp.h"
+#endif
 
 #include "RooExponential.h"
 #include "RooRealVar.h"
@@ -59,6 +64,9 @@ RooExponential::RooExponential(const RooExponential& other, const char* name) :
 ///cout << "exp(x=" << x << ",c=" << c << ")=" << exp(c*x) << endl ;
 
 Double_t RooExponential::evaluate() const{
+#ifdef R__HAS_VDT
+  if (TMath::IsFastMathEnabled()) return vdt::fast_exp(c*x);
+#endif
   return exp(c*x);
 }
 
@@ -27,6 +27,11 @@ Plain Gaussian p.d.f
 #include "Riostream.h"
 #include "Riostream.h"
 #include <math.h>
+#include "TMath.h"
+#include "RConfigure.h"
+#ifdef R__HAS_VDT
+#include "vdt/exp.h"
+#endif
 
 #include "RooGaussian.h"
 #include "RooAbsReal.h"
@@ -69,7 +74,12 @@ Double_t RooGaussian::evaluate() const
 {
   Double_t arg= x - mean;  
   Double_t sig = sigma ;
-  Double_t ret =exp(-0.5*arg*arg/(sig*sig)) ;
+  Double_t ret ;
+#ifdef R__HAS_VDT
+  if (TMath::IsFastMathEnabled()) ret = vdt::fast_exp(-0.5*arg*arg/(sig*sig)) ;
+  else
+#endif
+  ret = exp(-0.5*arg*arg/(sig*sig)) ;
 //   if (gDebug>2) {
 //     cout << "gauss(" << GetName() << ") x = " << x << " mean = " << mean << " sigma = " << sigma << " ret = " << ret << endl ;
 //   }
@@ -4,6 +4,7 @@
 #include "TFormula.h"
 #include "TGraph.h"
 #include "Math/ChebyshevPol.h"
+#include "RConfigure.h"
 
 #include <limits>
 #include <cstdlib>
@@ -627,6 +628,50 @@ bool test36() {
    
    return ok; 
 } 
+bool test37() {
+   // test evaluation on arrays of points
+   // (more than 10000 points are evaluated, so that the compiled loop is used)
+   bool ok = true;
+   TF1 f1("f1","[0]*exp(-0.5*((x-[1])/[2])^2)+[3]*x",-5,5);
+   f1.SetParameters(2,1,0.5,0.1);
+   std::vector<double> x(20000), y(20000);
+   for (size_t i = 0; i < x.size(); ++i) x[i] = -5. + 0.0005*i;
+   f1.EvalParVec(x.size(), x.data(), y.data());
+   for (size_t i = 0; i < x.size(); ++i) ok &= TMath::AreEqualAbs( y[i], f1.Eval(x[i]), 1.E-12);
+
+   // other parameters and a normalized function
+   double par[4] = {1,0,1,0};
+   f1.SetNormalized(true);
+   f1.EvalParVec(x.size(), x.data(), y.data(), par);
+   for (size_t i = 0; i < x.size(); ++i) ok &= TMath::AreEqualAbs( y[i], f1.EvalPar(&x[i],par), 1.E-12);
+
+#ifdef R__HAS_VDT
+   // the compiled loop with the vdt functions
+   TMath::EnableFastMath();
+   f1.EvalParVec(x.size(), x.data(), y.data(), par);
+   TMath::EnableFastMath(false);
+   for (size_t i = 0; i < x.size(); ++i) ok &= TMath::AreEqualAbs( y[i], f1.EvalPar(&x[i],par), 1.E-10);
+#endif
+
+   // points with a stride, one by one and then with the compiled loop
+   TF2 f2("f2","x*[0]+y*y*[1]");
+   f2.SetParameters(2,3);
+   double xy[9] = {1,2,-1, 3,4,-1, 5,6,-1};
+   f2.EvalParVec(3, xy, y.data(), 0, 3);
+   for (int i = 0; i < 3; ++i) ok &= TMath::AreEqualAbs( y[i], f2.Eval(xy[3*i],xy[3*i+1]), 1.E-12);
+   std::vector<double> xys(3*x.size(), -1.);
+   for (size_t i = 0; i < x.size(); ++i) { xys[3*i] = x[i]; xys[3*i+1] = 0.5*x[i]; }
+   f2.EvalParVec(x.size(), xys.data(), y.data(), 0, 3);
+   for (size_t i = 0; i < x.size(); ++i) ok &= TMath::AreEqualAbs( y[i], f2.Eval(xys[3*i],xys[3*i+1]), 1.E-12);
+
+   // lambda functions are evaluated point by point
+   TF1 f3("f3",[](double *xx, double *p){ return p[0]*xx[0]*xx[0]; }, -1, 1, 1);
+   f3.SetParameter(0,2);
+   f3.EvalParVec(10, x.data(), y.data());
+   for (size_t i = 0; i < 10; ++i) ok &= TMath::AreEqualAbs( y[i], 2*x[i]*x[i], 1.E-12);
+
+   return ok;
+}
    
 void PrintError(int itest)  { 
    Error("TFormula test","test%d FAILED ",itest);
@@ -681,6 +726,7 @@ int runTests(bool debug = false) {
    IncrTest(itest); if (!test34() ) { PrintError(itest); }
    IncrTest(itest); if (!test35() ) { PrintError(itest); }
    IncrTest(itest); if (!test36() ) { PrintError(itest); }
+   IncrTest(itest); if (!test37() ) { PrintError(itest); }
 
    std::cout << ".\n";
     
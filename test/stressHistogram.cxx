@@ -47,7 +47,7 @@
 // Test 14: Interpolation tests for Histograms...............................OK
 // Test 15: Scale tests for Profiles.........................................OK
 // Test 16: Integral tests for Histograms....................................OK
-// Test 17: Buffer tests for Histograms......................................OK
+// Test 17: Buffer and FillN tests for Histograms............................OK
 // Test 18: Extend axis tests for Histograms.................................OK
 // Test 19: TH1-THn[Sparse] Conversion tests.................................OK
 // Test 20: FillData tests for Histograms and Sparses........................OK
@@ -68,10 +68,14 @@
 #include "TH2.h"
 #include "THn.h"
 #include "THnSparse.h"
+#include "TH2Poly.h"
+#include "TGraph.h"
+#include "TKDE.h"
 
 #include "TProfile.h"
 #include "TProfile2D.h"
 #include "TProfile3D.h"
+#include "ROOT/TH1ConcurrentFill.h"
 
 #include "TF1.h"
 #include "TF2.h"
@@ -2884,6 +2888,62 @@ bool testClone3D()
    return ret;
 }
 
+bool testCloneCompact1D()
+{
+   // Tests the compact storage of TH1U against a TH1D filled with the same
+   // values, with bins promoted on overflow or by non-integer contents
+
+   TH1U* h1 = new TH1U("clC1D-h1", "h1-Title", 100, minRange, maxRange);
+   TH1D* h2 = new TH1D("clC1D-h2", "h2-Title", 100, minRange, maxRange);
+
+   // one bin above the capacity of the 16 bits counters
+   const Double_t xo = 0.5 * (minRange + maxRange);
+   for ( Int_t e = 0; e < 70000; ++e ) {
+      h1->Fill(xo);
+      h2->Fill(xo);
+   }
+   for ( Int_t e = 0; e < nEvents; ++e ) {
+      Double_t x = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      h1->Fill(x);
+      h2->Fill(x);
+   }
+   // and one bin with a non-integer content
+   h1->Fill(minRange + 0.001, 0.25);
+   h2->Fill(minRange + 0.001, 0.25);
+
+   auto differ = [&](const TH1 *ha) {
+      for ( Int_t bin = 0; bin < h2->GetNcells(); ++bin ) {
+         if ( ha->GetBinContent(bin) != h2->GetBinContent(bin) ||
+              ha->GetBinError(bin) != h2->GetBinError(bin) ) {
+            std::cout << "Bin " << bin << ": " << ha->GetBinContent(bin)
+                      << " != " << h2->GetBinContent(bin) << std::endl;
+            return true;
+         }
+      }
+      return false;
+   };
+
+   bool ret = differ(h1) || h1->IsPromoted() || h1->GetNPromoted() != 2;
+
+   // the clone is streamed, including the promoted bins
+   TH1U* h3 = static_cast<TH1U*> ( h1->Clone() );
+   ret |= differ(h3) || h3->IsPromoted() || h3->GetNPromoted() != 2;
+
+   // scaling makes most contents non-integer and promotes the whole array
+   h1->Scale(0.3);
+   h2->Scale(0.3);
+   ret |= differ(h1) || !h1->IsPromoted();
+
+   h1->Reset();
+   ret |= h1->IsPromoted() || h1->GetNPromoted() != 0 || h1->GetSum() != 0;
+
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << "testCloneCompact1D: \t" << (ret?"FAILED":"OK") << std::endl;
+   delete h1;
+   delete h2;
+   delete h3;
+   return ret;
+}
+
 bool testCloneProfile3D()
 {
    // Tests the clone method for 3D Profiles
@@ -3477,6 +3537,105 @@ bool testMerge3D()
    return ret;
 }
 
+bool testMergeParallel()
+{
+   // Tests the merge of many small 1D histograms and of large 3D histograms
+   // with the same binning, done by several threads with implicit multithreading
+
+#ifdef R__USE_IMT
+   ROOT::EnableImplicitMT();
+#endif
+
+   const Int_t nSmall = 80;
+   TH1D* h1 = new TH1D("mergePar-h1", "h1-Title", 20000, minRange, maxRange);
+   TH1D* h1ref = new TH1D("mergePar-h1ref", "h1ref-Title", 20000, minRange, maxRange);
+   h1->Sumw2(); h1ref->Sumw2();
+   TList *list1 = new TList;
+   list1->SetOwner();
+   for ( Int_t i = 0; i < nSmall; ++i ) {
+      TH1D* h = new TH1D(TString::Format("mergePar-h1-%d", i), "h-Title", 20000, minRange, maxRange);
+      for ( Int_t e = 0; e < nEvents; ++e ) {
+         Double_t x = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+         Double_t w = r.Uniform(0.5, 1.5);
+         h->Fill(x, w);
+         h1ref->Fill(x, w);
+      }
+      list1->Add(h);
+   }
+   h1->Merge(list1);
+   bool ret = equals("MergeParallel1D", h1, h1ref, cmpOptStats, 1E-10);
+
+   TH3D* h3 = new TH3D("mergePar-h3", "h3-Title", 64, minRange, maxRange, 64, minRange, maxRange, 64, minRange, maxRange);
+   TH3D* h3ref = new TH3D("mergePar-h3ref", "h3ref-Title", 64, minRange, maxRange, 64, minRange, maxRange, 64, minRange, maxRange);
+   TList *list3 = new TList;
+   list3->SetOwner();
+   for ( Int_t i = 0; i < 4; ++i ) {
+      TH3D* h = new TH3D(TString::Format("mergePar-h3-%d", i), "h-Title",
+                         64, minRange, maxRange, 64, minRange, maxRange, 64, minRange, maxRange);
+      for ( Int_t e = 0; e < 100 * nEvents; ++e ) {
+         Double_t x = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+         Double_t y = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+         Double_t z = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+         h->Fill(x, y, z, 1.0);
+         h3ref->Fill(x, y, z, 1.0);
+      }
+      list3->Add(h);
+   }
+   h3->Merge(list3);
+   ret |= equals("MergeParallel3D", h3, h3ref, cmpOptStats, 1E-10);
+
+#ifdef R__USE_IMT
+   ROOT::DisableImplicitMT();
+#endif
+
+   delete h1;
+   delete h1ref;
+   delete h3;
+   delete h3ref;
+   delete list1;
+   delete list3;
+   return ret;
+}
+
+bool testMergeCompact3D()
+{
+   // Tests the merge of 3D histograms with compact storage, compared to the
+   // same histograms with one double per bin
+
+   TH3U* h1 = new TH3U("mergeC3D-h1", "h1-Title", 32, minRange, maxRange, 32, minRange, maxRange, 32, minRange, maxRange);
+   TH3D* h2 = new TH3D("mergeC3D-h2", "h2-Title", 32, minRange, maxRange, 32, minRange, maxRange, 32, minRange, maxRange);
+   TList *list = new TList;
+   list->SetOwner();
+   for ( Int_t i = 0; i < 4; ++i ) {
+      TH3U* h = new TH3U(TString::Format("mergeC3D-h-%d", i), "h-Title",
+                         32, minRange, maxRange, 32, minRange, maxRange, 32, minRange, maxRange);
+      for ( Int_t e = 0; e < 10 * nEvents; ++e ) {
+         Double_t x = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+         Double_t y = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+         Double_t z = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+         h->Fill(x, y, z);
+         h2->Fill(x, y, z);
+      }
+      list->Add(h);
+   }
+   h1->Merge(list);
+
+   bool ret = h1->IsPromoted() || h1->GetNPromoted() != 0 ||
+              h1->GetEntries() != h2->GetEntries() || compareStatistics(h1, h2, false, 1E-10);
+   for ( Int_t bin = 0; bin < h2->GetNcells(); ++bin ) {
+      if ( h1->GetBinContent(bin) != h2->GetBinContent(bin) ) {
+         ret = true;
+         break;
+      }
+   }
+
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << "testMergeCompact3D: \t" << (ret?"FAILED":"OK") << std::endl;
+   delete h1;
+   delete h2;
+   delete list;
+   return ret;
+}
+
 bool testMergeProf3D()
 {
    // Tests the merge method for 3D Profiles
@@ -3597,6 +3756,49 @@ bool testMergeHn()
    return ret;
 }
 
+template <typename HIST>
+bool testMergeParallelHn()
+{
+   // Tests the merge of large n-dim histograms with the same binning with
+   // implicit multithreading, compared to the sequential merge
+
+   Int_t bsize[] = { 64, 64, 64 };
+   Double_t xmin[] = {minRange, minRange, minRange};
+   Double_t xmax[] = {maxRange, maxRange, maxRange};
+
+   HIST* hSeq = new HIST("mergeParHn-seq", "seq-Title", 3, bsize, xmin, xmax);
+   HIST* hPar = new HIST("mergeParHn-par", "par-Title", 3, bsize, xmin, xmax);
+   hSeq->Sumw2(); hPar->Sumw2();
+   TList *list = new TList;
+   list->SetOwner();
+   for ( Int_t i = 0; i < 4; ++i ) {
+      HIST* h = new HIST(TString::Format("mergeParHn-%d", i), "h-Title", 3, bsize, xmin, xmax);
+      h->Sumw2();
+      for ( Int_t e = 0; e < 100 * nEvents; ++e ) {
+         Double_t points[3];
+         points[0] = r.Uniform( minRange * .9, maxRange * 1.1);
+         points[1] = r.Uniform( minRange * .9, maxRange * 1.1);
+         points[2] = r.Uniform( minRange * .9, maxRange * 1.1);
+         h->Fill(points, r.Uniform(0.5, 1.5));
+      }
+      list->Add(h);
+   }
+
+   hSeq->Merge(list);
+#ifdef R__USE_IMT
+   ROOT::EnableImplicitMT();
+#endif
+   hPar->Merge(list);
+#ifdef R__USE_IMT
+   ROOT::DisableImplicitMT();
+#endif
+
+   bool ret = equals(TString::Format("MergeParallelHn<%s>", HIST::Class()->GetName()), hPar, hSeq, cmpOptNone, 1E-10);
+   delete hPar;
+   delete list;
+   return ret;
+}
+
 bool testMerge1DLabelSame()
 {
    // Tests the merge with some equal labels method for 1D Histograms
@@ -6075,6 +6277,104 @@ bool testInterpolation3D()
    return status;
 }
 
+bool testGraphEval()
+{
+   // Tests TGraph::Eval on unsorted points against the same points sorted in x
+
+   bool status = false;
+
+   const Int_t n = numberOfBins;
+   TGraph g1(n), g2(n);
+   for ( Int_t i = 0; i < n; ++i ) {
+      Double_t x = r.Uniform(minRange, maxRange);
+      g1.SetPoint(i, x, function1D(x) + r.Uniform(-1, 1));
+   }
+   for ( Int_t i = 0; i < n; ++i ) {
+      Double_t x, y;
+      g1.GetPoint(i, x, y);
+      g2.SetPoint(i, x, y);
+   }
+   g2.Sort();
+
+   Double_t xp[1000], y1[1000], y2[1000];
+   for ( Int_t i = 0; i < 1000; ++i )
+      xp[i] = r.Uniform(1.1 * minRange, 1.1 * maxRange);
+
+   for ( Int_t pass = 0; pass < 2; ++pass ) {
+      for ( Int_t s = 0; s < 2; ++s ) {
+         Option_t *opt = (s ? "S" : "");
+         g1.Eval(1000, xp, y1, opt);
+         for ( Int_t i = 0; i < 1000; ++i ) {
+            y2[i] = g2.Eval(xp[i], 0, opt);
+            if ( fabs(y1[i] - y2[i]) > 1.E-13 * (fabs(y2[i]) + 1.) || y1[i] != g1.Eval(xp[i], 0, opt) ) {
+               status = true;
+               std::cout << "x: " << xp[i] << " opt: " << opt
+                         << " unsorted: " << y1[i] << " sorted: " << y2[i] << std::endl;
+            }
+         }
+      }
+      // the cached order and spline must follow the modified points
+      Double_t x, y;
+      g1.GetPoint(n / 2, x, y);
+      g1.SetPoint(n / 2, 0.5 * x, -y);
+      g1.GetPoint(n / 3, x, y);
+      g1.SetPoint(n / 3, 0.7 * x, 2 * y);
+      g2 = g1;
+      g2.Sort();
+   }
+
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << "testGraphEval: \t" << (status?"FAILED":"OK") << std::endl;
+   return status;
+}
+
+bool testKDEEvaluation()
+{
+   // Tests the approximate evaluations of TKDE against the exact sum over the data points, for
+   // a fixed and an adaptive bandwidth. The maximum difference, relative to the maximum of the
+   // density, must be below 1E-6 for the truncated sums (kernel tolerance 1E-8), 2E-3 for the
+   // binned evaluation on the default grid (step of an eighth of the bandwidth) and 5E-5 on a
+   // grid of 4096 points. The fixed bandwidth grid is computed by FFT when the plugin is available
+
+   bool status = false;
+
+   const UInt_t nData = 1000;
+   const UInt_t nEval = 500;
+   std::vector<Double_t> data(nData), xp(nEval), yExact(nEval), y(nEval);
+   for ( UInt_t i = 0; i < nData; ++i )
+      data[i] = r.Gaus(0, 1);
+   for ( UInt_t i = 0; i < nEval; ++i )
+      xp[i] = -3.5 + 7. * i / (nEval - 1.);
+
+   const char* iterations[2] = { "Fixed", "Adaptive" };
+   for ( Int_t it = 0; it < 2; ++it ) {
+      TString opt = TString::Format("KernelType:Gaussian;Iteration:%s;Mirror:noMirror;Binning:Unbinned", iterations[it]);
+      TKDE kde(nData, &data[0], -5., 5., opt.Data(), 1.0);
+      kde.GetValues(nEval, &xp[0], &yExact[0]);
+      const Double_t yMax = *std::max_element(yExact.begin(), yExact.end());
+
+      struct { TKDE::EEvaluation eval; Double_t tolerance; UInt_t npoints; Double_t maxDiff; const char* name; } modes[3] = {
+         { TKDE::kTruncatedEvaluation, 1.E-8, 0,    1.E-6, "truncated" },
+         { TKDE::kBinnedEvaluation,    1.E-8, 0,    2.E-3, "binned" },
+         { TKDE::kBinnedEvaluation,    1.E-8, 4096, 5.E-5, "binned 4096 points" }
+      };
+      for ( Int_t m = 0; m < 3; ++m ) {
+         kde.SetEvaluation(modes[m].eval, modes[m].tolerance, modes[m].npoints);
+         kde.GetValues(nEval, &xp[0], &y[0]);
+         Double_t diff = 0;
+         for ( UInt_t i = 0; i < nEval; ++i )
+            diff = std::max(diff, std::abs(y[i] - yExact[i]));
+         if ( !(diff <= modes[m].maxDiff * yMax) ) {
+            status = true;
+            std::cout << "TKDE " << iterations[it] << " " << modes[m].name << ": maximum relative difference "
+                      << diff / yMax << " larger than " << modes[m].maxDiff << std::endl;
+         }
+      }
+   }
+
+   if ( defaultEqualOptions & cmpOptPrint ) std::cout << "testKDEEvaluation: \t" << (status?"FAILED":"OK") << std::endl;
+   return status;
+}
+
 bool testScale1DProf()
 {
    TProfile* p1 = new TProfile("scD1-p1", "p1-Title", numberOfBins, minRange, maxRange);
@@ -6654,6 +6954,346 @@ bool testH3Buffer() {
    return iret;
 }
 
+// test bulk filling with FillN against Fill
+bool testH1FillN() {
+
+   int iret = 0;
+
+   double bins[] = {-4, -2, -1, -0.5, 0, 0.2, 0.5, 1, 2, 3, 4};
+   TH1D * h1 = new TH1D("h1","h1",10,bins);
+   TH1D * h2 = new TH1D("h2","h2",10,bins);
+   TH1D * h3 = new TH1D("h3","h3",40,-3,3);
+   TH1D * h4 = new TH1D("h4","h4",40,-3,3);
+
+   // values interleaved with weights, to test the stride
+   const int nevt = 5000;
+   std::vector<double> xw(2*nevt);
+   for (int i = 0; i < nevt ; ++i) {
+      xw[2*i]   = gRandom->Gaus(0,2);
+      xw[2*i+1] = gRandom->Uniform(0.5,1.5);
+      h1->Fill(xw[2*i], xw[2*i+1]);
+      h3->Fill(xw[2*i]);
+   }
+   h2->FillN(nevt, &xw[0], &xw[1], 2);
+   h4->FillN(nevt, &xw[0], 0, 2);
+
+   iret |= equals("testh1fillnvar",h1,h2,cmpOptStats,1.E-13);
+   iret |= equals("testh1filln",h3,h4,cmpOptStats,1.E-13);
+
+   if ( defaultEqualOptions & cmpOptPrint )
+      std::cout << "FillN H1:\t" << (iret?"FAILED":"OK") << std::endl;
+
+   delete h1;
+   delete h2;
+   delete h3;
+   delete h4;
+
+   return iret;
+}
+
+bool testH2FillN() {
+
+   int iret = 0;
+
+   double ybins[] = {-5, -3, -1, 0, 1, 2, 5};
+   TH2D * h1 = new TH2D("h1","h1",20,-4,4,6,ybins);
+   TH2D * h2 = new TH2D("h2","h2",20,-4,4,6,ybins);
+
+   const int nevt = 5000;
+   std::vector<double> x(nevt), y(nevt), w(nevt);
+   for (int i = 0; i < nevt ; ++i) {
+      x[i] = gRandom->Gaus(0,2);
+      y[i] = gRandom->Gaus(1,3);
+      w[i] = gRandom->Uniform(0.5,1.5);
+      h1->Fill(x[i], y[i], w[i]);
+   }
+   h2->FillN(nevt, &x[0], &y[0], &w[0]);
+
+   iret |= equals("testh2filln",h1,h2,cmpOptStats,1.E-13);
+
+   if ( defaultEqualOptions & cmpOptPrint )
+      std::cout << "FillN H2:\t" << (iret?"FAILED":"OK") << std::endl;
+
+   delete h1;
+   delete h2;
+
+   return iret;
+}
+
+bool testH3FillN() {
+
+   int iret = 0;
+
+   TH3D * h1 = new TH3D("h1","h1",4,-5,5,4,-5,5,4,-5,5);
+   TH3D * h2 = new TH3D("h2","h2",4,-5,5,4,-5,5,4,-5,5);
+
+   const int nevt = 5000;
+   std::vector<double> x(nevt), y(nevt), z(nevt);
+   for (int i = 0; i < nevt ; ++i) {
+      x[i] = gRandom->Gaus(0,2);
+      y[i] = gRandom->Gaus(1,3);
+      z[i] = gRandom->Uniform(-6,6);
+      h1->Fill(x[i], y[i], z[i]);
+   }
+   h2->FillN(nevt, &x[0], &y[0], &z[0], 0);
+
+   iret |= equals("testh3filln",h1,h2,cmpOptStats,1.E-13);
+
+   if ( defaultEqualOptions & cmpOptPrint )
+      std::cout << "FillN H3:\t" << (iret?"FAILED":"OK") << std::endl;
+
+   delete h1;
+   delete h2;
+
+   return iret;
+}
+
+bool testConcurrentFill1D() {
+   // Tests the filling of a 1D histogram by two fillers, in atomic and sharded
+   // mode, compared to TH1::Fill
+
+   TH1D* h1 = new TH1D("cfill1D-h1", "h1-Title", numberOfBins, minRange, maxRange);
+   TH1D* h2 = new TH1D("cfill1D-h2", "h2-Title", numberOfBins, minRange, maxRange);
+   TH1D* h3 = new TH1D("cfill1D-h3", "h3-Title", numberOfBins, minRange, maxRange);
+   h1->Sumw2(); h2->Sumw2(); h3->Sumw2();
+
+   {
+      ROOT::TH1ConcurrentFillManager<TH1D> atomicManager(*h1, ROOT::EConcurrentFillMode::kAtomic);
+      ROOT::TH1ConcurrentFillManager<TH1D> shardedManager(*h2);
+      auto atomic1 = atomicManager.MakeFiller();
+      auto atomic2 = atomicManager.MakeFiller();
+      auto sharded1 = shardedManager.MakeFiller();
+      auto sharded2 = shardedManager.MakeFiller();
+      for ( Int_t e = 0; e < nEvents; ++e ) {
+         Double_t x = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+         Double_t w = r.Uniform(0.5, 1.5);
+         (e % 2 ? atomic1 : atomic2).Fill(x, w);
+         (e % 2 ? sharded1 : sharded2).Fill(x, w);
+         h3->Fill(x, w);
+      }
+   } // the fillers are flushed here
+
+   int iret = equals("ConcurrentFill1DAtomic", h1, h3, cmpOptStats, 1E-10);
+   iret |= equals("ConcurrentFill1DSharded", h2, h3, cmpOptStats, 1E-10);
+   delete h1;
+   delete h2;
+   delete h3;
+   return iret;
+}
+
+bool testConcurrentFill2D() {
+   // Tests the filling of a 2D histogram by two fillers, in atomic and sharded
+   // mode, compared to TH2::Fill
+
+   TH2D* h1 = new TH2D("cfill2D-h1", "h1-Title", numberOfBins, minRange, maxRange, numberOfBins + 2, minRange, maxRange);
+   TH2D* h2 = new TH2D("cfill2D-h2", "h2-Title", numberOfBins, minRange, maxRange, numberOfBins + 2, minRange, maxRange);
+   TH2D* h3 = new TH2D("cfill2D-h3", "h3-Title", numberOfBins, minRange, maxRange, numberOfBins + 2, minRange, maxRange);
+   h1->Sumw2(); h2->Sumw2(); h3->Sumw2();
+
+   {
+      ROOT::TH1ConcurrentFillManager<TH2D> atomicManager(*h1, ROOT::EConcurrentFillMode::kAtomic);
+      ROOT::TH1ConcurrentFillManager<TH2D> shardedManager(*h2);
+      auto atomic1 = atomicManager.MakeFiller();
+      auto atomic2 = atomicManager.MakeFiller();
+      auto sharded1 = shardedManager.MakeFiller();
+      auto sharded2 = shardedManager.MakeFiller();
+      for ( Int_t e = 0; e < nEvents * nEvents; ++e ) {
+         Double_t x = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+         Double_t y = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+         Double_t w = r.Uniform(0.5, 1.5);
+         (e % 2 ? atomic1 : atomic2).Fill(x, y, w);
+         (e % 2 ? sharded1 : sharded2).Fill(x, y, w);
+         h3->Fill(x, y, w);
+      }
+   }
+
+   int iret = equals("ConcurrentFill2DAtomic", h1, h3, cmpOptStats, 1E-10);
+   iret |= equals("ConcurrentFill2DSharded", h2, h3, cmpOptStats, 1E-10);
+   delete h1;
+   delete h2;
+   delete h3;
+   return iret;
+}
+
+bool testConcurrentFill3D() {
+   // Tests the filling of a 3D histogram by two fillers, in atomic and sharded
+   // mode, compared to TH3::Fill
+
+   TH3D* h1 = new TH3D("cfill3D-h1", "h1-Title", numberOfBins, minRange, maxRange, numberOfBins + 1, minRange, maxRange,
+                       numberOfBins + 2, minRange, maxRange);
+   TH3D* h2 = new TH3D("cfill3D-h2", "h2-Title", numberOfBins, minRange, maxRange, numberOfBins + 1, minRange, maxRange,
+                       numberOfBins + 2, minRange, maxRange);
+   TH3D* h3 = new TH3D("cfill3D-h3", "h3-Title", numberOfBins, minRange, maxRange, numberOfBins + 1, minRange, maxRange,
+                       numberOfBins + 2, minRange, maxRange);
+   h1->Sumw2(); h2->Sumw2(); h3->Sumw2();
+
+   {
+      ROOT::TH1ConcurrentFillManager<TH3D> atomicManager(*h1, ROOT::EConcurrentFillMode::kAtomic);
+      ROOT::TH1ConcurrentFillManager<TH3D> shardedManager(*h2);
+      auto atomic1 = atomicManager.MakeFiller();
+      auto atomic2 = atomicManager.MakeFiller();
+      auto sharded1 = shardedManager.MakeFiller();
+      auto sharded2 = shardedManager.MakeFiller();
+      for ( Int_t e = 0; e < nEvents * nEvents; ++e ) {
+         Double_t x = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+         Double_t y = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+         Double_t z = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+         Double_t w = r.Uniform(0.5, 1.5);
+         (e % 2 ? atomic1 : atomic2).Fill(x, y, z, w);
+         (e % 2 ? sharded1 : sharded2).Fill(x, y, z, w);
+         h3->Fill(x, y, z, w);
+      }
+   }
+
+   int iret = equals("ConcurrentFill3DAtomic", h1, h3, cmpOptStats, 1E-10);
+   iret |= equals("ConcurrentFill3DSharded", h2, h3, cmpOptStats, 1E-10);
+   delete h1;
+   delete h2;
+   delete h3;
+   return iret;
+}
+
+bool testConcurrentFillIntLabels() {
+   // Tests that the atomic fill of a TH1S saturates the bins as TH1S::Fill
+   // does, and the filling by bin label. The slabs of the sharded mode must
+   // not be registered in the current directory
+
+   TH1S* h1 = new TH1S("cfillS-h1", "h1-Title", 3, 0, 3);
+   TH1S* h2 = new TH1S("cfillS-h2", "h2-Title", 3, 0, 3);
+   // the first bin has no label, so that the axis is not extendable
+   const char *labels[3] = { "", "b", "c" };
+   for ( Int_t i = 1; i < 3; ++i ) {
+      h1->GetXaxis()->SetBinLabel(i + 1, labels[i]);
+      h2->GetXaxis()->SetBinLabel(i + 1, labels[i]);
+   }
+
+   int iret = 0;
+   {
+      ROOT::TH1ConcurrentFillManager<TH1S> atomicManager(*h1, ROOT::EConcurrentFillMode::kAtomic);
+      auto atomic = atomicManager.MakeFiller();
+      for ( Int_t e = 0; e < 5; ++e ) {
+         atomic.Fill(0.5, 20000.);
+         h2->Fill(0.5, 20000.);
+         atomic.Fill(1.5, -20000.);
+         h2->Fill(1.5, -20000.);
+         atomic.Fill("c", 2.);
+         h2->Fill("c", 2.);
+      }
+
+      TList *before = gDirectory ? gDirectory->GetList() : 0;
+      Int_t nBefore = before ? before->GetSize() : 0;
+      ROOT::TH1ConcurrentFillManager<TH1S> shardedManager(*h2);
+      auto sharded = shardedManager.MakeFiller();
+      iret |= equals(before ? before->GetSize() : 0, nBefore);
+   }
+
+   for ( Int_t i = 0; i <= 4; ++i )
+      iret |= equals(h1->GetBinContent(i), h2->GetBinContent(i));
+   iret |= equals(h1->GetBinContent(1), 32767);
+   iret |= equals(h1->GetBinContent(2), -32767);
+   iret |= equals(h1->GetEntries(), h2->GetEntries());
+   iret |= equals(h1->GetMean(), h2->GetMean(), 1E-10);
+   if ( defaultEqualOptions & cmpOptPrint )
+      std::cout << "ConcurrentFillIntLabels:\t" << (iret?"FAILED":"OK") << std::endl;
+
+   delete h1;
+   delete h2;
+   return iret;
+}
+
+bool testH2PolyFillN() {
+
+   int iret = 0;
+
+   // honeycomb bins, plus rectangles of different sizes overlapping them
+   TH2Poly * h1 = new TH2Poly("h1","h1",0,10,0,10);
+   TH2Poly * h2 = new TH2Poly("h2","h2",0,10,0,10);
+   h1->Honeycomb(0.5, 0.5, 0.25, 15, 15);
+   h2->Honeycomb(0.5, 0.5, 0.25, 15, 15);
+   for (int i = 0; i < 20; ++i) {
+      double x = gRandom->Uniform(0,10);
+      double y = gRandom->Uniform(0,10);
+      double d = gRandom->Uniform(0.01,3);
+      h1->AddBin(x, y, x+d, y+d);
+      h2->AddBin(x, y, x+d, y+d);
+   }
+
+   const int nevt = 5000;
+   std::vector<double> x(nevt), y(nevt);
+   for (int i = 0; i < nevt ; ++i) {
+      x[i] = gRandom->Uniform(-1,11);
+      y[i] = gRandom->Uniform(-1,11);
+      h1->Fill(x[i], y[i]);
+
+      // the bin found must be the first bin containing the point
+      int expected = -5;
+      if (x[i] < 0 || x[i] > 10 || y[i] < 0 || y[i] > 10) {
+         expected = h1->FindBin(x[i], y[i]);
+      } else {
+         TIter next(h1->GetBins());
+         while (TH2PolyBin * bin = (TH2PolyBin*) next()) {
+            if (bin->IsInside(x[i], y[i])) {
+               expected = bin->GetBinNumber();
+               break;
+            }
+         }
+      }
+      if (h1->FindBin(x[i], y[i]) != expected) iret |= 1;
+   }
+   h2->FillN(nevt, &x[0], &y[0], 0);
+
+   for (int bin = -9; bin <= h1->GetNumberOfBins(); ++bin)
+      iret |= equals(h1->GetBinContent(bin), h2->GetBinContent(bin));
+   iret |= equals(h1->GetEntries(), h2->GetEntries());
+
+   if ( defaultEqualOptions & cmpOptPrint )
+      std::cout << "FillN H2Poly:\t" << (iret?"FAILED":"OK") << std::endl;
+
+   delete h1;
+   delete h2;
+
+   return iret;
+}
+
+template<typename HIST>
+bool testHnFillN() {
+
+   const Int_t ndim = 3;
+   Int_t bsize[ndim];
+   Double_t xmin[ndim], xmax[ndim];
+   for (Int_t d = 0; d < ndim; ++d) {
+      bsize[d] = TMath::Nint( r.Uniform(10, 40) );
+      xmin[d] = minRange;
+      xmax[d] = maxRange;
+   }
+
+   HIST* s1 = new HIST("fn-s1", "s1", ndim, bsize, xmin, xmax);
+   HIST* s2 = new HIST("fn-s2", "s2", ndim, bsize, xmin, xmax);
+   HIST* s3 = new HIST("fn-s3", "s3", ndim, bsize, xmin, xmax);
+   s1->Sumw2(); s2->Sumw2(); s3->Sumw2();
+
+   const Int_t nevt = 5000;
+   std::vector<Double_t> x(nevt * ndim), w(nevt);
+   for (Int_t i = 0; i < nevt; ++i) {
+      for (Int_t d = 0; d < ndim; ++d)
+         x[i * ndim + d] = r.Uniform( minRange * .9 , maxRange * 1.1 );
+      w[i] = r.Rndm();
+      s1->Fill(&x[i * ndim], w[i]);
+   }
+   // fill the two halves separately and merge them
+   s2->FillN(nevt / 2, &x[0], &w[0]);
+   s3->FillN(nevt - nevt / 2, &x[(nevt / 2) * ndim], &w[nevt / 2]);
+   TList *list = new TList;
+   list->Add(s3);
+   s2->Merge(list);
+   delete list;
+
+   bool ret = equals(TString::Format("FillNHn<%s>", HIST::Class()->GetName()), s1, s2, cmpOptStats, 1E-10);
+   delete s1;
+   delete s3;
+   return ret;
+}
+
 bool testH1Extend() {
 
    TH1D * h1 = new TH1D("h1","h1",10,0,10);
@@ -9954,7 +10594,7 @@ int stressHistogram()
 
    // Test 8
    // Copy Tests
-   const unsigned int numberOfCopy = 26;
+   const unsigned int numberOfCopy = 27;
    pointer2Test copyTestPointer[numberOfCopy] = { testAssign1D,             testAssignProfile1D,
                                                   testAssignVar1D,          testAssignProfileVar1D,
                                                   testCopyConstructor1D,    testCopyConstructorProfile1D,
@@ -9967,7 +10607,8 @@ int stressHistogram()
                                                   testAssign3D,             testAssignProfile3D,
                                                   testCopyConstructor3D,    testCopyConstructorProfile3D,
                                                   testClone3D,              testCloneProfile3D,
-                                                  testCloneHn<THnD>,        testCloneHn<THnSparseD>
+                                                  testCloneHn<THnD>,        testCloneHn<THnSparseD>,
+                                                  testCloneCompact1D
    };
    struct TTestSuite copyTestSuite = { numberOfCopy,
                                        "Copy tests for 1D, 2D and 3D Histograms and Profiles.............",
@@ -9988,7 +10629,7 @@ int stressHistogram()
 
    // Test 10
    // Merge Tests
-   const unsigned int numberOfMerge = 49;
+   const unsigned int numberOfMerge = 53;
    pointer2Test mergeTestPointer[numberOfMerge] = { testMerge1D,                 testMergeProf1D,
                                                     testMergeVar1D,              testMergeProfVar1D,
                                                     testMerge2D,                 testMergeProf2D,
@@ -10014,7 +10655,9 @@ int stressHistogram()
                                                     testMerge3DDiffEmpty,        testMergeProf1DDiffEmpty,
                                                     testMerge1DRebin,            testMerge2DRebin,
                                                     testMerge3DRebin,            testMerge1DRebinProf,
-                                                    testMerge1DNoLimits
+                                                    testMerge1DNoLimits,         testMergeParallel,
+                                                    testMergeParallelHn<THnD>,   testMergeParallelHn<THnSparseD>,
+                                                    testMergeCompact3D
    };
    struct TTestSuite mergeTestSuite = { numberOfMerge,
                                         "Merge tests for 1D, 2D and 3D Histograms and Profiles............",
@@ -10031,11 +10674,13 @@ int stressHistogram()
 
    // Test 12
    // Interpolation Tests
-   const unsigned int numberOfInterpolation = 4;
+   const unsigned int numberOfInterpolation = 6;
    pointer2Test interpolationTestPointer[numberOfInterpolation] = { testInterpolation1D,
                                                                     testInterpolationVar1D,
                                                                     testInterpolation2D,
-                                                                    testInterpolation3D
+                                                                    testInterpolation3D,
+                                                                    testGraphEval,
+                                                                    testKDEEvaluation
    };
    struct TTestSuite interpolationTestSuite = { numberOfInterpolation,
                                                 "Interpolation tests for Histograms...............................",
@@ -10063,14 +10708,24 @@ int stressHistogram()
                                            "Integral tests for Histograms....................................",
                                            integralTestPointer };
 
-   const unsigned int numberOfBufferTest = 4;
+   const unsigned int numberOfBufferTest = 14;
    pointer2Test bufferTestPointer[numberOfBufferTest] = { testH1Buffer,
                                                           testH1BufferWeights,
                                                           testH2Buffer,
-                                                          testH3Buffer
+                                                          testH3Buffer,
+                                                          testH1FillN,
+                                                          testH2FillN,
+                                                          testH3FillN,
+                                                          testH2PolyFillN,
+                                                          testHnFillN<THnSparseD>,
+                                                          testHnFillN<THnD>,
+                                                          testConcurrentFill1D,
+                                                          testConcurrentFill2D,
+                                                          testConcurrentFill3D,
+                                                          testConcurrentFillIntLabels
    };
    struct TTestSuite bufferTestSuite = { numberOfBufferTest,
-                                           "Buffer tests for Histograms......................................",
+                                           "Buffer and FillN tests for Histograms............................",
                                            bufferTestPointer };
 
    const unsigned int numberOfExtendTest = 4;
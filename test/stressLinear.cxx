@@ -54,6 +54,7 @@
 // Test 12 : Matrix Vector Multiplications..........................OK  //
 // Test 13 : Matrix Inversion.......................................OK  //
 // Test 14 : Matrix Persistence.....................................OK  //
+// Test 15 : Blocked Multiplications and Decompositions.............OK  //
 // ******************************************************************   //
 // *  Starting  Sparse Matrix - S T R E S S                         *   //
 // ******************************************************************   //
@@ -98,6 +99,7 @@
 #include <TGraph.h>
 #include <TROOT.h>
 #include "TMath.h"
+#include "RConfigure.h"
 
 #include "TMatrixF.h"
 #include "TMatrixFSym.h"
@@ -138,6 +140,10 @@ void mstress_sym_mm_multiplications(Int_t msize);
 void mstress_vm_multiplications    ();
 void mstress_inversion             ();
 void mstress_matrix_io             ();
+void mstress_blocked_kernels       ();
+TMatrixD naive_mult                (const TMatrixD &a,const TMatrixD &b);
+void     naive_lu                  (TMatrixD &a,Bool_t implicit);
+TMatrixD naive_chol                (const TMatrixDSym &a);
 
 void spstress_allocation           (Int_t msize);
 void spstress_matrix_fill          (Int_t rsize,Int_t csize);
@@ -235,6 +241,7 @@ void stressLinear(Int_t maxSizeReq,Int_t verbose)
     mstress_inversion();
 
     mstress_matrix_io();
+    mstress_blocked_kernels();
     std::cout << "******************************************************************" <<std::endl;
   }
 
@@ -2158,6 +2165,177 @@ void mstress_matrix_io()
   StatusPrint(14,"Matrix Persistence",ok);
 }
 
+//
+//------------------------------------------------------------------------
+//   Textbook versions of the products and decompositions, which serve as
+//   reference for the blocked (and multithreaded) kernels of the library
+//
+TMatrixD naive_mult(const TMatrixD &a,const TMatrixD &b)
+{
+  const Int_t nrows = a.GetNrows();
+  const Int_t nk    = a.GetNcols();
+  const Int_t ncols = b.GetNcols();
+  const Double_t *ap = a.GetMatrixArray();
+  const Double_t *bp = b.GetMatrixArray();
+  TMatrixD c(nrows,ncols);
+  Double_t *cp = c.GetMatrixArray();
+  for (Int_t i = 0; i < nrows; i++) {
+    for (Int_t j = 0; j < ncols; j++) {
+      Double_t cij = 0;
+      for (Int_t k = 0; k < nk; k++)
+        cij += ap[i*nk+k]*bp[k*ncols+j];
+      cp[i*ncols+j] = cij;
+    }
+  }
+  return c;
+}
+
+// in place, with the pivoting of TDecompLU (scaled for implicit, Crout, or not, Gauss)
+void naive_lu(TMatrixD &a,Bool_t implicit)
+{
+  const Int_t n = a.GetNrows();
+  Double_t *ap = a.GetMatrixArray();
+  TArrayD scale(n);
+  for (Int_t i = 0; i < n; i++) {
+    Double_t max = 0.0;
+    for (Int_t j = 0; j < n; j++)
+      max = TMath::Max(max,TMath::Abs(ap[i*n+j]));
+    scale[i] = (!implicit ? 1.0 : (max == 0.0 ? 0.0 : 1.0/max));
+  }
+  for (Int_t j = 0; j < n; j++) {
+    Int_t imax = j;
+    Double_t max = (implicit ? 0.0 : TMath::Abs(ap[j*n+j]));
+    for (Int_t i = (implicit ? j : j+1); i < n; i++) {
+      const Double_t tmp = scale[i]*TMath::Abs(ap[i*n+j]);
+      if (tmp > max || (implicit && tmp == max)) {
+        max = tmp;
+        imax = i;
+      }
+    }
+    if (imax != j) {
+      for (Int_t k = 0; k < n; k++) {
+        const Double_t tmp = ap[imax*n+k];
+        ap[imax*n+k] = ap[j*n+k];
+        ap[j*n+k]    = tmp;
+      }
+      scale[imax] = scale[j];
+    }
+    for (Int_t i = j+1; i < n; i++) {
+      if (implicit)
+        ap[i*n+j] *= 1.0/ap[j*n+j];
+      else
+        ap[i*n+j] /= ap[j*n+j];
+      for (Int_t k = j+1; k < n; k++)
+        ap[i*n+k] -= ap[i*n+j]*ap[j*n+k];
+    }
+  }
+}
+
+// upper triangular U with A = U^T * U, computed row by row
+TMatrixD naive_chol(const TMatrixDSym &a)
+{
+  const Int_t n = a.GetNrows();
+  const Double_t *ap = a.GetMatrixArray();
+  TMatrixD u(n,n);
+  Double_t *up = u.GetMatrixArray();
+  for (Int_t i = 0; i < n; i++) {
+    Double_t uii = ap[i*n+i];
+    for (Int_t k = 0; k < i; k++)
+      uii -= up[k*n+i]*up[k*n+i];
+    up[i*n+i] = TMath::Sqrt(uii);
+    for (Int_t j = i+1; j < n; j++) {
+      Double_t uij = ap[i*n+j];
+      for (Int_t k = 0; k < i; k++)
+        uij -= up[k*n+i]*up[k*n+j];
+      up[i*n+j] = uij/up[i*n+i];
+    }
+  }
+  return u;
+}
+
+//
+//------------------------------------------------------------------------
+//   Verify the blocked products and LU/Cholesky decompositions against the
+//   textbook loops for sizes around the block sizes of the kernels (64, 128)
+//   and, with implicit multithreading, above the threshold for the threads.
+//   The terms of each element are summed in the same order, so the results
+//   only differ when the compiler contracts the multiply-adds differently.
+//
+void mstress_blocked_kernels()
+{
+  if (gVerbose)
+    std::cout << "\n---> Verify the blocked products and decompositions" << std::endl;
+
+  Bool_t ok = kTRUE;
+  const Int_t nrSizes = 12;
+  const Int_t sizes[nrSizes] = {1,3,4,5,63,64,65,127,128,129,130,257};
+
+  Int_t nrPasses = 1;
+#ifdef R__USE_IMT
+  nrPasses = 2;
+#endif
+  Double_t seed = 4357;
+  for (Int_t ipass = 0; ipass < nrPasses && ok; ipass++) {
+#ifdef R__USE_IMT
+    if (ipass == 1)
+      ROOT::EnableImplicitMT();
+#endif
+    for (Int_t isize = 0; isize < nrSizes && ok; isize++) {
+      const Int_t msize = sizes[isize];
+      const Double_t epsilon = EPSILON*msize;
+      const Int_t verbose = (gVerbose && isize == nrSizes-1);
+
+      if (verbose)
+        std::cout << "\nTest A*B, A^T*B and A*B^T for the size " << msize
+                  << (ipass ? " with threads" : "") << std::endl;
+      TMatrixD a(msize+2,msize);
+      a.Randomize(-1.0,1.0,seed);
+      TMatrixD b(msize,msize+1);
+      b.Randomize(-1.0,1.0,seed);
+      const TMatrixD at(TMatrixD::kTransposed,a);
+      const TMatrixD bt(TMatrixD::kTransposed,b);
+      const TMatrixD ab = naive_mult(a,b);
+      ok &= VerifyMatrixIdentity(TMatrixD(a,TMatrixD::kMult,b),ab,verbose,epsilon);
+      ok &= VerifyMatrixIdentity(TMatrixD(at,TMatrixD::kTransposeMult,b),ab,verbose,epsilon);
+      ok &= VerifyMatrixIdentity(TMatrixD(a,TMatrixD::kMultTranspose,bt),ab,verbose,epsilon);
+
+      if (verbose)
+        std::cout << "Test the LU decompositions, with and without implicit pivoting" << std::endl;
+      TMatrixD m(msize,msize);
+      m.Randomize(-1.0,1.0,seed);
+      for (Int_t implicit = 0; implicit < 2; implicit++) {
+        TDecompLU lu(m,0.0,implicit);
+        TMatrixD lu_naive = m;
+        naive_lu(lu_naive,implicit);
+        ok &= VerifyMatrixIdentity(lu.GetLU(),lu_naive,verbose,epsilon);
+      }
+
+      if (verbose)
+        std::cout << "Test the Cholesky decomposition" << std::endl;
+      TMatrixDSym s(msize);
+      const TMatrixD mtm = naive_mult(TMatrixD(TMatrixD::kTransposed,m),m);
+      for (Int_t i = 0; i < msize; i++)
+        for (Int_t j = 0; j < msize; j++)
+          s(i,j) = mtm(i,j)+(i == j ? 1.0 : 0.0);
+      TDecompChol chol(s);
+      ok &= chol.Decompose();
+      ok &= VerifyMatrixIdentity(chol.GetU(),naive_chol(s),verbose,epsilon);
+
+      if (!ok && gVerbose)
+        std::cout << "Blocked kernels failed for size " << msize << (ipass ? " with threads" : "") << std::endl;
+    }
+  }
+#ifdef R__USE_IMT
+  // also when a failure stopped the threaded pass
+  ROOT::DisableImplicitMT();
+#endif
+
+  if (gVerbose)
+    std::cout << "\nDone\n" << std::endl;
+
+  StatusPrint(15,"Blocked Multiplications and Decompositions",ok);
+}
+
 //------------------------------------------------------------------------
 //          Test allocation functions and compatibility check
 //
@@ -6,7 +6,8 @@
 //    TSPectrum test suite
 //    ====================
 //
-// This stress program tests many elements of the TSpectrum, TSpectrum2 classes.
+// This stress program tests many elements of the TSpectrum, TSpectrum2 and
+// TSpectrum3 classes.
 //
 // To run in batch, do
 //   stressSpectrum        : run 100 experiments with graphics (default)
@@ -37,6 +38,9 @@
 //****************************************************************************
 //Peak1 : found = 70.21/ 73.75, good = 65.03/ 68.60, ghost = 8.54/ 8.39,--- OK
 //Peak2 : found =163/300, good =163, ghost =8,----------------------------  OK
+//Spectrum1 : Background, Smoothing, Deconvolution, Search--------------- OK
+//Spectrum2 : Background, Smoothing, Deconvolution, Search--------------- OK
+//Spectrum3 : Background, Smoothing, Deconvolution, Search--------------- OK
 //****************************************************************************
 //stressSpectrum: Real Time =  19.86 seconds Cpu Time =  19.04 seconds
 //****************************************************************************
@@ -52,11 +56,14 @@
 #include "TRandom.h"
 #include "TSpectrum.h"
 #include "TSpectrum2.h"
+#include "TSpectrum3.h"
 #include "TStyle.h"
 #include "Riostream.h"
 #include "TROOT.h"
 #include "TMath.h"
 
+#include <vector>
+
 Int_t npeaks;
 Double_t fpeaks(Double_t *x, Double_t *par) {
    Double_t result = par[0] + par[1]*x[0];
@@ -248,6 +255,227 @@ void stress2(Int_t np2) {
           nfound,npeaks,ngood,nghost,sok);
 }
 
+// Peaks on a linear background used to check the array methods against the
+// reference values.
+Double_t refSpectrum1(Int_t i) {
+   const Double_t pos[5] = {100.3, 240.7, 262.1, 500.5, 800.2};
+   const Double_t amp[5] = {500, 2000, 800, 1500, 300};
+   Double_t v = 50 + 0.02 * i;
+   for (Int_t p = 0; p < 5; p++) {
+      Double_t t = (i - pos[p]) / 3.;
+      v += amp[p] * TMath::Exp(-0.5 * t * t);
+   }
+   return v;
+}
+Double_t refSpectrum2(Int_t i, Int_t j) {
+   const Double_t pos[3][2] = {{15.2, 20.4}, {40.6, 42.1}, {44.3, 12.8}};
+   const Double_t amp[3] = {1000, 600, 300};
+   Double_t v = 20 + 0.1 * i + 0.05 * j;
+   for (Int_t p = 0; p < 3; p++) {
+      Double_t tx = (i - pos[p][0]) / 2., ty = (j - pos[p][1]) / 2.;
+      v += amp[p] * TMath::Exp(-0.5 * (tx * tx + ty * ty));
+   }
+   return v;
+}
+Double_t refSpectrum3(Int_t i, Int_t j, Int_t k) {
+   const Double_t pos[2][3] = {{6.3, 8.1, 12.2}, {16.5, 15.4, 7.7}};
+   const Double_t amp[2] = {1000, 500};
+   Double_t v = 10 + 0.1 * i + 0.05 * j + 0.02 * k;
+   for (Int_t p = 0; p < 2; p++) {
+      Double_t tx = (i - pos[p][0]) / 2., ty = (j - pos[p][1]) / 2., tz = (k - pos[p][2]) / 2.;
+      v += amp[p] * TMath::Exp(-0.5 * (tx * tx + ty * ty + tz * tz));
+   }
+   return v;
+}
+// Append the sum of the channels and a sum weighted with the channel index
+// modulo 7 to the results.
+void addChecksums(std::vector<Double_t> &res, const std::vector<Double_t> &v) {
+   Double_t sum = 0, wsum = 0;
+   for (size_t i = 0; i < v.size(); i++) {
+      sum  += v[i];
+      wsum += (i % 7 + 1) * v[i];
+   }
+   res.push_back(sum);
+   res.push_back(wsum);
+}
+// Compare the results with the reference values. The tolerance allows for
+// rounding differences in the summation order of the deconvolution.
+Bool_t checkReference(const char *name, const std::vector<Double_t> &res, const Double_t *ref, Int_t nref) {
+   if ((Int_t)res.size() != nref) {
+      printf("%s : %d results, should be %d\n", name, (Int_t)res.size(), nref);
+      return kFALSE;
+   }
+   Bool_t ok = kTRUE;
+   for (Int_t i = 0; i < nref; i++) {
+      if (TMath::Abs(res[i] - ref[i]) > 1e-8 * TMath::Max(1., TMath::Abs(ref[i]))) {
+         printf("%s : result %d = %.15g, should be %.15g\n", name, i, res[i], ref[i]);
+         ok = kFALSE;
+      }
+   }
+   return ok;
+}
+// Check the background, smoothing, deconvolution and peak search of the
+// array methods of TSpectrum, TSpectrum2 and TSpectrum3 against reference
+// values obtained with the sequential algorithms of ROOT 6.07.
+std::vector<Double_t> spectrumResults1() {
+   const Int_t n = 1024;
+   std::vector<Double_t> res;
+   std::vector<Double_t> v(n), dest(n), resp(n, 0.);
+   TSpectrum s;
+   for (Int_t i = 0; i < n; i++) v[i] = refSpectrum1(i);
+   s.Background(&v[0], n, 20, TSpectrum::kBackDecreasingWindow, TSpectrum::kBackOrder2, kFALSE, TSpectrum::kBackSmoothing3, kFALSE);
+   addChecksums(res, v);
+   for (Int_t i = 0; i < n; i++) v[i] = refSpectrum1(i);
+   s.Background(&v[0], n, 20, TSpectrum::kBackIncreasingWindow, TSpectrum::kBackOrder4, kTRUE, TSpectrum::kBackSmoothing5, kTRUE);
+   addChecksums(res, v);
+   for (Int_t i = 0; i < n; i++) v[i] = refSpectrum1(i);
+   s.SmoothMarkov(&v[0], n, 3);
+   addChecksums(res, v);
+   for (Int_t i = 0; i < 30; i++) resp[i] = TMath::Exp(-0.5 * (i - 10.) * (i - 10.) / 9.);
+   for (Int_t i = 0; i < n; i++) v[i] = refSpectrum1(i);
+   s.Deconvolution(&v[0], &resp[0], n, 200, 5, 1.2);
+   addChecksums(res, v);
+   for (Int_t i = 0; i < n; i++) v[i] = refSpectrum1(i);
+   s.DeconvolutionRL(&v[0], &resp[0], n, 200, 1, 1);
+   addChecksums(res, v);
+   for (Int_t i = 0; i < n; i++) v[i] = refSpectrum1(i);
+   Int_t npeaks = s.SearchHighRes(&v[0], &dest[0], n, 3, 5, kTRUE, 3, kTRUE, 3);
+   addChecksums(res, dest);
+   res.push_back(npeaks);
+   for (Int_t p = 0; p < npeaks; p++) res.push_back(s.GetPositionX()[p]);
+   return res;
+}
+std::vector<Double_t> spectrumResults2() {
+   const Int_t n = 64;
+   std::vector<Double_t> res;
+   std::vector<Double_t> buf(n * n), out(n * n), rbuf(n * n, 0.);
+   std::vector<Double_t *> v(n), dest(n), resp(n);
+   for (Int_t i = 0; i < n; i++) {
+      v[i] = &buf[i * n];
+      dest[i] = &out[i * n];
+      resp[i] = &rbuf[i * n];
+   }
+   for (Int_t i = 0; i < 8; i++)
+      for (Int_t j = 0; j < 8; j++) resp[i][j] = TMath::Exp(-0.5 * ((i - 3.) * (i - 3.) + (j - 3.) * (j - 3.)) / 4.);
+   TSpectrum2 s;
+   for (Int_t step = 0; step < 5; step++) {
+      for (Int_t i = 0; i < n; i++)
+         for (Int_t j = 0; j < n; j++) v[i][j] = refSpectrum2(i, j);
+      if (step == 0) s.Background(&v[0], n, n, 8, 8, TSpectrum2::kBackDecreasingWindow, TSpectrum2::kBackSuccessiveFiltering);
+      if (step == 1) s.Background(&v[0], n, n, 6, 4, TSpectrum2::kBackIncreasingWindow, TSpectrum2::kBackOneStepFiltering);
+      if (step == 2) s.SmoothMarkov(&v[0], n, n, 3);
+      if (step == 3) s.Deconvolution(&v[0], &resp[0], n, n, 100, 2, 1.2);
+      if (step < 4) {
+         addChecksums(res, buf);
+         continue;
+      }
+      Int_t npeaks = s.SearchHighRes(&v[0], &dest[0], n, n, 2, 5, kTRUE, 3, kTRUE, 3);
+      addChecksums(res, out);
+      res.push_back(npeaks);
+      for (Int_t p = 0; p < npeaks; p++) {
+         res.push_back(s.GetPositionX()[p]);
+         res.push_back(s.GetPositionY()[p]);
+      }
+   }
+   return res;
+}
+std::vector<Double_t> spectrumResults3() {
+   const Int_t n = 24;
+   std::vector<Double_t> res;
+   std::vector<Double_t> buf(n * n * n), out(n * n * n), rbuf(n * n * n, 0.);
+   std::vector<Double_t *> rows(3 * n * n);
+   std::vector<Double_t **> v(n), dest(n), resp(n);
+   for (Int_t i = 0; i < n; i++) {
+      v[i] = &rows[i * n];
+      dest[i] = &rows[(n + i) * n];
+      resp[i] = &rows[(2 * n + i) * n];
+      for (Int_t j = 0; j < n; j++) {
+         v[i][j] = &buf[(i * n + j) * n];
+         dest[i][j] = &out[(i * n + j) * n];
+         resp[i][j] = &rbuf[(i * n + j) * n];
+      }
+   }
+   for (Int_t i = 0; i < 6; i++)
+      for (Int_t j = 0; j < 6; j++)
+         for (Int_t k = 0; k < 6; k++)
+            resp[i][j][k] = TMath::Exp(-0.5 * ((i - 2.) * (i - 2.) + (j - 2.) * (j - 2.) + (k - 2.) * (k - 2.)) / 2.25);
+   TSpectrum3 s;
+   for (Int_t step = 0; step < 6; step++) {
+      for (Int_t i = 0; i < n; i++)
+         for (Int_t j = 0; j < n; j++)
+            for (Int_t k = 0; k < n; k++) v[i][j][k] = refSpectrum3(i, j, k);
+      if (step == 0) s.Background(&v[0], n, n, n, 4, 4, 4, TSpectrum3::kBackDecreasingWindow, TSpectrum3::kBackSuccessiveFiltering);
+      if (step == 1) s.Background(&v[0], n, n, n, 3, 3, 2, TSpectrum3::kBackIncreasingWindow, TSpectrum3::kBackOneStepFiltering);
+      if (step == 2) s.SmoothMarkov(&v[0], n, n, n, 3);
+      if (step == 3) s.Deconvolution(&v[0], (const Double_t ***)&resp[0], n, n, n, 50, 2, 1.2);
+      if (step < 4) {
+         addChecksums(res, buf);
+         continue;
+      }
+      Int_t npeaks;
+      if (step == 4)
+         npeaks = s.SearchHighRes((const Double_t ***)&v[0], &dest[0], n, n, n, 2, 5, kTRUE, 3, kTRUE, 3);
+      else
+         npeaks = s.SearchFast((const Double_t ***)&v[0], &dest[0], n, n, n, 2, 5, kTRUE, 3);
+      addChecksums(res, out);
+      res.push_back(npeaks);
+      for (Int_t p = 0; p < npeaks; p++) {
+         res.push_back(s.GetPositionX()[p]);
+         res.push_back(s.GetPositionY()[p]);
+         res.push_back(s.GetPositionZ()[p]);
+      }
+   }
+   return res;
+}
+void stress3() {
+   // reference values obtained with the sequential algorithms of ROOT 6.07,
+   // the z direction of the 3-d Markov smoothing corrected
+   const Double_t ref1[18] = {
+      61704.88443339958, 246549.14323620099, 62065.585688476596, 247915.95944200145,
+      100026.93260185426, 398903.70156297227, 99712.532956209005, 398339.67582871369,
+      100026.93260185441, 397984.81027393613, 27475.651246240501, 109679.99562884164,
+      5, 240.96971130558842, 500.95291317103488, 262.00940592642786,
+      100.02218687126647, 800.01334594780303};
+   const Double_t ref2[17] = {
+      102258.70370427272, 408982.37876203877, 101907.2850777181, 407845.25452809338,
+      149051.64560354911, 591290.7912642709, 148715.11793964516, 572916.10209010344,
+      23678.954399582322, 94100.647776629063, 3, 15.04052155713511,
+      20.93283313571748, 40.988664153516048, 42.005825468859079, 44.044935654329535,
+      13.00214156402332};
+   const Double_t ref3[32] = {
+      307895.72002054343, 1231787.3908286789, 346656.41105130926, 1386577.3391085961,
+      354226.94210066553, 1416842.6695764533, 352594.15460224618, 1410990.9621627398,
+      15769.697330491712, 63076.074083684383, 5, 6.0080824555718406,
+      16.00125428253207, 20.992194526316219, 6.9362230131787168, 8.0364077752875591,
+      12.055332140042019, 14.00576038749775, 8.0001368560542421, 20.996636356169617,
+      16.970932547066326, 15.058183367999385, 8.0022632022434532, 22.996775037663951,
+      15.99528738808581, 17.005292662941855, 614.91655417688901, 2459.849891669809,
+      1, 6.90851310829186, 8.0918996366927427, 12.1104036049689};
+   const char *names[3] = {"Spectrum1", "Spectrum2", "Spectrum3"};
+   const Double_t *refs[3] = {ref1, ref2, ref3};
+   const Int_t nrefs[3] = {18, 17, 32};
+   Int_t nmt = 1;
+#ifdef R__USE_IMT
+   // the parallel algorithms must give the same results
+   nmt = 2;
+#endif
+   Bool_t ok[3] = {kTRUE, kTRUE, kTRUE};
+   for (Int_t mt = 0; mt < nmt; mt++) {
+#ifdef R__USE_IMT
+      if (mt) ROOT::EnableImplicitMT();
+#endif
+      ok[0] &= checkReference(names[0], spectrumResults1(), refs[0], nrefs[0]);
+      ok[1] &= checkReference(names[1], spectrumResults2(), refs[1], nrefs[1]);
+      ok[2] &= checkReference(names[2], spectrumResults3(), refs[2], nrefs[2]);
+#ifdef R__USE_IMT
+      if (mt) ROOT::DisableImplicitMT();
+#endif
+   }
+   for (Int_t k = 0; k < 3; k++)
+      printf("%s : Background, Smoothing, Deconvolution, Search--------------- %s\n",
+             names[k], ok[k] ? "OK" : "FAILED");
+}
+
 void stressSpectrum(Int_t ntimes=100) {
    std::cout << "****************************************************************************" <<std::endl;
    std::cout << "*  Starting  stress S P E C T R U M                                        *" <<std::endl;
@@ -256,6 +484,7 @@ void stressSpectrum(Int_t ntimes=100) {
    stress1(ntimes);
    stress2(300);
    gBenchmark->Stop ("stressSpectrum");
+   stress3();
    Double_t reftime100 = 19.04; //pcbrun compiled
    Double_t ct = gBenchmark->GetCpuTime("stressSpectrum");
    const Double_t rootmarks = 800*reftime100*ntimes/(100*ct);
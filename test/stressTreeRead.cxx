@@ -0,0 +1,477 @@
+/////////////////////////////////////////////////////////////////
+//
+//___A stress test for the reading of trees and chains___
+//
+//   The functions below test the reading of trees with TTreeReader
+//   and TChain when some of the data are missing or unreadable
+//   - Test1() - reading a TTreeReaderArray through a chain in which one
+//               tree does not have the branch, and a missing branch
+//   - Test2() - counting the entries of a chain with an entries cache file
+//               when some files cannot be read
+//   - Test3() - reading a chain which opens the next file in the background,
+//               sequentially and with jumps to another tree
+//   - Test4() - per-branch counters of TTreePerfStats, printed and saved
+//               in JSON format
+//   - Test5() - exact and best lookups of a TTreeIndex, also after appending
+//               indices with a delayed sort
+//
+//   To run in batch mode, do
+//     stressTreeRead
+//     stressTreeRead 1000
+//   Here the parameter is the number of entries in each TTree.
+//   Default value is 1000
+//
+//   An example of output when all tests pass:
+// **********************************************************************
+// ***************Starting tree reading stress test**********************
+// **********************************************************************
+// Test1: TTreeReaderArray with missing branches---------------------- OK
+// Test2: TChain entries cache with unreadable files------------------- OK
+// Test3: TChain open-ahead of the next file-------------------------- OK
+// Test4: TTreePerfStats per-branch counters--------------------------- OK
+// Test5: TTreeIndex lookups with duplicate and missing keys----------- OK
+// **********************************************************************
+
+#include <list>
+#include <string>
+#include <fstream>
+#include <vector>
+#include <functional>
+#include <stdlib.h>
+#include "TApplication.h"
+#include "TTree.h"
+#include "TChain.h"
+#include "TFile.h"
+#include "TROOT.h"
+#include "TError.h"
+#include "TSystem.h"
+#include "TTreeReader.h"
+#include "TTreeReaderArray.h"
+#include "TTreePerfStats.h"
+#include "TTreeIndex.h"
+#include "TBranch.h"
+
+Int_t stressTreeRead(Int_t nentries = 1000);
+
+const char* gTreeReadFileNameTemplate = "stressTreeRead_%d.root";
+const Int_t gTreeReadNFiles = 2;
+
+Bool_t Test1(Int_t nentries)
+{
+   // Read the vector branch a of the chain file0, file1, file0, where the tree
+   // of file1 has no branch a. The entries of file1 must be seen as empty
+   // read errors, without affecting the entries read before and after them.
+   // A reader of a branch which does not exist must not read any entry.
+
+   TChain chain("T");
+   chain.Add("stressTreeRead_0.root");
+   chain.Add("stressTreeRead_1.root");
+   chain.Add("stressTreeRead_0.root");
+
+   Int_t errorLevel = gErrorIgnoreLevel;
+   gErrorIgnoreLevel = kFatal;
+
+   TTreeReader reader(&chain);
+   TTreeReaderArray<Float_t> a(reader, "a");
+   Long64_t nerrors = 0;
+   Long64_t nwrong = 0;
+   while (reader.Next()) {
+      Long64_t entry = reader.GetCurrentEntry();
+      size_t size = a.GetSize();
+      if (a.GetReadStatus() == ROOT::Internal::TTreeReaderValueBase::kReadError) {
+         ++nerrors;
+         if (size != 0) ++nwrong;
+         continue;
+      }
+      Int_t ientry = entry % nentries;
+      if (size != size_t(ientry % 5)) {
+         ++nwrong;
+         continue;
+      }
+      for (size_t i = 0; i < size; ++i) {
+         if (a[i] != ientry + 0.5f * i) ++nwrong;
+      }
+   }
+
+   TTreeReader readerMissing(&chain);
+   TTreeReaderArray<Float_t> missing(readerMissing, "nonexistent");
+   Bool_t missingRead = readerMissing.Next();
+   Bool_t missingOk = !missingRead && missing.GetSize() == 0
+      && missing.GetReadStatus() == ROOT::Internal::TTreeReaderValueBase::kReadError;
+
+   gErrorIgnoreLevel = errorLevel;
+
+   if (nerrors != nentries)
+      printf("\nnumber of entries with read errors = %lld, should be %d\n", nerrors, nentries);
+   if (nwrong > 0)
+      printf("\nnumber of wrong values = %lld\n", nwrong);
+   if (!missingOk)
+      printf("\nthe reader of a missing branch has read an entry\n");
+   return nerrors == nentries && nwrong == 0 && missingOk;
+}
+
+Bool_t Test2(Int_t nentries)
+{
+   // Count the entries of a chain with an entries cache file, where one file
+   // is not a ROOT file and another one does not contain the tree. Only the
+   // number of entries of the readable tree must be recorded in the cache,
+   // and a second chain must find the same number of entries.
+
+   const char *cachename = "stressTreeRead_entries.txt";
+   const char *badname = "stressTreeRead_bad.root";
+   gSystem->Unlink(cachename);
+   {
+      std::ofstream bad(badname);
+      bad << "this is not a ROOT file\n";
+   }
+
+   Int_t errorLevel = gErrorIgnoreLevel;
+   gErrorIgnoreLevel = kFatal;
+
+   Long64_t entries[2];
+   for (Int_t k = 0; k < 2; ++k) {
+      TChain chain("T");
+      chain.Add("stressTreeRead_0.root");
+      chain.Add(badname);
+      chain.Add("stressTreeRead_1.root/U");
+      chain.SetEntriesCacheFile(cachename);
+      entries[k] = chain.GetEntries();
+   }
+
+   gErrorIgnoreLevel = errorLevel;
+
+   Int_t nlines = 0;
+   Int_t nwrong = 0;
+   {
+      std::ifstream in(cachename);
+      std::string line;
+      while (std::getline(in, line)) {
+         ++nlines;
+         if (line.find("stressTreeRead_0.root") == std::string::npos) ++nwrong;
+      }
+   }
+   gSystem->Unlink(cachename);
+   gSystem->Unlink(badname);
+
+   if (entries[0] != nentries || entries[1] != nentries)
+      printf("\nnumber of entries = %lld and %lld, should be %d\n", entries[0], entries[1], nentries);
+   if (nlines != 1 || nwrong > 0)
+      printf("\nthe cache file has %d lines, %d for trees which could not be read\n", nlines, nwrong);
+   return entries[0] == nentries && entries[1] == nentries && nlines == 1 && nwrong == 0;
+}
+
+Bool_t Test3(Int_t nentries)
+{
+   // Read the branch n of the chain file0, file1, file0, file1, opening the
+   // file of the next tree in the background from the middle of each tree.
+   // All the entries must be read as without the open-ahead, also after a jump
+   // to a tree which is not the one being opened ahead; the file opened ahead
+   // must then be closed.
+
+   TChain chain("T");
+   for (Int_t k = 0; k < 2; ++k) {
+      chain.Add("stressTreeRead_0.root");
+      chain.Add("stressTreeRead_1.root");
+   }
+   chain.SetOpenAheadFraction(0.5);
+   Int_t n = 0;
+   chain.SetBranchAddress("n", &n);
+
+   Long64_t nwrong = 0;
+   Long64_t nentriesChain = chain.GetEntries();
+   for (Long64_t entry = 0; entry < nentriesChain; ++entry) {
+      if (chain.GetEntry(entry) <= 0 || n != (entry % nentries) % 5) ++nwrong;
+   }
+
+   // Start opening the file of tree 1 from the end of tree 0, then jump to tree 3.
+   Long64_t entry0 = nentries - 2;
+   Long64_t entry3 = 3 * nentries + 1;
+   chain.GetEntry(entry0);
+   chain.GetEntry(entry0 + 1);
+   if (chain.GetEntry(entry3) <= 0 || n != (entry3 % nentries) % 5) ++nwrong;
+   Int_t nfiles = 0;
+   TIter next(gROOT->GetListOfFiles());
+   while (TObject *obj = next()) {
+      if (TString(obj->GetName()).BeginsWith("stressTreeRead_")) ++nfiles;
+   }
+
+   if (nentriesChain != 4 * nentries)
+      printf("\nnumber of entries = %lld, should be %d\n", nentriesChain, 4 * nentries);
+   if (nwrong > 0)
+      printf("\nnumber of wrong entries = %lld\n", nwrong);
+   if (nfiles != 1)
+      printf("\nnumber of open files after the jump = %d, should be 1\n", nfiles);
+   return nentriesChain == 4 * nentries && nwrong == 0 && nfiles == 1;
+}
+
+Bool_t Test4(Int_t nentries)
+{
+   // Read all the entries of the tree of file 0 with a TTreePerfStats. For
+   // each branch the bytes and the number of baskets read must be those of
+   // the baskets of the branch, and all the entries must be deserialized.
+   // The counters must appear in the table of Print("branches") and in the
+   // file written by SaveAs(".json").
+
+   const char *printname = "stressTreeRead_perf.txt";
+   const char *jsonname = "stressTreeRead_perf.json";
+   TFile f("stressTreeRead_0.root");
+   TTree *tree = (TTree*)f.Get("T");
+   if (!tree) return kFALSE;
+   TTreePerfStats *ps = new TTreePerfStats("ioperf", tree);
+   for (Long64_t entry = 0; entry < nentries; ++entry) tree->GetEntry(entry);
+   tree->SetPerfStats(0);
+
+   gSystem->RedirectOutput(printname, "w");
+   ps->Print("branches");
+   gSystem->RedirectOutput(0);
+   ps->SaveAs(jsonname);
+
+   std::string printed, json, line;
+   {
+      std::ifstream in(printname);
+      while (std::getline(in, line)) printed += line + "\n";
+   }
+   {
+      std::ifstream in(jsonname);
+      while (std::getline(in, line)) json += line + "\n";
+   }
+
+   Int_t nwrong = 0;
+   const std::vector<TTreePerfStats::BranchStats_t> &stats = ps->GetBranchStats();
+   TIter next(tree->GetListOfBranches());
+   while (TBranch *branch = (TBranch*)next()) {
+      const TTreePerfStats::BranchStats_t *bs = 0;
+      for (auto const &s : stats) {
+         if (s.fName == branch->GetName()) bs = &s;
+      }
+      if (!bs) {
+         printf("\nno counters for branch %s\n", branch->GetName());
+         ++nwrong;
+         continue;
+      }
+      Int_t nbaskets = branch->GetWriteBasket();
+      Long64_t bytes = 0;
+      for (Int_t i = 0; i < nbaskets; ++i) bytes += branch->GetBasketBytes()[i];
+      if (bs->fReadCalls != nbaskets || bs->fBytesRead != bytes) {
+         printf("\nbranch %s: %d baskets and %lld bytes read, should be %d and %lld\n",
+                branch->GetName(), bs->fReadCalls, bs->fBytesRead, nbaskets, bytes);
+         ++nwrong;
+      }
+      if (bs->fBytesUnzipped <= 0 || bs->fBytesUnzipped > branch->GetTotBytes()) {
+         printf("\nbranch %s: %lld bytes unzipped\n", branch->GetName(), bs->fBytesUnzipped);
+         ++nwrong;
+      }
+      if (bs->fEntriesRead != nentries) {
+         printf("\nbranch %s: %lld entries read, should be %d\n", branch->GetName(), bs->fEntriesRead, nentries);
+         ++nwrong;
+      }
+      if (TString(branch->GetName()) == "n" && bs->fBytesStreamed != 4 * nentries) {
+         printf("\nbranch n: %lld bytes streamed, should be %d\n", bs->fBytesStreamed, 4 * nentries);
+         ++nwrong;
+      }
+      if (printed.find("\n" + std::string(branch->GetName()) + " ") == std::string::npos) {
+         printf("\nbranch %s not printed\n", branch->GetName());
+         ++nwrong;
+      }
+      TString entry = TString::Format("{\"name\": \"%s\", \"bytesRead\": %lld, \"bytesUnzipped\": %lld, "
+                                      "\"bytesStreamed\": %lld, \"readCalls\": %d, \"cacheMisses\": %d, "
+                                      "\"entriesRead\": %lld,", branch->GetName(), bs->fBytesRead,
+                                      bs->fBytesUnzipped, bs->fBytesStreamed, bs->fReadCalls,
+                                      bs->fCacheMisses, bs->fEntriesRead);
+      if (json.find(entry.Data()) == std::string::npos) {
+         printf("\nbranch %s not saved in JSON format\n", branch->GetName());
+         ++nwrong;
+      }
+   }
+   if (stats.size() != (size_t)tree->GetListOfBranches()->GetEntries()) {
+      printf("\ncounters of %d branches, should be %d\n", (Int_t)stats.size(),
+             tree->GetListOfBranches()->GetEntries());
+      ++nwrong;
+   }
+
+   delete ps;
+   gSystem->Unlink(printname);
+   gSystem->Unlink(jsonname);
+   return nwrong == 0;
+}
+
+TTree *MakeIndexTree(Int_t nentries, Int_t seed)
+{
+   // Creates a memory resident tree where the pairs (major,minor) are often
+   // repeated: major takes only even values and minor is in [0,3).
+
+   TTree *tree = new TTree("TI", "TI");
+   tree->SetDirectory(0);
+   Int_t major = 0, minor = 0;
+   tree->Branch("major", &major, "major/I");
+   tree->Branch("minor", &minor, "minor/I");
+   for (Int_t i = 0; i < nentries; ++i) {
+      major = 2 * ((7 * i + seed) % 11);
+      minor = (i * i + seed) % 3;
+      tree->Fill();
+   }
+   return tree;
+}
+
+Int_t CheckIndexLookups(const TTreeIndex &index, const std::vector<std::pair<Int_t,Int_t> > &values)
+{
+   // Compare the lookups of index with the bisection of the sorted values of
+   // the index (the implementation without hash table), and check that the
+   // entries found have the requested values. Returns the number of errors.
+
+   const Long64_t n = index.GetN();
+   const Long64_t *major = index.GetIndexValues();
+   const Long64_t *minor = index.GetIndexValuesMinor();
+   const Long64_t *entries = index.GetIndex();
+   Int_t nwrong = 0;
+   for (Long64_t i = 1; i < n; ++i) {
+      if (major[i] < major[i-1] || (major[i] == major[i-1] && minor[i] < minor[i-1])) ++nwrong;
+   }
+   for (Int_t ma = -2; ma < 25; ++ma) {
+      for (Int_t mi = -1; mi < 5; ++mi) {
+         Long64_t pos = 0, count = n;
+         while (count > 0) {
+            Long64_t step = count / 2;
+            Long64_t mid = pos + step;
+            if (major[mid] < ma || (major[mid] == ma && minor[mid] < mi)) {
+               pos = mid + 1;
+               count -= step + 1;
+            } else
+               count = step;
+         }
+         Bool_t found = pos < n && major[pos] == ma && minor[pos] == mi;
+         Long64_t exact = found ? entries[pos] : -1;
+         Long64_t best = found ? entries[pos] : (pos > 0 ? entries[pos-1] : -1);
+         if (index.GetEntryNumberWithIndex(ma, mi) != exact) ++nwrong;
+         if (index.GetEntryNumberWithBestIndex(ma, mi) != best) ++nwrong;
+
+         Bool_t exists = kFALSE;
+         for (auto const &v : values) {
+            if (v.first == ma && v.second == mi) exists = kTRUE;
+         }
+         if (exists != found) ++nwrong;
+         if (found && (values[exact].first != ma || values[exact].second != mi)) ++nwrong;
+      }
+   }
+   return nwrong;
+}
+
+Bool_t Test5(Int_t nentries)
+{
+   // Look up all the pairs (major,minor) of a range including duplicate and
+   // missing pairs, in the index of one tree and in the index made by appending
+   // the indices of three trees with a delayed sort.
+
+   std::vector<std::pair<Int_t,Int_t> > values;
+   TTree *trees[3];
+   for (Int_t k = 0; k < 3; ++k) {
+      trees[k] = MakeIndexTree(nentries + k, k);
+      for (Int_t i = 0; i < nentries + k; ++i) {
+         values.push_back(std::make_pair(2 * ((7 * i + k) % 11), (i * i + k) % 3));
+      }
+   }
+   std::vector<std::pair<Int_t,Int_t> > values0(values.begin(), values.begin() + nentries);
+
+   Int_t nwrong = 0;
+   {
+      // The lookups in the index of the first tree build its hash table,
+      // which must then be rebuilt after the appends.
+      TTreeIndex index(trees[0], "major", "minor");
+      nwrong += CheckIndexLookups(index, values0);
+
+      TTreeIndex index1(trees[1], "major", "minor");
+      TTreeIndex index2(trees[2], "major", "minor");
+      index.Append(&index1, kTRUE);
+      index.Append(&index2, kTRUE);
+      index.Append(0, kFALSE);
+      if (index.GetN() != (Long64_t)values.size()) {
+         printf("\nthe appended index has %lld entries, should be %d\n", index.GetN(), (Int_t)values.size());
+         ++nwrong;
+      } else {
+         nwrong += CheckIndexLookups(index, values);
+      }
+   }
+
+   for (Int_t k = 0; k < 3; ++k) delete trees[k];
+   if (nwrong > 0)
+      printf("\nnumber of wrong index lookups = %d\n", nwrong);
+   return nwrong == 0;
+}
+
+void MakeTrees(Int_t nentries)
+{
+   // Creates the files, each with one tree T of nentries. Entry i of the
+   // tree of file 0 has a vector a of i%5 elements i + 0.5*k; the tree of
+   // file 1 has only the size n.
+
+   Int_t n = 0;
+   std::vector<Float_t> a;
+   char buffer[50];
+   for (Int_t ifile = 0; ifile < gTreeReadNFiles; ifile++) {
+      snprintf(buffer, 50, gTreeReadFileNameTemplate, ifile);
+      TFile f(buffer, "RECREATE");
+      TTree *tree = new TTree("T", "T");
+      tree->Branch("n", &n, "n/I");
+      if (ifile == 0) tree->Branch("a", &a);
+      for (Int_t i = 0; i < nentries; i++) {
+         n = i % 5;
+         a.resize(n);
+         for (Int_t k = 0; k < n; ++k) a[k] = i + 0.5f * k;
+         tree->Fill();
+      }
+      tree->Write();
+      f.Close();
+   }
+}
+
+void CleanUp()
+{
+   char buffer[50];
+   for (Int_t i = 0; i < gTreeReadNFiles; i++) {
+      snprintf(buffer, 50, gTreeReadFileNameTemplate, i);
+      gSystem->Unlink(buffer);
+   }
+}
+
+Int_t stressTreeRead(Int_t nentries)
+{
+   MakeTrees(nentries);
+   printf("**********************************************************************\n");
+   printf("***************Starting tree reading stress test**********************\n");
+   printf("**********************************************************************\n");
+
+   Int_t retval = 0;
+   using fcnCharPtrPair = std::pair<std::function<bool(Int_t)>,const char*>;
+   std::list<fcnCharPtrPair> testDescrList = {
+      {Test1, "Test1: TTreeReaderArray with missing branches---------------------- "},
+      {Test2, "Test2: TChain entries cache with unreadable files------------------- "},
+      {Test3, "Test3: TChain open-ahead of the next file-------------------------- "},
+      {Test4, "Test4: TTreePerfStats per-branch counters--------------------------- "},
+      {Test5, "Test5: TTreeIndex lookups with duplicate and missing keys----------- "}
+   };
+
+   for (auto const & testDescrPair : testDescrList) {
+      auto test = testDescrPair.first;
+      auto descr = testDescrPair.second;
+      Bool_t testRes = test(nentries);
+      retval += !testRes; // increment by one upon failure
+      printf("%s %s\n", descr, testRes ? "OK" : "FAILED" );
+   }
+
+   printf("**********************************************************************\n");
+   CleanUp();
+   return retval;
+}
+//_____________________________batch only_____________________
+#ifndef __CINT__
+
+int main(int argc, char *argv[])
+{
+   gROOT->SetBatch();
+   TApplication theApp("App", &argc, argv);
+   Int_t nentries = 1000;
+   if (argc > 1) nentries = atoi(argv[1]);
+   return stressTreeRead(nentries);
+}
+
+#endif
@@ -35,6 +35,8 @@ class TCollection;
 class TChain : public TTree {
 
 protected:
+   class TOpenAhead;
+
    Int_t        fTreeOffsetLen;    ///<  Current size of fTreeOffset array
    Int_t        fNtrees;           ///<  Number of trees
    Int_t        fTreeNumber;       ///<! Current Tree number in fTreeOffset table
@@ -45,6 +47,9 @@ protected:
    TObjArray   *fFiles;            ///< -> List of file names containing the trees (TChainElement, owned)
    TList       *fStatus;           ///< -> List of active/inactive branches (TChainElement, owned)
    TChain      *fProofChain;       ///<! chain proxy when going to be processed by PROOF
+   TString      fEntriesCacheFile; ///<! Name of the file caching the number of entries of each tree
+   Float_t      fOpenAheadFraction;///<! Fraction of the current tree after which the next file is opened in the background (0: disabled)
+   TOpenAhead  *fOpenAhead;        ///<! Next file being opened in the background
 
 private:
    TChain(const TChain&);            // not implemented
@@ -53,7 +58,9 @@ private:
 
 protected:
    void InvalidateCurrentTree();
+   void OpenAhead(Long64_t treeReadEntry);
    void ReleaseChainProof();
+   void ReleaseOpenAhead();
 
 public:
    // TChain constants
@@ -81,6 +88,7 @@ public:
    virtual TFriendElement *AddFriend(TTree* chain, const char* alias = "", Bool_t warn = kFALSE);
    virtual void      Browse(TBrowser*);
    virtual void      CanDeleteRefs(Bool_t flag = kTRUE);
+           Long64_t  ComputeTreeOffsets();
    virtual void      CreatePackets();
    virtual void      DirectoryAutoAdd(TDirectory *);
    virtual Long64_t  Draw(const char* varexp, const TCut& selection, Option_t* option = "", Long64_t nentries = kMaxEntries, Long64_t firstentry = 0);
@@ -97,6 +105,7 @@ public:
            Int_t     GetNtrees() const { return fNtrees; }
    virtual Long64_t  GetEntries() const;
    virtual Long64_t  GetEntries(const char *sel) { return TTree::GetEntries(sel); }
+   const char       *GetEntriesCacheFile() const { return fEntriesCacheFile; }
    virtual Int_t     GetEntry(Long64_t entry=0, Int_t getall=0);
    virtual Long64_t  GetEntryNumber(Long64_t entry) const;
    virtual Int_t     GetEntryWithIndex(Int_t major, Int_t minor=0);
@@ -111,6 +120,7 @@ public:
    virtual const char *GetAlias(const char *aliasName) const;
    virtual Double_t  GetMaximum(const char *columname);
    virtual Double_t  GetMinimum(const char *columname);
+   Float_t           GetOpenAheadFraction() const { return fOpenAheadFraction; }
    virtual Int_t     GetNbranches();
    virtual Long64_t  GetReadEntry() const;
    TList            *GetStatus() const { return fStatus; }
@@ -156,10 +166,12 @@ public:
    virtual void      SetBranchStatus(const char *bname, Bool_t status=1, UInt_t *found=0);
    virtual Int_t     SetCacheSize(Long64_t cacheSize = -1);
    virtual void      SetDirectory(TDirectory *dir);
+   void              SetEntriesCacheFile(const char *filename) { fEntriesCacheFile = filename; }
    virtual void      SetEntryList(TEntryList *elist, Option_t *opt="");
    virtual void      SetEntryListFile(const char *filename="", Option_t *opt="");
    virtual void      SetEventList(TEventList *evlist);
    virtual void      SetMakeClass(Int_t make) { TTree::SetMakeClass(make); if (fTree) fTree->SetMakeClass(make);}
+   void              SetOpenAheadFraction(Float_t fraction = 0.9);
    virtual void      SetPacketSize(Int_t size = 100);
    virtual void      SetProof(Bool_t on = kTRUE, Bool_t refresh = kFALSE, Bool_t gettreeheader = kFALSE);
    virtual void      SetWeight(Double_t w=1, Option_t *option="");
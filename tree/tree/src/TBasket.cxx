@@ -450,6 +450,10 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
    Bool_t oldCase;
    char *rawUncompressedBuffer, *rawCompressedBuffer;
    Int_t uncompressedBufferLen;
+   Double_t readStart = 0;
+   Bool_t cacheMiss = kTRUE;
+   // Optional monitor for per-branch profiling.
+   TVirtualPerfStats *perfStats = fBranch->GetTree()->GetPerfStats();
 
    // See if the cache has already unzipped the buffer for us.
    TFileCacheRead *pf = nullptr;
@@ -463,7 +467,14 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
       char *buffer;
       res = pf->GetUnzipBuffer(&buffer, pos, len, &free);
       if (R__unlikely(res >= 0)) {
+         Int_t complen = len;
          len = ReadBasketBuffersUnzip(buffer, res, free, file);
+         if (R__unlikely(perfStats) && len >= 0) {
+            // The basket was read and unzipped by the cache.
+            Double_t now = TTimeStamp();
+            perfStats->BasketReadEvent(fBranch, complen, now, kFALSE);
+            if (len > 0) perfStats->BasketUnzipEvent(fBranch, now, complen, fObjlen);
+         }
          // Note that in the kNotDecompressed case, the above function will return 0;
          // In such a case, we should stop processing
          if (len <= 0) return -len;
@@ -491,6 +502,10 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
       return 1;
    }
 
+   if (R__unlikely(perfStats)) {
+      readStart = TTimeStamp();
+   }
+
    if (pf) {
       TVirtualPerfStats* temp = gPerfStats;
       if (fBranch->GetTree()->GetPerfStats() != 0) gPerfStats = fBranch->GetTree()->GetPerfStats();
@@ -515,6 +530,8 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
          if (ret) {
             return 1;
          }
+      } else {
+         cacheMiss = kFALSE;
       }
       gPerfStats = temp;
    } else {
@@ -528,6 +545,9 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
       }
       else gPerfStats = temp;
    }
+   if (R__unlikely(perfStats)) {
+      perfStats->BasketReadEvent(fBranch, len, readStart, cacheMiss);
+   }
    Streamer(*readBufferRef);
    if (IsZombie()) {
       return 1;
@@ -540,6 +560,9 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
    {
       if (R__likely(fObjlen+fKeylen == fNbytes)) {
          // The basket was really not compressed as expected.
+         if (R__unlikely(perfStats)) {
+            perfStats->BasketUnzipEvent(fBranch, TTimeStamp(), len, fObjlen);
+         }
          goto AfterBuffer;
       } else {
          // Well, somehow the buffer was compressed anyway, we have the compressed data in the uncompressed buffer
@@ -573,7 +596,7 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
 
       // Optional monitor for zip time profiling.
       Double_t start = 0;
-      if (R__unlikely(gPerfStats)) {
+      if (R__unlikely(gPerfStats || perfStats)) {
          start = TTimeStamp();
       }
 
@@ -593,6 +616,9 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
          if (R__unlikely(oldCase && (nin > fObjlen || nbuf > fObjlen))) {
             //buffer was very likely not compressed in an old version
             memcpy(rawUncompressedBuffer+fKeylen, rawCompressedObjectBuffer+fKeylen, fObjlen);
+            if (R__unlikely(perfStats)) {
+               perfStats->BasketUnzipEvent(fBranch, start, len, fObjlen);
+            }
             goto AfterBuffer;
          }
 
@@ -613,14 +639,20 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
       }
       len = fObjlen+fKeylen;
       TVirtualPerfStats* temp = gPerfStats;
-      if (fBranch->GetTree()->GetPerfStats() != 0) gPerfStats = fBranch->GetTree()->GetPerfStats();
+      if (perfStats != 0) gPerfStats = perfStats;
       if (R__unlikely(gPerfStats)) {
          gPerfStats->UnzipEvent(fBranch->GetTree(),pos,start,nintot,fObjlen);
       }
+      if (R__unlikely(perfStats)) {
+         perfStats->BasketUnzipEvent(fBranch,start,nintot,fObjlen);
+      }
       gPerfStats = temp;
    } else {
       // Nothing is compressed - copy over wholesale.
       memcpy(rawUncompressedBuffer, rawCompressedBuffer, len);
+      if (R__unlikely(perfStats)) {
+         perfStats->BasketUnzipEvent(fBranch, TTimeStamp(), len, fObjlen);
+      }
    }
 
 AfterBuffer:
@@ -37,8 +37,10 @@
 #include "TTree.h"
 #include "TTreeCache.h"
 #include "TTreeCacheUnzip.h"
+#include "TTimeStamp.h"
 #include "TVirtualMutex.h"
 #include "TVirtualPad.h"
+#include "TVirtualPerfStats.h"
 
 #include <atomic>
 #include <cstddef>
@@ -1309,7 +1311,17 @@ Int_t TBranch::GetEntry(Long64_t entry, Int_t getall)
    }
 
    // Int_t bufbegin = buf->Length();
-   (this->*fReadLeaves)(*buf);
+   // This runs for every entry: read the member through the inline, non
+   // virtual accessor so that the check costs a single load.
+   TVirtualPerfStats *perfStats = fTree->TTree::GetPerfStats();
+   if (R__unlikely(perfStats)) {
+      // Optional monitor for per-branch streamer time profiling.
+      Double_t start = TTimeStamp();
+      (this->*fReadLeaves)(*buf);
+      perfStats->BranchStreamerEvent(this, start, buf->Length() - bufbegin);
+   } else {
+      (this->*fReadLeaves)(*buf);
+   }
    return buf->Length() - bufbegin;
 }
 
@@ -54,8 +54,48 @@ the trees in the chain.
 #include "TFileStager.h"
 #include "TFilePrefetch.h"
 
+#include <fstream>
+#include <future>
+#include <map>
+#include <string>
+#include <vector>
+
+#ifdef R__USE_IMT
+#include "tbb/parallel_for.h"
+#endif
+
 ClassImp(TChain)
 
+////////////////////////////////////////////////////////////////////////////////
+/// Open a file of the chain and read its tree header in a background thread.
+/// See TChain::SetOpenAheadFraction.
+
+class TChain::TOpenAhead {
+private:
+   Int_t                fTreeNumber; // Number of the tree in the chain
+   std::future<TFile*>  fFile;       // File being opened
+
+public:
+   TOpenAhead(Int_t treenum, const char *filename, const char *treename) : fTreeNumber(treenum)
+   {
+      std::string fname(filename);
+      std::string tname(treename);
+      fFile = std::async(std::launch::async, [fname, tname]() {
+         TDirectory::TContext ctxt;
+         TFile *file = TFile::Open(fname.c_str());
+         if (file && !file->IsZombie()) {
+            // The tree stays attached to the file: the TFile::Get of
+            // TChain::LoadTree finds it in memory.
+            file->Get(tname.c_str());
+         }
+         return file;
+      });
+   }
+
+   Int_t  GetTreeNumber() const { return fTreeNumber; }
+   TFile *GetFile() { return fFile.get(); }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Default constructor.
 
@@ -71,6 +111,8 @@ TChain::TChain()
 , fFiles(0)
 , fStatus(0)
 , fProofChain(0)
+, fOpenAheadFraction(0)
+, fOpenAhead(0)
 {
    fTreeOffset = new Long64_t[fTreeOffsetLen];
    fFiles = new TObjArray(fTreeOffsetLen);
@@ -144,6 +186,8 @@ TChain::TChain(const char* name, const char* title)
 , fFiles(0)
 , fStatus(0)
 , fProofChain(0)
+, fOpenAheadFraction(0)
+, fOpenAhead(0)
 {
    //
    //*-*
@@ -175,6 +219,7 @@ TChain::~TChain()
 {
    gROOT->GetListOfCleanups()->Remove(this);
 
+   ReleaseOpenAhead();
    SafeDelete(fProofChain);
    fStatus->Delete();
    delete fStatus;
@@ -724,6 +769,133 @@ void TChain::CanDeleteRefs(Bool_t flag /* = kTRUE */)
    fCanDeleteRefs = flag;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the offset table of the chain with the number of entries of all its
+/// trees, without loading them in the chain.
+///
+/// The trees whose number of entries is not yet known are first looked up in
+/// the cache file set with SetEntriesCacheFile (if any). The cache records the
+/// size and modification time of each file, and an entry is only used if the
+/// file has not changed since it was recorded. The remaining files are opened
+/// to read the number of entries of their tree; when implicit multi-threading
+/// is enabled they are opened concurrently on the ROOT thread pool, whose size
+/// bounds the number of files open at the same time. The cache file is then
+/// updated with the new numbers.
+///
+/// As in LoadTree, a file which cannot be opened or which does not contain
+/// the tree counts as having no entries. Such files are not recorded in the
+/// cache file, so that they are opened again the next time.
+///
+/// GetEntries calls this function when implicit multi-threading is enabled
+/// or a cache file has been set. Example:
+/// ~~~{.cpp}
+///     ROOT::EnableImplicitMT(8);
+///     TChain ch("T");
+///     ch.Add("root://server//data/run*.root");
+///     ch.SetEntriesCacheFile("run_entries.txt");
+///     ch.GetEntries(); // files opened 8 at a time, or read from the cache
+/// ~~~
+/// Return the total number of entries in the chain.
+
+Long64_t TChain::ComputeTreeOffsets()
+{
+   struct CacheRecord_t {
+      Long64_t fSize;
+      Long_t   fMtime;
+      Long64_t fEntries;
+   };
+   typedef std::pair<std::string, std::string> CacheKey_t; // (tree name, file name)
+   std::map<CacheKey_t, CacheRecord_t> cache;
+
+   TString cachename = fEntriesCacheFile;
+   const Bool_t useCache = !cachename.IsNull();
+   if (useCache) {
+      gSystem->ExpandPathName(cachename);
+      // Each line is: entries size mtime treename filename
+      std::ifstream in(cachename.Data());
+      CacheRecord_t rec;
+      std::string tname, fname;
+      while (in >> rec.fEntries >> rec.fSize >> rec.fMtime >> tname) {
+         std::getline(in, fname);
+         fname.erase(0, fname.find_first_not_of(' '));
+         cache[CacheKey_t(tname, fname)] = rec;
+      }
+   }
+
+   std::vector<Int_t> todo;
+   std::vector<FileStat_t> stats(fNtrees);
+   std::vector<Bool_t> hasStat(fNtrees, kFALSE);
+   for (Int_t i = 0; i < fNtrees; ++i) {
+      TChainElement *element = (TChainElement*) fFiles->At(i);
+      if (!element || element->GetEntries() != TTree::kMaxEntries) continue;
+      if (useCache && gSystem->GetPathInfo(element->GetTitle(), stats[i]) == 0) {
+         hasStat[i] = kTRUE;
+         auto rec = cache.find(CacheKey_t(element->GetName(), element->GetTitle()));
+         if (rec != cache.end() && rec->second.fSize == stats[i].fSize
+             && rec->second.fMtime == stats[i].fMtime) {
+            element->SetNumberEntries(rec->second.fEntries);
+            continue;
+         }
+      }
+      todo.push_back(i);
+   }
+
+   // counted[i] is set if the number of entries of tree i could be read;
+   // a vector of char rather than of bool, as it is written concurrently
+   std::vector<Char_t> counted(fNtrees, 0);
+   auto countEntries = [this, &counted](Int_t i) {
+      TChainElement *element = (TChainElement*) fFiles->At(i);
+      Long64_t nentries = 0;
+      TDirectory::TContext ctxt;
+      TFile *file = TFile::Open(element->GetTitle());
+      if (file && !file->IsZombie()) {
+         TTree *tree = (TTree*) file->Get(element->GetName());
+         if (tree) {
+            nentries = tree->GetEntries();
+            counted[i] = 1;
+         } else {
+            Error("ComputeTreeOffsets", "Cannot find tree with name %s in file %s", element->GetName(), element->GetTitle());
+         }
+      }
+      delete file;
+      element->SetNumberEntries(nentries);
+   };
+
+#ifdef R__USE_IMT
+   if (ROOT::IsImplicitMTEnabled() && todo.size() > 1) {
+      tbb::parallel_for(0, (Int_t)todo.size(), [&](Int_t k) { countEntries(todo[k]); });
+   } else
+#endif
+   {
+      for (auto i : todo) countEntries(i);
+   }
+
+   fTreeOffset[0] = 0;
+   for (Int_t i = 0; i < fNtrees; ++i) {
+      TChainElement *element = (TChainElement*) fFiles->At(i);
+      fTreeOffset[i+1] = fTreeOffset[i] + (element ? element->GetEntries() : 0);
+   }
+   fEntries = fTreeOffset[fNtrees];
+
+   if (useCache && !todo.empty()) {
+      for (auto i : todo) {
+         if (!hasStat[i] || !counted[i]) continue;
+         TChainElement *element = (TChainElement*) fFiles->At(i);
+         CacheRecord_t rec = { stats[i].fSize, stats[i].fMtime, element->GetEntries() };
+         cache[CacheKey_t(element->GetName(), element->GetTitle())] = rec;
+      }
+      std::ofstream out(cachename.Data());
+      if (!out) {
+         Warning("ComputeTreeOffsets", "Cannot write the cache file %s", cachename.Data());
+      }
+      for (auto &rec : cache) {
+         out << rec.second.fEntries << ' ' << rec.second.fSize << ' ' << rec.second.fMtime << ' '
+             << rec.first.first << ' ' << rec.first.second << '\n';
+      }
+   }
+   return fEntries;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Initialize the packet descriptor string.
 
@@ -910,7 +1082,7 @@ Long64_t TChain::GetChainEntryNumber(Long64_t entry) const
 ////////////////////////////////////////////////////////////////////////////////
 /// Return the total number of entries in the chain.
 /// In case the number of entries in each tree is not yet known,
-/// the offset table is computed.
+/// the offset table is computed (see ComputeTreeOffsets).
 
 Long64_t TChain::GetEntries() const
 {
@@ -922,7 +1094,11 @@ Long64_t TChain::GetEntries() const
       return fProofChain->GetEntries();
    }
    if (fEntries == TTree::kMaxEntries) {
-      const_cast<TChain*>(this)->LoadTree(TTree::kMaxEntries-1);
+      if (ROOT::IsImplicitMTEnabled() || !fEntriesCacheFile.IsNull()) {
+         const_cast<TChain*>(this)->ComputeTreeOffsets();
+      } else {
+         const_cast<TChain*>(this)->LoadTree(TTree::kMaxEntries-1);
+      }
    }
    return fEntries;
 }
@@ -1287,6 +1463,9 @@ Long64_t TChain::LoadTree(Long64_t entry)
 
    // If entry belongs to the current tree return entry.
    if (fTree && treenum == fTreeNumber) {
+      if (fOpenAheadFraction > 0) {
+         OpenAhead(treeReadEntry);
+      }
       // First set the entry the tree on its owns friends
       // (the friends of the chain will be updated in the
       // next loop).
@@ -1450,7 +1629,15 @@ Long64_t TChain::LoadTree(Long64_t entry)
 
    // FIXME: We leak memory here, we've just lost the open file
    //        if we did not delete it above.
-   {
+   if (fOpenAhead && fOpenAhead->GetTreeNumber() == treenum) {
+      // The file has been opened in the background, wait for it if needed.
+      fFile = fOpenAhead->GetFile();
+      delete fOpenAhead;
+      fOpenAhead = 0;
+      if (fFile) fFile->SetBit(kMustCleanup);
+   } else {
+      // We jumped to another tree than the one opened ahead (if any): close it.
+      ReleaseOpenAhead();
       TDirectory::TContext ctxt;
       fFile = TFile::Open(element->GetTitle());
       if (fFile) fFile->SetBit(kMustCleanup);
@@ -1713,6 +1900,28 @@ void TChain::Lookup(Bool_t force)
    SafeDelete(stg);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Start opening the file of the next tree in the background if the entry
+/// treeReadEntry of the current tree is beyond the fraction set with
+/// SetOpenAheadFraction.
+
+void TChain::OpenAhead(Long64_t treeReadEntry)
+{
+   Int_t next = fTreeNumber + 1;
+   if (next >= fNtrees || (fOpenAhead && fOpenAhead->GetTreeNumber() == next)) {
+      return;
+   }
+   if (treeReadEntry < fOpenAheadFraction * fTree->GetEntries()) {
+      return;
+   }
+   TChainElement *element = (TChainElement*) fFiles->At(next);
+   if (!element) {
+      return;
+   }
+   ReleaseOpenAhead();
+   fOpenAhead = new TOpenAhead(next, element->GetTitle(), element->GetName());
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Loop on nentries of this chain starting at firstentry.  (NOT IMPLEMENTED)
 
@@ -2204,6 +2413,17 @@ void TChain::RecursiveRemove(TObject *obj)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Wait for the file being opened in the background (if any) and close it.
+
+void TChain::ReleaseOpenAhead()
+{
+   if (!fOpenAhead) return;
+   delete fOpenAhead->GetFile();
+   delete fOpenAhead;
+   fOpenAhead = 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Remove a friend from the list of friends.
 
@@ -2232,6 +2452,7 @@ void TChain::RemoveFriend(TTree* oldFriend)
 
 void TChain::Reset(Option_t*)
 {
+   ReleaseOpenAhead();
    delete fFile;
    fFile = 0;
    fNtrees         = 0;
@@ -2254,6 +2475,7 @@ void TChain::Reset(Option_t*)
 
 void TChain::ResetAfterMerge(TFileMergeInfo *info)
 {
+   ReleaseOpenAhead();
    fNtrees         = 0;
    fTreeNumber     = -1;
    fTree           = 0;
@@ -2718,6 +2940,32 @@ void TChain::SetEventList(TEventList *evlist)
    SetEntryList(enlist);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Open the file of the next tree of the chain in the background once the
+/// event loop has reached the given fraction of the current tree.
+///
+/// The file is opened, and its tree header and StreamerInfo are read, in a
+/// separate thread while the current tree is processed, so that LoadTree
+/// does not stall on the file switch. This is mostly useful for remote files
+/// which take a long time to open. A fraction of 0 disables the open-ahead.
+///
+/// Since the file is opened concurrently with the event loop, enabling the
+/// open-ahead also enables the thread safety of ROOT (ROOT::EnableThreadSafety).
+
+void TChain::SetOpenAheadFraction(Float_t fraction)
+{
+   if (fraction < 0 || fraction > 1) {
+      Error("SetOpenAheadFraction", "The fraction must be between 0 and 1, got %g", fraction);
+      return;
+   }
+   fOpenAheadFraction = fraction;
+   if (fOpenAheadFraction > 0) {
+      ROOT::EnableThreadSafety();
+   } else {
+      ReleaseOpenAhead();
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set number of entries per packet for parallel root.
 
@@ -24,6 +24,7 @@
 #pragma link C++ class TTreeFormulaManager;
 #pragma link C++ class TTreeDrawArgsParser+;
 #pragma link C++ class TTreePerfStats+;
+#pragma link C++ class TTreePerfStats::BranchStats_t+;
 #pragma link C++ class TTreeReader+;
 #pragma link C++ class TTreeTableInterface;
 
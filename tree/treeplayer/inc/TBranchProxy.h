@@ -123,6 +123,7 @@ namespace Detail {
 
       TBranchProxy* GetProxy() { return this; }
       const char* GetBranchName() const { return fBranchName; }
+      Internal::TBranchProxyDirector* GetDirector() const { return fDirector; }
 
       void Reset();
 
@@ -40,11 +40,12 @@ namespace Internal{
       //This class could actually be the selector itself.
       TTree   *fTree;  // TTree we are currently looking at.
       Long64_t fEntry; // Entry currently being read.
+      ULong64_t fGeneration; // Incremented each time the entry or the tree changes, starts at 1.
 
       std::list<Detail::TBranchProxy*> fDirected;
       std::list<TFriendProxy*> fFriends;
 
-      TBranchProxyDirector(const TBranchProxyDirector &) : fTree(0), fEntry(-1) {;}
+      TBranchProxyDirector(const TBranchProxyDirector &) : fTree(0), fEntry(-1), fGeneration(1) {;}
       TBranchProxyDirector& operator=(const TBranchProxyDirector&) {return *this;}
 
    public:
@@ -55,6 +56,7 @@ namespace Internal{
       void     Attach(Detail::TBranchProxy* p);
       void     Attach(TFriendProxy* f);
       TH1F*    CreateHistogram(const char *options);
+      ULong64_t GetGeneration() const { return fGeneration; }
       Long64_t GetReadEntry() const { return fEntry; }
       TTree*   GetTree() const { return fTree; };
       // void   Print();
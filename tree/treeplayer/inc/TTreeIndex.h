@@ -29,6 +29,10 @@
 #include "TTreeFormula.h"
 #endif
 
+#include <atomic>
+#include <mutex>
+#include <vector>
+
 class TTreeIndex : public TVirtualIndex {
 
 protected:
@@ -42,6 +46,13 @@ protected:
    TTreeFormula  *fMinorFormula;        //! Pointer to minor TreeFormula
    TTreeFormula  *fMajorFormulaParent;  //! Pointer to major TreeFormula in Parent tree (if any)
    TTreeFormula  *fMinorFormulaParent;  //! Pointer to minor TreeFormula in Parent tree (if any)
+   mutable std::vector<Long64_t> fHashTable;        //! Open addressing table of positions in fIndexValues, for exact lookups
+   mutable std::atomic<Bool_t>   fHashTableValid;   //! True if fHashTable was built from the current index values
+   mutable std::mutex            fHashTableMutex;   //! Protects the lazy construction of fHashTable
+
+   void                   BuildHashTable() const;
+   void                   ResetHashTable();
+   Long64_t               FindExactValue(Long64_t major, Long64_t minor) const;
 
 private:
    TTreeIndex(const TTreeIndex&);            // Not implemented.
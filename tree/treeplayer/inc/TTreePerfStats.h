@@ -28,6 +28,10 @@
 #include "TString.h"
 #endif
 
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 
 class TBrowser;
 class TFile;
@@ -37,8 +41,27 @@ class TPaveText;
 class TGraphErrors;
 class TGaxis;
 class TText;
+class TH1D;
 class TTreePerfStats : public TVirtualPerfStats {
 
+public:
+   // I/O counters of one branch.
+   struct BranchStats_t {
+      TString    fName;         //name of the branch
+      Long64_t   fBytesRead;    //Number of compressed bytes read
+      Long64_t   fBytesUnzipped;//Number of bytes after decompression
+      Long64_t   fBytesStreamed;//Number of bytes deserialized
+      Long64_t   fEntriesRead;  //Number of entries deserialized
+      Int_t      fReadCalls;    //Number of baskets read
+      Int_t      fCacheMisses;  //Number of baskets not found in the TTreeCache
+      Double_t   fReadTime;     //Time spent reading the baskets
+      Double_t   fUnzipTime;    //Time spent uncompressing the baskets
+      Double_t   fStreamerTime; //Time spent deserializing the entries
+
+      BranchStats_t() : fBytesRead(0), fBytesUnzipped(0), fBytesStreamed(0), fEntriesRead(0),
+                        fReadCalls(0), fCacheMisses(0), fReadTime(0), fUnzipTime(0), fStreamerTime(0) {}
+   };
+
 protected:
    Int_t         fTreeCacheSize; //TTreeCache buffer size
    Int_t         fNleaves;       //Number of leaves in the tree
@@ -62,6 +85,13 @@ protected:
    TStopwatch   *fWatch;         //TStopwatch pointer
    TGaxis       *fRealTimeAxis;  //pointer to TGaxis object showing real-time
    TText        *fHostInfoText;  //Graphics Text object with the fHostInfo data
+   std::vector<BranchStats_t> fBranchStats; //I/O counters of each branch read
+   std::unordered_map<const TObject*,Int_t> fBranchIndex; //!index of each branch in fBranchStats
+   std::mutex    fBranchMutex;   //!protects the branch counters against concurrent branch reads
+
+   BranchStats_t   &GetBranchStatsFor(TObject *branch);
+   void             PrintBranches() const;
+   void             SaveBranchesJSON(const char *filename) const;
 
 public:
    TTreePerfStats();
@@ -70,10 +100,12 @@ public:
    virtual void     Browse(TBrowser *b);
    virtual Int_t    DistancetoPrimitive(Int_t px, Int_t py);
    virtual void     Draw(Option_t *option="");
+   TH1D            *DrawBranches(Option_t *option="bytes");
    virtual void     ExecuteEvent(Int_t event, Int_t px, Int_t py);
    virtual void     Finish();
    virtual Long64_t GetBytesRead() const {return fBytesRead;}
    virtual Long64_t GetBytesReadExtra() const {return fBytesReadExtra;}
+   const std::vector<BranchStats_t> &GetBranchStats() const {return fBranchStats;}
    virtual Double_t GetCpuTime()   const {return fCpuTime;}
    virtual Double_t GetDiskTime()  const {return fDiskTime;}
    TGraphErrors    *GetGraphIO()     {return fGraphIO;}
@@ -99,12 +131,16 @@ public:
    virtual void     FileOpenEvent(TFile *, const char *, Double_t) {}
    virtual void     FileReadEvent(TFile *file, Int_t len, Double_t start);
    virtual void     UnzipEvent(TObject *tree, Long64_t pos, Double_t start, Int_t complen, Int_t objlen);
+   virtual void     BasketReadEvent(TObject *branch, Int_t len, Double_t start, Bool_t cacheMiss);
+   virtual void     BasketUnzipEvent(TObject *branch, Double_t start, Int_t complen, Int_t objlen);
+   virtual void     BranchStreamerEvent(TObject *branch, Double_t start, Int_t len);
    virtual void     RateEvent(Double_t , Double_t , Long64_t , Long64_t) {}
 
    virtual void     SaveAs(const char *filename="",Option_t *option="") const;
    virtual void     SavePrimitive(std::ostream &out, Option_t *option = "");
    virtual void     SetBytesRead(Long64_t nbytes) {fBytesRead = nbytes;}
    virtual void     SetBytesReadExtra(Long64_t nbytes) {fBytesReadExtra = nbytes;}
+   void             SetBranchStats(const BranchStats_t &stats);
    virtual void     SetCompress(Double_t cx) {fCompress = cx;}
    virtual void     SetDiskTime(Double_t t) {fDiskTime = t;}
    virtual void     SetNumEvents(Long64_t) {}
@@ -121,7 +157,7 @@ public:
    virtual void     SetTreeCacheSize(Int_t nbytes) {fTreeCacheSize = nbytes;}
    virtual void     SetUnzipTime(Double_t uztime) {fUnzipTime = uztime;}
 
-   ClassDef(TTreePerfStats,1)  // TTree I/O performance measurement
+   ClassDef(TTreePerfStats,2)  // TTree I/O performance measurement
 };
 
 #endif
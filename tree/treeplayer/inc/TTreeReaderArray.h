@@ -36,21 +36,26 @@ namespace Internal {
    public:
       TTreeReaderArrayBase(TTreeReader* reader, const char* branchname,
                            TDictionary* dict):
-         TTreeReaderValueBase(reader, branchname, dict), fImpl(0) {}
+         TTreeReaderValueBase(reader, branchname, dict), fImpl(0), fCachedSize(0) {}
 
-      size_t GetSize() const { return fImpl->GetSize(GetProxy()); }
+      size_t GetSize() const {
+         if (IsCacheValid()) return fCachedSize;
+         return fImpl ? fImpl->GetSize(GetProxy()) : 0;
+      }
       Bool_t IsEmpty() const { return !GetSize(); }
 
       virtual EReadStatus GetReadStatus() const { return fImpl ? fImpl->fReadStatus : kReadError; }
 
    protected:
       void* UntypedAt(size_t idx) const { return fImpl->At(GetProxy(), idx); }
+      void FillCache(Bool_t allowContiguous);
       virtual void CreateProxy();
       const char* GetBranchContentDataType(TBranch* branch,
                                            TString& contentTypeName,
                                            TDictionary* &dict) const;
 
       TVirtualCollectionReader* fImpl; // Common interface to collections
+      size_t fCachedSize; // Size of the collection for the cached entry
 
       // FIXME: re-introduce once we have ClassDefInline!
       //ClassDef(TTreeReaderArrayBase, 0);//Accessor to member of an object stored in a collection
@@ -126,7 +131,13 @@ public:
       // Create an array reader of branch "branchname" for TTreeReader "tr".
    }
 
-   T& At(size_t idx) { return *(T*)UntypedAt(idx); }
+   T& At(size_t idx) {
+      // For contiguous collections of fundamental types, the address of the
+      // first element is looked up once per entry and the access is direct.
+      if (!IsCacheValid()) FillCache(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value);
+      if (fCachedAddress) return ((T*)fCachedAddress)[idx];
+      return *(T*)UntypedAt(idx);
+   }
    T& operator[](size_t idx) { return At(idx); }
 
    Iterator_t begin() {
@@ -73,6 +73,8 @@ namespace Internal {
       virtual ~TVirtualCollectionReader();
       virtual size_t GetSize(Detail::TBranchProxy*) = 0;
       virtual void* At(Detail::TBranchProxy*, size_t /*idx*/) = 0;
+      // True if the elements are stored one after the other, At(idx) being At(0) + idx.
+      virtual Bool_t IsContiguous(Detail::TBranchProxy*) { return kFALSE; }
    };
 
 }
@@ -99,6 +99,16 @@ namespace Internal {
 
       void MarkTreeReaderUnavailable() { fTreeReader = 0; }
 
+      // True if fCachedAddress has been set for the current entry of the director.
+      Bool_t IsCacheValid() const {
+         return fProxy && fProxy->GetDirector()
+            && fCachedGeneration == fProxy->GetDirector()->GetGeneration();
+      }
+      void SetCachedAddress(void *address) {
+         fCachedAddress = address;
+         fCachedGeneration = fProxy->GetDirector()->GetGeneration();
+      }
+
       TString      fBranchName; // name of the branch to read data from.
       TString      fLeafName;
       TTreeReader* fTreeReader; // tree reader we belong to
@@ -109,6 +119,8 @@ namespace Internal {
       ESetupStatus fSetupStatus; // setup status of this data access
       EReadStatus  fReadStatus; // read status of this data access
       std::vector<Long64_t> fStaticClassOffsets;
+      void*        fCachedAddress; // address of the data read for the director generation fCachedGeneration
+      ULong64_t    fCachedGeneration; // director generation for which fCachedAddress is valid, 0 if none
 
       // FIXME: re-introduce once we have ClassDefInline!
       //ClassDef(TTreeReaderValueBase, 0);//Base class for accessors to data via TTreeReader
@@ -130,12 +142,19 @@ public:
                            TDictionary::GetDictionary(typeid(NonConstT_t))) {}
 
    T* Get() {
+      // Once the current entry has been read, the address of the data stays
+      // valid until the reader moves to another entry or tree.
+      if (IsCacheValid()) return (T*)fCachedAddress;
       if (!fProxy){
          Error("Get()", "Value reader not properly initialized, did you remember to call TTreeReader.Set(Next)Entry()?");
          return 0;
       }
       void *address = GetAddress(); // Needed to figure out if it's a pointer
-      return fProxy->IsaPointer() ? *(T**)address : (T*)address; }
+      if (!address) return 0;
+      T *value = fProxy->IsaPointer() ? *(T**)address : (T*)address;
+      SetCachedAddress(value);
+      return value;
+   }
    T* operator->() { return Get(); }
    T& operator*() { return *Get(); }
 
@@ -50,7 +50,8 @@ namespace Internal {
 
    TBranchProxyDirector::TBranchProxyDirector(TTree* tree, Long64_t i) :
       fTree(tree),
-      fEntry(i)
+      fEntry(i),
+      fGeneration(1)
    {
       // Simple constructor
    }
@@ -58,7 +59,8 @@ namespace Internal {
    TBranchProxyDirector::TBranchProxyDirector(TTree* tree, Int_t i) :
       // cint has a problem casting int to long long
       fTree(tree),
-      fEntry(i)
+      fEntry(i),
+      fGeneration(1)
    {
       // Simple constructor
    }
@@ -132,6 +134,7 @@ namespace Internal {
 
       // move to a new entry to read
       fEntry = entry;
+      ++fGeneration;
       if (!fFriends.empty()) {
          for_each(fFriends.begin(),fFriends.end(),ResetReadEntry);
       }
@@ -146,6 +149,7 @@ namespace Internal {
       TTree* oldtree = fTree;
       fTree = newtree;
       fEntry = -1;
+      ++fGeneration;
       //if (fInitialized) fInitialized = setup();
       //fprintf(stderr,"calling SetTree for %p\n",this);
       for_each(fDirected.begin(),fDirected.end(),Reset);
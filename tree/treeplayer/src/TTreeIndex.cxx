@@ -11,12 +11,26 @@
 
 /** \class TTreeIndex
 A Tree Index with majorname and minorname.
+
+The (major,minor) pairs are kept sorted, which allows for the "best index"
+searches. Exact lookups go through a transient open addressing hash table
+of the positions in the sorted table, built by the first exact lookup.
+When implicit multi-threading is enabled, the sort of the index and the
+merge of appended indices are done in parallel.
 */
 
 #include "TTreeIndex.h"
 #include "TTree.h"
 #include "TMath.h"
 
+#include <algorithm>
+
+#ifdef R__USE_IMT
+#include "TROOT.h"
+#include "tbb/parallel_for.h"
+#include "tbb/parallel_sort.h"
+#endif
+
 ClassImp(TTreeIndex)
 
 
@@ -27,7 +41,7 @@ struct IndexSortComparator {
   {}
 
    template<typename Index>
-   bool operator()(Index i1, Index i2) {
+   bool operator()(Index i1, Index i2) const {
       if( *(fValMajor + i1) == *(fValMajor + i2) )
          return *(fValMinor + i1) < *(fValMinor + i2);
       else
@@ -39,11 +53,81 @@ struct IndexSortComparator {
   Long64_t *fValMajor, *fValMinor;
 };
 
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Sort the permutation index[0..n) according to comp.
+/// The sort is done in parallel if implicit multi-threading is enabled.
+
+template <typename Comparator>
+void SortIndex(Long64_t *index, Long64_t n, Comparator comp)
+{
+#ifdef R__USE_IMT
+   if (ROOT::IsImplicitMTEnabled()) {
+      tbb::parallel_sort(index, index + n, comp);
+      return;
+   }
+#endif
+   std::sort(index, index + n, comp);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Sort the permutation index[0..n) according to comp, taking advantage of
+/// the runs that are already sorted (e.g. the indices of the trees of a chain
+/// appended one after the other). The runs are merged pairwise, which costs
+/// O(N log R) for R runs instead of O(N log N) for a full sort. The merges of
+/// one pass are independent and are done in parallel if implicit
+/// multi-threading is enabled.
+
+template <typename Comparator>
+void MergeSortedRuns(Long64_t *index, Long64_t n, Comparator comp)
+{
+   // Start of each sorted run, followed by n.
+   std::vector<Long64_t> bounds(1, 0);
+   for (Long64_t i = 1; i < n; ++i) {
+      if (comp(index[i], index[i-1])) bounds.push_back(i);
+   }
+   bounds.push_back(n);
+
+   while (bounds.size() > 2) {
+      const size_t nmerges = (bounds.size() - 1) / 2;
+      auto mergePair = [&](size_t k) {
+         std::inplace_merge(index + bounds[2*k], index + bounds[2*k+1], index + bounds[2*k+2], comp);
+      };
+#ifdef R__USE_IMT
+      if (ROOT::IsImplicitMTEnabled()) {
+         tbb::parallel_for(size_t(0), nmerges, mergePair);
+      } else
+#endif
+      {
+         for (size_t k = 0; k < nmerges; ++k) mergePair(k);
+      }
+      std::vector<Long64_t> merged;
+      for (size_t k = 0; k < bounds.size(); k += 2) merged.push_back(bounds[k]);
+      if (merged.back() != n) merged.push_back(n);
+      bounds.swap(merged);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Hash of the pair (major,minor), using the splitmix64 finalizer.
+
+inline ULong64_t HashIndexValue(Long64_t major, Long64_t minor)
+{
+   ULong64_t h = ((ULong64_t)major * 0x9E3779B97F4A7C15ULL) ^ (ULong64_t)minor;
+   h ^= h >> 30; h *= 0xBF58476D1CE4E5B9ULL;
+   h ^= h >> 27; h *= 0x94D049BB133111EBULL;
+   h ^= h >> 31;
+   return h;
+}
+
+} // anonymous namespace
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Default constructor for TTreeIndex
 
-TTreeIndex::TTreeIndex(): TVirtualIndex()
+TTreeIndex::TTreeIndex(): TVirtualIndex(), fHashTableValid(kFALSE)
 {
    fTree               = 0;
    fN                  = 0;
@@ -121,7 +205,7 @@ TTreeIndex::TTreeIndex(): TVirtualIndex()
 /// see comments in TTree::SetTreeIndex.
 
 TTreeIndex::TTreeIndex(const TTree *T, const char *majorname, const char *minorname)
-           : TVirtualIndex()
+           : TVirtualIndex(), fHashTableValid(kFALSE)
 {
    fTree               = (TTree*)T;
    fN                  = 0;
@@ -179,7 +263,7 @@ TTreeIndex::TTreeIndex(const TTree *T, const char *majorname, const char *minorn
    }
    fIndex = new Long64_t[fN];
    for(i = 0; i < fN; i++) { fIndex[i] = i; }
-   std::sort(fIndex, fIndex + fN, IndexSortComparator(tmp_major, tmp_minor) );
+   SortIndex(fIndex, fN, IndexSortComparator(tmp_major, tmp_minor) );
    //TMath::Sort(fN,w,fIndex,0);
    fIndexValues = new Long64_t[fN];
    fIndexValuesMinor = new Long64_t[fN];
@@ -212,6 +296,9 @@ TTreeIndex::~TTreeIndex()
 /// Append 'add' to this index.  Entry 0 in add will become entry n+1 in this.
 /// If delaySort is true, do not sort the value, then you must call
 /// Append(0,kFALSE);
+///
+/// Since each appended index is already sorted, the final sort only merges
+/// the sorted runs.
 
 void TTreeIndex::Append(const TVirtualIndex *add, Bool_t delaySort )
 {
@@ -268,7 +355,7 @@ void TTreeIndex::Append(const TVirtualIndex *add, Bool_t delaySort )
       Long64_t *conv = new Long64_t[fN];
 
       for(Long64_t i = 0; i < fN; i++) { conv[i] = i; }
-      std::sort(conv, conv+fN, IndexSortComparator(addValues, addValues2) );
+      MergeSortedRuns(conv, fN, IndexSortComparator(addValues, addValues2) );
       //Long64_t *w = fIndexValues;
       //TMath::Sort(fN,w,conv,0);
 
@@ -286,6 +373,76 @@ void TTreeIndex::Append(const TVirtualIndex *add, Bool_t delaySort )
       delete [] ind;
       delete [] conv;
    }
+   // The hash table will be rebuilt from the new values by the next lookup.
+   ResetHashTable();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Build the hash table used by FindExactValue, if it is not up to date.
+/// The table has a power of two size of at least twice the number of entries,
+/// and uses linear probing. It stores the position in the sorted tables of the
+/// first occurrence of each (major,minor) pair.
+/// The table is built by the first lookup, so that an index which is only
+/// appended to or streamed does not pay for it.
+
+void TTreeIndex::BuildHashTable() const
+{
+   std::lock_guard<std::mutex> lock(fHashTableMutex);
+   if (fHashTableValid) return;
+   fHashTable.clear();
+   if (fN <= 0 || !fIndexValues || !fIndexValuesMinor) {
+      fHashTableValid = kTRUE;
+      return;
+   }
+
+   ULong64_t size = 2;
+   while (size < 2 * (ULong64_t)fN) size <<= 1;
+   fHashTable.assign(size, -1);
+   const ULong64_t mask = size - 1;
+   for (Long64_t pos = 0; pos < fN; ++pos) {
+      // Equal pairs are adjacent in the sorted tables, keep only the first one
+      // to match the lower bound returned by FindValues.
+      if (pos && fIndexValues[pos] == fIndexValues[pos-1]
+          && fIndexValuesMinor[pos] == fIndexValuesMinor[pos-1]) continue;
+      ULong64_t slot = HashIndexValue(fIndexValues[pos], fIndexValuesMinor[pos]) & mask;
+      while (fHashTable[slot] >= 0) slot = (slot + 1) & mask;
+      fHashTable[slot] = pos;
+   }
+   fHashTableValid = kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Discard the hash table after a change of the index values.
+
+void TTreeIndex::ResetHashTable()
+{
+   std::lock_guard<std::mutex> lock(fHashTableMutex);
+   fHashTable.clear();
+   fHashTableValid = kFALSE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the position of the pair major|minor in the IndexValues tables,
+/// or -1 if the pair is not in the index.
+/// This is the index in IndexValues table, not entry# !
+
+Long64_t TTreeIndex::FindExactValue(Long64_t major, Long64_t minor) const
+{
+   if (!fHashTableValid) BuildHashTable();
+   if (fHashTable.empty()) {
+      Long64_t pos = FindValues(major, minor);
+      if( pos < fN && fIndexValues[pos] == major && fIndexValuesMinor[pos] == minor )
+         return pos;
+      return -1;
+   }
+   const ULong64_t mask = fHashTable.size() - 1;
+   ULong64_t slot = HashIndexValue(major, minor) & mask;
+   while (true) {
+      Long64_t pos = fHashTable[slot];
+      if (pos < 0) return -1;
+      if (fIndexValues[pos] == major && fIndexValuesMinor[pos] == minor) return pos;
+      slot = (slot + 1) & mask;
+   }
 }
 
 
@@ -390,9 +547,9 @@ Long64_t TTreeIndex::GetEntryNumberWithBestIndex(Long64_t major, Long64_t minor)
 {
    if (fN == 0) return -1;
 
-   Long64_t pos = FindValues(major, minor);
-   if( pos < fN && fIndexValues[pos] == major && fIndexValuesMinor[pos] == minor )
-      return fIndex[pos];
+   Long64_t pos = FindExactValue(major, minor);
+   if (pos >= 0) return fIndex[pos];
+   pos = FindValues(major, minor);
    if( --pos < 0 )
       return -1;
    return fIndex[pos];
@@ -405,7 +562,7 @@ Long64_t TTreeIndex::GetEntryNumberWithBestIndex(Long64_t major, Long64_t minor)
 /// To read the data corresponding to an entry number, use TTree::GetEntryWithIndex
 /// the BuildIndex function has created a table of Double_t* of sorted values
 /// corresponding to val = major<<31 + minor;
-/// The function performs binary search in this sorted table.
+/// The pair is looked up in the hash table of the index.
 /// If it finds a pair that maches val, it returns directly the
 /// index in the table, otherwise it returns -1.
 ///
@@ -415,10 +572,9 @@ Long64_t TTreeIndex::GetEntryNumberWithIndex(Long64_t major, Long64_t minor) con
 {
    if (fN == 0) return -1;
 
-   Long64_t pos = FindValues(major, minor);
-   if( pos < fN && fIndexValues[pos] == major && fIndexValuesMinor[pos] == minor )
-      return fIndex[pos];
-   return -1;
+   Long64_t pos = FindExactValue(major, minor);
+   if (pos < 0) return -1;
+   return fIndex[pos];
 }
 
 
@@ -561,6 +717,7 @@ void TTreeIndex::Streamer(TBuffer &R__b)
       fIndex      = new Long64_t[fN];
       R__b.ReadFastArray(fIndex,fN);
       R__b.CheckByteCount(R__s, R__c, TTreeIndex::IsA());
+      ResetHashTable();
    } else {
       R__c = R__b.WriteVersion(TTreeIndex::IsA(), kTRUE);
       TVirtualIndex::Streamer(R__b);
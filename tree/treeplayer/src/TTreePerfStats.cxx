@@ -77,6 +77,22 @@ ReadTotal +ReadTotal*Readextra/100. Same for ReadSize.
 A consequence of NOTE1, the Disk I/O speed corresponds to the effective
 number of bytes returned to the application per second.
 The Physical disk speed is DiskIO + DiskIO*ReadExtra/100.
+
+ ### Per-branch counters
+While the TTreePerfStats is attached to the Tree, each branch reports
+the baskets it reads (compressed bytes, read time, whether the basket
+was found in the TTreeCache), the time spent uncompressing them and
+the time spent deserializing its entries. The counters are kept in
+fBranchStats (see GetBranchStats) and are saved together with the object.
+They can be inspected with:
+~~~{.cpp}
+   root > ioperf->Print("branches");        // table sorted by total time
+   root > ioperf->DrawBranches("unzip");    // one bar per branch
+   root > ioperf->SaveAs("ioperf.json");    // export as JSON
+~~~
+Measuring the deserialization time requires two time stamps per entry
+and per branch, hence the per-branch counters add a small overhead to
+the monitored event loop only.
 */
 
 #include "TTreePerfStats.h"
@@ -95,6 +111,9 @@ The Physical disk speed is DiskIO + DiskIO*ReadExtra/100.
 #include "TTimeStamp.h"
 #include "TDatime.h"
 #include "TMath.h"
+#include "TH1.h"
+
+#include <algorithm>
 
 ClassImp(TTreePerfStats)
 
@@ -204,6 +223,53 @@ void TTreePerfStats::Browse(TBrowser * /*b*/)
    gPad->Update();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Record the read of a basket of a branch.
+/// -  len is the number of compressed bytes read
+/// -  start is the TimeStamp before reading
+/// -  cacheMiss is true if the basket was not found in the TTreeCache
+
+void TTreePerfStats::BasketReadEvent(TObject *branch, Int_t len, Double_t start, Bool_t cacheMiss)
+{
+   Double_t tnow = TTimeStamp();
+   std::lock_guard<std::mutex> lock(fBranchMutex);
+   BranchStats_t &stats = GetBranchStatsFor(branch);
+   stats.fBytesRead += len;
+   stats.fReadCalls++;
+   if (cacheMiss) stats.fCacheMisses++;
+   stats.fReadTime += tnow-start;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Record the decompression of a basket of a branch.
+/// -  start is the TimeStamp before unzip
+/// -  complen is the length of the compressed buffer
+/// -  objlen is the length of the de-compressed buffer
+
+void TTreePerfStats::BasketUnzipEvent(TObject *branch, Double_t start, Int_t /* complen */, Int_t objlen)
+{
+   Double_t tnow = TTimeStamp();
+   std::lock_guard<std::mutex> lock(fBranchMutex);
+   BranchStats_t &stats = GetBranchStatsFor(branch);
+   stats.fBytesUnzipped += objlen;
+   stats.fUnzipTime += tnow-start;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Record the deserialization of one entry of a branch.
+/// -  start is the TimeStamp before streaming
+/// -  len is the number of bytes consumed from the basket
+
+void TTreePerfStats::BranchStreamerEvent(TObject *branch, Double_t start, Int_t len)
+{
+   Double_t tnow = TTimeStamp();
+   std::lock_guard<std::mutex> lock(fBranchMutex);
+   BranchStats_t &stats = GetBranchStatsFor(branch);
+   stats.fBytesStreamed += len;
+   stats.fEntriesRead++;
+   stats.fStreamerTime += tnow-start;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return distance to one of the objects in the TTreePerfStats
 
@@ -264,6 +330,70 @@ void TTreePerfStats::Draw(Option_t *option)
    AppendPad(opt.Data());
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Draw one bar per branch showing one of the per-branch counters,
+/// the most expensive branch first, in the spirit of TFileDrawMap.
+/// The option selects the counter:
+/// -  "bytes"    : MBytes read (default)
+/// -  "unzipped" : MBytes after decompression
+/// -  "reads"    : number of baskets read
+/// -  "misses"   : number of baskets not found in the TTreeCache
+/// -  "entries"  : number of entries deserialized
+/// -  "readtime" : time spent reading the baskets
+/// -  "unzip"    : time spent uncompressing the baskets
+/// -  "streamer" : time spent deserializing the entries
+/// -  "time"     : sum of the three times above
+/// The histogram is returned; it is deleted together with the pad.
+
+TH1D *TTreePerfStats::DrawBranches(Option_t *option)
+{
+   Int_t nbranches = fBranchStats.size();
+   if (!nbranches) {
+      Warning("DrawBranches", "No per-branch counters were recorded");
+      return 0;
+   }
+   TString opt = option;
+   opt.ToLower();
+   if (opt.Length() == 0) opt = "bytes";
+
+   std::vector<Double_t> values(nbranches);
+   TString title;
+   for (Int_t i=0;i<nbranches;i++) {
+      const BranchStats_t &stats = fBranchStats[i];
+      Double_t t = stats.fReadTime+stats.fUnzipTime+stats.fStreamerTime;
+      if (opt == "unzipped")      {values[i] = 1e-6*stats.fBytesUnzipped; title = "MBytes after decompression";}
+      else if (opt == "reads")    {values[i] = stats.fReadCalls;          title = "baskets read";}
+      else if (opt == "misses")   {values[i] = stats.fCacheMisses;        title = "baskets not found in the TTreeCache";}
+      else if (opt == "entries")  {values[i] = stats.fEntriesRead;        title = "entries deserialized";}
+      else if (opt == "readtime") {values[i] = stats.fReadTime;           title = "read time (s)";}
+      else if (opt == "unzip")    {values[i] = stats.fUnzipTime;          title = "unzip time (s)";}
+      else if (opt == "streamer") {values[i] = stats.fStreamerTime;       title = "streamer time (s)";}
+      else if (opt == "time")     {values[i] = t;                         title = "read+unzip+streamer time (s)";}
+      else                        {values[i] = 1e-6*stats.fBytesRead;     title = "MBytes read";}
+   }
+   std::vector<Int_t> order(nbranches);
+   for (Int_t i=0;i<nbranches;i++) order[i] = i;
+   std::stable_sort(order.begin(),order.end(),[&values](Int_t a, Int_t b) {return values[a] < values[b];});
+
+   TH1D *h = new TH1D("branchperf",Form("%s: %s per branch",fName.Data(),title.Data()),nbranches,0,nbranches);
+   h->SetDirectory(0);
+   h->SetBit(kCanDelete);
+   h->SetStats(kFALSE);
+   h->SetFillColor(kAzure-4);
+   h->SetBarWidth(0.8);
+   h->SetBarOffset(0.1);
+   // horizontal bars are drawn from the bottom, put the largest one on top
+   for (Int_t i=0;i<nbranches;i++) {
+      h->GetXaxis()->SetBinLabel(i+1,fBranchStats[order[i]].fName.Data());
+      h->SetBinContent(i+1,values[order[i]]);
+   }
+   h->GetYaxis()->SetTitle(title.Data());
+   if (!gPad || !gPad->IsEditable()) gROOT->MakeDefCanvas();
+   gPad->SetLeftMargin(0.25);
+   h->Draw("hbar");
+   return h;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return distance to one of the objects in the TTreePerfStats
 
@@ -311,6 +441,33 @@ void TTreePerfStats::UnzipEvent(TObject * tree, Long64_t /* pos */, Double_t sta
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the counters of a branch, creating them if the branch is seen for
+/// the first time. A branch with the same name (e.g. in the next Tree of a
+/// TChain) shares the counters. fBranchMutex must be held by the caller.
+
+TTreePerfStats::BranchStats_t &TTreePerfStats::GetBranchStatsFor(TObject *branch)
+{
+   const char *name = branch->GetName();
+   auto iter = fBranchIndex.find(branch);
+   // The name check protects against a deleted branch whose address is reused.
+   if (iter != fBranchIndex.end() && fBranchStats[iter->second].fName == name) {
+      return fBranchStats[iter->second];
+   }
+   Int_t index = -1;
+   Int_t nbranches = fBranchStats.size();
+   for (Int_t i=0;i<nbranches;i++) {
+      if (fBranchStats[i].fName == name) {index = i; break;}
+   }
+   if (index < 0) {
+      index = nbranches;
+      fBranchStats.push_back(BranchStats_t());
+      fBranchStats.back().fName = name;
+   }
+   fBranchIndex[branch] = index;
+   return fBranchStats[index];
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// When the run is finished this function must be called
 /// to save the current parameters in the file and Tree in this object
@@ -336,6 +493,7 @@ void TTreePerfStats::Finish()
       fGraphTime->GetY()[i]   = fGraphTime->GetY()[i-1] +fRealNorm*fGraphTime->GetEY()[i];
       fGraphTime->GetEY()[i]  = 0;
    }
+   fGraphTime->ResetEvalCache();
 }
 
 
@@ -423,12 +581,15 @@ void TTreePerfStats::Paint(Option_t *option)
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Print the TTree I/O perf stats.
+/// With option "unzip" the unzip and streamer times are printed.
+/// With option "branches" the per-branch counters are printed as a table.
 
 void TTreePerfStats::Print(Option_t * option) const
 {
    TString opts(option);
    opts.ToLower();
    Bool_t unzip = opts.Contains("unzip");
+   Bool_t branches = opts.Contains("branches");
    TTreePerfStats *ps = (TTreePerfStats*)this;
    ps->Finish();
 
@@ -457,18 +618,97 @@ void TTreePerfStats::Print(Option_t * option) const
       printf("ReadStrCP = %7.3f MBytes/s\n",1e-6*fCompress*fBytesRead/(fCpuTime-fUnzipTime));
       printf("ReadZipCP = %7.3f MBytes/s\n",1e-6*fCompress*fBytesRead/fUnzipTime);
    }
+   if (branches) PrintBranches();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Print the per-branch counters, the most expensive branch
+/// (read+unzip+streamer time) first.
+
+void TTreePerfStats::PrintBranches() const
+{
+   Int_t nbranches = fBranchStats.size();
+   std::vector<Int_t> order(nbranches);
+   for (Int_t i=0;i<nbranches;i++) order[i] = i;
+   auto totalTime = [this](Int_t i) {
+      const BranchStats_t &stats = fBranchStats[i];
+      return stats.fReadTime+stats.fUnzipTime+stats.fStreamerTime;
+   };
+   std::stable_sort(order.begin(),order.end(),[&totalTime](Int_t a, Int_t b) {return totalTime(a) > totalTime(b);});
+
+   printf("%-32s %10s %10s %7s %7s %10s %9s %9s %9s\n","Branch","Read(MB)","UnZip(MB)",
+          "Reads","Misses","Entries","ReadT(s)","UnzipT(s)","StrmT(s)");
+   for (Int_t i=0;i<nbranches;i++) {
+      const BranchStats_t &stats = fBranchStats[order[i]];
+      printf("%-32s %10.3f %10.3f %7d %7d %10lld %9.3f %9.3f %9.3f\n",stats.fName.Data(),
+             1e-6*stats.fBytesRead,1e-6*stats.fBytesUnzipped,stats.fReadCalls,stats.fCacheMisses,
+             stats.fEntriesRead,stats.fReadTime,stats.fUnzipTime,stats.fStreamerTime);
+   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Save this object to filename
+/// Save this object to filename.
+/// If filename ends with ".json" the global and per-branch counters are
+/// exported in JSON format.
 
 void TTreePerfStats::SaveAs(const char *filename, Option_t * /*option*/) const
 {
    TTreePerfStats *ps = (TTreePerfStats*)this;
    ps->Finish();
+   if (filename && TString(filename).EndsWith(".json")) {
+      SaveBranchesJSON(filename);
+      return;
+   }
    ps->TObject::SaveAs(filename);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Write the global and the per-branch counters to filename in JSON format.
+
+void TTreePerfStats::SaveBranchesJSON(const char *filename) const
+{
+   std::ofstream out(filename);
+   if (!out.good()) {
+      Error("SaveAs", "Cannot open file %s", filename);
+      return;
+   }
+   auto quoted = [](const TString &str) {
+      TString res = str;
+      res.ReplaceAll("\\","\\\\");
+      res.ReplaceAll("\"","\\\"");
+      return TString::Format("\"%s\"",res.Data());
+   };
+   out<<"{"<<std::endl;
+   out<<"  \"name\": "<<quoted(fName)<<","<<std::endl;
+   out<<"  \"hostInfo\": "<<quoted(fHostInfo)<<","<<std::endl;
+   out<<"  \"treeCacheSize\": "<<fTreeCacheSize<<","<<std::endl;
+   out<<"  \"readCalls\": "<<fReadCalls<<","<<std::endl;
+   out<<"  \"bytesRead\": "<<fBytesRead<<","<<std::endl;
+   out<<"  \"bytesReadExtra\": "<<fBytesReadExtra<<","<<std::endl;
+   out<<"  \"realTime\": "<<fRealTime<<","<<std::endl;
+   out<<"  \"cpuTime\": "<<fCpuTime<<","<<std::endl;
+   out<<"  \"diskTime\": "<<fDiskTime<<","<<std::endl;
+   out<<"  \"unzipTime\": "<<fUnzipTime<<","<<std::endl;
+   out<<"  \"branches\": ["<<std::endl;
+   Int_t nbranches = fBranchStats.size();
+   for (Int_t i=0;i<nbranches;i++) {
+      const BranchStats_t &stats = fBranchStats[i];
+      out<<"    {\"name\": "<<quoted(stats.fName)
+         <<", \"bytesRead\": "<<stats.fBytesRead
+         <<", \"bytesUnzipped\": "<<stats.fBytesUnzipped
+         <<", \"bytesStreamed\": "<<stats.fBytesStreamed
+         <<", \"readCalls\": "<<stats.fReadCalls
+         <<", \"cacheMisses\": "<<stats.fCacheMisses
+         <<", \"entriesRead\": "<<stats.fEntriesRead
+         <<", \"readTime\": "<<stats.fReadTime
+         <<", \"unzipTime\": "<<stats.fUnzipTime
+         <<", \"streamerTime\": "<<stats.fStreamerTime
+         <<"}"<<(i+1<nbranches ? "," : "")<<std::endl;
+   }
+   out<<"  ]"<<std::endl;
+   out<<"}"<<std::endl;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Save primitive as a C++ statement(s) on output stream out
 
@@ -496,6 +736,22 @@ void TTreePerfStats::SavePrimitive(std::ostream &out, Option_t *option /*= ""*/)
    out<<"   ps->SetDiskTime("<<fDiskTime<<");"<<std::endl;
    out<<"   ps->SetUnzipTime("<<fUnzipTime<<");"<<std::endl;
    out<<"   ps->SetCompress("<<fCompress<<");"<<std::endl;
+   for (const BranchStats_t &stats : fBranchStats) {
+      out<<"   {"<<std::endl;
+      out<<"      TTreePerfStats::BranchStats_t bs;"<<std::endl;
+      out<<"      bs.fName = "<<quote<<stats.fName<<quote<<";"<<std::endl;
+      out<<"      bs.fBytesRead = "<<stats.fBytesRead<<";"<<std::endl;
+      out<<"      bs.fBytesUnzipped = "<<stats.fBytesUnzipped<<";"<<std::endl;
+      out<<"      bs.fBytesStreamed = "<<stats.fBytesStreamed<<";"<<std::endl;
+      out<<"      bs.fEntriesRead = "<<stats.fEntriesRead<<";"<<std::endl;
+      out<<"      bs.fReadCalls = "<<stats.fReadCalls<<";"<<std::endl;
+      out<<"      bs.fCacheMisses = "<<stats.fCacheMisses<<";"<<std::endl;
+      out<<"      bs.fReadTime = "<<stats.fReadTime<<";"<<std::endl;
+      out<<"      bs.fUnzipTime = "<<stats.fUnzipTime<<";"<<std::endl;
+      out<<"      bs.fStreamerTime = "<<stats.fStreamerTime<<";"<<std::endl;
+      out<<"      ps->SetBranchStats(bs);"<<std::endl;
+      out<<"   }"<<std::endl;
+   }
 
    Int_t i, npoints = fGraphIO->GetN();
    out<<"   TGraphErrors *psGraphIO = new TGraphErrors("<<npoints<<");"<<std::endl;
@@ -524,3 +780,18 @@ void TTreePerfStats::SavePrimitive(std::ostream &out, Option_t *option /*= ""*/)
 
    out<<"   ps->Draw("<<quote<<option<<quote<<");"<<std::endl;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set the counters of the branch stats.fName, replacing existing ones.
+
+void TTreePerfStats::SetBranchStats(const BranchStats_t &stats)
+{
+   std::lock_guard<std::mutex> lock(fBranchMutex);
+   for (BranchStats_t &old : fBranchStats) {
+      if (old.fName == stats.fName) {
+         old = stats;
+         return;
+      }
+   }
+   fBranchStats.push_back(stats);
+}
@@ -101,6 +101,12 @@ namespace {
             return myCollectionProxy->At(idx);
          }
       }
+
+      virtual Bool_t IsContiguous(ROOT::Detail::TBranchProxy* proxy) {
+         TVirtualCollectionProxy *myCollectionProxy = (TVirtualCollectionProxy*) proxy->GetCollection();
+         return myCollectionProxy && myCollectionProxy->GetCollectionType() == ROOT::kSTLvector
+            && !myCollectionProxy->HasPointers();
+      }
    };
 
    class TCollectionLessSTLReader : public TVirtualCollectionReader {
@@ -140,6 +146,10 @@ namespace {
             return myCollectionProxy->At(idx);
          }
       }
+
+      virtual Bool_t IsContiguous(ROOT::Detail::TBranchProxy* /*proxy*/) {
+         return localCollection->GetCollectionType() == ROOT::kSTLvector && !localCollection->HasPointers();
+      }
    };
 
 
@@ -185,6 +195,8 @@ namespace {
          return (void*)((Byte_t*)array + (objectSize * idx));
       }
 
+      virtual Bool_t IsContiguous(ROOT::Detail::TBranchProxy* /*proxy*/) { return kTRUE; }
+
       void SetBasicTypeSize(Int_t size){
          basicTypeSize = size;
       }
@@ -273,6 +285,8 @@ namespace {
          return (Byte_t*)address + (elementSize * idx);
       }
 
+      virtual Bool_t IsContiguous(ROOT::Detail::TBranchProxy* /*proxy*/) { return kTRUE; }
+
    protected:
       void ProxyRead(){
          valueReader->ProxyRead();
@@ -299,6 +313,32 @@ Extracts array data from a TTree.
 
 ClassImp(TTreeReaderArrayBase)
 
+////////////////////////////////////////////////////////////////////////////////
+/// Cache the size of the collection for the current entry and, if
+/// allowContiguous is true and the elements are stored contiguously,
+/// the address of its first element. If the entry cannot be read, the
+/// cached size is 0 and no address is cached.
+
+void ROOT::Internal::TTreeReaderArrayBase::FillCache(Bool_t allowContiguous)
+{
+   fCachedSize = 0;
+   if (!fProxy || !fProxy->GetDirector() || !fImpl) {
+      fCachedAddress = 0;
+      return;
+   }
+   size_t size = fImpl->GetSize(fProxy);
+   if (fImpl->fReadStatus == kReadError) {
+      SetCachedAddress(0);
+      return;
+   }
+   fCachedSize = size;
+   void *address = 0;
+   if (allowContiguous && fCachedSize > 0 && fImpl->IsContiguous(fProxy)) {
+      address = fImpl->At(fProxy, 0);
+   }
+   SetCachedAddress(address);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Create the proxy object for our branch.
 
@@ -46,7 +46,9 @@ ROOT::Internal::TTreeReaderValueBase::TTreeReaderValueBase(TTreeReader* reader /
    fLeaf(NULL),
    fTreeLastOffset(-1),
    fSetupStatus(kSetupNotSetup),
-   fReadStatus(kReadNothingYet)
+   fReadStatus(kReadNothingYet),
+   fCachedAddress(0),
+   fCachedGeneration(0)
 {
    if (fTreeReader) fTreeReader->RegisterValueReader(this);
 }